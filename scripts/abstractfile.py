@@ -5,6 +5,7 @@ import getopt
 import gzip
 import os
 import re
+import subprocess
 import sys
 import tempfile
 
@@ -62,6 +63,10 @@ def open( apath, mode = 'r' ):
 
     if afile.type == 'gzip':
         return gzip.GzipFile( afile.cpath, mode )
+    elif afile.type == 'zstd':
+        if 'r' not in mode:
+            err( "zstd files are read-only from scripts: %s" % apath )
+        return subprocess.Popen( ['zstd', '-dcq', afile.cpath], stdout = subprocess.PIPE ).stdout
     else:
         return __builtin__.open( afile.cpath, mode )
 
@@ -206,6 +211,14 @@ def shell_tail( argv ):
             cmd = 'tail %s "%s"' % (' '.join(opts), tmp)
             exitval = os.system( cmd )
             os.remove( tmp )
+    elif afile.type == 'zstd':
+        tmp = '%s/abstractfile.tail.%s' % (tempfile.gettempdir(), os.getpid())
+        cmd = 'zstd -dcq "%s" > "%s"' % (afile.cpath, tmp)
+        exitval = os.system( cmd )
+        if exitval == 0:
+            cmd = 'tail %s "%s"' % (' '.join(opts), tmp)
+            exitval = os.system( cmd )
+            os.remove( tmp )
     else:
         cmd = 'tail %s "%s"' % (' '.join(opts), afile.cpath)
         exitval = os.system( cmd )
@@ -257,6 +270,9 @@ def resolve_apath( apath ):
         pathgz = apath + '.gz'
         if os.path.exists( pathgz ):
             return AbstractFile( 'gzip', apath )
+        pathzst = apath + '.zst'
+        if os.path.exists( pathzst ):
+            return AbstractFile( 'zstd', apath )
 
     return None
 
@@ -275,6 +291,8 @@ def resolve_cpath( cpath ):
 
     if cpath.endswith( '.gz' ):
         return AbstractFile( 'gzip', cpath[:-3] )
+    elif cpath.endswith( '.zst' ):
+        return AbstractFile( 'zstd', cpath[:-4] )
     else:
         return AbstractFile( 'file', cpath );
 
@@ -294,6 +312,8 @@ class AbstractFile:
 
         if type == 'gzip':
             self.cpath = apath + '.gz'
+        elif type == 'zstd':
+            self.cpath = apath + '.zst'
         else:
             self.cpath = apath
 
@@ -310,6 +330,8 @@ class AbstractFile:
             n += 1
         if os.path.exists( self.apath + '.gz' ):
             n += 1
+        if os.path.exists( self.apath + '.zst' ):
+            n += 1
 
         return n > 1
 
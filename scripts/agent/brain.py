@@ -1,6 +1,7 @@
 import os.path
 from numpy import array, matrix, vstack, zeros, ones
 from lazy import Lazy
+from pw_brainFunction import read_brainFunction
 
 #############################
 ### BrainAnatomy
@@ -123,28 +124,10 @@ class BrainFunction:
         assert os.path.isfile(self.filename),\
                 "Invalid brain function file: %s" % self.filename
 
-        # Open brain function, clean lines
-        f = open(filename)
-        lines = [ x.strip() for x in f.readlines()]
-        f.close()
-       
-        # validate version number
-        version = lines.pop(0).split(' ')[1]
-        assert version == '1', "Only compatible with version 1 brainFunction"
-
-        # validate brain function header
-        header = lines.pop(0).split(' ')
-        assert header[0] == 'brainFunction', "invalid brain function header."
-        assert len(header) >= 9, "header should have at least 9 parts."
-
-        #assert lines[-1].startswith('end fitness'),\
-        #        "brainFunction file did not finish"
-        if lines and lines[-1].startswith('end fitness'):
-            self.agent_fitness = float(lines.pop().split('=')[-1].strip())
-        else:
-            self.agent_fitness = None
-        
-        # remove summary line, extract overall fitness
+        # Read the header, count the recorded steps
+        data = read_brainFunction(filename, activations=False)
+        header = data.header
+        self.agent_fitness = data.fitness
 
         # process header information
         self.num_inputneurons = int(header[3])
@@ -163,7 +146,9 @@ class BrainFunction:
         Bstart, Bend = map(int, header[9].split('-'))
         self.neurons['blue'] = range(Bstart,Bend+1)
     
-        self.timesteps_lived = int(len(lines) / self.num_neurons)
+        # With a stride, each column is every stride-th step of the life.
+        self.stride = data.stride
+        self.timesteps_lived = data.num_rows
         
         ##############################################
         # define the neural groups
@@ -182,13 +167,6 @@ class BrainFunction:
         self.neurons['processing'] = PROCESSING_NEURONS
         self.neurons['internal'] = INTERNAL_NEURONS
 
-        assert len(lines) % self.num_neurons == 0,\
-                "#timesteps lived not evenly divisible by #neurons"
-        
-        
-
-
-
 
     ###########################################
     # Lazy loading of activations
@@ -197,22 +175,8 @@ class BrainFunction:
     def acts(self):
         print "calculating activations"
         
-        # Open brain function, clean lines
-        f = open(self.filename)
-        lines = [ x.strip() for x in f.xreadlines()]
-        lines = lines[2:-1]
-        f.close()
-
-        activations = [ [] for i in xrange(self.num_neurons) ]
-        
-        for line in lines:
-            parts = line.split(' ')
-            assert len(parts) == 2, "function line was not in (neuron, act)"
-            neuron, act = parts
-            activations[ int(neuron) ].append( float(act) )
-
-        # convert to numpy arrays
-        activations = array( activations )
+        # Neurons a version 2 file didn't record are all NaN
+        activations = read_brainFunction(self.filename).acts
     
         numrows, numcols = activations.shape
         assert numrows == self.num_neurons, "#rows != num_neurons"
@@ -262,6 +262,13 @@ case "$MODE" in
 	export -f PWFARM_STATUS
 
 	PWFARM_STATUS "Init Task"
+
+	# Polyworld publishes its progress to this file instead of invoking
+	# PWFARM_STATUS itself; forward it to the status server.
+	export PWFARM_METRICS="$FIELD_STATE_DIR/metrics"
+	rm -f "$PWFARM_METRICS"
+	$PWFARM_SCRIPTS_DIR/__pwfarm_metrics.py "$PWFARM_METRICS" forward $PWFARM_STATUS_STATE &
+	pid_metrics=$!
 	
 	echo $$ > $PID_COMMAND
 
@@ -299,6 +306,9 @@ case "$MODE" in
 
 	log "Command complete. exitval=$exitval"
 
+	kill $pid_metrics 2>/dev/null
+	wait $pid_metrics 2>/dev/null
+
 	PWFARM_TASKMETA set exitval $exitval
 
 	if [ $exitval == 0 ]; then
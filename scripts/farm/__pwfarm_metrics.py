@@ -0,0 +1,124 @@
+#!/usr/bin/env python
+
+#
+# Reads the metrics file Polyworld publishes when PWFARM_METRICS is set (see
+# src/library/monitor/FarmMetrics.h for the layout). Polyworld only rewrites
+# the file in place; it never blocks on, or starts, a reader.
+#
+# Modes:
+#
+#  print : Print the current metrics once.
+#
+#  forward STATUS_STATE : Poll the file and send each new sample to the status
+#         server of __pwfarm_status.py, in the form the farm UI has always shown:
+#         Polyworld [step=100 agents=98 food=203]
+#
+
+import os
+import struct
+import subprocess
+import sys
+import time
+
+MAGIC = b'PWMETRIC'
+VERSION = 1
+MAX_PROPERTIES = 16
+MAX_STRING = 32
+
+HEADER = struct.Struct( '=8sIIQqqiiffff' )
+PROPERTY = struct.Struct( '=%ds%ds' % (MAX_STRING, MAX_STRING) )
+SIZE = HEADER.size + MAX_PROPERTIES * PROPERTY.size
+SEQUENCE_OFFSET = 16
+
+POLL_SECONDS = 2
+
+def main():
+    if len(sys.argv) < 3:
+        usage()
+
+    path = sys.argv[1]
+    mode = sys.argv[2]
+
+    if mode == 'print':
+        metrics = read( path )
+        if metrics == None:
+            print( 'no metrics' )
+            sys.exit( 1 )
+        for key in ['step', 'maxSteps', 'population', 'pid', 'maxFitness', 'currentMaxFitness', 'averageFitness']:
+            print( '%s %s' % (key, metrics[key]) )
+        for title, value in metrics['properties']:
+            print( '%s %s' % (title, value) )
+    elif mode == 'forward' and len(sys.argv) == 4:
+        forward( path, sys.argv[3] )
+    else:
+        usage()
+
+    sys.exit( 0 )
+
+def usage():
+    print( 'usage: %s PATH print|forward STATUS_STATE' % sys.argv[0] )
+    sys.exit( 1 )
+
+def decode( s ):
+    return s.split( b'\0', 1 )[0].decode( 'utf-8', 'replace' )
+
+# Returns None if the file doesn't exist yet or hasn't been initialized.
+def read( path ):
+    try:
+        f = open( path, 'rb' )
+    except IOError:
+        return None
+
+    try:
+        while True:
+            f.seek( 0 )
+            data = f.read( SIZE )
+            if len(data) < SIZE:
+                return None
+
+            fields = HEADER.unpack_from( data )
+            magic, version, nproperties, sequence = fields[0:4]
+            if magic != MAGIC or version != VERSION:
+                return None
+
+            # seqlock: odd while the simulation is writing
+            if sequence % 2 == 1:
+                time.sleep( 0.01 )
+                continue
+
+            properties = []
+            for i in range( min(nproperties, MAX_PROPERTIES) ):
+                title, value = PROPERTY.unpack_from( data, HEADER.size + i * PROPERTY.size )
+                properties.append( (decode(title), decode(value)) )
+
+            # reread the sequence to make sure the copy wasn't torn
+            f.seek( SEQUENCE_OFFSET )
+            if struct.unpack( '=Q', f.read(8) )[0] != sequence:
+                continue
+
+            return { 'sequence': sequence,
+                     'step': fields[4],
+                     'maxSteps': fields[5],
+                     'population': fields[6],
+                     'pid': fields[7],
+                     'maxFitness': fields[8],
+                     'currentMaxFitness': fields[9],
+                     'averageFitness': fields[10],
+                     'properties': properties }
+    finally:
+        f.close()
+
+def forward( path, status_state ):
+    status_script = os.path.join( os.path.dirname(os.path.abspath(__file__)), '__pwfarm_status.py' )
+    sequence = None
+
+    while True:
+        metrics = read( path )
+        if metrics != None and metrics['sequence'] != sequence:
+            sequence = metrics['sequence']
+            status = 'Polyworld [%s]' % ' '.join( ['%s=%s' % p for p in metrics['properties']] )
+            subprocess.call( [status_script, status_state, 'set', status] )
+
+        time.sleep( POLL_SECONDS )
+
+main()
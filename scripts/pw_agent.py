@@ -20,7 +20,7 @@ class pw_agent:
 
 		f1 = gzip.open(filename1)
 		header1 = f1.readline()
-		if header1.startswith('version 1'):
+		if header1.startswith('version '):
 			header1 = f1.readline()
 			if header1.startswith('brainFunction'):
 				self.func_filename = filename1
@@ -36,7 +36,7 @@ class pw_agent:
 		if filename2:
 			f2 = gzip.open(filename2)
 			header2 = f2.readline()
-			if header2.startswith('version 1'):
+			if header2.startswith('version '):
 				header2 = f2.readline()
 				if header2.startswith('brainFunction'):
 					assert self.func_filename is None, "func_filename already defined!"
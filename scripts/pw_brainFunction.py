@@ -6,6 +6,105 @@ import numpy
 #from copy import copy
 #import numpy
 
+class BrainFunctionData:
+	'''raw contents of a brainFunction file of any version'''
+	pass
+
+def _open( filename ):
+	f = open( filename, 'rb' )
+	magic = f.read(2)
+	f.close()
+	if magic == '\x1f\x8b':
+		return gzip.open( filename )
+	return open( filename, 'rb' )
+
+def _readline( data, pos ):
+	end = data.find( '\n', pos )
+	if end < 0:
+		end = len(data)
+	return data[pos:end].strip(), end + 1
+
+def read_brainFunction( filename, activations=True ):
+	'''Reads a version 0, 1 or 2 brainFunction file. Version 2 files may hold
+	only some neurons, every stride-th step, and binary rows (see
+	src/library/brain/BrainFunctionFormat.h). acts is neurons x rows, with NaN
+	for neurons that weren't recorded; with activations=False only num_rows
+	is counted.'''
+	f = _open( filename )
+	data = f.read()
+	f.close()
+
+	result = BrainFunctionData()
+
+	version = 0
+	line, pos = _readline( data, 0 )
+	if line.startswith( 'version ' ):
+		version = int( line.split(' ')[1] )
+		line, pos = _readline( data, pos )
+	assert version <= 2, "unknown brainFunction version %d" % version
+
+	result.header = line.split(' ')
+	assert result.header[0] == 'brainFunction', "was not a brainFunction file"
+	assert len(result.header) >= 9, "header line has less than 9 parts"
+	num_neurons = int(result.header[2])
+
+	# recording encoding=quantized stride=4 neurons=0-11,20-31
+	encoding = 'text'
+	result.stride = 1
+	recorded = range( num_neurons )
+	if version >= 2:
+		line, pos = _readline( data, pos )
+		fields = dict( [x.split('=') for x in line.split(' ')[1:]] )
+		encoding = fields['encoding']
+		result.stride = int( fields['stride'] )
+		recorded = []
+		for r in fields['neurons'].split(','):
+			first, last = [ int(x) for x in r.split('-') ]
+			recorded += range( first, last + 1 )
+
+	result.fitness = None
+	columns = [ [] for i in recorded ]
+	column_of = dict( [(neuron, i) for i, neuron in enumerate(recorded)] )
+	num_lines = 0
+
+	if encoding == 'text':
+		for line in data[pos:].splitlines():
+			if line.startswith( 'end fitness' ):
+				result.fitness = float( line.split('=')[-1].strip() )
+				break
+			num_lines += 1
+			if activations:
+				neuron, act = line.split(' ')
+				columns[ column_of[int(neuron)] ].append( float(act) )
+		assert num_lines % len(recorded) == 0, "Error. number of lines not divisible by #neurons"
+		result.num_rows = num_lines / len(recorded)
+	else:
+		dtype = '<f2' if encoding == 'float16' else numpy.uint8
+		rowsize = 1 + len(recorded) * numpy.dtype(dtype).itemsize
+		result.num_rows = 0
+		# an incomplete file may end in part of a row
+		while data[pos:pos+1] == 'R' and pos + rowsize <= len(data):
+			if activations:
+				row = numpy.frombuffer( data[pos+1:pos+rowsize], dtype=dtype ).astype( float )
+				if encoding == 'quantized':
+					row /= 255.0
+				for i in range( len(recorded) ):
+					columns[i].append( row[i] )
+			result.num_rows += 1
+			pos += rowsize
+		line, pos = _readline( data, pos )
+		if line.startswith( 'end fitness' ):
+			result.fitness = float( line.split('=')[-1].strip() )
+
+	result.acts = None
+	if activations:
+		result.acts = numpy.empty( (num_neurons, result.num_rows) )
+		result.acts.fill( numpy.nan )
+		for i, neuron in enumerate(recorded):
+			result.acts[neuron] = columns[i]
+
+	return result
+
 class pw_brainFunction:
 	'''holds the data of a polyworld brainFunction file'''
 
@@ -25,22 +124,12 @@ class pw_brainFunction:
 		if not input_filename:
 			return None
 
-		lines = [ x.strip() for x in gzip.open( input_filename ).readlines() ]
-		if lines[0] == "version 1":
-			lines.pop(0)
+		data = read_brainFunction( input_filename )
 
 		# brainFunction 157 15 8 17 0 2-3 4-5 6-7
 		# format:
-		self.header = lines.pop(0).split(' ')
-
-		#print 'firstline=', firstline
-		assert self.header[0] == 'brainFunction', "was not a brainFunction file"
-		assert len(self.header) >= 9, "header line has less than 9 parts"
-
-		if len(lines) > 0 and lines[-1].startswith('end fitness'):
-			self.agent_fitness = float(lines.pop().split('=')[-1].strip())
-		else:
-			self.agent_fitness = None
+		self.header = data.header
+		self.agent_fitness = data.fitness
 
 		self.num_inputneurons = int(self.header[3])
 		self.agent_index = int(self.header[1])
@@ -58,20 +147,10 @@ class pw_brainFunction:
 		Bstart, Bend = [ int(x) for x in self.header[9].split('-') ]
 		self.neurons['blue'] = range(Bstart,Bend+1)
 
-		self.timesteps_lived = int(len(lines) / self.num_neurons)
-
-		assert len(lines) % self.num_neurons == 0, "Error. number of timesteps lived not divisible by #neurons"
-
-		self.acts = [ [] for i in range(self.num_neurons) ]
-
-		for line in lines:
-			parts = line.split(' ')
-			assert len(parts) == 2, "Error, was not two entries on the line"
-			neuron, act = parts
-			self.acts[ int(neuron) ].append( float(act) )
-
-		# convert to numpy arrays
-		self.acts = array( self.acts )
+		# With a stride, each column is every stride-th step of the life.
+		self.stride = data.stride
+		self.timesteps_lived = data.num_rows
+		self.acts = data.acts
 
 		numrows, numcols = self.acts.shape
 		assert numrows == self.num_neurons, "#rows != num_neurons"
@@ -5,6 +5,7 @@
 
 #include "monitor/MonitorManager.h"
 #include "sim/Simulation.h"
+#include "sim/StepProfiler.h"
 
 //===========================================================================
 // SimulationController
@@ -82,6 +83,22 @@ bool SimulationController::isPaused()
 	return paused;
 }
 
+//---------------------------------------------------------------------------
+// SimulationController::isProfiling
+//---------------------------------------------------------------------------
+bool SimulationController::isProfiling()
+{
+	return StepProfiler::isEnabled();
+}
+
+//---------------------------------------------------------------------------
+// SimulationController::setProfiling
+//---------------------------------------------------------------------------
+void SimulationController::setProfiling( bool profiling )
+{
+	StepProfiler::setEnabled( profiling );
+}
+
 //---------------------------------------------------------------------------
 // SimulationController::pause
 //---------------------------------------------------------------------------
@@ -26,6 +26,9 @@ class SimulationController : public QObject
 
 	bool isPaused();
 
+	bool isProfiling();
+	void setProfiling( bool profiling );
+
  signals:
 	void step();
 
@@ -85,6 +85,12 @@ void TerminalUI::step()
 				cout << "GUI shown. You may need to raise the window." << endl;
 			}
 		}
+		else if( cmd == "profile" )
+		{
+			bool profiling = !simulationController->isProfiling();
+			simulationController->setProfiling( profiling );
+			cout << "Step profiling " << (profiling ? "on." : "off.") << endl;
+		}
 		else
 		{
 			if( cmd != "help" )
@@ -95,6 +101,7 @@ void TerminalUI::step()
 			cerr << "help - Show this message." << endl;
 			cerr << "end - End simulation." << endl;
 			cerr << "gui - Show GUI." << endl;
+			cerr << "profile - Toggle step profiling." << endl;
 		}
 	}
 }
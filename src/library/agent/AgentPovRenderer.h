@@ -20,5 +20,15 @@ class AgentPovRenderer
 	virtual void render( class agent *a ) = 0;
 	virtual void endStep() = 0;
 
+	// When batched, render() only draws, and readRetinas() reads back the
+	// retinas of every agent rendered so far in the step at once. Brains
+	// mustn't be updated between the two.
+	virtual void setBatchedReadback( bool batched ) = 0;
+	virtual void readRetinas() = 0;
+
+	// Whether render() draws the stage through GL. If not, there may be no
+	// GL context, and the simulation must leave the stage uncompiled.
+	virtual bool usesGL() { return true; }
+
     util::Signal<> renderComplete;
 };
@@ -0,0 +1,60 @@
+#include "AgentRegistry.h"
+
+#include <assert.h>
+
+#include "agent.h"
+
+using namespace std;
+
+//===========================================================================
+// AgentRegistry
+//===========================================================================
+
+vector<agent *> AgentRegistry::agents;
+unordered_map<long, agent *> AgentRegistry::numbers;
+
+//---------------------------------------------------------------------------
+// AgentRegistry::add
+//---------------------------------------------------------------------------
+void AgentRegistry::add( agent *a )
+{
+	assert( a->registryIndex < 0 );
+
+	a->registryIndex = agents.size();
+	agents.push_back( a );
+	numbers[ a->Number() ] = a;
+}
+
+//---------------------------------------------------------------------------
+// AgentRegistry::remove
+//---------------------------------------------------------------------------
+void AgentRegistry::remove( agent *a )
+{
+	int index = a->registryIndex;
+	if( index < 0 )
+		return;
+
+	assert( agents[index] == a );
+
+	// fill the hole with the last agent
+	agent *last = agents.back();
+	agents[index] = last;
+	last->registryIndex = index;
+	agents.pop_back();
+
+	numbers.erase( a->Number() );
+
+	a->registryIndex = -1;
+}
+
+//---------------------------------------------------------------------------
+// AgentRegistry::find
+//---------------------------------------------------------------------------
+agent *AgentRegistry::find( long number )
+{
+	unordered_map<long, agent *>::iterator it = numbers.find( number );
+	if( it == numbers.end() )
+		return NULL;
+
+	return it->second;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+//===========================================================================
+// AgentRegistry
+//
+// All living agents in a dense array, for lookups by number and for scans
+// of the population that don't need x-sorted order. Removal swaps the last
+// agent into the hole, so the order is arbitrary and changes with deaths.
+//
+// Agents are added at birth and removed at death by TSimulation, so the
+// registry may only be modified and scanned by the master thread.
+//===========================================================================
+class AgentRegistry
+{
+ public:
+	static void add( class agent *a );
+	static void remove( class agent *a );
+
+	static int getCount();
+	static const std::vector<class agent *> &getAgents();
+
+	static class agent *find( long number );
+
+ private:
+	static std::vector<class agent *> agents;
+	static std::unordered_map<long, class agent *> numbers;
+};
+
+//===========================================================================
+// inlines
+//===========================================================================
+inline int AgentRegistry::getCount() { return agents.size(); }
+inline const std::vector<class agent *> &AgentRegistry::getAgents() { return agents; }
@@ -3,6 +3,11 @@
 #include <gl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
 
 #include "brain/Brain.h"
 #include "brain/NervousSystem.h"
@@ -18,12 +23,15 @@
 #define SlowVision false
 #define TauVision 0.2
 
+using namespace std;
+
 
 Retina::Retina( int width )
 {
 	this->width = width;
 	
 	buf = (unsigned char *)calloc( width * 4, sizeof(unsigned char) );
+	pixels = NULL;
 
 #if PrintBrain
 	bprinted = false;
@@ -44,10 +52,7 @@ void Retina::sensor_grow( NervousSystem *cns )
 
 void Retina::sensor_prebirth_signal( RandomNumberGenerator *rng )
 {
-	for( int i = 0; i < width * 4; i++ )
-	{
-		buf[i] = (unsigned char)(rng->range(0.0, 255.0));
-	}
+	rng->range( 0.0, 255.0, buf, width * 4 );
 
 	sensor_update( false );
 }
@@ -58,12 +63,14 @@ void Retina::sensor_update( bool bprint )
 	(
 		printf( "numneurons red,green,blue=%d, %d, %d\n",
 				channels[0].numneurons, channels[1].numneurons, channels[2].numneurons );
-		printf( "xwidth red,green,blue=%g, %g, %g\n",
-				channels[0].xwidth, channels[1].xwidth, channels[2].xwidth );
-		printf( "xintwidth red,green,blue=%d, %d, %d,\n",
-				channels[0].xintwidth, channels[1].xintwidth, channels[2].xintwidth );
 	)
 
+	if( pixels )
+	{
+		memcpy( buf, pixels, width * 4 );
+		pixels = NULL;
+	}
+
 	for( int i = 0; i < 3; i++ )
 	{
 		channels[i].update( bprint );
@@ -145,11 +152,74 @@ void Retina::updateBuffer( short x, short y,
 #endif
 }
 
+void Retina::setPixels( const unsigned char *pixels )
+{
+	this->pixels = pixels;
+}
+
 const unsigned char *Retina::getBuffer()
 {
 	return buf;
 }
 
+Retina::Pooling::Pooling( int width, int numneurons )
+{
+	this->numneurons = numneurons;
+	scale = 1.0 / (width * 255.0);
+
+	// In 1/numneurons of a pixel, neuron i spans [i * width, (i + 1) * width)
+	// and pixel p spans [p * numneurons, (p + 1) * numneurons).
+	for( int i = 0; i < numneurons; i++ )
+	{
+		int begin = i * width;
+		int end = (i + 1) * width;
+		int first = begin / numneurons;
+		int last = (end - 1) / numneurons;
+
+		firstPixel.push_back( first );
+		offsets.push_back( weights.size() );
+		for( int p = first; p <= last; p++ )
+		{
+			weights.push_back( min((p + 1) * numneurons, end) - max(p * numneurons, begin) );
+		}
+	}
+	offsets.push_back( weights.size() );
+}
+
+const Retina::Pooling *Retina::Pooling::get( int width, int numneurons )
+{
+	static map< pair<int, int>, Pooling * > poolings;
+	static mutex poolingsMutex;
+
+	lock_guard<mutex> lock( poolingsMutex );
+
+	Pooling *&pooling = poolings[ make_pair(width, numneurons) ];
+	if( pooling == NULL )
+	{
+		pooling = new Pooling( width, numneurons );
+	}
+
+	return pooling;
+}
+
+void Retina::Pooling::apply( const unsigned char *buf, int index, double *activations ) const
+{
+	const int *weight = &weights[0];
+
+	for( int i = 0; i < numneurons; i++ )
+	{
+		const unsigned char *pixel = buf + (firstPixel[i] * 4) + index;
+		int npixels = offsets[i + 1] - offsets[i];
+
+		int sum = 0;
+		for( int j = 0; j < npixels; j++ )
+			sum += pixel[j * 4] * weight[j];
+		weight += npixels;
+
+		activations[i] = sum * scale;
+	}
+}
+
 void Retina::Channel::init( Retina *retina,
 							NervousSystem *cns,
 							int index,
@@ -163,18 +233,7 @@ void Retina::Channel::init( Retina *retina,
 
 	numneurons = nerve->getNeuronCount();
 
-	int width = retina->width;
-
-	if( numneurons > 0 )
-	{
-		xwidth = float(width) / numneurons;
-		xintwidth = width / numneurons;
-
-		if( (xintwidth * numneurons) != width )
-		{
-			xintwidth = 0;
-		}
-	}
+	pooling = numneurons > 0 ? Pooling::get( retina->width, numneurons ) : NULL;
 }
 
 void Retina::Channel::update( bool bprint )
@@ -182,61 +241,13 @@ void Retina::Channel::update( bool bprint )
 	if( numneurons == 0 )
 		return;
 
-    short pixel;
-    float avgcolor;
-    float endpixloc;
-    
-    if( xintwidth )
-    {
-        pixel = 0;
-        for(int i = 0; i < numneurons; i++)
-        {
-            avgcolor = 0.0;
-            for (short ipix = 0; ipix < xintwidth; ipix++)
-                avgcolor += buf[((pixel++) * 4) + index];
-
-			nerve->set( i, avgcolor / (xwidth * 255.0) );
-        }
-    }
-    else
-    {
-        pixel = 0;
-        avgcolor = 0.0;
-
-		BPRINT("x%swidth = %f\n", name, xwidth);
-
-        for (int i = 0; i < numneurons; i++)
-        {
-            endpixloc = xwidth * float(i+1);
-
-			BPRINT("  neuron %d, endpixloc = %g\n", i, endpixloc);
-
-            while (float(pixel) < (endpixloc - 1.0))
-            {
-                avgcolor += buf[((pixel++) * 4) + index];
-				BPRINT("    in loop with pixel %d, avgcolor = %g\n", pixel,avgcolor);
-                IF_BPRINT
-				(
-					if ((float(pixel) < (endpixloc - 1.0)) && (float(pixel) >= (endpixloc - 1.0 - 1.0e-5)))
-						BPRINT("Got in-loop borderline case\n");
-                )
-            }
-            
-            avgcolor += (endpixloc - float(pixel)) * buf[(pixel * 4) + index];
-			nerve->set( i, avgcolor / (xwidth * 255.0) );
-
-			BPRINT("    after loop with pixel %d, avgcolor = %g, color = %g\n", pixel, avgcolor, nerve->get(i));
-            IF_BPRINT
-			(
-                if ((float(pixel) >= (endpixloc - 1.0)) && (float(pixel) < (endpixloc - 1.0 + 1.0e-5)))
-                    printf("Got outside-loop borderline case\n");
-			)
-			avgcolor = (1.0 - (endpixloc - float(pixel))) * buf[(pixel * 4) + index];
-			BPRINT("  before incrementing pixel = %d, avgcolor = %g\n", pixel, avgcolor);
-
-            pixel++;
-        }
-    }
+	pooling->apply( buf, index, nerve->getActivations() );
+
+	IF_BPRINT
+	(
+		for( int i = 0; i < numneurons; i++ )
+			printf( "  %s neuron %d = %g\n", name, i, nerve->get(i) );
+	)
 
 #if SlowVision
 	for(int i = 0; i < numneurons; i++ )
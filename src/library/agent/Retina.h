@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "brain/Brain.h"
 #include "brain/Sensor.h"
 
@@ -20,16 +22,42 @@ class Retina : public Sensor
 	virtual void sensor_dump_anatomical( AbstractFile *f );
 
 	void updateBuffer( short x, short y, short width, short height );
+	// Row read back for this step by the POV renderer, which sensor_update()
+	// copies from. pixels must stay valid until then.
+	void setPixels( const unsigned char *pixels );
 
 	const unsigned char *getBuffer();
 
  private:
 	int width;
 	unsigned char *buf;
+	const unsigned char *pixels;
 #if PrintBrain
 	bool bprinted;
 #endif
 
+	// Weights of a row's pixels in each of a channel's neurons, shared by
+	// every retina with the same width and neuron count. Neuron i averages
+	// the span [i, i + 1) * width / numneurons of the row. Measured in
+	// 1/numneurons of a pixel, each pixel's part of that span is a whole
+	// number, so a neuron is an integer dot product and one scale.
+	class Pooling
+	{
+	public:
+		static const Pooling *get( int width, int numneurons );
+
+		void apply( const unsigned char *buf, int index, double *activations ) const;
+
+	private:
+		Pooling( int width, int numneurons );
+
+		int numneurons;
+		double scale;
+		std::vector<int> firstPixel;	// by neuron
+		std::vector<int> offsets;		// by neuron, into weights; numneurons + 1
+		std::vector<int> weights;
+	};
+
 	class Channel
 	{
 	public:
@@ -37,9 +65,8 @@ class Retina : public Sensor
 		const char *name;
 		unsigned char *buf;
 		Nerve *nerve;
-		float xwidth;
+		const Pooling *pooling;
 		int index;
-		int xintwidth;
 		int numneurons;
 
 		void init( Retina *retina,
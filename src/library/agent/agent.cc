@@ -32,6 +32,7 @@
 #include "sim/debug.h"
 #include "sim/globals.h"
 #include "sim/Simulation.h"
+#include "sim/StepProfiler.h"
 #include "utils/AbstractFile.h"
 #include "utils/datalib.h"
 #include "utils/graybin.h"
@@ -247,7 +248,8 @@ agent::agent(TSimulation* sim, gstage* stage)
 		fMateWaitSensor(NULL),
 		fSpeedSensor(NULL),
 		fCarryingSensor(NULL),
-		fBeingCarriedSensor(NULL)
+		fBeingCarriedSensor(NULL),
+		registryIndex(-1)
 {
 	AgentAttachedData::alloc( this );
 
@@ -515,6 +517,8 @@ void agent::setGenomeReady()
 //---------------------------------------------------------------------------
 void agent::grow( long mateWait, bool seeding )
 {
+	StepProfiler::Timer timer( StepProfiler::BRAIN_CONSTRUCTION );
+
 	InitGeneCache();
 
 	// ---
@@ -1243,76 +1247,79 @@ float agent::UpdateBody( float moveFitnessParam,
 		// other side.
 
 		barrier* b = NULL;
-		barrier::gXSortedBarriers.reset();
-		while( barrier::gXSortedBarriers.next(b) )
+		if( barrier::gBarrierBVH.isListSorted() )
 		{
-			if( (b->xmax() > (    x() - FF * CarryRadius())) ||
-				(b->xmax() > (LastX() - FF * CarryRadius())) )
+			// Same barriers, in the same order, as the list scan below, but
+			// only those near the agent. A push can carry the agent toward
+			// barriers it wasn't near, so look again after every move.
+			static thread_local vector<int> candidates;
+			int first = 0;
+			bool moved = true;
+			while( moved )
 			{
-				// end of barrier comes after beginning of agent
-				// in either its new or old position
-				if( (b->xmin() > (    x() + FF * CarryRadius())) &&
-					(b->xmin() > (LastX() + FF * CarryRadius())) )
-				{
-					// beginning of barrier comes after end of agent,
-					// in both new and old positions,
-					// so there is no overlap, and we can stop searching
-					// for this agent's possible barrier overlaps
-					break;  // get out of the sorted barriers while loop
-				}
-				else // we have an overlap in x
+				moved = false;
+				float r = FF * CarryRadius();
+				candidates.clear();
+				barrier::gBarrierBVH.query( min(x(), LastX()) - r, max(x(), LastX()) + r,
+											min(z(), LastZ()) - r, max(z(), LastZ()) + r,
+											first,
+											candidates );
+				for( int index : candidates )
 				{
-					if( ((b->zmin() < ( z() + FF * CarryRadius())) || (b->zmin() < (LastZ() + FF * CarryRadius()))) &&
+					b = barrier::gBarrierBVH.get( index );
+					first = index + 1;
+
+					if( ((b->xmax() > (    x() - FF * CarryRadius())) ||
+						 (b->xmax() > (LastX() - FF * CarryRadius()))) &&
+						((b->xmin() <= (    x() + FF * CarryRadius())) ||
+						 (b->xmin() <= (LastX() + FF * CarryRadius()))) &&
+						((b->zmin() < ( z() + FF * CarryRadius())) || (b->zmin() < (LastZ() + FF * CarryRadius()))) &&
 						((b->zmax() > ( z() - FF * CarryRadius())) || (b->zmax() > (LastZ() - FF * CarryRadius()))) )
 					{
-						if( barrier::gStickyBarriers )
+						float xo = x();
+						float zo = z();
+
+						CollideWithBarrier( b );
+
+						if( (x() != xo) || (z() != zo) )
 						{
-							fPosition[0] = LastX();
-							fPosition[2] = LastZ();
+							moved = true;
+							break;
 						}
-						else
+					}
+				}
+			}
+		}
+		else
+		{
+			barrier::gXSortedBarriers.reset();
+			while( barrier::gXSortedBarriers.next(b) )
+			{
+				if( (b->xmax() > (    x() - FF * CarryRadius())) ||
+					(b->xmax() > (LastX() - FF * CarryRadius())) )
+				{
+					// end of barrier comes after beginning of agent
+					// in either its new or old position
+					if( (b->xmin() > (    x() + FF * CarryRadius())) &&
+						(b->xmin() > (LastX() + FF * CarryRadius())) )
+					{
+						// beginning of barrier comes after end of agent,
+						// in both new and old positions,
+						// so there is no overlap, and we can stop searching
+						// for this agent's possible barrier overlaps
+						break;  // get out of the sorted barriers while loop
+					}
+					else // we have an overlap in x
+					{
+						if( ((b->zmin() < ( z() + FF * CarryRadius())) || (b->zmin() < (LastZ() + FF * CarryRadius()))) &&
+							((b->zmax() > ( z() - FF * CarryRadius())) || (b->zmax() > (LastZ() - FF * CarryRadius()))) )
 						{
-							// also overlap in z, so there may be an intersection
-							float dist  = b->dist(     x(),     z() );
-							float disto = b->dist( LastX(), LastZ() );
-							float p;
-
-							if( fabs( dist ) < FF * CarryRadius() )
-							{
-								// they actually overlap/intersect
-								if( (disto*dist) < 0.0 )
-								{   // sign change, so crossed the barrier already
-									p = fabs( dist ) + FF * CarryRadius();
-									if( disto < 0.0 ) p = -p;
-								}
-								else
-								{
-									p = FF * CarryRadius() - fabs( dist );
-									if( dist < 0. ) p = -p;
-								}
-
-								addz(  p * b->sina() );
-								addx( -p * b->cosa() );
-
-							} // actual intersection
-							else if( (disto * dist) < 0.0 )
-							{
-								// the agent completely passed through the barrier
-								p = fabs( dist ) + FF * CarryRadius();
-
-								if( disto < 0.0 )
-									p = -p;
-
-								addz(  p * b->sina() );
-								addx( -p * b->cosa() );
-							}
-						}
-
-						logs->postEvent( CollisionEvent(this, OT_BARRIER) );
-					} // overlap in z
-				} // beginning of barrier comes after end of agent
-			} // end of barrier comes after beginning of agent
-		} // while( barrier::gXSortedBarriers.next(b) )
+							CollideWithBarrier( b );
+						} // overlap in z
+					} // beginning of barrier comes after end of agent
+				} // end of barrier comes after beginning of agent
+			} // while( barrier::gXSortedBarriers.next(b) )
+		}
 
 		// If there are solid objects besides bricks, or
 		// if only bricks are solid and bricks are present in the simulation...
@@ -1480,6 +1487,59 @@ float agent::UpdateBody( float moveFitnessParam,
 }
 
 
+//---------------------------------------------------------------------------
+// agent::CollideWithBarrier
+//
+// Pushes the agent back out of a barrier whose bounds it overlaps.
+//---------------------------------------------------------------------------
+void agent::CollideWithBarrier( barrier *b )
+{
+	if( barrier::gStickyBarriers )
+	{
+		fPosition[0] = LastX();
+		fPosition[2] = LastZ();
+	}
+	else
+	{
+		// also overlap in z, so there may be an intersection
+		float dist  = b->dist(     x(),     z() );
+		float disto = b->dist( LastX(), LastZ() );
+		float p;
+
+		if( fabs( dist ) < FF * CarryRadius() )
+		{
+			// they actually overlap/intersect
+			if( (disto*dist) < 0.0 )
+			{   // sign change, so crossed the barrier already
+				p = fabs( dist ) + FF * CarryRadius();
+				if( disto < 0.0 ) p = -p;
+			}
+			else
+			{
+				p = FF * CarryRadius() - fabs( dist );
+				if( dist < 0. ) p = -p;
+			}
+
+			addz(  p * b->sina() );
+			addx( -p * b->cosa() );
+
+		} // actual intersection
+		else if( (disto * dist) < 0.0 )
+		{
+			// the agent completely passed through the barrier
+			p = fabs( dist ) + FF * CarryRadius();
+
+			if( disto < 0.0 )
+				p = -p;
+
+			addz(  p * b->sina() );
+			addx( -p * b->cosa() );
+		}
+	}
+
+	logs->postEvent( CollisionEvent(this, OT_BARRIER) );
+}
+
 //---------------------------------------------------------------------------
 // agent::UpdateColor
 //---------------------------------------------------------------------------
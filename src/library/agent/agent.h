@@ -152,6 +152,7 @@ public:
 					  int solidObjects,
 					  agent* carrier );
 	void UpdateColor();
+	void CollideWithBarrier( class barrier *b );
 	void AvoidCollisions( int solidObjects );
 	void AvoidCollisionDirectional( int direction, int solidObjects );
 	void GetCollisionFixedCoordinates( float xo, float zo, float xn, float zn, float xb, float zb, float rc, float rb, float *xf, float *zf );
@@ -229,6 +230,7 @@ public:
 	Energy LastEatEnergy();
 	Energy LastEatEnergyRaw();
 	genome::Genome* Genes();
+	genome::Genome* ReleaseGenes();	// caller takes ownership; only once the agent is dead
 	NervousSystem* GetNervousSystem();
     long Number();
 	float CurrentHeuristicFitness();
@@ -368,6 +370,9 @@ protected:
 	friend class AgentAttachedData;
 	AgentAttachedData::SlotData *attachedData;
 
+	friend class AgentRegistry;
+	int registryIndex;	// into AgentRegistry::agents; -1 if not registered
+
 	AgentListeners listeners;
 };
 
@@ -420,6 +425,7 @@ inline float agent::LastEatDistance() { return dist( fPosition[0], fPosition[2],
 inline Energy agent::LastEatEnergy() { return fLastEatEnergy; }
 inline Energy agent::LastEatEnergyRaw() { return fLastEatEnergyRaw; }
 inline genome::Genome* agent::Genes() { return fGenome; }
+inline genome::Genome* agent::ReleaseGenes() { assert( !fAlive ); genome::Genome *g = fGenome; fGenome = NULL; return g; }
 inline NervousSystem* agent::GetNervousSystem() { return fCns; }
 inline long agent::Number() { return getTypeNumber(); }
 // replace both occurences of 0.8 with actual estimate of fraction of lifespan agent will live
@@ -180,9 +180,11 @@ void Brain::dumpAnatomical( AbstractFile *file, long index, float fitness )
 //---------------------------------------------------------------------------
 // Brain::startFunctional
 //---------------------------------------------------------------------------
-void Brain::startFunctional( AbstractFile *file, long index )
+void Brain::startFunctional( AbstractFile *file, long index, const BrainFunctionFormat &format )
 {
-	file->printf( "version 1\n" );
+	bool version1 = format.isVersion1( _dims.numNeurons );
+
+	file->printf( "version %d\n", version1 ? 1 : 2 );
 
 	// print the header, with index (agent number)
 	file->printf( "brainFunction %ld", index );
@@ -197,6 +199,9 @@ void Brain::startFunctional( AbstractFile *file, long index )
 	_cns->startFunctional( file );
 
 	file->printf( "\n" );
+
+	if( !version1 )
+		format.writeHeader( file );
 }
 
 //---------------------------------------------------------------------------
@@ -210,9 +215,18 @@ void Brain::endFunctional( AbstractFile *file, float fitness )
 //---------------------------------------------------------------------------
 // Brain::writeFunctional
 //---------------------------------------------------------------------------
-void Brain::writeFunctional( AbstractFile *file )
+void Brain::writeFunctional( AbstractFile *file, BrainFunctionFormat &format )
 {
-	_neuralnet->writeFunctional( file );
+	if( format.isVersion1(_dims.numNeurons) )
+	{
+		_neuralnet->writeFunctional( file );
+	}
+	else
+	{
+		_functionalActivations.resize( _dims.numNeurons );
+		_neuralnet->getActivations( &_functionalActivations[0], 0, _dims.numNeurons );
+		format.writeRow( file, &_functionalActivations[0] );
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -4,8 +4,10 @@
 #include <istream>
 #include <ostream>
 #include <string>
+#include <vector>
 
 // Local
+#include "BrainFunctionFormat.h"
 #include "NeuralNetRenderer.h"
 #include "NeuronModel.h"
 #include "proplib/proplib.h"
@@ -140,9 +142,9 @@ public:
 
 	void dumpAnatomical( AbstractFile *file, long index, float fitness );
 
-	void startFunctional( AbstractFile *file, long index );
+	void startFunctional( AbstractFile *file, long index, const BrainFunctionFormat &format );
 	void endFunctional( AbstractFile* file, float fitness );
-	void writeFunctional( AbstractFile* file );
+	void writeFunctional( AbstractFile* file, BrainFunctionFormat &format );
 
 	void dumpSynapses( AbstractFile *file, long index );
 	void loadSynapses( AbstractFile *file, float maxWeight = -1.0f );
@@ -157,6 +159,8 @@ protected:
 	NeuralNetRenderer *_renderer;
 	float _energyUse;
 	bool _frozen;
+	// Activations of a version 2 brainFunction row.
+	std::vector<double> _functionalActivations;
 };
 
 //===========================================================================
@@ -0,0 +1,271 @@
+// Self
+#include "BrainFunctionFormat.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Local
+#include "utils/AbstractFile.h"
+
+using namespace std;
+
+#define RowTag 'R'
+
+//---------------------------------------------------------------------------
+// toHalf
+//
+// Round to nearest. Activations are in [0,1], so there's no need for
+// infinities or NaNs.
+//---------------------------------------------------------------------------
+static unsigned short toHalf( float value )
+{
+	unsigned int bits;
+	memcpy( &bits, &value, sizeof(bits) );
+
+	unsigned short sign = (bits >> 16) & 0x8000;
+	int exponent = int((bits >> 23) & 0xff) - 127 + 15;
+	unsigned int mantissa = bits & 0x7fffff;
+
+	if( exponent <= 0 )
+	{
+		if( exponent < -10 )
+			return sign;
+		// Subnormal
+		mantissa |= 0x800000;
+		int shift = 14 - exponent;
+		unsigned int half = mantissa >> shift;
+		if( (mantissa >> (shift - 1)) & 1 )
+			half++;
+		return sign | half;
+	}
+	else if( exponent >= 31 )
+	{
+		return sign | 0x7bff;	// largest finite
+	}
+
+	unsigned int half = (exponent << 10) | (mantissa >> 13);
+	if( mantissa & 0x1000 )
+		half++;	// may carry into the exponent, which is still right
+	return sign | half;
+}
+
+//---------------------------------------------------------------------------
+// fromHalf
+//---------------------------------------------------------------------------
+static float fromHalf( unsigned short half )
+{
+	float sign = (half & 0x8000) ? -1.0f : 1.0f;
+	int exponent = (half >> 10) & 0x1f;
+	int mantissa = half & 0x3ff;
+
+	if( exponent == 0 )
+		return sign * ldexpf( float(mantissa), -24 );
+	else
+		return sign * ldexpf( float(mantissa | 0x400), exponent - 25 );
+}
+
+//---------------------------------------------------------------------------
+// BrainFunctionFormat::BrainFunctionFormat
+//---------------------------------------------------------------------------
+BrainFunctionFormat::BrainFunctionFormat()
+: encoding( Text )
+, stride( 1 )
+{
+}
+
+//---------------------------------------------------------------------------
+// BrainFunctionFormat::isVersion1
+//---------------------------------------------------------------------------
+bool BrainFunctionFormat::isVersion1( int numNeurons ) const
+{
+	return (encoding == Text)
+		&& (stride == 1)
+		&& (ranges.size() == 1)
+		&& (ranges[0].first == 0)
+		&& (ranges[0].last == numNeurons - 1);
+}
+
+//---------------------------------------------------------------------------
+// BrainFunctionFormat::getNumColumns
+//---------------------------------------------------------------------------
+int BrainFunctionFormat::getNumColumns() const
+{
+	int n = 0;
+	for( const Range &range : ranges )
+		n += range.last - range.first + 1;
+	return n;
+}
+
+//---------------------------------------------------------------------------
+// BrainFunctionFormat::getColumn
+//---------------------------------------------------------------------------
+int BrainFunctionFormat::getColumn( int neuron ) const
+{
+	int column = 0;
+	for( const Range &range : ranges )
+	{
+		if( (neuron >= range.first) && (neuron <= range.last) )
+			return column + (neuron - range.first);
+		column += range.last - range.first + 1;
+	}
+	return -1;
+}
+
+//---------------------------------------------------------------------------
+// BrainFunctionFormat::writeHeader
+//---------------------------------------------------------------------------
+void BrainFunctionFormat::writeHeader( AbstractFile *file ) const
+{
+	static const char *encodingNames[] = { "text", "float16", "quantized" };
+
+	file->printf( "recording encoding=%s stride=%d neurons=", encodingNames[encoding], stride );
+	for( size_t i = 0; i < ranges.size(); i++ )
+		file->printf( "%s%d-%d", i ? "," : "", ranges[i].first, ranges[i].last );
+	file->printf( "\n" );
+}
+
+//---------------------------------------------------------------------------
+// BrainFunctionFormat::parseHeader
+//---------------------------------------------------------------------------
+bool BrainFunctionFormat::parseHeader( const char *line )
+{
+	char encodingName[32];
+	int nread;
+	if( (sscanf(line, "recording encoding=%31s stride=%d neurons=%n", encodingName, &stride, &nread) != 2)
+		|| (stride < 1) )
+	{
+		return false;
+	}
+
+	if( 0 == strcmp(encodingName, "text") )
+		encoding = Text;
+	else if( 0 == strcmp(encodingName, "float16") )
+		encoding = Float16;
+	else if( 0 == strcmp(encodingName, "quantized") )
+		encoding = Quantized;
+	else
+		return false;
+
+	ranges.clear();
+	const char *s = line + nread;
+	while( true )
+	{
+		Range range;
+		if( sscanf(s, "%d-%d%n", &range.first, &range.last, &nread) != 2 )
+			return false;
+		ranges.push_back( range );
+		s += nread;
+		if( *s != ',' )
+			break;
+		s++;
+	}
+
+	return !ranges.empty();
+}
+
+//---------------------------------------------------------------------------
+// BrainFunctionFormat::writeRow
+//---------------------------------------------------------------------------
+void BrainFunctionFormat::writeRow( AbstractFile *file, const double *activations )
+{
+	if( encoding == Text )
+	{
+		for( const Range &range : ranges )
+			for( int i = range.first; i <= range.last; i++ )
+				file->printf( "%d %g\n", i, activations[i] );
+		return;
+	}
+
+	int bytesPerValue = encoding == Float16 ? 2 : 1;
+	rowBuffer.resize( 1 + getNumColumns() * bytesPerValue );
+
+	unsigned char *out = &rowBuffer[0];
+	*(out++) = RowTag;
+	for( const Range &range : ranges )
+	{
+		for( int i = range.first; i <= range.last; i++ )
+		{
+			if( encoding == Float16 )
+			{
+				unsigned short half = toHalf( float(activations[i]) );
+				*(out++) = half & 0xff;
+				*(out++) = half >> 8;
+			}
+			else
+			{
+				double a = activations[i];
+				a = a < 0.0 ? 0.0 : (a > 1.0 ? 1.0 : a);
+				*(out++) = (unsigned char)lround( a * 255.0 );
+			}
+		}
+	}
+
+	file->write( &rowBuffer[0], 1, rowBuffer.size() );
+}
+
+//---------------------------------------------------------------------------
+// BrainFunctionFormat::readRow
+//---------------------------------------------------------------------------
+bool BrainFunctionFormat::readRow( AbstractFile *file, double *row )
+{
+	int ncols = getNumColumns();
+
+	if( encoding == Text )
+	{
+		char line[200];
+		for( int i = 0; i < ncols; i++ )
+		{
+			int neuron;
+			double activation;
+			if( !file->gets(line, sizeof(line))
+				|| (sscanf(line, "%d %lf", &neuron, &activation) != 2) )
+			{
+				return false;
+			}
+			int column = getColumn( neuron );
+			if( column < 0 )
+				return false;
+			row[column] = activation;
+		}
+		return true;
+	}
+
+	int bytesPerValue = encoding == Float16 ? 2 : 1;
+	rowBuffer.resize( 1 + ncols * bytesPerValue );
+
+	if( (file->read(&rowBuffer[0], 1, rowBuffer.size()) != rowBuffer.size()) || (rowBuffer[0] != RowTag) )
+		return false;
+
+	const unsigned char *in = &rowBuffer[1];
+	for( int i = 0; i < ncols; i++ )
+	{
+		if( encoding == Float16 )
+		{
+			row[i] = fromHalf( (unsigned short)(in[0] | (in[1] << 8)) );
+			in += 2;
+		}
+		else
+		{
+			row[i] = *(in++) / 255.0;
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// BrainFunctionFormat::parseEncoding
+//---------------------------------------------------------------------------
+BrainFunctionFormat::Encoding BrainFunctionFormat::parseEncoding( const string &name )
+{
+	if( name == "Float16" )
+		return Float16;
+	else if( name == "Quantized" )
+		return Quantized;
+
+	assert( name == "Text" );
+	return Text;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+class AbstractFile;
+
+//===========================================================================
+// BrainFunctionFormat
+//
+// How a brainFunction file records activations. Version 1 files hold every
+// neuron at every step as "index activation" lines. Version 2 adds a
+// "recording" line after the brainFunction header, naming the encoding, the
+// step stride and the neurons kept, and its rows hold only those neurons:
+//
+//   Text       "index activation" lines, as in version 1
+//   Float16    'R', then one little-endian half float per neuron
+//   Quantized  'R', then one byte per neuron, activation [0,1] in 1/255ths
+//
+// Either way the file ends with the version 1 "end fitness" line.
+//===========================================================================
+class BrainFunctionFormat
+{
+ public:
+	enum Encoding
+	{
+		Text,
+		Float16,
+		Quantized
+	};
+
+	// Inclusive range of neuron indexes.
+	struct Range
+	{
+		int first;
+		int last;
+	};
+
+	BrainFunctionFormat();
+
+	bool isVersion1( int numNeurons ) const;
+	int getNumColumns() const;
+	// Column of neuron, or -1 if it isn't recorded.
+	int getColumn( int neuron ) const;
+
+	void writeHeader( AbstractFile *file ) const;
+	bool parseHeader( const char *line );
+
+	// Rows go through a buffer kept here, so every file needs its own
+	// format.
+	void writeRow( AbstractFile *file, const double *activations );
+	// false at the end line, or at the end of an incomplete file.
+	bool readRow( AbstractFile *file, double *row );
+
+	static Encoding parseEncoding( const std::string &name );
+
+	Encoding encoding;
+	int stride;
+	std::vector<Range> ranges;
+
+ private:
+	std::vector<unsigned char> rowBuffer;
+};
@@ -57,6 +57,13 @@ int Nerve::getNeuronCount()
 	return numneurons;
 }
 
+double *Nerve::getActivations( ActivationBuffer buf )
+{
+	assert( index > -1 );
+
+	return *(activations[buf]) + index;
+}
+
 void Nerve::config( int _numneurons,
 					int _index )
 {
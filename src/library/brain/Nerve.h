@@ -39,6 +39,8 @@ class Nerve
 			  ActivationBuffer buf = CURRENT );
 	int getIndex();
 	int getNeuronCount();
+	// This nerve's neurons in buf, valid until the buffers are swapped.
+	double *getActivations( ActivationBuffer buf = CURRENT );
 
  public:
 	void config( int numneurons,
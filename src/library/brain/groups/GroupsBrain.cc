@@ -230,6 +230,10 @@ void GroupsBrain::grow()
 {
     debugcheck( "(brain) on entry" );
 
+	// Each worker thread keeps its own table so births don't reallocate it.
+	static thread_local GroupsGenome::DerivedAttrs derivedAttrs;
+	_genome->beginDerivedAttrs( &derivedAttrs );
+
 	ALLOC_GROW_STACK_BUFFERS();
 
     _numgroups = _genome->getGroupCount(NGT_ANY);
@@ -616,6 +620,8 @@ void GroupsBrain::grow()
     _energyUse = Brain::config.maxneuron2energy * float(_dims.numNeurons) / float(config.maxneurons)
 		+ Brain::config.maxsynapse2energy * float(_dims.numSynapses) / float(config.maxsynapses);
 
+	_genome->endDerivedAttrs();
+
     debugcheck( "after setting up brain architecture" );
 }
 
@@ -687,10 +693,9 @@ void GroupsBrain::growSynapses( int groupIndex_to,
 		float nsynjiperneur = float(synapseCount_fromto)/float(neuronCount_to);
 		int synapseCount_new = short(nsynjiperneur + remainder[groupIndex_from] + 1.e-5);
 		remainder[groupIndex_from] += nsynjiperneur - synapseCount_new;
-		float td_fromto = _genome->get( _genome->TOPOLOGICAL_DISTORTION,
-										synapseType,
-										g_groupIndex_from,
-										g_groupIndex_to );
+		float td_fromto = _genome->getTopologicalDistortion( synapseType,
+															 g_groupIndex_from,
+															 g_groupIndex_to );
 		if( config.enableTopologicalDistortionRngSeed )
 		{
 			long td_seed = _genome->get( td_seedGene,
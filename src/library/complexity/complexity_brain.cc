@@ -6,6 +6,7 @@
 #include <list>
 
 #include "complexity_algorithm.h"
+#include "brain/BrainFunctionFormat.h"
 #include "utils/AbstractFile.h"
 
 using namespace std;
@@ -122,6 +123,7 @@ double CalcComplexity_brainfunction(const char *fnameAct,
 	long agent_birth = -1;
 	long agent_num;
 	long agent_lifespan;
+	long stride = 1;
 
 	gsl_matrix * activity = readin_brainfunction(fnameAct,
 												 tile,
@@ -132,7 +134,8 @@ double CalcComplexity_brainfunction(const char *fnameAct,
 												 &agent_lifespan,
 												 num_neurons,
 												 &numinputneurons,
-												 &numoutputneurons);
+												 &numoutputneurons,
+												 &stride);
 
 	if( agent_number )
 		*agent_number = agent_num;
@@ -169,6 +172,13 @@ double CalcComplexity_brainfunction(const char *fnameAct,
     		}
     	}
 
+    	// Filtering maps events to rows one per step.
+    	if( (num_filter_events > 0) && (stride > 1) )
+    	{
+			cerr << "Error: event filtering needs every step recorded, but '" << fnameAct << "' has a stride of " << stride << " (" << __func__ << ")" << endl;
+			exit( 1 );
+    	}
+
     	if( num_filter_events > 0 )
 	    	FilterActivity( activity, filter_events, agent_num, agent_birth, agent_lifespan, events, numinputneurons );
     }
@@ -575,7 +585,8 @@ gsl_matrix * readin_brainfunction(const char* fname,
 								  long *lifespan,
 								  long *num_neurons,
 								  long *num_ineurons,
-								  long *num_oneurons)
+								  long *num_oneurons,
+								  long *stride)
 {
 	long numneur;
 	long numineur;
@@ -612,6 +623,14 @@ gsl_matrix * readin_brainfunction(const char* fname,
 		FunctionFile->gets( tline, 100 );
 	}
 
+	// Organ info can make the header longer than tline; skip the rest of it.
+	if( !strchr(tline, '\n') )
+	{
+		char rest[100];
+		while( FunctionFile->gets(rest, 100) && !strchr(rest, '\n') )
+			;
+	}
+
 	string params = tline;
 	params = params.substr(14, params.length());
 
@@ -662,32 +681,69 @@ gsl_matrix * readin_brainfunction(const char* fname,
 	if( agent_birth )
 		*agent_birth = atol( birth_time.c_str() );
 
-	vector<string> FileContents;
-
-	char nextl[200];
-	while( FunctionFile->gets(nextl, 200) )	// returns null when at end of file
-		FileContents.push_back( nextl );
+	// Version 2 files may keep only some neurons, and only some steps; the
+	// matrix holds what was recorded, and the neuron counts are those of the
+	// recorded columns.
+	BrainFunctionFormat format;
+	if( version >= 2 )
+	{
+		char recording[1024];
+		if( !FunctionFile->gets(recording, sizeof(recording)) || !format.parseHeader(recording) )
+		{
+			cerr << "brainFunction file '" << fname << "' has an invalid recording line -- Terminating." << endl;
+			exit(1);
+		}
 
-	delete FunctionFile;					// Don't need this anymore.
+		long ni = 0;
+		long no = 0;
+		for( int i = 0; i < numneur; i++ )
+		{
+			if( format.getColumn(i) < 0 )
+				continue;
+			if( i < numineur )
+				ni++;
+			else if( i < numineur + numoneur )
+				no++;
+		}
+		numneur = format.getNumColumns();
+		numineur = ni;
+		numoneur = no;
+		if( num_neurons )
+			*num_neurons = numneur;
+		if( num_ineurons )
+			*num_ineurons = numineur;
+		if( num_oneurons )
+			*num_oneurons = numoneur;
+	}
+	else
+	{
+		BrainFunctionFormat::Range all = { 0, int(numneur) - 1 };
+		format.ranges.push_back( all );
+	}
 
 	int numcols = numneur;
 
-	if( FileContents.size() % numcols )	// true iff we are dealing with a complete brainfunction file
-		FileContents.pop_back();		// get rid of the last line (in complete files, it's fitness).
+	// Read complete rows, up to the fitness line or the end of an incomplete
+	// file.
+	vector<double> values;
+	if( numcols > 0 )
+	{
+		vector<double> row( numcols );
+		while( format.readRow(FunctionFile, &row[0]) )
+			values.insert( values.end(), row.begin(), row.end() );
+	}
+
+	delete FunctionFile;					// Don't need this anymore.
 
-	int numrows = FileContents.size() / numcols;
+	int filerows = numcols > 0 ? values.size() / numcols : 0;
+	int numrows = filerows;
 	if( lifespan )
-		*lifespan = numrows;	// actual lifespan, not accounting for max_timestpes
+		*lifespan = numrows * format.stride;	// actual lifespan (to within a stride), not accounting for max_timestpes
+	if( stride )
+		*stride = format.stride;
 	if( numrows == 0 )
 		return NULL;
 
-	// bogus? if( numcols == *num_ineurons ) { *num_ineurons = 0; }	// make sure there was a num_ineurons
-
-	if( (float(numrows) - (FileContents.size() / numcols)) != 0.0 )
-	{
-		cerr << "Warning: #lines (" << FileContents.size() << ") in brainFunction file '" << fname << "' is not an even multiple of #neurons (" << numcols << ").  brainFunction file may be corrupt." << endl;
-	}
-
 	if( num_timesteps > 0 )
 	{
 		if( tile )
@@ -720,32 +776,11 @@ gsl_matrix * readin_brainfunction(const char* fname,
 
 	activity = gsl_matrix_alloc( numrows, numcols );
 
-	int tcnt = 0;
-
-	vector<string>::iterator FileContents_it;
-	vector<string>::iterator FileContents_begin;
-	vector<string>::iterator FileContents_end;
-
-	FileContents_begin = FileContents.begin();
-	if( num_timesteps > 0 )
-	{
-		unsigned num_lines = num_timesteps * numneur;
-		if( tile && FileContents.size() < num_lines )
-		{
-			FileContents.reserve( num_lines );
-			FileContents_begin = FileContents.begin();
-			FileContents_it = FileContents.begin();
-			while( FileContents.size() < num_lines )
-			{
-				FileContents.push_back( *(FileContents_it++) );
-			}
-		}
-		FileContents_end = FileContents_begin  +  num_timesteps * numneur;
-	}
-	else
-		FileContents_end = FileContents.end();
-	if( max_timesteps > 0 && max_timesteps < (FileContents_end - FileContents_begin) )
-		FileContents_begin = FileContents_end  -  max_timesteps * numneur;
+	// Rows [rowBegin, rowEnd) of the file, tiled past its end.
+	int rowBegin = 0;
+	int rowEnd = num_timesteps > 0 ? num_timesteps : filerows;
+	if( max_timesteps > 0 && max_timesteps < (rowEnd - rowBegin) )
+		rowBegin = rowEnd - max_timesteps;
 
 #define DebugReadBrainFunction 0
 #if DebugReadBrainFunction
@@ -755,22 +790,21 @@ gsl_matrix * readin_brainfunction(const char* fname,
 	sprintf( debugFilename, "matrix_%d.txt", fileCount );
 	FILE* debugFile = fopen( debugFilename, "w" );
 	fprintf( debugFile, "Matrix size = %d rows x %d columns\n", numrows, numcols );
-	fprintf( debugFile, "Original numLines = %lu\n", (unsigned long) (FileContents.end() - FileContents.begin()) );
-	fprintf( debugFile, "firstLine = %lu\n", (unsigned long) (FileContents_begin - FileContents.begin() + 1) );
-	fprintf( debugFile, "numLines = %lu\n", (unsigned long) (FileContents_end - FileContents_begin) );
+	fprintf( debugFile, "Original numRows = %d\n", filerows );
+	fprintf( debugFile, "firstRow = %d\n", rowBegin );
+	fprintf( debugFile, "numRows = %d\n", rowEnd - rowBegin );
 #endif
 
-	for( FileContents_it = FileContents_begin; FileContents_it != FileContents_end; FileContents_it++ )
+	for( int i = rowBegin; i < rowEnd; i++ )
 	{
-		int thespace = (*FileContents_it).find( " ", 0 );
-		int    tstep1 = atoi( ((*FileContents_it).substr( 0, thespace )).c_str() );
-		double  tstep2 = atof( ((*FileContents_it).substr( thespace, (*FileContents_it).length() )).c_str() );
-
-		gsl_matrix_set( activity, int(tcnt/numcols), tstep1, tstep2);
+		const double *row = &values[(i % filerows) * numcols];
+		for( int j = 0; j < numcols; j++ )
+		{
+			gsl_matrix_set( activity, i - rowBegin, j, row[j] );
 #if DebugReadBrainFunction
-		fprintf( debugFile, "set row=%d, col=%d = %g\n", int(tcnt/numcols), tstep1, tstep2 );
+			fprintf( debugFile, "set row=%d, col=%d = %g\n", i - rowBegin, j, row[j] );
 #endif
-		tcnt++;
+		}
 	}
 
 #if DebugReadBrainFunction
@@ -89,7 +89,8 @@ gsl_matrix * readin_brainfunction(const char *path,
 											 long *lifespan,
 											 long *num_neurons,
 											 long *num_ineurons,
-											 long *num_oneurons);
+											 long *num_oneurons,
+											 long *stride = NULL);
 gsl_matrix * readin_brainanatomy( const char* );
 
 
@@ -269,8 +269,10 @@ gsl_matrix *MotionComplexity::populateMatrix( Epoch &epoch )
 				 "%s/motion/position/position_%ld.txt",
 				 path_run, agent.number );
 
-		DataLibReader in( path );
+		DataLibReader in( path, DataLibReader::MAPPED );
 		in.seekTable( "Positions" );
+		DataLibReader::ColumnHandle col_x = in.colHandle( "x" );
+		DataLibReader::ColumnHandle col_z = in.colHandle( "z" );
 
 		// ---
 		// --- Presence Filter
@@ -295,8 +297,8 @@ gsl_matrix *MotionComplexity::populateMatrix( Epoch &epoch )
 			{
 				in.seekRow( step - agent.birth );
 
-				x = in.col( "x" );
-				z = in.col( "z" );
+				x = in.getFloat( col_x );
+				z = in.getFloat( col_z );
 			}
 			else
 			{
@@ -0,0 +1,222 @@
+#include "BarrierBVH.h"
+
+#include <assert.h>
+
+#include <algorithm>
+
+#include "barrier.h"
+
+using namespace std;
+
+#define LeafSize 4
+
+//---------------------------------------------------------------------------
+// BarrierBVH::BarrierBVH
+//---------------------------------------------------------------------------
+BarrierBVH::BarrierBVH()
+: sorted( true )
+{
+}
+
+//---------------------------------------------------------------------------
+// BarrierBVH::build
+//---------------------------------------------------------------------------
+void BarrierBVH::build( bxsortedlist &list )
+{
+	barriers.clear();
+	items.clear();
+	nodes.clear();
+
+	barrier *b;
+	list.reset();
+	while( list.next(b) )
+	{
+		items.push_back( barriers.size() );
+		barriers.push_back( b );
+	}
+
+	if( !barriers.empty() )
+		buildNode( 0, barriers.size() );
+
+	refitNode( 0 );
+}
+
+//---------------------------------------------------------------------------
+// BarrierBVH::update
+//
+// Call after the barriers have updated for the step.
+//---------------------------------------------------------------------------
+void BarrierBVH::update( bxsortedlist &list )
+{
+	barrier *b;
+	int i = 0;
+	list.reset();
+	while( list.next(b) )
+	{
+		if( (i == (int)barriers.size()) || (barriers[i] != b) )
+		{
+			build( list );
+			return;
+		}
+		i++;
+	}
+	if( i != (int)barriers.size() )
+	{
+		build( list );
+		return;
+	}
+
+	refitNode( 0 );
+}
+
+//---------------------------------------------------------------------------
+// BarrierBVH::query
+//---------------------------------------------------------------------------
+void BarrierBVH::query( float xmin, float xmax,
+						float zmin, float zmax,
+						int first,
+						vector<int> &result )
+{
+	if( nodes.empty() )
+		return;
+
+	size_t nresult = result.size();
+
+	int stack[64];
+	int nstack = 0;
+	stack[nstack++] = 0;
+
+	while( nstack )
+	{
+		const Node &node = nodes[ stack[--nstack] ];
+
+		// inclusive, so the caller's exact test sees every candidate
+		if( (node.xmin > xmax) || (node.xmax < xmin) || (node.zmin > zmax) || (node.zmax < zmin) )
+			continue;
+
+		if( node.left < 0 )
+		{
+			for( int i = node.begin; i < node.end; i++ )
+			{
+				int index = items[i];
+				barrier *b = barriers[index];
+				if( (index >= first)
+					&& (b->xmin() <= xmax) && (b->xmax() >= xmin)
+					&& (b->zmin() <= zmax) && (b->zmax() >= zmin) )
+				{
+					result.push_back( index );
+				}
+			}
+		}
+		else
+		{
+			assert( nstack + 2 <= 64 );
+			stack[nstack++] = node.left;
+			stack[nstack++] = node.right;
+		}
+	}
+
+	sort( result.begin() + nresult, result.end() );
+}
+
+//---------------------------------------------------------------------------
+// BarrierBVH::buildNode
+//
+// Median split of the barrier centers along the longer axis.
+//---------------------------------------------------------------------------
+int BarrierBVH::buildNode( int begin, int end )
+{
+	int inode = nodes.size();
+	nodes.push_back( Node() );
+
+	float cxmin = barriers[items[begin]]->xmin(), cxmax = cxmin;
+	float czmin = barriers[items[begin]]->zmin(), czmax = czmin;
+	for( int i = begin; i < end; i++ )
+	{
+		barrier *b = barriers[items[i]];
+		float cx = 0.5f * (b->xmin() + b->xmax());
+		float cz = 0.5f * (b->zmin() + b->zmax());
+		cxmin = min( cxmin, cx ); cxmax = max( cxmax, cx );
+		czmin = min( czmin, cz ); czmax = max( czmax, cz );
+	}
+
+	if( end - begin <= LeafSize )
+	{
+		nodes[inode].begin = begin;
+		nodes[inode].end = end;
+		nodes[inode].left = nodes[inode].right = -1;
+		return inode;
+	}
+
+	bool splitX = (cxmax - cxmin) >= (czmax - czmin);
+	int mid = (begin + end) / 2;
+	nth_element( items.begin() + begin, items.begin() + mid, items.begin() + end,
+				 [this, splitX]( int a, int b )
+				 {
+					 barrier *ba = barriers[a];
+					 barrier *bb = barriers[b];
+					 if( splitX )
+						 return (ba->xmin() + ba->xmax()) < (bb->xmin() + bb->xmax());
+					 else
+						 return (ba->zmin() + ba->zmax()) < (bb->zmin() + bb->zmax());
+				 } );
+
+	int left = buildNode( begin, mid );
+	int right = buildNode( mid, end );
+
+	nodes[inode].begin = begin;
+	nodes[inode].end = end;
+	nodes[inode].left = left;
+	nodes[inode].right = right;
+
+	return inode;
+}
+
+//---------------------------------------------------------------------------
+// BarrierBVH::refitNode
+//
+// Recomputes bounds below inode; at the root, also rechecks list order.
+//---------------------------------------------------------------------------
+void BarrierBVH::refitNode( int inode )
+{
+	if( inode == 0 )
+	{
+		sorted = true;
+		for( int i = 1; i < (int)barriers.size(); i++ )
+		{
+			if( barriers[i]->xmin() < barriers[i - 1]->xmin() )
+			{
+				sorted = false;
+				break;
+			}
+		}
+
+		if( nodes.empty() )
+			return;
+	}
+
+	Node &node = nodes[inode];
+
+	if( node.left < 0 )
+	{
+		barrier *b = barriers[ items[node.begin] ];
+		node.xmin = b->xmin(); node.xmax = b->xmax();
+		node.zmin = b->zmin(); node.zmax = b->zmax();
+		for( int i = node.begin + 1; i < node.end; i++ )
+		{
+			b = barriers[ items[i] ];
+			node.xmin = min( node.xmin, b->xmin() ); node.xmax = max( node.xmax, b->xmax() );
+			node.zmin = min( node.zmin, b->zmin() ); node.zmax = max( node.zmax, b->zmax() );
+		}
+	}
+	else
+	{
+		refitNode( node.left );
+		refitNode( node.right );
+
+		const Node &l = nodes[node.left];
+		const Node &r = nodes[node.right];
+		node.xmin = min( l.xmin, r.xmin ); node.xmax = max( l.xmax, r.xmax );
+		node.zmin = min( l.zmin, r.zmin ); node.zmax = max( l.zmax, r.zmax );
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+
+class barrier;
+class bxsortedlist;
+
+//===========================================================================
+// BarrierBVH
+//
+// Bounding-volume hierarchy over the barriers' x/z bounds, so an agent's
+// barrier test only visits barriers near it. Barriers are identified by
+// their position in gXSortedBarriers, and queries return them in that
+// order, so callers can resolve collisions in the same sequence as a scan
+// of the list.
+//
+// Moving barriers only refit the node bounds; the tree is rebuilt if the
+// list order changes.
+//===========================================================================
+class BarrierBVH
+{
+ public:
+	BarrierBVH();
+
+	void build( bxsortedlist &barriers );
+	void update( bxsortedlist &barriers );
+
+	// The agent barrier test stops at the first barrier starting past the
+	// agent, which only skips nothing when the list is sorted by xmin.
+	bool isListSorted();
+
+	int size();
+	barrier *get( int index );
+
+	// Appends, in list order, every barrier at index >= first whose bounds
+	// touch the box.
+	void query( float xmin, float xmax,
+				float zmin, float zmax,
+				int first,
+				std::vector<int> &result );
+
+ private:
+	struct Node
+	{
+		float xmin, xmax, zmin, zmax;
+		int begin, end;		// range of items, for leaves
+		int left, right;	// children; -1 for leaves
+	};
+
+	int buildNode( int begin, int end );
+	void refitNode( int inode );
+
+	std::vector<barrier *> barriers;	// list order
+	std::vector<int> items;				// barrier indices, grouped by leaf
+	std::vector<Node> nodes;
+	bool sorted;
+};
+
+inline bool BarrierBVH::isListSorted() { return sorted; }
+inline int BarrierBVH::size() { return barriers.size(); }
+inline barrier *BarrierBVH::get( int index ) { return barriers[index]; }
@@ -18,7 +18,7 @@ EnergyPolarity::EnergyPolarity()
 {
 	assert( globals::numEnergyTypes <= MAX_ENERGY_TYPES );
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 		values[i] = POSITIVE;
 }
 
@@ -27,13 +27,13 @@ EnergyPolarity::EnergyPolarity( proplib::Property &prop )
 	assert( prop.getType() == proplib::Node::Array );
 	assert( (int)prop.elements().size() == globals::numEnergyTypes );
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
-		values[i] = (Polarity)(int)prop.get( i );
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
+		values[i] = i < globals::numEnergyTypes ? (Polarity)(int)prop.get( i ) : POSITIVE;
 }
 
 bool EnergyPolarity::operator==( const EnergyPolarity &other ) const
 {
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
 		if( values[i] != other.values[i] )
 			return false;
@@ -46,7 +46,7 @@ EnergyPolarity EnergyPolarity::operator*( const EnergyPolarity &other ) const
 {
 	EnergyPolarity result;
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
 		result.values[i] = (Polarity)(values[i] * other.values[i]);
 	}
@@ -59,14 +59,14 @@ EnergyMultiplier::EnergyMultiplier()
 {
 	assert( globals::numEnergyTypes <= MAX_ENERGY_TYPES );
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 		values[i] = 1;
 }
 
 EnergyMultiplier::EnergyMultiplier( float *values )
 {
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
-		this->values[i] = values[i];
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
+		this->values[i] = i < globals::numEnergyTypes ? values[i] : 1;
 }
 
 EnergyMultiplier::EnergyMultiplier( proplib::Property &prop )
@@ -74,8 +74,8 @@ EnergyMultiplier::EnergyMultiplier( proplib::Property &prop )
 	assert( prop.getType() == proplib::Node::Array );
 	assert( (int)prop.elements().size() == globals::numEnergyTypes );
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
-		values[i] = (float)prop.get( i );
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
+		values[i] = i < globals::numEnergyTypes ? (float)prop.get( i ) : 1;
 }
 
 float EnergyMultiplier::operator[]( int i ) const
@@ -85,7 +85,7 @@ float EnergyMultiplier::operator[]( int i ) const
 
 bool operator==( const EnergyMultiplier &a, const EnergyMultiplier &b )
 {
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 		if( fabs( a[i] - b[i] ) > EPSILON )
 			return false;
 
@@ -113,13 +113,13 @@ Energy::Energy( proplib::Property &prop )
 	assert( prop.getType() == proplib::Node::Array );
 	assert( (int)prop.elements().size() == globals::numEnergyTypes );
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
-		values[i] = (float)prop.get( i );
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
+		values[i] = i < globals::numEnergyTypes ? (float)prop.get( i ) : 0;
 }
 
 Energy::Energy( const Energy &positive, const Energy &negative, const EnergyPolarity &polarity )
 {
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
 		if( polarity.values[i] == EnergyPolarity::NEGATIVE )
 			values[i] = negative.values[i];
@@ -133,8 +133,8 @@ void Energy::init( float val )
 {
 	assert( globals::numEnergyTypes <= MAX_ENERGY_TYPES );
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
-		values[i] = val;
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
+		values[i] = i < globals::numEnergyTypes ? val : 0;
 }
 
 bool Energy::isDepleted() const
@@ -144,18 +144,21 @@ bool Energy::isDepleted() const
 
 bool Energy::isDepleted( const Energy &threshold ) const
 {
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	// Unused values would always compare as depleted, so are masked out, but
+	// without a branch per value.
+	bool depleted = false;
+
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
-		if( values[i] <= threshold.values[i] )
-			return true;
+		depleted |= (i < globals::numEnergyTypes) & (values[i] <= threshold.values[i]);
 	}
 
-	return false;
+	return depleted;
 }
 
 bool Energy::isZero() const
 {
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
 		if( (values[i] < -EPSILON) || (values[i] > EPSILON) )
 			return false;
@@ -168,7 +171,7 @@ float Energy::sum() const
 {
 	float result = 0;
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 		result += values[i];
 
 	return result;
@@ -181,22 +184,18 @@ float Energy::mean() const
 
 void Energy::zero()
 {
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 		values[i] = 0.0;
 }
 
 void Energy::constrain( const Energy &minEnergy, const Energy &maxEnergy )
 {
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	// Selects rather than branches, so it vectorizes.
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
-		if( values[i] < minEnergy.values[i] )
-		{
-			values[i] = minEnergy.values[i];
-		}
-		else if( values[i] > maxEnergy.values[i] )
-		{
-			values[i] = maxEnergy.values[i];
-		}
+		float val = values[i];
+		values[i] = val < minEnergy.values[i] ? minEnergy.values[i]
+			: (val > maxEnergy.values[i] ? maxEnergy.values[i] : val);
 	}
 }
 
@@ -204,7 +203,7 @@ void Energy::constrain( const Energy &minEnergy, const Energy &maxEnergy, Energy
 {
 	result_overflow = 0;
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
 		float diff;
 
@@ -230,7 +229,7 @@ Energy Energy::createDepletionThreshold( const Energy &threshold, const EnergyPo
 {
 	Energy result = threshold;
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
 		if( polarity.values[i] == EnergyPolarity::UNDEFINED )
 			result.values[i] = numeric_limits<float>::quiet_NaN();
@@ -246,7 +245,7 @@ float Energy::operator[]( int index ) const
 
 Energy &Energy::operator+=( const Energy &other )
 {
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
 		values[i] += other.values[i];
 	}
@@ -256,7 +255,7 @@ Energy &Energy::operator+=( const Energy &other )
 
 Energy &Energy::operator-=( const Energy &other )
 {
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
 		values[i] -= other.values[i];
 	}
@@ -266,11 +265,11 @@ Energy &Energy::operator-=( const Energy &other )
 
 Energy operator+( const Energy &a, const Energy &b )
 {
-	Energy result;
+	Energy result = a;
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
-		result.values[i] = a.values[i] + b.values[i];
+		result.values[i] += b.values[i];
 	}
 
 	return result;
@@ -278,11 +277,11 @@ Energy operator+( const Energy &a, const Energy &b )
 
 Energy operator-( const Energy &a, const Energy &b )
 {
-	Energy result;
+	Energy result = a;
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
-		result.values[i] = a.values[i] - b.values[i];
+		result.values[i] -= b.values[i];
 	}
 
 	return result;
@@ -290,11 +289,11 @@ Energy operator-( const Energy &a, const Energy &b )
 
 Energy operator*( const Energy &a, float val )
 {
-	Energy result;
+	Energy result = a;
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
-		result.values[i] = a.values[i] * val;
+		result.values[i] *= val;
 	}
 
 	return result;
@@ -307,11 +306,11 @@ Energy operator*( float val, const Energy &a )
 
 Energy operator*( const Energy &e, const EnergyPolarity &p )
 {
-	Energy result;
+	Energy result = e;
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
-		result.values[i] = e.values[i] * p.values[i];
+		result.values[i] *= p.values[i];
 	}
 
 	return result;
@@ -321,7 +320,7 @@ Energy operator*( const Energy &e, const EnergyMultiplier &m )
 {
 	Energy result;
 
-	for( int i = 0; i < globals::numEnergyTypes; i++ )
+	for( int i = 0; i < MAX_ENERGY_TYPES; i++ )
 	{
 		if( (m[i] != 0) && ( sign(m[i]) == sign(e.values[i]) ) )
 			result.values[i] = e.values[i] * fabs( m.values[i] );
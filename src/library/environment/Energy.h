@@ -9,7 +9,15 @@
 // Energy to be fairly cheap to instantiate because we create a lot of temp instances.
 // MAX_ENERGY_TYPES can be increased to any arbitrary value, but the larger it is, the
 // more bytes need to be copied around.
+//
+// The arithmetic works on all MAX_ENERGY_TYPES values, whatever the worldfile's
+// NumEnergyTypes, so its loops have a constant count and compile to a few
+// vector instructions. For that, the values past globals::numEnergyTypes are
+// always the identity of the operations that touch them: 0 for an Energy,
+// POSITIVE for a polarity and 1 for a multiplier.
 #define MAX_ENERGY_TYPES 4
+// An SSE register, and as much as new guarantees.
+#define ENERGY_ALIGNMENT 16
 
 // forward decl
 class Energy;
@@ -18,7 +26,7 @@ namespace proplib
 	class Property;
 }
 
-class EnergyPolarity
+class alignas(ENERGY_ALIGNMENT) EnergyPolarity
 {
  public:
 	enum Polarity
@@ -41,7 +49,7 @@ class EnergyPolarity
 	Polarity values[MAX_ENERGY_TYPES];
 };
 
-class EnergyMultiplier
+class alignas(ENERGY_ALIGNMENT) EnergyMultiplier
 {
 	PROPLIB_CPP_PROPERTIES
 
@@ -64,7 +72,7 @@ class EnergyMultiplier
 bool operator==( const EnergyMultiplier &a, const EnergyMultiplier &b );
 bool operator!=( const EnergyMultiplier &a, const EnergyMultiplier &b );
 
-class Energy
+class alignas(ENERGY_ALIGNMENT) Energy
 {
 	PROPLIB_CPP_PROPERTIES
 
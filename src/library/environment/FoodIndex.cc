@@ -0,0 +1,272 @@
+#include "FoodIndex.h"
+
+#include <assert.h>
+#include <math.h>
+
+#include <algorithm>
+
+#include "food.h"
+#include "utils/objectxsortedlist.h"
+
+using namespace std;
+
+#define MaxCellsPerSide 512
+
+//---------------------------------------------------------------------------
+// FoodIndex::FoodIndex
+//---------------------------------------------------------------------------
+FoodIndex::FoodIndex()
+: worldsize( 0.0 )
+, cellSize( 1.0 )
+, ncells( 1 )
+, maxRadius( 0.0 )
+, ordered( false )
+{
+	cells.resize( 1 );
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::init
+//
+// Must be called before any food is added.
+//---------------------------------------------------------------------------
+void FoodIndex::init( float worldsize, float cellSize )
+{
+	this->worldsize = worldsize;
+
+	ncells = 1;
+	if( cellSize > 0.0 )
+		ncells = max( 1, min( MaxCellsPerSide, (int)ceil(worldsize / cellSize) ) );
+	this->cellSize = worldsize / ncells;
+
+	cells.clear();
+	cells.resize( ncells * ncells );
+	maxRadius = 0.0;
+	ordered = false;
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::add
+//---------------------------------------------------------------------------
+void FoodIndex::add( food *f )
+{
+	insertCell( f, cellIndex(f->x(), f->z()) );
+
+	maxRadius = max( maxRadius, f->radius() );
+
+	if( ordered )
+	{
+		// Number it between its neighbors in the list.
+		food *prev = prevFood( f );
+		food *next = nextFood( f );
+		if( prev && next )
+		{
+			f->fIndexOrder = 0.5 * (prev->fIndexOrder + next->fIndexOrder);
+			if( (f->fIndexOrder == prev->fIndexOrder) || (f->fIndexOrder == next->fIndexOrder) )
+				ordered = false;
+		}
+		else if( prev )
+			f->fIndexOrder = prev->fIndexOrder + 1.0;
+		else if( next )
+			f->fIndexOrder = next->fIndexOrder - 1.0;
+		else
+			f->fIndexOrder = 0.0;
+
+		if( !isInListOrder(f) || (maxRadius > food::gMaxFoodRadius) )
+			ordered = false;
+	}
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::remove
+//---------------------------------------------------------------------------
+void FoodIndex::remove( food *f )
+{
+	removeCell( f );
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::update
+//
+// Call after f moves or shrinks.
+//---------------------------------------------------------------------------
+void FoodIndex::update( food *f )
+{
+	int cell = cellIndex( f->x(), f->z() );
+	if( cell != f->fIndexCell )
+	{
+		removeCell( f );
+		insertCell( f, cell );
+	}
+
+	if( ordered && !isInListOrder(f) )
+		ordered = false;
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::sync
+//
+// Rebins food that moved with its carrier and numbers the food in list
+// order. Call once the list has been sorted; returns isOrdered().
+//---------------------------------------------------------------------------
+bool FoodIndex::sync()
+{
+	objectxsortedlist &list = objectxsortedlist::gXSortedObjects;
+
+	ordered = true;
+	maxRadius = 0.0;
+
+	double order = 0.0;
+	food *prev = NULL;
+	food *f;
+
+	list.reset();
+	while( list.nextObj( FOODTYPE, (gobject**) &f ) )
+	{
+		if( prev && ((f->x() - f->radius()) < (prev->x() - prev->radius())) )
+			ordered = false;
+
+		f->fIndexOrder = order;
+		order += 1.0;
+
+		maxRadius = max( maxRadius, f->radius() );
+
+		int cell = cellIndex( f->x(), f->z() );
+		if( cell != f->fIndexCell )
+		{
+			removeCell( f );
+			insertCell( f, cell );
+		}
+
+		prev = f;
+	}
+	list.reset();
+
+	if( maxRadius > food::gMaxFoodRadius )
+		ordered = false;
+
+	return ordered;
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::endSync
+//
+// The numbering isn't maintained outside of Interact.
+//---------------------------------------------------------------------------
+void FoodIndex::endSync()
+{
+	ordered = false;
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::order
+//---------------------------------------------------------------------------
+double FoodIndex::order( food *f )
+{
+	return f->fIndexOrder;
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::query
+//---------------------------------------------------------------------------
+void FoodIndex::query( float xmin, float xmax,
+					   float zmin, float zmax,
+					   vector<food *> &result )
+{
+	// a little extra so rounding in the callers' tests can't exclude a piece
+	float margin = maxRadius + 0.001 * cellSize;
+
+	int imin = cellIndex( xmin - margin, zmin - margin );
+	int imax = cellIndex( xmax + margin, zmax + margin );
+	int ixmin = imin % ncells, izmin = imin / ncells;
+	int ixmax = imax % ncells, izmax = imax / ncells;
+
+	for( int iz = izmin; iz <= izmax; iz++ )
+	{
+		for( int ix = ixmin; ix <= ixmax; ix++ )
+		{
+			const vector<food *> &cell = cells[ iz * ncells + ix ];
+			result.insert( result.end(), cell.begin(), cell.end() );
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::cellIndex
+//
+// Positions off the world are clamped to the edge cells.
+//---------------------------------------------------------------------------
+int FoodIndex::cellIndex( float x, float z )
+{
+	// the world runs from 0 to worldsize in x, and 0 to -worldsize in z
+	int ix = (int)floor( x / cellSize );
+	int iz = (int)floor( (z + worldsize) / cellSize );
+
+	ix = max( 0, min(ncells - 1, ix) );
+	iz = max( 0, min(ncells - 1, iz) );
+
+	return iz * ncells + ix;
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::insertCell
+//---------------------------------------------------------------------------
+void FoodIndex::insertCell( food *f, int cell )
+{
+	f->fIndexCell = cell;
+	f->fIndexSlot = cells[cell].size();
+	cells[cell].push_back( f );
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::removeCell
+//---------------------------------------------------------------------------
+void FoodIndex::removeCell( food *f )
+{
+	if( f->fIndexCell < 0 )
+		return;
+
+	vector<food *> &cell = cells[f->fIndexCell];
+	assert( cell[f->fIndexSlot] == f );
+
+	// fill the hole with the last piece
+	food *last = cell.back();
+	cell[f->fIndexSlot] = last;
+	last->fIndexSlot = f->fIndexSlot;
+	cell.pop_back();
+
+	f->fIndexCell = -1;
+	f->fIndexSlot = -1;
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::isInListOrder
+//---------------------------------------------------------------------------
+bool FoodIndex::isInListOrder( food *f )
+{
+	food *prev = prevFood( f );
+	if( prev && ((f->x() - f->radius()) < (prev->x() - prev->radius())) )
+		return false;
+
+	food *next = nextFood( f );
+	if( next && ((next->x() - next->radius()) < (f->x() - f->radius())) )
+		return false;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::prevFood
+//---------------------------------------------------------------------------
+food *FoodIndex::prevFood( food *f )
+{
+	return (food *)objectxsortedlist::gXSortedObjects.prevObj( f, FOODTYPE );
+}
+
+//---------------------------------------------------------------------------
+// FoodIndex::nextFood
+//---------------------------------------------------------------------------
+food *FoodIndex::nextFood( food *f )
+{
+	return (food *)objectxsortedlist::gXSortedObjects.nextObj( f, FOODTYPE );
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+class food;
+
+//===========================================================================
+// FoodIndex
+//
+// Uniform grid over the food, keyed by center, so Eat() can find the pieces
+// touching an agent without walking the x-sorted list. Cells are as wide as
+// the largest food or agent, so a query covers a few cells.
+//
+// In CompatibilityMode, Eat() takes the first overlapping food in list
+// order. That is also the overlapping food with the lowest order() as long
+// as the food in gXSortedObjects is sorted by x - radius and no piece is
+// larger than gMaxFoodRadius. sync() checks both and numbers the food in
+// list order; eating, pickup and drop can undo the sort, so they report the
+// piece through update(), which clears isOrdered() if it no longer fits.
+//===========================================================================
+class FoodIndex
+{
+ public:
+	FoodIndex();
+
+	void init( float worldsize, float cellSize );
+
+	// f must already be in gXSortedObjects
+	void add( food *f );
+	void remove( food *f );
+	void update( food *f );
+
+	bool sync();
+	void endSync();
+	bool isOrdered();
+	double order( food *f );
+
+	// Appends every food whose center could be within the largest food
+	// radius of the box.
+	void query( float xmin, float xmax,
+				float zmin, float zmax,
+				std::vector<food *> &result );
+
+ private:
+	int cellIndex( float x, float z );
+	void insertCell( food *f, int cell );
+	void removeCell( food *f );
+	bool isInListOrder( food *f );
+	food *prevFood( food *f );
+	food *nextFood( food *f );
+
+	float worldsize;
+	float cellSize;
+	int ncells;		// per side
+	std::vector< std::vector<food *> > cells;
+	float maxRadius;
+	bool ordered;
+};
+
+inline bool FoodIndex::isOrdered() { return ordered; }
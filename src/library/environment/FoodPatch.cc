@@ -94,6 +94,8 @@ FoodPatch::~FoodPatch()
 //
 // Add food to the FoodPatch.
 // Find an appropriate point in the patch (based on patch shape and distribution)
+// The caller puts the new piece in the world, so a step's growth can be
+// inserted into the object list and stage together.
 //-------------------------------------------------------------------------------------------
 food *FoodPatch::addFood( long step )
 {
@@ -121,10 +123,6 @@ food *FoodPatch::addFood( long step )
 		f->domain( domainNumberOfParent );
 		f->setPatch( this );
 
-		// Finally, add it to the world object list and fStage
-		objectxsortedlist::gXSortedObjects.add( f );
-		fStage->AddObject( f );
-
 		// Update the patch's count
 		foodCount++;
 		return f;
@@ -22,6 +22,7 @@ Color barrier::gBarrierColor;
 bool barrier::gStickyBarriers;
 bool barrier::gRatioPositions;
 bxsortedlist barrier::gXSortedBarriers;
+BarrierBVH barrier::gBarrierBVH;
 vector<barrier *> barrier::gBarriers;
 
 
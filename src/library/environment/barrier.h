@@ -12,6 +12,7 @@
 #include <vector>
 
 // Local
+#include "BarrierBVH.h"
 #include "graphics/gpolygon.h"
 #include "utils/gdlink.h"
 #include "utils/objectlist.h"
@@ -82,6 +83,7 @@ public:
 	static bool gStickyBarriers;
 	static bool gRatioPositions;
 	static bxsortedlist gXSortedBarriers;
+	static BarrierBVH gBarrierBVH;
 	static std::vector<barrier *> gBarriers;
 
     barrier();
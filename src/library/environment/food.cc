@@ -10,6 +10,7 @@
 #include "food.h"
 
 // System
+#include <mutex>
 #include <ostream>
 
 // Local
@@ -22,6 +23,8 @@ using namespace std;
 
 // Static class variables
 unsigned long food::fFoodEver;
+vector<void *> food::fFreeList;
+static mutex freeListMutex;
 
 // External globals
 float food::gFoodHeight;
@@ -76,6 +79,41 @@ food::~food()
 }
 
 
+//-------------------------------------------------------------------------------------------
+// food::operator new
+//
+// Food comes and goes every step, so the storage of deleted pieces is kept
+// for reuse rather than returned to the heap. The free list is locked, since
+// nothing confines food allocation to the master thread.
+//-------------------------------------------------------------------------------------------
+void *food::operator new( size_t size )
+{
+	assert( size == sizeof(food) );
+
+	lock_guard<mutex> lock( freeListMutex );
+
+	if( fFreeList.empty() )
+		return ::operator new( size );
+
+	void *p = fFreeList.back();
+	fFreeList.pop_back();
+	return p;
+}
+
+
+//-------------------------------------------------------------------------------------------
+// food::operator delete
+//-------------------------------------------------------------------------------------------
+void food::operator delete( void *p )
+{
+	if( p )
+	{
+		lock_guard<mutex> lock( freeListMutex );
+		fFreeList.push_back( p );
+	}
+}
+
+
 //-------------------------------------------------------------------------------------------
 // food::dump
 //-------------------------------------------------------------------------------------------
@@ -207,6 +245,10 @@ void food::initrest()
 	setType( FOODTYPE );
 	setTypeNumber( ++food::fFoodEver );
 	setcolor( foodType->color );
+
+	fIndexCell = -1;
+	fIndexSlot = -1;
+	fIndexOrder = 0.0;
 }
 
 
@@ -11,6 +11,7 @@
 // System
 #include <iostream>
 #include <list>
+#include <vector>
 
 using namespace std;
 
@@ -29,6 +30,8 @@ class food;
 //===========================================================================
 class food : public gboxf
 {
+	friend class FoodIndex;
+
 public:
 	static float gFoodHeight;
 	static Color gFoodColor;
@@ -47,6 +50,9 @@ public:
     food( const FoodType *foodType, long step, const Energy &e, float x, float z);
     ~food();
 
+	static void *operator new( size_t size );
+	static void operator delete( void *p );
+
 	void dump(ostream& out);
 	void load(istream& in);
 
@@ -76,6 +82,7 @@ protected:
    	virtual void setradius();
 
     static unsigned long fFoodEver;
+	static vector<void *> fFreeList;
 
 	Energy fEnergy;
     short fDomain;
@@ -88,6 +95,11 @@ protected:
 	// allows us to remove this object from the list without having to
 	// search for it.
 	FoodList::iterator fAllFoodIterator;
+
+	// FoodIndex bookkeeping
+	int fIndexCell;
+	int fIndexSlot;
+	double fIndexOrder;
 };
 
 //===========================================================================
@@ -1,6 +1,7 @@
 #include "Genome.h"
 
 #include <assert.h>
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -168,16 +169,78 @@ void Genome::randomize()
 		assert( false );
 }
 
+//---------------------------------------------------------------------------
+// Mutation sites
+//
+// Rather than drawing a number per bit (or byte) and comparing it to the
+// rate, mutate() draws the gap to the next site from the geometric
+// distribution of the gaps between successes of those same Bernoulli trials,
+// so it costs one draw per mutation. Which sites mutate has the same
+// distribution as before, but not the same values for a given seed: runs are
+// still reproducible from their seed, just not against runs from before the
+// change.
+//---------------------------------------------------------------------------
+class MutationSites
+{
+ public:
+	MutationSites( float rate, long count )
+		: count( count )
+		, next( -1 )
+		, lnq( rate < 1.0f ? log1p(-double(rate)) : 0.0 )
+		, all( rate >= 1.0f )
+	{
+		// log1p keeps lnq from rounding to 0 for tiny rates; if it still
+		// does, there are no sites.
+		if( (rate <= 0.0f) || (!all && (lnq == 0.0)) )
+			next = count;
+		else
+			advance();
+	}
+
+	// Returns false when there are no more sites.
+	bool get( long *site )
+	{
+		if( next >= count )
+			return false;
+
+		*site = next;
+		advance();
+		return true;
+	}
+
+ private:
+	void advance()
+	{
+		if( all )
+		{
+			next++;
+		}
+		else
+		{
+			// 1 - randpw() is in (0, 1], so the log is finite, but the
+			// quotient can overflow to inf for tiny rates; compare so that
+			// anything but a gap inside the genome ends the sites.
+			double gap = floor( log(1.0 - randpw()) / lnq );
+			if( !(gap < double(count - next)) )
+				next = count;
+			else
+				next += long(gap) + 1;
+		}
+	}
+
+	long count;
+	long next;
+	double lnq;
+	bool all;
+};
+
 void Genome::mutateBits( float rate )
 {
-    for (long byte = 0; byte < nbytes; byte++)
-    {
-        for (long bit = 0; bit < 8; bit++)
-        {
-            if (randpw() < rate)
-                mutable_data[byte] ^= char(1 << (7-bit));
-        }
-    }
+	MutationSites sites( rate, nbytes * 8 );
+	long bit;
+
+	while( sites.get(&bit) )
+		mutable_data[bit >> 3] ^= char(1 << (7 - (bit & 7)));
 }
 
 void Genome::mutateBits()
@@ -194,11 +257,11 @@ void Genome::mutateOneByte( long byte, float stdev )
 void Genome::mutateBytes( float rate )
 {
     float stdev = pow( 2.0, get( "MutationStdevPower" ) );
-    for (long byte = 0; byte < nbytes; byte++)
-    {
-        if (randpw() < rate)
-            mutateOneByte( byte, stdev );
-    }
+    MutationSites sites( rate, nbytes );
+    long byte;
+
+    while( sites.get(&byte) )
+        mutateOneByte( byte, stdev );
 }
 
 void Genome::mutateBytes()
@@ -256,13 +319,11 @@ void Genome::crossover( Genome *g1, Genome *g2, bool mutate )
 	// figure out crossover points -- derived class logic.
 	getCrossoverPoints( crossoverPoints, numCrossPoints );
 
-    long i, j;
-
 #ifdef DUMPBITS
     if (GenomeSchema::config.resolution == GenomeSchema::RESOLUTION_BIT)
     {
         cout << "**The crossover bits(bytes) are:" nl << "  ";
-        for (i = 0; i < numCrossPoints; i++)
+        for (long i = 0; i < numCrossPoints; i++)
         {
             long byte = crossoverPoints[i] >> 3;
             cout << crossoverPoints[i] << "(" << byte << ") ";
@@ -272,7 +333,7 @@ void Genome::crossover( Genome *g1, Genome *g2, bool mutate )
     else if (GenomeSchema::config.resolution == GenomeSchema::RESOLUTION_BYTE)
     {
         cout << "**The crossover bytes are:" nl << "  ";
-        for (i = 0; i < numCrossPoints; i++)
+        for (long i = 0; i < numCrossPoints; i++)
         {
             cout << crossoverPoints[i] << " ";
         }
@@ -284,71 +345,71 @@ void Genome::crossover( Genome *g1, Genome *g2, bool mutate )
     }
 #endif
 
-    long begbyte = 0;
-    long endbyte = -1;
-    long bit;
     bool first = (randpw() < 0.5);
-    const Genome* ga;
-    const Genome* gb;
 
-	// now do crossover using the ordered pts
-    for (i = 0; i <= numCrossPoints; i++)
-    {
+    if (GenomeSchema::config.resolution == GenomeSchema::RESOLUTION_BIT)
+        crossoverStretches<GenomeSchema::RESOLUTION_BIT>( g1, g2, crossoverPoints, numCrossPoints, first );
+    else if (GenomeSchema::config.resolution == GenomeSchema::RESOLUTION_BYTE)
+        crossoverStretches<GenomeSchema::RESOLUTION_BYTE>( g1, g2, crossoverPoints, numCrossPoints, first );
+    else
+        assert( false );
+
+    if (mutate)
+        this->mutate();
+}
+
+// Copies alternating stretches of g1 and g2 between the crossover points,
+// which are bit indices for RESOLUTION_BIT and byte indices for
+// RESOLUTION_BYTE. The byte holding a point is mixed from both parents.
+template<GenomeSchema::Resolution resolution>
+void Genome::crossoverStretches( const Genome *g1, const Genome *g2,
+								 const long *crossoverPoints, long numCrossPoints,
+								 bool first )
+{
+	long begbyte = 0;
+	long endbyte;
+
+	for( long i = 0; i <= numCrossPoints; i++ )
+	{
 		// for copying the end of the genome
-        if (i == numCrossPoints)
-        {
-            endbyte = nbytes;
-        }
-        else
-        {
-            if (GenomeSchema::config.resolution == GenomeSchema::RESOLUTION_BIT)
-                endbyte = crossoverPoints[i] >> 3;
-            else if (GenomeSchema::config.resolution == GenomeSchema::RESOLUTION_BYTE)
-                endbyte = crossoverPoints[i];
-            else
-                assert( false );
-		}
-        ga = first ? g1 : g2;
-        gb = first ? g2 : g1;
+		if( i == numCrossPoints )
+			endbyte = nbytes;
+		else if( resolution == GenomeSchema::RESOLUTION_BIT )
+			endbyte = crossoverPoints[i] >> 3;
+		else
+			endbyte = crossoverPoints[i];
+
+		const Genome *ga = first ? g1 : g2;
+		const Genome *gb = first ? g2 : g1;
 
 #ifdef DUMPBITS
-        cout << "**copying bytes " << begbyte << " to " << endbyte
-             << " from the ";
-        if (first)
-            cout << "first genome" nl;
-        else
-            cout << "second genome" nl;
-        cout.flush();
+		cout << "**copying bytes " << begbyte << " to " << endbyte
+			 << " from the " << (first ? "first" : "second") << " genome" nl;
+		cout.flush();
 #endif
 
-        for (j = begbyte; j < endbyte; j++)
-            mutable_data[j] = ga->mutable_data[j];    // copy from the appropriate genome
-
-        if (i < numCrossPoints)  // except on the last stretch...
-        {
-            if (GenomeSchema::config.resolution == GenomeSchema::RESOLUTION_BIT)
-            {
-                bit = crossoverPoints[i] - (endbyte << 3);
-                // this goes left to right, corresponding more directly to little-endian machines, but leave it alone (at least for now)
-                mutable_data[endbyte] = char((ga->mutable_data[endbyte] & (255 << (8 - bit)))
-                                        | (gb->mutable_data[endbyte] & (255 >> bit)));
-            }
-            else if (GenomeSchema::config.resolution == GenomeSchema::RESOLUTION_BYTE)
-            {
-                mutable_data[endbyte] = gb->mutable_data[endbyte];
-            }
-            else
-            {
-                assert( false );
-            }
-        }
+		// Points can share a byte at bit resolution, leaving nothing between.
+		if( endbyte > begbyte )
+			memcpy( mutable_data + begbyte, ga->mutable_data + begbyte, endbyte - begbyte );
 
-        first = !first;
-        begbyte = endbyte + 1;
-    }
+		if( i < numCrossPoints )  // except on the last stretch...
+		{
+			if( resolution == GenomeSchema::RESOLUTION_BIT )
+			{
+				long bit = crossoverPoints[i] - (endbyte << 3);
+				// this goes left to right, corresponding more directly to little-endian machines, but leave it alone (at least for now)
+				mutable_data[endbyte] = char((ga->mutable_data[endbyte] & (255 << (8 - bit)))
+											 | (gb->mutable_data[endbyte] & (255 >> bit)));
+			}
+			else
+			{
+				mutable_data[endbyte] = gb->mutable_data[endbyte];
+			}
+		}
 
-    if (mutate)
-        this->mutate();
+		first = !first;
+		begbyte = endbyte + 1;
+	}
 }
 
 void Genome::copyFrom( Genome *g )
@@ -99,6 +99,10 @@ namespace genome
 
 	private:
 		void alloc();
+		template<GenomeSchema::Resolution resolution>
+			void crossoverStretches( const Genome *g1, const Genome *g2,
+									 const long *crossoverPoints, long numCrossPoints,
+									 bool first );
 
 		GenomeSchema *schema;
 		GenomeLayout *layout;
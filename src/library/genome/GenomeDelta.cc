@@ -0,0 +1,490 @@
+#include "GenomeDelta.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <set>
+
+#include "Genome.h"
+#include "utils/AbstractFile.h"
+
+using namespace genome;
+using namespace std;
+
+#define MAGIC "PWGDELTA"
+#define VERSION 2
+
+// record tags
+#define TAG_STEP 'S'
+#define TAG_DEATH 'D'
+#define TAG_KEYFRAME 'K'
+#define TAG_DELTA 'B'
+#define TAG_SNAPSHOT 'F'
+#define TAG_INDEX 'I'
+
+// The index is followed by its own offset, in this many little-endian bytes.
+#define INDEX_OFFSET_SIZE 8
+
+// ================================================================================
+// ===
+// === CLASS GenomeDeltaWriter
+// ===
+// ================================================================================
+
+//---------------------------------------------------------------------------
+// GenomeDeltaWriter::GenomeDeltaWriter
+//---------------------------------------------------------------------------
+GenomeDeltaWriter::GenomeDeltaWriter( AbstractFile *out,
+									  int nbytes,
+									  int keyframeInterval )
+: out( out )
+, nbytes( nbytes )
+, keyframeInterval( keyframeInterval )
+, written( strlen(MAGIC) )
+, lastBirth( 0 )
+{
+	out->write( MAGIC, 1, strlen(MAGIC) );
+	writeVarint( VERSION );
+	writeVarint( nbytes );
+}
+
+//---------------------------------------------------------------------------
+// GenomeDeltaWriter::~GenomeDeltaWriter
+//
+// Ends the stream with the index of snapshots.
+//---------------------------------------------------------------------------
+GenomeDeltaWriter::~GenomeDeltaWriter()
+{
+	unsigned long indexOffset = written + buf.size();
+
+	writeByte( TAG_INDEX );
+	writeVarint( snapshots.size() );
+	for( Snapshot &snapshot : snapshots )
+	{
+		writeVarint( snapshot.step );
+		writeVarint( snapshot.lastBirth );
+		writeVarint( snapshot.offset );
+	}
+	for( int i = 0; i < INDEX_OFFSET_SIZE; i++ )
+		writeByte( (unsigned char)(indexOffset >> (8 * i)) );
+
+	out->write( buf.data(), 1, buf.size() );
+}
+
+//---------------------------------------------------------------------------
+// GenomeDeltaWriter::birth
+//---------------------------------------------------------------------------
+void GenomeDeltaWriter::birth( long number,
+							   Genome *g,
+							   long parent1,
+							   long parent2 )
+{
+	GenomeBytes &child = living[number];
+	child.resize( nbytes );
+	for( int i = 0; i < nbytes; i++ )
+		child[i] = g->get_raw_uint( i );
+
+	if( number > lastBirth )
+		lastBirth = number;
+
+	map<long, GenomeBytes>::iterator it1 = living.find( parent1 );
+	map<long, GenomeBytes>::iterator it2 = living.find( parent2 );
+
+	if( (parent1 == 0) || (parent2 == 0) || (it1 == living.end()) || (it2 == living.end()) )
+	{
+		writeByte( TAG_KEYFRAME );
+		writeVarint( number );
+		writeBytes( child );
+		return;
+	}
+
+	const GenomeBytes *parents[2] = { &it1->second, &it2->second };
+
+	// Follow the child through its parents, switching parent whenever only the
+	// other one matches. Bytes matching neither are mutations. This recovers
+	// the crossover points of byte-resolution genomes exactly; any encoding
+	// of the child is lossless, so it needn't be the one crossover used.
+	int first = (child[0] == (*parents[0])[0]) || (child[0] != (*parents[1])[0]) ? 0 : 1;
+	int src = first;
+	vector<long> crossoverPoints;
+	vector<long> mutations;
+
+	for( int i = 0; i < nbytes; i++ )
+	{
+		if( child[i] == (*parents[src])[i] )
+			continue;
+
+		if( child[i] == (*parents[1 - src])[i] )
+		{
+			crossoverPoints.push_back( i );
+			src = 1 - src;
+		}
+		else
+		{
+			mutations.push_back( i );
+		}
+	}
+
+	writeByte( TAG_DELTA );
+	writeVarint( number );
+	writeVarint( parent1 );
+	writeVarint( parent2 );
+	writeByte( first );
+
+	writeVarint( crossoverPoints.size() );
+	long prev = 0;
+	for( long offset : crossoverPoints )
+	{
+		writeVarint( offset - prev );
+		prev = offset;
+	}
+
+	writeVarint( mutations.size() );
+	prev = 0;
+	for( long offset : mutations )
+	{
+		writeVarint( offset - prev );
+		writeByte( child[offset] );
+		prev = offset;
+	}
+}
+
+//---------------------------------------------------------------------------
+// GenomeDeltaWriter::death
+//---------------------------------------------------------------------------
+void GenomeDeltaWriter::death( long number )
+{
+	living.erase( number );
+
+	writeByte( TAG_DEATH );
+	writeVarint( number );
+}
+
+//---------------------------------------------------------------------------
+// GenomeDeltaWriter::step
+//
+// Ends a step; the records of the step are written out in one piece.
+//---------------------------------------------------------------------------
+void GenomeDeltaWriter::step( long step )
+{
+	writeByte( TAG_STEP );
+	writeVarint( step );
+
+	if( (keyframeInterval > 0) && (step > 0) && (step % keyframeInterval == 0) )
+	{
+		Snapshot snapshot = { step, lastBirth, long(written + buf.size()) };
+		snapshots.push_back( snapshot );
+
+		writeByte( TAG_SNAPSHOT );
+		writeVarint( living.size() );
+		for( map<long, GenomeBytes>::value_type &entry : living )
+		{
+			writeVarint( entry.first );
+			writeBytes( entry.second );
+		}
+	}
+
+	out->write( buf.data(), 1, buf.size() );
+	out->flush();
+	written += buf.size();
+	buf.clear();
+}
+
+//---------------------------------------------------------------------------
+// GenomeDeltaWriter::writeByte
+//---------------------------------------------------------------------------
+void GenomeDeltaWriter::writeByte( unsigned char val )
+{
+	buf.push_back( val );
+}
+
+//---------------------------------------------------------------------------
+// GenomeDeltaWriter::writeVarint
+//
+// LEB128: seven bits per byte, low bits first.
+//---------------------------------------------------------------------------
+void GenomeDeltaWriter::writeVarint( unsigned long val )
+{
+	while( val >= 0x80 )
+	{
+		buf.push_back( (unsigned char)(val | 0x80) );
+		val >>= 7;
+	}
+	buf.push_back( (unsigned char)val );
+}
+
+//---------------------------------------------------------------------------
+// GenomeDeltaWriter::writeBytes
+//---------------------------------------------------------------------------
+void GenomeDeltaWriter::writeBytes( const GenomeBytes &bytes )
+{
+	buf.insert( buf.end(), bytes.begin(), bytes.end() );
+}
+
+// ================================================================================
+// ===
+// === CLASS GenomeDeltaReader
+// ===
+// ================================================================================
+
+//---------------------------------------------------------------------------
+// GenomeDeltaReader::GenomeDeltaReader
+//---------------------------------------------------------------------------
+GenomeDeltaReader::GenomeDeltaReader( AbstractFile *in )
+: in( in )
+, valid( false )
+, nbytes( 0 )
+, start( 0 )
+{
+	char magic[sizeof(MAGIC) - 1];
+	unsigned long version, size;
+
+	if( (in->read( magic, 1, sizeof(magic) ) == sizeof(magic))
+		&& (memcmp( magic, MAGIC, sizeof(magic) ) == 0)
+		&& readVarint( version ) && (version == VERSION)
+		&& readVarint( size ) )
+	{
+		nbytes = size;
+		start = in->tell();
+		valid = true;
+	}
+}
+
+//---------------------------------------------------------------------------
+// GenomeDeltaReader::next
+//---------------------------------------------------------------------------
+bool GenomeDeltaReader::next( Record &record )
+{
+	assert( valid );
+
+	while( true )
+	{
+		unsigned char tag;
+		if( !readByte( tag ) )
+		{
+			record.type = RECORD_END;
+			return true;
+		}
+
+		unsigned long val;
+
+		switch( tag )
+		{
+		case TAG_INDEX:
+			record.type = RECORD_END;
+			return true;
+
+		case TAG_STEP:
+			if( !readVarint( val ) )
+				return false;
+			record.type = RECORD_STEP;
+			record.step = val;
+			return true;
+
+		case TAG_DEATH:
+			if( !readVarint( val ) )
+				return false;
+			living.erase( val );
+			record.type = RECORD_DEATH;
+			record.agent = val;
+			return true;
+
+		case TAG_KEYFRAME:
+			{
+				if( !readVarint( val ) )
+					return false;
+				GenomeBytes &child = living[val];
+				if( !readBytes( child ) )
+					return false;
+				record.type = RECORD_BIRTH;
+				record.agent = val;
+				record.genome = &child;
+			}
+			return true;
+
+		case TAG_DELTA:
+			{
+				unsigned long number, parent1, parent2;
+				unsigned char first;
+				if( !readVarint( number ) || !readVarint( parent1 ) || !readVarint( parent2 ) || !readByte( first ) )
+					return false;
+
+				map<long, GenomeBytes>::iterator it1 = living.find( parent1 );
+				map<long, GenomeBytes>::iterator it2 = living.find( parent2 );
+				if( (it1 == living.end()) || (it2 == living.end()) || (first > 1) )
+					return false;
+				const GenomeBytes *parents[2] = { &it1->second, &it2->second };
+
+				GenomeBytes child( nbytes );
+
+				unsigned long ncrossover;
+				if( !readVarint( ncrossover ) )
+					return false;
+				int src = first;
+				unsigned long begin = 0;
+				for( unsigned long i = 0; i <= ncrossover; i++ )
+				{
+					unsigned long end = nbytes;
+					if( i < ncrossover )
+					{
+						if( !readVarint( val ) )
+							return false;
+						end = begin + val;
+						if( end > (unsigned long)nbytes )
+							return false;
+					}
+					memcpy( child.data() + begin, parents[src]->data() + begin, end - begin );
+					src = 1 - src;
+					begin = end;
+				}
+
+				unsigned long nmutations;
+				if( !readVarint( nmutations ) )
+					return false;
+				unsigned long offset = 0;
+				for( unsigned long i = 0; i < nmutations; i++ )
+				{
+					unsigned char byte;
+					if( !readVarint( val ) || !readByte( byte ) )
+						return false;
+					offset += val;
+					if( offset >= (unsigned long)nbytes )
+						return false;
+					child[offset] = byte;
+				}
+
+				GenomeBytes &stored = living[number];
+				stored.swap( child );
+				record.type = RECORD_BIRTH;
+				record.agent = number;
+				record.genome = &stored;
+			}
+			return true;
+
+		case TAG_SNAPSHOT:
+			{
+				// Full copy of the population; replaces what the deltas built.
+				// Entries are overwritten in place, so genomes already handed
+				// out through Record::genome stay valid.
+				unsigned long count;
+				if( !readVarint( count ) )
+					return false;
+				set<long> snapshot;
+				for( unsigned long i = 0; i < count; i++ )
+				{
+					if( !readVarint( val ) || !readBytes( living[val] ) )
+						return false;
+					snapshot.insert( val );
+				}
+				for( map<long, GenomeBytes>::iterator it = living.begin(); it != living.end(); )
+				{
+					if( snapshot.count(it->first) )
+						++it;
+					else
+						living.erase( it++ );
+				}
+			}
+			break;
+
+		default:
+			return false;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+// GenomeDeltaReader::seekAgent
+//
+// Agent numbers only grow, so the last snapshot taken before any agent
+// numbered agent or above was born still has every ancestor it needs.
+//---------------------------------------------------------------------------
+bool GenomeDeltaReader::seekAgent( long agent )
+{
+	assert( valid );
+
+	bool indexed = false;
+	long offset = start;
+
+	// A stream cut short has no index; its last bytes aren't an offset to
+	// one.
+	unsigned char tail[INDEX_OFFSET_SIZE];
+	if( (in->seek( -INDEX_OFFSET_SIZE, SEEK_END ) == 0)
+		&& (in->read( tail, 1, sizeof(tail) ) == sizeof(tail)) )
+	{
+		long end = in->tell() - INDEX_OFFSET_SIZE;
+		unsigned long indexOffset = 0;
+		for( int i = 0; i < INDEX_OFFSET_SIZE; i++ )
+			indexOffset |= (unsigned long)tail[i] << (8 * i);
+
+		unsigned char tag;
+		unsigned long count;
+		if( (indexOffset >= (unsigned long)start) && (indexOffset < (unsigned long)end)
+			&& (in->seek( indexOffset, SEEK_SET ) == 0)
+			&& readByte( tag ) && (tag == TAG_INDEX)
+			&& readVarint( count ) && (count < (unsigned long)end) )
+		{
+			long found = start;
+			unsigned long i;
+			for( i = 0; i < count; i++ )
+			{
+				unsigned long step, lastBirth, snapshotOffset;
+				if( !readVarint( step ) || !readVarint( lastBirth ) || !readVarint( snapshotOffset )
+					|| (snapshotOffset >= indexOffset) )
+				{
+					break;
+				}
+				if( (long)lastBirth < agent )
+					found = snapshotOffset;
+			}
+			if( (i == count) && (in->tell() == end) )
+			{
+				indexed = true;
+				offset = found;
+			}
+		}
+	}
+
+	living.clear();
+	if( in->seek( offset, SEEK_SET ) != 0 )
+	{
+		in->seek( start, SEEK_SET );
+		return false;
+	}
+
+	return indexed;
+}
+
+//---------------------------------------------------------------------------
+// GenomeDeltaReader::readByte
+//---------------------------------------------------------------------------
+bool GenomeDeltaReader::readByte( unsigned char &val )
+{
+	return in->read( &val, 1, 1 ) == 1;
+}
+
+//---------------------------------------------------------------------------
+// GenomeDeltaReader::readVarint
+//---------------------------------------------------------------------------
+bool GenomeDeltaReader::readVarint( unsigned long &val )
+{
+	val = 0;
+	for( int shift = 0; shift < 64; shift += 7 )
+	{
+		unsigned char byte;
+		if( !readByte( byte ) )
+			return false;
+		val |= (unsigned long)(byte & 0x7f) << shift;
+		if( !(byte & 0x80) )
+			return true;
+	}
+	return false;
+}
+
+//---------------------------------------------------------------------------
+// GenomeDeltaReader::readBytes
+//---------------------------------------------------------------------------
+bool GenomeDeltaReader::readBytes( GenomeBytes &bytes )
+{
+	bytes.resize( nbytes );
+	return in->read( bytes.data(), 1, nbytes ) == (size_t)nbytes;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <map>
+#include <vector>
+
+class AbstractFile;
+
+namespace genome
+{
+	class Genome;
+
+	// ================================================================================
+	// ===
+	// === Binary population genetics stream
+	// ===
+	// === Records births, deaths and step boundaries like the text form of
+	// === PopulationGeneticsLog, but a birth is stored relative to its parents:
+	// === the parent it starts copying from, the offsets at which it switches to
+	// === the other parent, and the bytes that match neither (mutations).
+	// === Agents without recorded parents are stored in full (keyframes), and
+	// === every keyframeInterval steps the whole living population is stored in
+	// === full so a reader never has to trust more than one interval of deltas.
+	// === A complete stream ends with an index of those snapshots, so a reader
+	// === after one agent can start from the last snapshot before its birth.
+	// ===
+	// === Genome bytes are the raw (gray-decoded, logical order) values that
+	// === Genome::dump() writes.
+	// ===
+	// ================================================================================
+
+	typedef std::vector<unsigned char> GenomeBytes;
+
+	// ================================================================================
+	// ===
+	// === CLASS GenomeDeltaWriter
+	// ===
+	// ================================================================================
+	class GenomeDeltaWriter
+	{
+	public:
+		GenomeDeltaWriter( AbstractFile *out,
+						   int nbytes,
+						   int keyframeInterval );
+		~GenomeDeltaWriter();
+
+		// parent numbers are 0 when unknown
+		void birth( long number,
+					Genome *g,
+					long parent1,
+					long parent2 );
+		void death( long number );
+		void step( long step );
+
+	private:
+		void writeByte( unsigned char val );
+		void writeVarint( unsigned long val );
+		void writeBytes( const GenomeBytes &bytes );
+
+		struct Snapshot
+		{
+			long step;
+			long lastBirth;	// highest agent number born before it
+			long offset;
+		};
+
+		AbstractFile *out;
+		int nbytes;
+		int keyframeInterval;
+		std::map<long, GenomeBytes> living;
+		std::vector<unsigned char> buf;
+		long written;
+		long lastBirth;
+		std::vector<Snapshot> snapshots;
+	};
+
+	// ================================================================================
+	// ===
+	// === CLASS GenomeDeltaReader
+	// ===
+	// ================================================================================
+	class GenomeDeltaReader
+	{
+	public:
+		enum RecordType
+		{
+			RECORD_STEP,
+			RECORD_BIRTH,
+			RECORD_DEATH,
+			RECORD_END
+		};
+
+		struct Record
+		{
+			RecordType type;
+			long step;
+			long agent;
+			const GenomeBytes *genome;	// births only; valid until the agent's death
+		};
+
+		GenomeDeltaReader( AbstractFile *in );
+
+		bool isValid() { return valid; }
+		int getGenomeSize() { return nbytes; }
+
+		// Returns false on a malformed stream.
+		bool next( Record &record );
+
+		// Moves to the last snapshot before the birth of agent, or to the
+		// start of the stream. Call before the first next(). Returns false
+		// if the stream has no index, or can't seek to it; next() then reads
+		// from the start.
+		bool seekAgent( long agent );
+
+	private:
+		bool readByte( unsigned char &val );
+		bool readVarint( unsigned long &val );
+		bool readBytes( GenomeBytes &bytes );
+
+		AbstractFile *in;
+		bool valid;
+		int nbytes;
+		long start;
+		std::map<long, GenomeBytes> living;
+	};
+}
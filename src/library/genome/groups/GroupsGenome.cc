@@ -15,6 +15,7 @@ GroupsGenome::GroupsGenome( GroupsGenomeSchema *schema,
 : Genome( schema,
 		  layout )
 , _schema( schema )
+, _derived( NULL )
 {
 	if( GroupsBrain::config.orderedinternalneurgroups )
 	{
@@ -173,6 +174,13 @@ std::vector<int> GroupsGenome::getOrderedGroups()
 int GroupsGenome::getNeuronCount( NeuronType type,
 								  int group )
 {
+	if( _derived )
+	{
+		int count = _derived->neuronCounts[group * 2 + type];
+		assert( count >= 0 );
+		return count;
+	}
+
 	NeurGroupGene *g = _schema->getGroupGene( group );
 
 	switch( g->getGroupType() )
@@ -224,6 +232,13 @@ int GroupsGenome::getSynapseCount( GroupsSynapseType *synapseType,
 								   int from,
 								   int to )
 {
+	if( _derived )
+	{
+		int count = _derived->synapseCounts[ getDerivedIndex(synapseType, from, to) ];
+		assert( count >= 0 );
+		return count;
+	}
+
 	NeuronType nt_from = synapseType->nt_from;
 	NeuronType nt_to = synapseType->nt_to;
 	bool to_output = _schema->getNeurGroupType(to) == NGT_OUTPUT;
@@ -294,6 +309,87 @@ Scalar GroupsGenome::get( Gene *gene,
 													  to );
 }
 
+float GroupsGenome::getTopologicalDistortion( GroupsSynapseType *synapseType,
+											  int from,
+											  int to )
+{
+	if( _derived )
+	{
+		return _derived->topologicalDistortion[ getDerivedIndex(synapseType, from, to) ];
+	}
+
+	return get( TOPOLOGICAL_DISTORTION,
+				synapseType,
+				from,
+				to );
+}
+
+void GroupsGenome::beginDerivedAttrs( DerivedAttrs *attrs )
+{
+	assert( _derived == NULL );
+
+	int maxGroups = _schema->getMaxGroupCount( NGT_ANY );
+	int numSynapseTypes = _schema->getSynapseTypes().size();
+	int ntables = numSynapseTypes * maxGroups * maxGroups;
+
+	attrs->maxGroups = maxGroups;
+	attrs->neuronCounts.assign( maxGroups * 2, -1 );
+	attrs->synapseCounts.assign( ntables, -1 );
+	attrs->topologicalDistortion.assign( ntables, 0.0f );
+
+	// Neuron counts are queried both by raw index and by ordered index, and
+	// with ordered internal groups those can be disjoint sets, so cover every
+	// group.
+	for( int group = 0; group < maxGroups; group++ )
+	{
+		attrs->neuronCounts[group * 2 + INHIBITORY] = getNeuronCount( INHIBITORY, group );
+		attrs->neuronCounts[group * 2 + EXCITATORY] = getNeuronCount( EXCITATORY, group );
+	}
+
+	// Synapses are only ever queried between the groups this genome expresses.
+	std::vector<int> groups = getOrderedGroups();
+
+	for( GroupsSynapseType *synapseType : _schema->getSynapseTypes() )
+	{
+		for( int from : groups )
+		{
+			for( int to : groups )
+			{
+				// Input groups are never synapse targets, and have no genes
+				// for it.
+				if( _schema->getNeurGroupType(to) == NGT_INPUT )
+					continue;
+
+				int index = (synapseType->index * maxGroups + from) * maxGroups + to;
+
+				attrs->synapseCounts[index] = getSynapseCount( synapseType, from, to );
+				attrs->topologicalDistortion[index] = get( TOPOLOGICAL_DISTORTION,
+														   synapseType,
+														   from,
+														   to );
+			}
+		}
+	}
+
+	_derived = attrs;
+}
+
+void GroupsGenome::endDerivedAttrs()
+{
+	assert( _derived != NULL );
+
+	_derived = NULL;
+}
+
+int GroupsGenome::getDerivedIndex( GroupsSynapseType *synapseType,
+								   int from,
+								   int to )
+{
+	int maxGroups = _derived->maxGroups;
+
+	return (synapseType->index * maxGroups + from) * maxGroups + to;
+}
+
 #define SEEDCHECK(VAL) assert(((VAL) >= 0) && ((VAL) <= 1))
 #define SEEDVAL(VAL) (unsigned char)((VAL) == 1 ? 255 : (VAL) * 256)
 
@@ -65,6 +65,29 @@ namespace genome
 					int from,
 					int to );
 
+		float getTopologicalDistortion( GroupsSynapseType *synapseType,
+										int from,
+										int to );
+
+		// ---
+		// --- Derived attributes (neuron and synapse counts, topological
+		// --- distortion) are queried once per synapse while a brain grows.
+		// --- Between beginDerivedAttrs() and endDerivedAttrs() they are
+		// --- answered from a table filled up front. The storage belongs to
+		// --- the caller so a worker thread can reuse it across births; the
+		// --- genome must not be modified while the table is in use.
+		// ---
+		struct DerivedAttrs
+		{
+			int maxGroups;
+			std::vector<int> neuronCounts;				// [group][NeuronType]
+			std::vector<int> synapseCounts;				// [synapseType][from][to]
+			std::vector<float> topologicalDistortion;	// [synapseType][from][to]
+		};
+
+		void beginDerivedAttrs( DerivedAttrs *attrs );
+		void endDerivedAttrs();
+
 		using Genome::seed;
 		using Genome::seedRandom;
 
@@ -87,7 +110,12 @@ namespace genome
 		virtual void getCrossoverPoints( long *crossoverPoints, long numCrossPoints );
 
 	private:
+		int getDerivedIndex( GroupsSynapseType *synapseType,
+							 int from,
+							 int to );
+
 		GroupsGenomeSchema *_schema;
+		DerivedAttrs *_derived;
 	};
 }
 
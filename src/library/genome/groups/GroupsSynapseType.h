@@ -27,6 +27,7 @@ namespace genome
 		int getOffset( int from, int to );
 
 	private:
+		friend class GroupsGenome;
 		friend class GroupsGenomeSchema;
 		friend class SynapseAttrGene;
 
@@ -71,6 +71,39 @@ void TGraphicObjectList::Add(gobject* itemToAdd)
 }
 
 
+//-------------------------------------------------------------------------------------------
+// TGraphicObjectList::AddSorted
+//
+// Adds items already stably sorted by x - radius in one pass, leaving the
+// list as Add() on each in turn would.
+//-------------------------------------------------------------------------------------------
+void TGraphicObjectList::AddSorted(const std::vector<gobject*>& items)
+{
+	TGraphicObjectList::iterator iter = begin();
+	for (gobject* itemToAdd : items)
+	{
+		for (; iter != end(); ++iter)
+		{
+			gobject* listItem = *iter;
+
+			if ((itemToAdd->x() - itemToAdd->radius()) < (listItem->x() - listItem->radius()))
+				break;
+		}
+
+		insert(iter, itemToAdd);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------
+// TGraphicObjectList::RemoveAll
+//-------------------------------------------------------------------------------------------
+void TGraphicObjectList::RemoveAll(const std::unordered_set<gobject*>& items)
+{
+	remove_if([&items](gobject* item) { return items.count(item) > 0; });
+}
+
+
 //-------------------------------------------------------------------------------------------
 // TGraphicObjectList::Sort
 //-------------------------------------------------------------------------------------------
@@ -11,6 +11,8 @@
 
 // System
 #include <stddef.h>
+#include <unordered_set>
+#include <vector>
 
 // Local
 #include "utils/objectlist.h"
@@ -59,6 +61,8 @@ public:
     void SetCurrentCamera(const gcamera* pcam) { fCurrentCamera = pcam; }
     
     virtual void Add(gobject* item);
+    void AddSorted(const std::vector<gobject*>& items);
+    void RemoveAll(const std::unordered_set<gobject*>& items);
     virtual void Sort();
 
     virtual void Draw();
@@ -46,7 +46,7 @@ void gobject::init()
 	fColor[1] = rand() / 32767.0;
 	fColor[2] = rand() / 32767.0;
 	fColor[3] = 0.;
-	listLink = NULL;
+	listIndex = -1;
 	fCarriedBy = NULL;
 	fTypeNumber = 0;
 	fCarryOffset[0] = 0.0;
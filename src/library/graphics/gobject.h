@@ -126,8 +126,7 @@ public:
 	unsigned long getTypeNumber();
 	void setTypeNumber( unsigned long typeNumber );
 
-    gdlink<gobject*>* listLink;    
-    gdlink<gobject*>* GetListLink();
+    long listIndex;	// position in objectxsortedlist::gXSortedObjects
 
 	bool BeingCarried( void );
 	gobject* CarriedBy( void );
@@ -198,7 +197,6 @@ inline int gobject::getType() { return objType; }
 inline void gobject::setType(int newType) { objType = newType; }
 inline unsigned long gobject::getTypeNumber() { return fTypeNumber; }
 inline void gobject::setTypeNumber( unsigned long typeNumber ) { fTypeNumber = typeNumber; }
-inline gdlink<gobject*>* gobject::GetListLink() { return listLink; }
 inline bool gobject::BeingCarried( void ) { return (fCarriedBy != NULL); }
 inline gobject* gobject::CarriedBy( void ) { return fCarriedBy; }
 inline int gobject::NumCarries() { return fCarries.size(); }
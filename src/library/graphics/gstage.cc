@@ -247,6 +247,15 @@ void gstage::AddObject(gobject* po)
 }
 
 
+//---------------------------------------------------------------------------
+// gstage::AddObjects
+//---------------------------------------------------------------------------
+void gstage::AddObjects(const vector<gobject*>& objects)
+{
+	fCastList->AddSorted(objects);
+}
+
+
 //---------------------------------------------------------------------------
 // gstage::AddLight
 //---------------------------------------------------------------------------
@@ -295,3 +304,12 @@ void gstage::RemoveObject(gobject* po)
 #endif
 }
 
+
+//---------------------------------------------------------------------------
+// gstage::RemoveObjects
+//---------------------------------------------------------------------------
+void gstage::RemoveObjects(const vector<gobject*>& objects)
+{
+	fCastList->RemoveAll(unordered_set<gobject*>(objects.begin(), objects.end()));
+}
+
@@ -48,6 +48,10 @@ public:
     void AddObject(gobject* po);        
     void RemoveObject(gobject* po);
 
+    // Batch forms: objects must be sorted by x - radius for AddObjects
+    void AddObjects(const std::vector<gobject*>& objects);
+    void RemoveObjects(const std::vector<gobject*>& objects);
+
     void AddLight(glight* pl);
     void RemoveLight(glight* pl);
 	        	
@@ -29,6 +29,7 @@ using namespace std;
 Logger::Logger()
 	: _simulation( NULL )
 	, _record( false )
+	, _profilerPhase( -1 )
 {
 	Logs::installLogger( const_cast<Logger *>(this) );
 }
@@ -6,6 +6,7 @@
 
 #include "agent/AgentAttachedData.h"
 #include "sim/simtypes.h"
+#include "utils/datalib.h"
 
 
 namespace proplib { class Document; }
@@ -94,6 +95,10 @@ class Logger
 	class TSimulation *_simulation;
 	bool _record;
 
+ private:
+	// StepProfiler phase timing this logger's processEvent().
+	int _profilerPhase;
+
  private:
 	union
 	{
@@ -189,4 +194,46 @@ class DataLibLogger : public Logger
 									   bool randomAccess = false,
 									   bool singleSchema = true );
 	class DataLibWriter *getWriter( class agent *a );
+
+	// Per-agent typed tables, kept as the agent's state in place of its
+	// writer. deleteTable() deletes the writer too.
+	template<typename Table>
+	void setTable( class agent *a, const Table &table );
+	template<typename Table>
+	Table &getTable( class agent *a );
+	template<typename Table>
+	void deleteTable( class agent *a );
 };
+
+//---------------------------------------------------------------------------
+// DataLibLogger::setTable
+//---------------------------------------------------------------------------
+template<typename Table>
+void DataLibLogger::setTable( agent *a, const Table &table )
+{
+	setAgentState( a, new Table(table) );
+}
+
+//---------------------------------------------------------------------------
+// DataLibLogger::getTable
+//---------------------------------------------------------------------------
+template<typename Table>
+Table &DataLibLogger::getTable( agent *a )
+{
+	return *(Table *)getAgentState( a );
+}
+
+//---------------------------------------------------------------------------
+// DataLibLogger::deleteTable
+//---------------------------------------------------------------------------
+template<typename Table>
+void DataLibLogger::deleteTable( agent *a )
+{
+	Table *table = (Table *)getAgentState( a );
+	if( table )
+	{
+		delete table->getWriter();
+		delete table;
+		setAgentState( a, NULL );
+	}
+}
@@ -2,11 +2,14 @@
 
 #include "Logs.h"
 
+#include <algorithm>
+#include <cxxabi.h>
 #include <fstream>
 #include <stdio.h>
 #include <stdlib.h>
 #include <iostream>
 #include <mutex>
+#include <typeinfo>
 
 #include "agent/agent.h"
 #include "brain/Brain.h"
@@ -17,6 +20,7 @@
 #include "proplib/proplib.h"
 #include "sim/globals.h"
 #include "sim/Simulation.h"
+#include "utils/BirthsDeathsIndex.h"
 #include "utils/analysis.h"
 #include "utils/datalib.h"
 #include "utils/misc.h"
@@ -74,6 +78,21 @@ void Logs::installLogger( Logger *logger )
 //---------------------------------------------------------------------------
 void Logs::registerEvents( Logger *logger, sim::EventType eventTypes )
 {
+	if( logger->_profilerPhase < 0 )
+	{
+		// Name the phase after the logger class, e.g. "Logs::EnergyLog" -> "EnergyLog".
+		int status;
+		char *name = abi::__cxa_demangle( typeid(*logger).name(), NULL, NULL, &status );
+		string phaseName = (status == 0) ? name : typeid(*logger).name();
+		free( name );
+
+		size_t colon = phaseName.rfind( ':' );
+		if( colon != string::npos )
+			phaseName = phaseName.substr( colon + 1 );
+
+		logger->_profilerPhase = StepProfiler::definePhase( phaseName );
+	}
+
 	int nbits = sizeof(sim::EventType) * 8;
 
 	for( int bit = 0; bit < nbits; bit++ )
@@ -190,7 +209,7 @@ void Logs::AgentEnergyLog::processEvent( const sim::AgentBirthEvent &e )
 			 "run/energy/agents/agent_%ld.txt",
 			 e.a->getTypeNumber() );
 
-	DataLibWriter *writer = createWriter( e.a, path, true, false );
+	DataLibWriter *writer = createWriter( path, true, false );
 
 	static const char *colnames[] =
 		{
@@ -199,16 +218,9 @@ void Logs::AgentEnergyLog::processEvent( const sim::AgentBirthEvent &e )
 			"FoodEnergy",
 			NULL
 		};
-	static const datalib::Type coltypes[] =
-		{
-			datalib::INT,
-			datalib::FLOAT,
-			datalib::FLOAT
-		};
 
-	writer->beginTable( "AgentEnergy",
-						colnames,
-						coltypes );
+	setTable<Table>( e.a, writer->beginTypedTable<int, float, float>("AgentEnergy",
+																	 colnames) );
 }
 
 //---------------------------------------------------------------------------
@@ -216,13 +228,11 @@ void Logs::AgentEnergyLog::processEvent( const sim::AgentBirthEvent &e )
 //---------------------------------------------------------------------------
 void Logs::AgentEnergyLog::processEvent( const sim::StepEndEvent &e )
 {
-	agent *a;
-	objectxsortedlist::gXSortedObjects.reset();
-	while( objectxsortedlist::gXSortedObjects.nextObj( AGENTTYPE, (gobject**)&a ) )
+	for( agent *a : AgentRegistry::getAgents() )
 	{
-		getWriter( a )->addRow( getStep(),
-								a->GetEnergy().sum(),
-								a->GetFoodEnergy().sum() );
+		getTable<Table>( a ).addRow( int(getStep()),
+									 a->GetEnergy().sum(),
+									 a->GetFoodEnergy().sum() );
 	}
 }
 
@@ -233,11 +243,11 @@ void Logs::AgentEnergyLog::processEvent( const sim::AgentDeathEvent &e )
 {
 	if( e.reason != LifeSpan::DR_SIMEND )
 	{
-		getWriter( e.a )->addRow( getStep(),
-								  e.a->GetEnergy().sum(),
-								  e.a->GetFoodEnergy().sum() );
+		getTable<Table>( e.a ).addRow( int(getStep()),
+									   e.a->GetEnergy().sum(),
+									   e.a->GetFoodEnergy().sum() );
 	}
-	delete getWriter( e.a );
+	deleteTable<Table>( e.a );
 }
 
 
@@ -351,28 +361,24 @@ void Logs::AgentPositionLog::processEvent( const sim::AgentBirthEvent &e )
 	{
 	case Precise:
 		{
-			DataLibWriter *writer = createWriter( e.a, path, true, false );
+			DataLibWriter *writer = createWriter( path, true, false );
 
 			static const char *colnames[] = {"Timestep", "x", "y", "z", NULL};
-			static const datalib::Type coltypes[] = {datalib::INT, datalib::FLOAT, datalib::FLOAT, datalib::FLOAT};
 
-			writer->beginTable( "Positions",
-								colnames,
-								coltypes );
+			setTable<PreciseTable>( e.a, writer->beginTypedTable<int, float, float, float>("Positions",
+																						   colnames) );
 		}
 		break;
 	case Approximate:
 		{
-			DataLibWriter *writer = createWriter( e.a, path );
+			DataLibWriter *writer = createWriter( path );
 
 			static const char *colnames[] = {"Timestep", "x", "z", NULL};
-			static const datalib::Type coltypes[] = {datalib::INT, datalib::FLOAT, datalib::FLOAT};
 			static const char *colformats[] = {"%d", "%.2f", "%.2f"};
 
-			writer->beginTable( "Positions",
-								colnames,
-								coltypes,
-								colformats );
+			setTable<ApproximateTable>( e.a, writer->beginTypedTable<int, float, float>("Positions",
+																						colnames,
+																						colformats) );
 		}
 		break;
 	case CenterOfMass:
@@ -390,15 +396,15 @@ void Logs::AgentPositionLog::processEvent( const AgentBodyUpdatedEvent &e )
 	switch( _mode )
 	{
 	case Precise:
-		getWriter( e.a )->addRow( getStep(),
-								  e.a->x(),
-								  e.a->y(),
-								  e.a->z() );
+		getTable<PreciseTable>( e.a ).addRow( int(getStep()),
+											  e.a->x(),
+											  e.a->y(),
+											  e.a->z() );
 		break;
 	case Approximate:
-		getWriter( e.a )->addRow( getStep(),
-								  e.a->x(),
-								  e.a->z() );
+		getTable<ApproximateTable>( e.a ).addRow( int(getStep()),
+												  e.a->x(),
+												  e.a->z() );
 		break;
 	case CenterOfMass:
 		break;
@@ -412,7 +418,17 @@ void Logs::AgentPositionLog::processEvent( const AgentBodyUpdatedEvent &e )
 //---------------------------------------------------------------------------
 void Logs::AgentPositionLog::processEvent( const sim::AgentDeathEvent &e )
 {
-	delete getWriter( e.a );
+	switch( _mode )
+	{
+	case Precise:
+		deleteTable<PreciseTable>( e.a );
+		break;
+	case Approximate:
+		deleteTable<ApproximateTable>( e.a );
+		break;
+	default:
+		assert( false );
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -442,6 +458,7 @@ void Logs::AgentPositionLog::recordCenterOfMass()
 	float z = 0.0f;
 	int count = 0;
 	agent *a;
+	// Float sums depend on order; x-sorted keeps the log as it was.
 	objectxsortedlist::gXSortedObjects.reset();
 	while( objectxsortedlist::gXSortedObjects.nextObj( AGENTTYPE, (gobject**)&a ) )
 	{
@@ -471,7 +488,8 @@ void Logs::BirthsDeathsLog::init( TSimulation *sim, Document *doc )
 		initRecording( sim,
 					   SimulationStateScope,
 					   sim::Event_AgentBirth
-					   | sim::Event_AgentDeath );
+					   | sim::Event_AgentDeath
+					   | sim::Event_SimEnd );
 
 		createFile( "run/BirthsDeaths.log" );
 		fprintf( getFile(), "%% Timestep Event Agent# Parent1 Parent2\n" );
@@ -527,6 +545,17 @@ void Logs::BirthsDeathsLog::processEvent( const sim::AgentDeathEvent &death )
 	}
 }
 
+//---------------------------------------------------------------------------
+// Logs::BirthsDeathsLog::processEvent
+//
+// Index the log for the analysis tools and lockstep runs.
+//---------------------------------------------------------------------------
+void Logs::BirthsDeathsLog::processEvent( const sim::SimEndEvent &e )
+{
+	fflush( getFile() );
+	BirthsDeathsIndex::build( "run/BirthsDeaths.log", "run/BirthsDeaths.idx" );
+}
+
 
 //===========================================================================
 // BrainAnatomyLog
@@ -817,6 +846,38 @@ void Logs::BrainFunctionLog::init( TSimulation *sim, Document *doc )
 		_recordBestRecent = doc->get( "RecordBrainBestRecent" );
 		_recordBestSoFar = doc->get( "RecordBrainBestSoFar" );
 		_nseeds = doc->get( "InitAgents" );
+		_encoding = BrainFunctionFormat::parseEncoding( doc->get("BrainFunctionEncoding") );
+		_stride = doc->get( "BrainFunctionStride" );
+		_maxSteps = (int)doc->get( "BrainFunctionMaxSteps" );
+		_recordInputNeurons = doc->get( "BrainFunctionInputNeurons" );
+		_recordOutputNeurons = doc->get( "BrainFunctionOutputNeurons" );
+		_recordInternalNeurons = doc->get( "BrainFunctionInternalNeurons" );
+		if( !_recordInputNeurons && !_recordOutputNeurons && !_recordInternalNeurons )
+		{
+			cerr << "RecordBrainFunction needs at least one of BrainFunctionInputNeurons, BrainFunctionOutputNeurons and BrainFunctionInternalNeurons" << endl;
+			exit( 1 );
+		}
+
+		// Complexity is computed from these files, and needs the input
+		// neurons; event filtering also needs every step.
+		if( doc->get("RecordComplexity") )
+		{
+			if( !_recordInputNeurons )
+			{
+				cerr << "RecordComplexity needs BrainFunctionInputNeurons" << endl;
+				exit( 1 );
+			}
+
+			string complexityType = (string)doc->get( "ComplexityType" );
+			for( char c : complexityType )
+			{
+				if( islower(c) && (_stride > 1) )
+				{
+					cerr << "Event filtering in ComplexityType needs BrainFunctionStride 1" << endl;
+					exit( 1 );
+				}
+			}
+		}
 
 		if( _recordBestRecent || _recordBestSoFar )
 		{
@@ -843,26 +904,43 @@ void Logs::BrainFunctionLog::init( TSimulation *sim, Document *doc )
 //---------------------------------------------------------------------------
 // Logs::BrainFunctionLog::processEvent
 //
-// Once agent is grown, begin recording brain function.
+// Once agent is grown, begin recording brain function, unless its brain
+// has none of the selected neuron groups.
 //---------------------------------------------------------------------------
 void Logs::BrainFunctionLog::processEvent( const AgentGrownEvent &e )
 {
+	BrainFunctionFormat format = getFormat( e.a );
+	if( format.ranges.empty() )
+		return;
+
 	char path[256];
 	sprintf( path, "run/brain/function/incomplete_brainFunction_%ld.txt", e.a->Number() );
 
-	AbstractFile *file = createFile( e.a, path );
-	e.a->GetBrain()->startFunctional( file, e.a->Number() );
+	Recording *recording = new Recording();
+	recording->file = createFile( path );
+	recording->format = format;
+	setAgentState( e.a, recording );
+
+	e.a->GetBrain()->startFunctional( recording->file, e.a->Number(), recording->format );
 }
 
 //---------------------------------------------------------------------------
 // Logs::BrainFunctionLog::processEvent
 //
-// When brain has executed a step, record its function state.
+// When brain has executed a step, record its function state, unless the
+// step falls between strides or past the end of the window.
 //---------------------------------------------------------------------------
 void Logs::BrainFunctionLog::processEvent( const BrainUpdatedEvent &e )
 {
-	AbstractFile *file = getFile( e.a );
-	e.a->GetBrain()->writeFunctional( file );
+	Recording *recording = (Recording *)getAgentState( e.a );
+	if( !recording )
+		return;
+
+	long age = e.a->Age();
+	if( (age % _stride) || ((_maxSteps > 0) && (age >= _maxSteps)) )
+		return;
+
+	e.a->GetBrain()->writeFunctional( recording->file, recording->format );
 }
 
 //---------------------------------------------------------------------------
@@ -872,10 +950,12 @@ void Logs::BrainFunctionLog::processEvent( const BrainUpdatedEvent &e )
 //---------------------------------------------------------------------------
 void Logs::BrainFunctionLog::processEvent( const BrainAnalysisBeginEvent &e )
 {
-	AbstractFile *file = getFile( e.a );
+	Recording *recording = (Recording *)getAgentState( e.a );
+	if( !recording )
+		return;
 
-	e.a->GetBrain()->endFunctional( file, e.a->CurrentHeuristicFitness() );
-	delete file;
+	e.a->GetBrain()->endFunctional( recording->file, e.a->CurrentHeuristicFitness() );
+	deleteRecording( e.a );
 
 	char s[256];
 	char t[256];
@@ -918,10 +998,57 @@ void Logs::BrainFunctionLog::processEvent( const EpochEndEvent &e )
 //---------------------------------------------------------------------------
 void Logs::BrainFunctionLog::processEvent( const SimEndEvent &e )
 {
-	agent *a;
-	objectxsortedlist::gXSortedObjects.reset();
-	while( objectxsortedlist::gXSortedObjects.nextObj( AGENTTYPE, (gobject**)&a ) )
-		delete getFile( a );
+	for( agent *a : AgentRegistry::getAgents() )
+		deleteRecording( a );
+}
+
+//---------------------------------------------------------------------------
+// Logs::BrainFunctionLog::getFormat
+//
+// Neurons are ordered input, output, internal, so the selected groups
+// make at most two ranges.
+//---------------------------------------------------------------------------
+BrainFunctionFormat Logs::BrainFunctionLog::getFormat( agent *a )
+{
+	NeuronModel::Dimensions dims = a->GetBrain()->getDimensions();
+
+	BrainFunctionFormat format;
+	format.encoding = _encoding;
+	format.stride = _stride;
+
+	bool groups[] = { _recordInputNeurons, _recordOutputNeurons, _recordInternalNeurons };
+	int begins[] = { dims.getFirstInputNeuron(), dims.getFirstOutputNeuron(), dims.getFirstInternalNeuron(), dims.numNeurons };
+	for( int i = 0; i < 3; i++ )
+	{
+		if( !groups[i] || (begins[i] == begins[i + 1]) )
+			continue;
+
+		if( !format.ranges.empty() && (format.ranges.back().last == begins[i] - 1) )
+		{
+			format.ranges.back().last = begins[i + 1] - 1;
+		}
+		else
+		{
+			BrainFunctionFormat::Range range = { begins[i], begins[i + 1] - 1 };
+			format.ranges.push_back( range );
+		}
+	}
+
+	return format;
+}
+
+//---------------------------------------------------------------------------
+// Logs::BrainFunctionLog::deleteRecording
+//---------------------------------------------------------------------------
+void Logs::BrainFunctionLog::deleteRecording( agent *a )
+{
+	Recording *recording = (Recording *)getAgentState( a );
+	if( recording )
+	{
+		delete recording->file;
+		delete recording;
+		setAgentState( a, NULL );
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -1035,16 +1162,9 @@ void Logs::CollisionLog::init( TSimulation *sim, Document *doc )
 				"Type",
 				NULL
 			};
-		const datalib::Type coltypes[] =
-			{
-				datalib::INT,
-				datalib::INT,
-				datalib::STRING
-			};
 
-		writer->beginTable( "Collisions",
-							colnames,
-							coltypes );
+		_table = writer->beginTypedTable<int, int, const char *>( "Collisions",
+																  colnames );
 	}
 }
 
@@ -1061,9 +1181,9 @@ void Logs::CollisionLog::processEvent( const sim::CollisionEvent &e )
 								  "barrier",
 								  "edge"};
 
-	getWriter()->addRow( getStep(),
-						 e.a->Number(),
-						 names[e.ot] );
+	_table.addRow( int(getStep()),
+				   int(e.a->Number()),
+				   names[e.ot] );
 }
 
 
@@ -1093,17 +1213,8 @@ void Logs::ContactLog::init( TSimulation *sim, Document *doc )
 				NULL
 			};
 
-		const datalib::Type coltypes[] =
-			{
-				datalib::INT,
-				datalib::INT,
-				datalib::INT,
-				datalib::STRING,
-			};
-
-		writer->beginTable( "Contacts",
-							colnames,
-							coltypes );
+		_table = writer->beginTypedTable<int, int, int, const char *>( "Contacts",
+																	   colnames );
 	}
 }
 
@@ -1120,10 +1231,10 @@ void Logs::ContactLog::processEvent( const AgentContactEndEvent &e )
 	encode( e.d, &b );
 	*(b++) = 0;
 
-	getWriter()->addRow( getStep(),
-						 e.c.number,
-						 e.d.number,
-						 buf );
+	_table.addRow( int(getStep()),
+				   int(e.c.number),
+				   int(e.d.number),
+				   (const char *)buf );
 }
 
 //---------------------------------------------------------------------------
@@ -1865,21 +1976,38 @@ Logs::PopulationGeneticsLog::~PopulationGeneticsLog()
 {
 	if( _record )
 	{
+		delete _delta;
 		delete f;
 	}
 }
 
 //---------------------------------------------------------------------------
 // Logs::PopulationGeneticsLog::init
+//
+// Encoding Text writes every genome in full, one byte value per line.
+// Encoding Delta writes the binary stream of genome/GenomeDelta.h, which
+// the genetics tool converts back to text.
 //---------------------------------------------------------------------------
 void Logs::PopulationGeneticsLog::init( TSimulation *sim, Document *doc )
 {
 	Property &prop = doc->get( "PopulationGeneticsLog" );
 	if( prop.get( "On" ) )
 	{
-		const char *fileName = ((string)prop.get( "FileName" )).c_str();
-		f = AbstractFile::open( AbstractFile::TYPE_FILE, fileName, "w" );
-		f->printf( "SIZE %d\n", genome::GenomeUtil::schema->getMutableSize() );
+		string fileName = (string)prop.get( "FileName" );
+		int size = genome::GenomeUtil::schema->getMutableSize();
+
+		if( (string)prop.get( "Encoding" ) == "Delta" )
+		{
+			f = AbstractFile::open( globals::recordFileType, fileName.c_str(), "w" );
+			_delta = new genome::GenomeDeltaWriter( f, size, prop.get( "KeyframeInterval" ) );
+		}
+		else
+		{
+			f = AbstractFile::open( AbstractFile::TYPE_FILE, fileName.c_str(), "w" );
+			f->printf( "SIZE %d\n", size );
+			_delta = NULL;
+		}
+
 		initRecording( sim,
 					   SimulationStateScope,
 					   sim::Event_SimInited
@@ -1894,8 +2022,15 @@ void Logs::PopulationGeneticsLog::init( TSimulation *sim, Document *doc )
 //---------------------------------------------------------------------------
 void Logs::PopulationGeneticsLog::processEvent( const sim::SimInitedEvent &e )
 {
-	f->printf( "STEP 0\n" );
-	f->flush();
+	if( _delta )
+	{
+		_delta->step( 0 );
+	}
+	else
+	{
+		f->printf( "STEP 0\n" );
+		f->flush();
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -1905,13 +2040,20 @@ void Logs::PopulationGeneticsLog::processEvent( const sim::AgentBirthEvent &e )
 {
 	if( e.reason != LifeSpan::BR_VIRTUAL )
 	{
-		static mutex m;
+		lock_guard<mutex> lock( _mutex );
+
+		if( _delta )
+		{
+			_delta->birth( e.a->Number(),
+						   e.a->Genes(),
+						   e.parent1 ? e.parent1->Number() : 0,
+						   e.parent2 ? e.parent2->Number() : 0 );
+		}
+		else
 		{
-			lock_guard<mutex> lock(m);
 			f->printf( "BIRTH %ld\n", e.a->Number() );
 			e.a->Genes()->dump( f );
 			f->printf( "\n" );
-			f->flush();
 		}
 	}
 }
@@ -1923,18 +2065,31 @@ void Logs::PopulationGeneticsLog::processEvent( const sim::AgentDeathEvent &e )
 {
 	if( e.reason != LifeSpan::DR_SIMEND )
 	{
-		f->printf( "DEATH %ld\n", e.a->Number() );
-		f->flush();
+		lock_guard<mutex> lock( _mutex );
+
+		if( _delta )
+			_delta->death( e.a->Number() );
+		else
+			f->printf( "DEATH %ld\n", e.a->Number() );
 	}
 }
 
 //---------------------------------------------------------------------------
 // Logs::PopulationGeneticsLog::processEvent
+//
+// Births and deaths are only flushed here, once per step.
 //---------------------------------------------------------------------------
 void Logs::PopulationGeneticsLog::processEvent( const sim::StepEndEvent &e )
 {
-	f->printf( "STEP %ld\n", getStep() );
-	f->flush();
+	if( _delta )
+	{
+		_delta->step( getStep() );
+	}
+	else
+	{
+		f->printf( "STEP %ld\n", getStep() );
+		f->flush();
+	}
 }
 
 
@@ -1972,6 +2127,26 @@ void Logs::SeparationLog::init( TSimulation *sim, Document *doc )
 
 
 		createWriter( "run/genome/separations.txt", false, false );
+
+		_writer = thread( [this]() { writeTables(); } );
+	}
+}
+
+//---------------------------------------------------------------------------
+// Logs::SeparationLog::~SeparationLog
+//---------------------------------------------------------------------------
+Logs::SeparationLog::~SeparationLog()
+{
+	if( _writer.joinable() )
+	{
+		{
+			lock_guard<mutex> lock( _pendingMutex );
+			_closing = true;
+		}
+		_pendingCond.notify_one();
+
+		// Flushes the remaining tables before ~DataLibLogger closes the file.
+		_writer.join();
 	}
 }
 
@@ -2007,40 +2182,26 @@ void Logs::SeparationLog::processEvent( const sim::AgentDeathEvent &death )
 
 	if( entries.size() > 0 )
 	{
-		char buf[16];
-		sprintf( buf, "%ld", death.a->Number() );
-
-		static const char *colnames[] =
-			{
-				"Agent",
-				"Separation",
-				NULL
-			};
-
-		static const datalib::Type coltypes[] =
-			{
-				datalib::INT,
-				datalib::FLOAT
-			};
-
-		DataLibWriter *writer = getWriter();
+		// Take the entries out of the cache, which frees the (now empty) map
+		// once the logs have seen the death.
+		SeparationCache::AgentEntries *table = new SeparationCache::AgentEntries();
+		table->swap( entries );
 
-		writer->beginTable( buf,
-							colnames,
-							coltypes );
-
-
-		itfor( SeparationCache::AgentEntries, entries, it )
 		{
-			writer->addRow( it->first, it->second );
+			lock_guard<mutex> lock( _pendingMutex );
+			_pending.push_back( make_pair(death.a->Number(), table) );
 		}
-
-		writer->endTable();
+		_pendingCond.notify_one();
 	}
 }
 
 //---------------------------------------------------------------------------
 // Logs::SeparationLog::processEvent
+//
+// The separation of every newborn to every agent alive, as one block: each
+// agent's entries are filled in by one thread, so the cache needs no lock.
+// Agent numbers only increase, so of any (agent, newborn) pair the agent
+// has the lower number and owns the entry, as in createEntry().
 //---------------------------------------------------------------------------
 void Logs::SeparationLog::processEvent( const sim::StepEndEvent &e )
 {
@@ -2048,21 +2209,87 @@ void Logs::SeparationLog::processEvent( const sim::StepEndEvent &e )
 
 	if( !_births.empty() )
 	{
-		itfor( list<agent *>, _births, it )
-		{
-			agent *a_born = *it;
+		sort( _births.begin(), _births.end(),
+			  []( agent *x, agent *y ) { return x->Number() < y->Number(); } );
 
-			xfor( AGENTTYPE, agent, a_other )
+		const vector<agent *> &agents = AgentRegistry::getAgents();
+		const vector<agent *> &births = _births;
+
+		_simulation->getScheduler().execParallelFor( agents.size(), [&agents, &births]( int begin, int end )
+		{
+			for( int i = begin; i < end; i++ )
 			{
-				if( a_born != a_other )
-					SeparationCache::createEntry( a_born, a_other );
+				agent *a = agents[i];
+				long number = a->Number();
+				SeparationCache::AgentEntries &entries = SeparationCache::getEntries( a );
+
+				// Births are in ascending order, so entries are appended in key order.
+				vector<agent *>::const_iterator it = upper_bound( births.begin(), births.end(), number,
+																  []( long n, agent *b ) { return n < b->Number(); } );
+				for( ; it != births.end(); ++it )
+				{
+					agent *b = *it;
+					entries.emplace_hint( entries.end(), b->Number(), a->Genes()->separation(b->Genes()) );
+				}
 			}
-		}
+		} );
 
 		_births.clear();
 	}
 }
 
+//---------------------------------------------------------------------------
+// Logs::SeparationLog::writeTables
+//
+// Body of the writer thread.
+//---------------------------------------------------------------------------
+void Logs::SeparationLog::writeTables()
+{
+	static const char *colnames[] =
+		{
+			"Agent",
+			"Separation",
+			NULL
+		};
+
+	static const datalib::Type coltypes[] =
+		{
+			datalib::INT,
+			datalib::FLOAT
+		};
+
+	DataLibWriter *writer = getWriter();
+
+	while( true )
+	{
+		PendingTable table;
+		{
+			unique_lock<mutex> lock( _pendingMutex );
+			_pendingCond.wait( lock, [this]() { return _closing || !_pending.empty(); } );
+			if( _pending.empty() )
+				break;
+			table = _pending.front();
+			_pending.pop_front();
+		}
+
+		char buf[16];
+		sprintf( buf, "%ld", table.first );
+
+		writer->beginTable( buf,
+							colnames,
+							coltypes );
+
+		itfor( SeparationCache::AgentEntries, *table.second, it )
+		{
+			writer->addRow( it->first, it->second );
+		}
+
+		writer->endTable();
+
+		delete table.second;
+	}
+}
+
 
 //===========================================================================
 // SynapseLog
@@ -1,11 +1,19 @@
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <list>
 #include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "Logger.h"
+#include "brain/BrainFunctionFormat.h"
 #include "environment/Energy.h"
+#include "genome/GenomeDelta.h"
+#include "genome/SeparationCache.h"
 #include "proplib/cppprops.h"
+#include "sim/StepProfiler.h"
 #include "utils/misc.h"
 #include "sim/simconst.h"
 
@@ -63,6 +71,7 @@ class Logs
 			LoggerList &loggers = _eventRegistry[ e.getType() ];
 			itfor( LoggerList, loggers, it )
 			{
+				StepProfiler::Timer timer( (*it)->_profilerPhase );
 				(*it)->processEvent( e );
 			}
 		}
@@ -96,6 +105,9 @@ class Logs
 		virtual void processEvent( const sim::AgentBirthEvent &e );
 		virtual void processEvent( const sim::StepEndEvent &e );
 		virtual void processEvent( const sim::AgentDeathEvent &e );
+
+	private:
+		typedef datalib::TypedTable<int, float, float> Table;
 	} _agentEnergy;
 
 	//===========================================================================
@@ -129,6 +141,9 @@ class Logs
 			CenterOfMass
 		} _mode;
 
+		typedef datalib::TypedTable<int, float, float, float> PreciseTable;
+		typedef datalib::TypedTable<int, float, float> ApproximateTable;
+
 		void recordCenterOfMass();
 
 	} _agentPosition;
@@ -142,6 +157,7 @@ class Logs
 		virtual void init( class TSimulation *sim, proplib::Document *doc );
 		virtual void processEvent( const sim::AgentBirthEvent &birth );
 		virtual void processEvent( const sim::AgentDeathEvent &death );
+		virtual void processEvent( const sim::SimEndEvent &e );
 
 	} _birthsDeaths;
 
@@ -208,12 +224,27 @@ class Logs
 		virtual void processEvent( const sim::SimEndEvent &e );
 
 	private:
+		// An agent's file and what goes in it, kept as the agent's state.
+		struct Recording
+		{
+			class AbstractFile *file;
+			BrainFunctionFormat format;
+		};
+
 		void recordEpochFittest( long step, sim::FitnessScope scope, const char *scopeName );
+		BrainFunctionFormat getFormat( class agent *a );
+		void deleteRecording( class agent *a );
 
 		bool _recordRecent;
 		bool _recordBestRecent;
 		bool _recordBestSoFar;
 		int _nseeds;
+		BrainFunctionFormat::Encoding _encoding;
+		int _stride;
+		long _maxSteps;
+		bool _recordInputNeurons;
+		bool _recordOutputNeurons;
+		bool _recordInternalNeurons;
 
 	} _brainFunction;
 
@@ -237,6 +268,8 @@ class Logs
 		virtual void init( class TSimulation *sim, proplib::Document *doc );
 		virtual void processEvent( const sim::CollisionEvent &e );
 
+	private:
+		datalib::TypedTable<int, int, const char *> _table;
 	} _collision;
 
 	//===========================================================================
@@ -250,6 +283,7 @@ class Logs
 	private:
 		void encode( const sim::AgentContactEndEvent::AgentInfo &info, char **buf );
 
+		datalib::TypedTable<int, int, int, const char *> _table;
 	} _contact;
 
 	//===========================================================================
@@ -389,6 +423,8 @@ class Logs
 
 	private:
 		AbstractFile *f;
+		genome::GenomeDeltaWriter *_delta;
+		std::mutex _mutex;
 	} _populationGenetics;
 
 	//===========================================================================
@@ -396,6 +432,9 @@ class Logs
 	//===========================================================================
 	class SeparationLog : public DataLibLogger
 	{
+	public:
+		virtual ~SeparationLog();
+
 	protected:
 		virtual void init( class TSimulation *sim, proplib::Document *doc );
 		virtual void processEvent( const sim::AgentBirthEvent &birth );
@@ -404,8 +443,18 @@ class Logs
 		virtual void processEvent( const sim::StepEndEvent &e );
 
 	private:
+		void writeTables();
+
 		enum { Contact, All } _mode;
-		std::list<class agent *> _births;
+		std::vector<class agent *> _births;
+
+		// Tables of dead agents, written by _writer in order of death.
+		typedef std::pair<long, SeparationCache::AgentEntries *> PendingTable;
+		std::deque<PendingTable> _pending;
+		std::mutex _pendingMutex;
+		std::condition_variable _pendingCond;
+		bool _closing = false;
+		std::thread _writer;
 	} _separation;
 
 	//===========================================================================
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+
+//===========================================================================
+// FarmMetrics
+//
+// Fixed layout of the metrics file FarmMonitor keeps mapped and rewrites in
+// place, so farm scripts can poll a run's progress without the simulation
+// starting any processes. Readers (scripts/farm/__pwfarm_metrics.py) must
+// be updated along with this struct.
+//
+// The writer bumps sequence to an odd value before an update and back to
+// an even value after it. A reader copies the struct and retries if the
+// sequence was odd or changed during the copy.
+//
+// All fields are native byte order.
+//===========================================================================
+struct FarmMetrics
+{
+	static const uint32_t VERSION = 1;
+	static const int MAX_PROPERTIES = 16;
+	static const int MAX_STRING = 32;	// including the terminating NUL
+
+	char magic[8];		// "PWMETRIC"
+	uint32_t version;
+	uint32_t nproperties;
+	uint64_t sequence;
+	int64_t step;
+	int64_t maxSteps;
+	int32_t population;
+	int32_t pid;
+	float maxFitness;
+	float currentMaxFitness;
+	float averageFitness;
+	float reserved;
+
+	struct Property
+	{
+		char title[MAX_STRING];
+		char value[MAX_STRING];
+	} properties[MAX_PROPERTIES];
+};
+
+static_assert( sizeof(FarmMetrics) == 64 + FarmMetrics::MAX_PROPERTIES * 2 * FarmMetrics::MAX_STRING,
+			   "FarmMetrics layout changed; update its readers" );
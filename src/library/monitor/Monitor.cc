@@ -1,10 +1,17 @@
 #include "Monitor.h"
 
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
 #include <iostream>
 #include <sstream>
 
 #include "AgentTracker.h"
 #include "CameraController.h"
+#include "FarmMetrics.h"
 #include "MovieController.h"
 #include "SceneRenderer.h"
 #include "sim/Simulation.h"
@@ -57,6 +64,11 @@ TSimulation *Monitor::getSimulation()
 	return sim;
 }
 
+bool Monitor::isSampleStep( long timestep )
+{
+	return true;
+}
+
 void Monitor::dump( ostream &out )
 {
 }
@@ -65,15 +77,22 @@ void Monitor::dump( ostream &out )
 // ChartMonitor
 //===========================================================================
 ChartMonitor::ChartMonitor( TSimulation *_sim,
+							int _frequency,
 							string _id,
 							string _name,
 							string _title )
 	: Monitor(CHART, _sim, _id, _name, _title)
+	, frequency(_frequency)
 {
 }
 
 ChartMonitor::~ChartMonitor() {}
 
+bool ChartMonitor::isSampleStep( long timestep )
+{
+	return (curveUpdated.receivers() > 0) && (timestep % frequency == 0);
+}
+
 void ChartMonitor::defineCurve( float rmin, float rmax, float r, float g, float b)
 {
 	CurveDef c;
@@ -86,8 +105,8 @@ void ChartMonitor::defineCurve( float rmin, float rmax, float r, float g, float
 //===========================================================================
 // BirthRateMonitor
 //===========================================================================
-BirthRateMonitor::BirthRateMonitor( TSimulation *_sim )
-	: ChartMonitor(_sim, "birthrate", "Birth Rate", "born / (born + created)")
+BirthRateMonitor::BirthRateMonitor( TSimulation *_sim, int _frequency )
+	: ChartMonitor(_sim, _frequency, "birthrate", "Birth Rate", "born / (born + created)")
 	, prevBorn(0),
 	prevCreated(0)
 {
@@ -126,8 +145,8 @@ void BirthRateMonitor::step( long timestep )
 //===========================================================================
 // FitnessMonitor
 //===========================================================================
-FitnessMonitor::FitnessMonitor( TSimulation *_sim )
-	: ChartMonitor(_sim, "fitness", "Fitness", "maxfit, curmaxfit, avgfit")
+FitnessMonitor::FitnessMonitor( TSimulation *_sim, int _frequency )
+	: ChartMonitor(_sim, _frequency, "fitness", "Fitness", "maxfit, curmaxfit, avgfit")
 {
 	defineCurve( 0.0, 1.0,
 				 1.0, 1.0, 1.0 );
@@ -151,8 +170,8 @@ void FitnessMonitor::step( long timestep )
 //===========================================================================
 // FoodEnergyMonitor
 //===========================================================================
-FoodEnergyMonitor::FoodEnergyMonitor( TSimulation *_sim )
-	: ChartMonitor(_sim, "foodenergy", "Food Energy", "energy in, total, avg")
+FoodEnergyMonitor::FoodEnergyMonitor( TSimulation *_sim, int _frequency )
+	: ChartMonitor(_sim, _frequency, "foodenergy", "Food Energy", "energy in, total, avg")
 {
 	defineCurve( -1.0, 1.0 );
 	defineCurve( -1.0, 1.0 );
@@ -181,8 +200,8 @@ void FoodEnergyMonitor::updateCurve( int curve, FoodEnergyStatScope scope )
 //===========================================================================
 // PopulationMonitor
 //===========================================================================
-PopulationMonitor::PopulationMonitor( TSimulation *_sim )
-	: ChartMonitor(_sim, "population", "Population", "Population")
+PopulationMonitor::PopulationMonitor( TSimulation *_sim, int _frequency )
+	: ChartMonitor(_sim, _frequency, "population", "Population", "Population")
 {
 	float colors[][3] =
 		{
@@ -232,10 +251,14 @@ AgentTracker *BrainMonitor::getTracker()
 	return tracker;
 }
 
+bool BrainMonitor::isSampleStep( long timestep )
+{
+	return ((timestep % frequency) == 0) && (update.receivers() > 0);
+}
+
 void BrainMonitor::step( long timestep )
 {
-	if( (timestep % frequency) == 0 )
-		update();
+	update();
 }
 
 //===========================================================================
@@ -267,66 +290,99 @@ StatusTextMonitor::StatusTextMonitor( TSimulation *_sim,
 	, frequencyDisplay( _frequencyDisplay )
 	, frequencyStore( _frequencyStore )
 	, storePerformance( _storePerformance )
+	, statusTextValid( false )
+{
+}
+
+StatusTextMonitor::~StatusTextMonitor()
 {
+	clearStatusText();
+}
+
+const StatusSnapshot &StatusTextMonitor::getStatus()
+{
+	return status;
 }
 
 StatusText &StatusTextMonitor::getStatusText()
 {
+	if( !statusTextValid && (status.step >= 0) )
+	{
+		clearStatusText();
+		formatStatusText( status, statusText );
+		statusTextValid = true;
+	}
+
 	return statusText;
 }
 
-void StatusTextMonitor::step( long timestep )
+bool StatusTextMonitor::isDisplayStep( long timestep )
 {
-	bool doDisplay =
-		((timestep == 1) || (timestep % frequencyDisplay == 0))
+	return ((timestep == 1) || (timestep % frequencyDisplay == 0))
 		&& (update.receivers() > 0);
-	bool doStore =
-		((timestep == 1) || (timestep % frequencyStore == 0));
+}
+
+bool StatusTextMonitor::isStoreStep( long timestep )
+{
+	return (timestep == 1) || (timestep % frequencyStore == 0);
+}
+
+bool StatusTextMonitor::isSampleStep( long timestep )
+{
+	return isDisplayStep( timestep ) || isStoreStep( timestep );
+}
 
-	if( doDisplay || doStore )
+void StatusTextMonitor::clearStatusText()
+{
+	itfor( StatusText, statusText, it )
 	{
-		itfor( StatusText, statusText, it )
-		{
-			free( *it );
-		}
-		statusText.clear();
+		free( *it );
+	}
+	statusText.clear();
+}
 
-		getSimulation()->getStatusText( statusText, frequencyStore );
+void StatusTextMonitor::step( long timestep )
+{
+	// The text is only formatted if a view, or the store, asks for it.
+	getSimulation()->getStatus( status, frequencyStore );
+	statusTextValid = false;
 
-		if( doDisplay )
-		{
-			update();
-		}
+	if( isDisplayStep(timestep) )
+	{
+		update();
+	}
 
-		if( doStore )
-		{
-			char statusFileName[256];
-		
-			sprintf( statusFileName, "run/stats/stat.%ld", timestep );
-			makeParentDir( statusFileName );
+	if( isStoreStep(timestep) )
+	{
+		char statusFileName[256];
 
-			FILE *statusFile = fopen( statusFileName, "w" );
-			ERRIF( statusFile == nullptr, "Failed opening %s", statusFileName );
+		sprintf( statusFileName, "run/stats/stat.%ld", timestep );
+		makeParentDir( statusFileName );
 
-			StatusText::const_iterator iter = statusText.begin();
-			for( ; iter != statusText.end(); ++iter )
-			{
-				// filter out performance stats
-				if( storePerformance || (0 != strncmp( *iter, "Rate", 4 )) )
-					fprintf( statusFile, "%s\n", *iter );
-			}
+		FILE *statusFile = fopen( statusFileName, "w" );
+		ERRIF( statusFile == nullptr, "Failed opening %s", statusFileName );
 
-			fclose( statusFile );
+		StatusText &statusText = getStatusText();
+		StatusText::const_iterator iter = statusText.begin();
+		for( ; iter != statusText.end(); ++iter )
+		{
+			// filter out performance stats
+			if( storePerformance || (0 != strncmp( *iter, "Rate", 4 )) )
+				fprintf( statusFile, "%s\n", *iter );
 		}
+
+		fclose( statusFile );
 	}
 }
 
 //===========================================================================
 // FarmMonitor
 //===========================================================================
+// The farm scripts name the metrics file through PWFARM_METRICS and poll
+// it; see FarmMetrics.h.
 bool FarmMonitor::isFarmEnv()
 {
-	return getenv("PWFARM_STATUS") != NULL;
+	return getenv("PWFARM_METRICS") != NULL;
 }
 
 FarmMonitor::FarmMonitor( TSimulation *sim,
@@ -335,6 +391,7 @@ FarmMonitor::FarmMonitor( TSimulation *sim,
 : Monitor(FARM, sim, "farm", "Farm", "Farm")
 , _frequency( frequency )
 , _properties( properties )
+, _metrics( NULL )
 {
 	int nmetadata;
 	proplib::CppProperties::PropertyMetadata *metadata;
@@ -351,37 +408,83 @@ FarmMonitor::FarmMonitor( TSimulation *sim,
 			}
 		}
 	}
-}
 
-void FarmMonitor::step( long timestep )
-{
-	if( (timestep == 1) || (timestep % _frequency == 0) )
+	const char *path = getenv( "PWFARM_METRICS" );
+	int fd = open( path, O_RDWR | O_CREAT | O_TRUNC, 0644 );
+	if( (fd < 0) || (ftruncate(fd, sizeof(FarmMetrics)) != 0) )
 	{
-		stringstream cmd;
+		cerr << "Failed creating farm metrics file " << path << endl;
+		if( fd >= 0 ) close( fd );
+		return;
+	}
+	void *addr = mmap( NULL, sizeof(FarmMetrics), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	close( fd );
+	if( addr == MAP_FAILED )
+	{
+		cerr << "Failed mapping farm metrics file " << path << endl;
+		return;
+	}
 
-		cmd << "bash -c 'PWFARM_STATUS Polyworld \"[";
+	_metrics = (FarmMetrics *)addr;
+	memset( _metrics, 0, sizeof(FarmMetrics) );
+	_metrics->version = FarmMetrics::VERSION;
+	_metrics->maxSteps = sim->GetMaxSteps();
+	_metrics->pid = getpid();
 
-		bool first = true;
-		itfor( vector<Property>, _properties, it )
+	int nproperties = 0;
+	itfor( vector<Property>, _properties, it )
+	{
+		if( it->metadata && (nproperties < FarmMetrics::MAX_PROPERTIES) )
 		{
-			if( it->metadata )
-			{
-				if( !first )
-				{
-					cmd << " ";
-				}
-				else
-					first = false;
-
-				cmd << it->title << "=" << it->metadata->toString();
-			}
+			strncpy( _metrics->properties[nproperties].title, it->title.c_str(), FarmMetrics::MAX_STRING - 1 );
+			nproperties++;
 		}
+	}
+	_metrics->nproperties = nproperties;
+
+	// Readers ignore the file until the magic is in place.
+	atomic_thread_fence( memory_order_release );
+	memcpy( _metrics->magic, "PWMETRIC", sizeof(_metrics->magic) );
+}
+
+FarmMonitor::~FarmMonitor()
+{
+	if( _metrics )
+		munmap( _metrics, sizeof(FarmMetrics) );
+}
+
+bool FarmMonitor::isSampleStep( long timestep )
+{
+	return _metrics && ((timestep == 1) || (timestep % _frequency == 0));
+}
 
-		cmd << "]\"'";
+void FarmMonitor::step( long timestep )
+{
+	volatile uint64_t &sequence = _metrics->sequence;
+
+	sequence = sequence + 1;
+	atomic_thread_fence( memory_order_release );
 
-		int rc = system( cmd.str().c_str() );
-		if( rc ) cerr << "Failed executing PWFARM_STATUS" << endl;
+	_metrics->step = timestep;
+	_metrics->population = sim->getNumAgents();
+	_metrics->maxFitness = sim->getFitnessStat( FST__MAX_FITNESS );
+	_metrics->currentMaxFitness = sim->getFitnessStat( FST__CURRENT_MAX_FITNESS );
+	_metrics->averageFitness = sim->getFitnessStat( FST__AVERAGE_FITNESS );
+
+	int iproperty = 0;
+	itfor( vector<Property>, _properties, it )
+	{
+		if( it->metadata && (iproperty < FarmMetrics::MAX_PROPERTIES) )
+		{
+			char *value = _metrics->properties[iproperty].value;
+			strncpy( value, it->metadata->toString(), FarmMetrics::MAX_STRING - 1 );
+			value[FarmMetrics::MAX_STRING - 1] = 0;
+			iproperty++;
+		}
 	}
+
+	atomic_thread_fence( memory_order_release );
+	sequence = sequence + 1;
 }
 
 //===========================================================================
@@ -8,6 +8,7 @@
 #include "proplib/proplib.h"
 #include "sim/simconst.h"
 #include "sim/simtypes.h"
+#include "sim/StatusSnapshot.h"
 #include "utils/datalib.h"
 #include "utils/Signal.h"
 
@@ -41,6 +42,10 @@ class Monitor
 	const char *getTitle();
 	class TSimulation *getSimulation();
 
+	// False if step() would have nothing to do, in which case the manager
+	// doesn't call it. Monitors sample at their own frequency, and those
+	// feeding a view go idle while nothing is connected.
+	virtual bool isSampleStep( long timestep );
 	virtual void step( long timestep ) = 0;
 
 	virtual void dump( std::ostream &out );
@@ -77,8 +82,11 @@ class ChartMonitor : public Monitor
     // (short curve, float data)
     util::Signal<short, float> curveUpdated;
 
+	virtual bool isSampleStep( long timestep );
+
  protected:
 	ChartMonitor( class TSimulation *_sim,
+				  int _frequency,
 				  std::string _id,
 				  std::string _name,
 				  std::string _title );
@@ -86,6 +94,7 @@ class ChartMonitor : public Monitor
 	void defineCurve( float rmin, float rmax, float r = -1, float g = -1, float b = -1);
 
  private:
+	int frequency;
 	CurveDefs curves;
 };
 
@@ -95,7 +104,7 @@ class ChartMonitor : public Monitor
 class BirthRateMonitor : public ChartMonitor
 {
  public:
-	BirthRateMonitor( class TSimulation *_sim );
+	BirthRateMonitor( class TSimulation *_sim, int _frequency );
 	virtual ~BirthRateMonitor();
 
 	virtual void step( long timestep );
@@ -112,7 +121,7 @@ class BirthRateMonitor : public ChartMonitor
 class FitnessMonitor : public ChartMonitor
 {
  public:
-	FitnessMonitor( class TSimulation *_sim );
+	FitnessMonitor( class TSimulation *_sim, int _frequency );
 	virtual ~FitnessMonitor();
 
 	virtual void step( long timestep );
@@ -124,7 +133,7 @@ class FitnessMonitor : public ChartMonitor
 class FoodEnergyMonitor : public ChartMonitor
 {
  public:
-	FoodEnergyMonitor( class TSimulation *_sim );
+	FoodEnergyMonitor( class TSimulation *_sim, int _frequency );
 	virtual ~FoodEnergyMonitor();
 
 	virtual void step( long timestep );
@@ -138,7 +147,7 @@ class FoodEnergyMonitor : public ChartMonitor
 class PopulationMonitor : public ChartMonitor
 {
  public:
-	PopulationMonitor( class TSimulation *_sim );
+	PopulationMonitor( class TSimulation *_sim, int _frequency );
 	virtual ~PopulationMonitor();
 
 	virtual void step( long timestep );
@@ -154,6 +163,7 @@ class BrainMonitor : public Monitor
 
 	class AgentTracker *getTracker();
 
+	virtual bool isSampleStep( long timestep );
 	virtual void step( long timestep );
 
     util::Signal<> update;
@@ -187,17 +197,27 @@ class StatusTextMonitor : public Monitor
 					   int frequencyStore,
 					   bool storePerformance );
 
+	virtual ~StatusTextMonitor();
+
+	const sim::StatusSnapshot &getStatus();
 	sim::StatusText &getStatusText();
 
+	virtual bool isSampleStep( long timestep );
 	virtual void step( long timestep );
 
     util::Signal<> update;
 
  private:
-	sim::StatusText statusText;
+	bool isDisplayStep( long timestep );
+	bool isStoreStep( long timestep );
+	void clearStatusText();
+
+	sim::StatusSnapshot status;
+	sim::StatusText statusText;	// formatted from status on demand
 	int frequencyDisplay;
 	int frequencyStore;
 	bool storePerformance;
+	bool statusTextValid;
 };
 
 //===========================================================================
@@ -221,12 +241,15 @@ class FarmMonitor : public Monitor
 	FarmMonitor( class TSimulation *sim,
 				 int frequency,
 				 const std::vector<Property> &properties );
+	virtual ~FarmMonitor();
 
+	virtual bool isSampleStep( long timestep );
 	virtual void step( long timestep );
 
  private:
 	int _frequency;
 	std::vector<Property> _properties;
+	struct FarmMetrics *_metrics;
 };
 
 //===========================================================================
@@ -35,19 +35,19 @@ MonitorManager::MonitorManager( TSimulation *_simulation,
 	// ---
 	if( (bool)doc.get("BirthRate").get("Enabled") )
 	{
-		addMonitor( new BirthRateMonitor(simulation) );
+		addMonitor( new BirthRateMonitor(simulation, doc.get("BirthRate").get("Frequency")) );
 	}
 	if( (bool)doc.get("Fitness").get("Enabled") )
 	{
-		addMonitor( new FitnessMonitor(simulation) );
+		addMonitor( new FitnessMonitor(simulation, doc.get("Fitness").get("Frequency")) );
 	}
 	if( (bool)doc.get("FoodEnergy").get("Enabled") )
 	{
-		addMonitor( new FoodEnergyMonitor(simulation) );
+		addMonitor( new FoodEnergyMonitor(simulation, doc.get("FoodEnergy").get("Frequency")) );
 	}
 	if( (bool)doc.get("Population").get("Enabled") )
 	{
-		addMonitor( new PopulationMonitor(simulation) );
+		addMonitor( new PopulationMonitor(simulation, doc.get("Population").get("Frequency")) );
 	}
 
 	// ---
@@ -371,9 +371,14 @@ void MonitorManager::step()
 		}
 	}
 
+	long step = simulation->getStep();
+
 	itfor( Monitors, monitors, it )
 	{
-		(*it)->step( simulation->getStep() );
+		Monitor *monitor = *it;
+
+		if( monitor->isSampleStep(step) )
+			monitor->step( step );
 	}
 }
 
@@ -0,0 +1,219 @@
+#include "cache.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "interpreter.h"
+#include "utils/misc.h"
+
+using namespace std;
+using namespace proplib;
+
+#define CACHEDIR PWHOME "/.bld/proplib-cache"
+#define CACHE_MAX_ENTRIES 256
+#define MAGIC "PWDC"
+#define VERSION 1
+
+// ----------------------------------------------------------------------
+// ----------------------------------------------------------------------
+// --- CLASS DocumentCache
+// ----------------------------------------------------------------------
+// ----------------------------------------------------------------------
+DocumentCache::DocumentCache()
+: _loaded( false )
+, _dirty( false )
+{
+	unsigned int version = VERSION;
+	_hash = hash64( &version, sizeof(version) );
+}
+
+DocumentCache::~DocumentCache()
+{
+	if( _loaded )
+	{
+		if( _dirty )
+			save();
+
+		Interpreter::cache = NULL;
+	}
+
+	if( getenv("PW_PROPLIB_TIMING") )
+		Timing::print();
+}
+
+void DocumentCache::addFile( const string &path )
+{
+	REQUIRE( !_loaded );
+
+	ifstream in( path.c_str() );
+	stringstream content;
+	content << in.rdbuf();
+
+	addString( content.str() );
+}
+
+void DocumentCache::addParameters( const ParameterMap &parameters )
+{
+	// ParameterMap is ordered, so the same parameters hash the same.
+	for( ParameterMap::const_iterator it = parameters.begin(); it != parameters.end(); ++it )
+	{
+		addString( it->first );
+		addString( it->second );
+	}
+}
+
+void DocumentCache::addString( const string &value )
+{
+	REQUIRE( !_loaded );
+
+	// Length first, so the boundaries between inputs count too.
+	uint64_t len = value.size();
+	_hash = hash64( &len, sizeof(len), _hash );
+	_hash = hash64( value.c_str(), value.size(), _hash );
+}
+
+void DocumentCache::load()
+{
+	REQUIRE( !_loaded );
+	REQUIRE( Interpreter::cache == NULL );
+
+	_loaded = true;
+	Interpreter::cache = this;
+
+	FILE *f = fopen( getPath().c_str(), "rb" );
+	if( f == NULL )
+		return;
+	touchCacheEntry( getPath() );
+
+	// A file that can't be read is treated as missing, and replaced on save.
+	auto readString = [f]( string &s )
+		{
+			uint32_t len;
+			if( fread(&len, sizeof(len), 1, f) != 1 )
+				return false;
+			s.resize( len );
+			return (len == 0) || (fread(&s[0], 1, len, f) == len);
+		};
+
+	char magic[4];
+	uint32_t version;
+	uint32_t count;
+	if( (fread(magic, sizeof(magic), 1, f) == 1)
+		&& (0 == memcmp(magic, MAGIC, sizeof(magic)))
+		&& (fread(&version, sizeof(version), 1, f) == 1)
+		&& (version == VERSION)
+		&& (fread(&count, sizeof(count), 1, f) == 1) )
+	{
+		for( uint32_t i = 0; i < count; i++ )
+		{
+			string expr;
+			string result;
+			if( !readString(expr) || !readString(result) )
+			{
+				_values.clear();
+				break;
+			}
+			_values[expr] = result;
+		}
+	}
+
+	fclose( f );
+}
+
+bool DocumentCache::lookup( const string &expr, string &result )
+{
+	map<string, string>::iterator it = _values.find( expr );
+	if( it == _values.end() )
+		return false;
+
+	result = it->second;
+	return true;
+}
+
+void DocumentCache::insert( const string &expr, const string &result )
+{
+	_values[expr] = result;
+	_dirty = true;
+}
+
+string DocumentCache::getPath()
+{
+	char name[32];
+	sprintf( name, "%016llx", _hash );
+
+	return string( CACHEDIR "/" ) + name;
+}
+
+void DocumentCache::save()
+{
+	string path = getPath();
+
+	// Through a rename, so concurrent runs never load a partial file.
+	char tmp[32];
+	sprintf( tmp, ".%d", (int)getpid() );
+	string pathTmp = path + tmp;
+
+	makeParentDir( path );
+	FILE *f = fopen( pathTmp.c_str(), "wb" );
+	if( f == NULL )
+	{
+		// Only a cache, so not worth failing the run over.
+		perror( pathTmp.c_str() );
+		return;
+	}
+
+	auto writeString = [f]( const string &s )
+		{
+			uint32_t len = s.size();
+			fwrite( &len, sizeof(len), 1, f );
+			fwrite( s.c_str(), 1, len, f );
+		};
+
+	uint32_t version = VERSION;
+	uint32_t count = _values.size();
+	fwrite( MAGIC, 4, 1, f );
+	fwrite( &version, sizeof(version), 1, f );
+	fwrite( &count, sizeof(count), 1, f );
+	for( map<string, string>::iterator it = _values.begin(); it != _values.end(); ++it )
+	{
+		writeString( it->first );
+		writeString( it->second );
+	}
+
+	if( (fclose(f) != 0) || (rename(pathTmp.c_str(), path.c_str()) != 0) )
+	{
+		perror( path.c_str() );
+		unlink( pathTmp.c_str() );
+		return;
+	}
+
+	_dirty = false;
+
+	pruneCacheDir( CACHEDIR, CACHE_MAX_ENTRIES );
+}
+
+
+// ----------------------------------------------------------------------
+// ----------------------------------------------------------------------
+// --- CLASS Timing
+// ----------------------------------------------------------------------
+// ----------------------------------------------------------------------
+double Timing::parse = 0;
+double Timing::validate = 0;
+double Timing::evaluate = 0;
+long Timing::evaluations = 0;
+long Timing::cached = 0;
+
+void Timing::print()
+{
+	fprintf( stderr,
+			 "proplib: parse %.3fs, validate %.3fs, evaluate %.3fs (%ld evaluations, %ld cached)\n",
+			 parse, validate, evaluate, evaluations, cached );
+}
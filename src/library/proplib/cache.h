@@ -0,0 +1,71 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "editor.h"
+
+namespace proplib
+{
+	// ----------------------------------------------------------------------
+	// ----------------------------------------------------------------------
+	// --- CLASS DocumentCache
+	// ---
+	// --- The resolved values of every expression evaluated while a document
+	// --- is built, converted, overlaid and validated, saved under a hash of
+	// --- the schema, document and parameters that determine it. While one
+	// --- is loaded, Interpreter answers from it before asking Python, so a
+	// --- second run over the same inputs doesn't start Python at all.
+	// ---
+	// --- Values are keyed by the Python code they came from, with symbols
+	// --- already replaced by their values, so an entry can't be stale even
+	// --- where the document was edited after the value was first read.
+	// ----------------------------------------------------------------------
+	// ----------------------------------------------------------------------
+	class DocumentCache
+	{
+	public:
+		DocumentCache();
+		// Saves any values resolved since load().
+		~DocumentCache();
+
+		// The inputs, added before load().
+		void addFile( const std::string &path );
+		void addParameters( const ParameterMap &parameters );
+		void addString( const std::string &value );
+
+		void load();
+
+		bool lookup( const std::string &expr, std::string &result );
+		void insert( const std::string &expr, const std::string &result );
+
+	private:
+		std::string getPath();
+		void save();
+
+		unsigned long long _hash;
+		std::map<std::string, std::string> _values;
+		bool _loaded;
+		bool _dirty;
+	};
+
+	// ----------------------------------------------------------------------
+	// ----------------------------------------------------------------------
+	// --- CLASS Timing
+	// ---
+	// --- Where the time building documents goes. Printed to stderr when a
+	// --- DocumentCache is destroyed, if PW_PROPLIB_TIMING is set.
+	// ----------------------------------------------------------------------
+	// ----------------------------------------------------------------------
+	class Timing
+	{
+	public:
+		static double parse;		// Parser::parseDocument
+		static double validate;		// SchemaDocument::apply, less evaluation
+		static double evaluate;		// Interpreter::eval
+		static long evaluations;
+		static long cached;			// evaluations answered by a DocumentCache
+
+		static void print();
+	};
+}
@@ -4,6 +4,8 @@
 #include <dlfcn.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <fstream>
 #include <sstream>
@@ -20,6 +22,8 @@ using namespace std;
 #define GENDIR "run/.cppprops"
 #define GENSRC GENDIR "/generated.cc"
 #define GENLIB GENDIR "/" CPPPROPS_TARGET
+#define CACHEDIR PWHOME "/.bld/cppprops-cache"
+#define CACHE_MAX_ENTRIES 64
 
 #define l(content) out << content << endl
 
@@ -67,7 +71,25 @@ void CppProperties::init( Document *doc, UpdateContext *context )
 
 	generateLibrarySource();
 
-    SYSTEM("cp " PWHOME "/etc/bld/cppprops.mak " GENDIR "/Makefile && export conf=" PWHOME "/Makefile.conf && make -C " GENDIR);
+	// Replicates of a worldfile generate the same source, so they only need
+	// to build it once.
+	string cachedLib = getCachedLibraryPath();
+	if( exists(cachedLib) )
+	{
+		SYSTEM( ("cp " + cachedLib + " " GENLIB).c_str() );
+		touchCacheEntry( dirname(cachedLib) );
+	}
+	else
+	{
+		SYSTEM("cp " PWHOME "/etc/bld/cppprops.mak " GENDIR "/Makefile && export conf=" PWHOME "/Makefile.conf && make -C " GENDIR);
+
+		// Through a rename, so concurrent runs never see a partial library.
+		char tmp[32];
+		sprintf( tmp, ".%d", (int)getpid() );
+		makeParentDir( cachedLib );
+		SYSTEM( ("cp " GENLIB " " + cachedLib + tmp + " && mv -f " + cachedLib + tmp + " " + cachedLib).c_str() );
+		pruneCacheDir( CACHEDIR, CACHE_MAX_ENTRIES );
+	}
 
 	void *libHandle = dlopen( GENLIB, RTLD_LAZY );
 	ERRIF( !libHandle, "Failed opening " GENLIB );
@@ -95,6 +117,39 @@ void CppProperties::getMetadata( PropertyMetadata **metadata, int *count )
 	_getMetadata( metadata, count );
 }
 
+//---------------------------------------------------------------------------
+// CppProperties::getCachedLibraryPath
+//
+// Keyed by the generated source and by the library it was built against,
+// which a rebuild of the library changes.
+//---------------------------------------------------------------------------
+string CppProperties::getCachedLibraryPath()
+{
+	unsigned long long hash;
+	{
+		ifstream in( GENSRC );
+		stringstream source;
+		source << in.rdbuf();
+		string text = source.str();
+		hash = hash64( text.c_str(), text.size() );
+	}
+
+	Dl_info info;
+	struct stat st;
+	if( dladdr((void *)&CppProperties::init, &info) && info.dli_fname && (stat(info.dli_fname, &st) == 0) )
+	{
+		long long mtime = st.st_mtime;
+		long long size = st.st_size;
+		hash = hash64( &mtime, sizeof(mtime), hash );
+		hash = hash64( &size, sizeof(size), hash );
+	}
+
+	char name[32];
+	sprintf( name, "%016llx", hash );
+
+	return string( CACHEDIR "/" ) + name + "/" + CPPPROPS_TARGET;
+}
+
 void CppProperties::generateLibrarySource()
 {
 	CppPropertyList cppProperties;
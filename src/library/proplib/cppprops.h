@@ -81,6 +81,7 @@ namespace proplib
 		typedef std::list<class RuntimeScalarProperty *> RuntimePropertyList;
 		typedef std::map<class Property *, CppPropertyInfo> CppPropertyInfoMap;
 
+		static std::string getCachedLibraryPath();
 		static void generateLibrarySource();
 		static void generateStateStructs( std::ofstream &out, DynamicPropertyList &dynamicProperties );
 		static void generateMetadata( std::ofstream &out,
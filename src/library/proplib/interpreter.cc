@@ -1,14 +1,20 @@
 #include "interpreter.h"
 
 #include <assert.h>
+#include <ctype.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
+#include <sys/wait.h>
 
 #include <sstream>
 
+#include "cache.h"
 #include "dom.h"
 #include "parser.h"
 #include "utils/misc.h"
+#include "utils/PwMovieUtils.h"
 #include "utils/Resources.h"
 
 using namespace std;
@@ -142,6 +148,7 @@ class InterpreterProcess {
 
     int stdinPipe[2];
     int stdoutPipe[2];
+    pid_t pid;
 
     ssize_t write(void const *buf, size_t n) {
         return ::write(stdinPipe[PIPE_WRITE], buf, n);
@@ -155,27 +162,38 @@ class InterpreterProcess {
         REQUIRE( 0 == pipe(stdinPipe) );
         REQUIRE( 0 == pipe(stdoutPipe) );
 
+        // Our ends stay out of every other child (cppprops builds, replicates),
+        // so the interpreter sees EOF and exits whenever this process dies,
+        // including by abort() or err().
+        REQUIRE( -1 != fcntl(stdinPipe[PIPE_WRITE], F_SETFD, FD_CLOEXEC) );
+        REQUIRE( -1 != fcntl(stdoutPipe[PIPE_READ], F_SETFD, FD_CLOEXEC) );
+
         string script_path = Resources::getInterpreterScript();
 
-        if(0 == fork()) {
+        pid = fork();
+        REQUIRE( pid != -1 );
+        if(0 == pid) {
             // child process
 
             // redirect stdin
             REQUIRE( -1 != dup2(stdinPipe[PIPE_READ], STDIN_FILENO) );
             // redirect stdout
             REQUIRE( -1 != dup2(stdoutPipe[PIPE_WRITE], STDOUT_FILENO) );
+            close(stdinPipe[PIPE_READ]);
+            close(stdoutPipe[PIPE_WRITE]);
 
             // run child process image
             execlp("python", "python", script_path.c_str(), NULL);
             PANIC();
         }
+
+        close(stdinPipe[PIPE_READ]);
+        close(stdoutPipe[PIPE_WRITE]);
     }
 
     void closePipes() {
-        close(stdinPipe[PIPE_READ]);
         close(stdinPipe[PIPE_WRITE]);
         close(stdoutPipe[PIPE_READ]);
-        close(stdoutPipe[PIPE_WRITE]);
     }
 
 public:
@@ -186,6 +204,7 @@ public:
     ~InterpreterProcess() {
         write("exit\n", 5);
         closePipes();
+        waitpid(pid, NULL, 0);
     }
 
     bool eval(const std::string &expr,
@@ -219,23 +238,101 @@ public:
 // ----------------------------------------------------------------------
 // ----------------------------------------------------------------------
 
+bool Interpreter::initialized = false;
 InterpreterProcess *Interpreter::process = nullptr;
+DocumentCache *Interpreter::cache = nullptr;
+
+//---------------------------------------------------------------------------
+// evalLiteral
+//
+// Python's str() of the literals most documents are made of, without the
+// round trip: ints, bools and plain strings. Anything else, including
+// floats, whose str() has rules of its own, goes to Python.
+//---------------------------------------------------------------------------
+static bool evalLiteral( const string &expr, string &result )
+{
+	size_t len = expr.length();
+	if( len == 0 )
+		return false;
+
+	if( (expr == "True") || (expr == "False") )
+	{
+		result = expr;
+		return true;
+	}
+
+	if( (len >= 2) && ((expr[0] == '"') || (expr[0] == '\'')) && (expr[len - 1] == expr[0]) )
+	{
+		string body = expr.substr( 1, len - 2 );
+		if( body.find_first_of("\"'\\\n") != string::npos )
+			return false;
+		result = body;
+		return true;
+	}
+
+	size_t digits = (expr[0] == '-') ? 1 : 0;
+	if( (len == digits) || (len - digits > 18) )
+		return false;
+	for( size_t i = digits; i < len; i++ )
+		if( !isdigit(expr[i]) )
+			return false;
+	// No leading zeros, which Python 3 rejects, and no -0, which it prints as 0.
+	if( (expr[digits] == '0') && ((len - digits > 1) || digits) )
+		return false;
+
+	result = expr;
+	return true;
+}
 
 void Interpreter::init()
 {
-	REQUIRE( !process );
-    process = new InterpreterProcess();
+	REQUIRE( !initialized );
+	initialized = true;
 }
 
 void Interpreter::dispose()
 {
-	REQUIRE( process );
-    delete process;
-    process = nullptr;
+	REQUIRE( initialized );
+	initialized = false;
+	if( process )
+	{
+		delete process;
+		process = nullptr;
+	}
 }
 
 bool Interpreter::eval( const std::string &expr,
 						char *result, size_t result_size )
 {
-    return process->eval(expr, result, result_size);
+	REQUIRE( initialized );
+
+	double start = hirestime();
+	Timing::evaluations++;
+
+	string value;
+	bool known = evalLiteral( expr, value );
+	if( !known && cache && cache->lookup(expr, value) )
+	{
+		known = true;
+		Timing::cached++;
+	}
+
+	bool success = true;
+	if( known )
+	{
+		REQUIRE( value.length() < result_size );
+		strcpy( result, value.c_str() );
+	}
+	else
+	{
+		if( !process )
+			process = new InterpreterProcess();
+
+		success = process->eval( expr, result, result_size );
+		if( success && cache )
+			cache->insert( expr, result );
+	}
+
+	Timing::evaluate += hirestime() - start;
+	return success;
 }
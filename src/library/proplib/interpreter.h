@@ -50,9 +50,13 @@ namespace proplib
 
 	private:
 		friend class ExpressionEvaluator;
+		friend class DocumentCache;
 		static bool eval( const std::string &expr,
 						  char *result, size_t result_size );
 
+		static bool initialized;
+		// Started by the first expression that isn't a literal or cached.
         static InterpreterProcess *process;
+		static class DocumentCache *cache;
 	};
 }
@@ -4,7 +4,8 @@ import sys
 
 while True:
 	header = sys.stdin.readline()
-	if header == "exit\n":
+	# EOF: the simulation is gone without saying exit
+	if header == "exit\n" or header == "":
 		break
 
 	assert( header == "<expr>\n" )
@@ -12,6 +13,8 @@ while True:
 	expr = []
 	while True:
 		line = sys.stdin.readline()
+		if line == "":
+			sys.exit()
 		if line == "</expr>\n":
 			break
 		else:
@@ -5,7 +5,9 @@
 
 #include <sstream>
 
+#include "cache.h"
 #include "utils/misc.h"
+#include "utils/PwMovieUtils.h"
 
 using namespace std;
 using namespace proplib;
@@ -478,6 +480,8 @@ void SyntaxNode::dump( ostream &out, string indent )
 
 SyntaxNode *Parser::parseDocument( std::string path, istream *in )
 {
+	double start = hirestime();
+
 	init( path, in );
 
 	next( Token::Bof );
@@ -492,6 +496,8 @@ SyntaxNode *Parser::parseDocument( std::string path, istream *in )
 
 	delete _tokenizer;
 
+	Timing::parse += hirestime() - start;
+
 	return result;
 }
 
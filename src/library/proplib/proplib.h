@@ -1,6 +1,7 @@
 #pragma once
 
 #include "builder.h"
+#include "cache.h"
 #include "dom.h"
 #include "editor.h"
 #include "overlay.h"
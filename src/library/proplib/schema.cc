@@ -6,9 +6,11 @@
 #include <sstream>
 
 #include "builder.h"
+#include "cache.h"
 #include "editor.h"
 #include "overlay.h"
 #include "utils/misc.h"
+#include "utils/PwMovieUtils.h"
 
 using namespace std;
 using namespace proplib;
@@ -52,6 +54,9 @@ void SchemaDocument::init()
 
 void SchemaDocument::apply( Document *doc )
 {
+	double start = hirestime();
+	double evaluateStart = Timing::evaluate;
+
 	parseDefaults( doc );
 
 	if( doc->getp("overlay") )
@@ -63,6 +68,8 @@ void SchemaDocument::apply( Document *doc )
 
 	normalize( *this, *doc );
 	validate( *doc );
+
+	Timing::validate += (hirestime() - start) - (Timing::evaluate - evaluateStart);
 }
 
 void SchemaDocument::makePathDefaults( Document *values, SymbolPath *symbolPath )
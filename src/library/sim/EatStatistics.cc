@@ -22,6 +22,9 @@ void EatStatistics::Init()
 	step.numFailed = 0;
 	step.numFailedYaw = 0;
 	step.numFailedVel = 0;
+	step.numScans = 0;
+	step.foodScanned = 0;
+	step.foodOverlapping = 0;
 	average.numAttemptsList.clear();
 	average.numFailedList.clear();
 	average.numFailedYawList.clear();
@@ -33,6 +36,14 @@ void EatStatistics::Init()
 	average.ratioFailed = numeric_limits<float>::quiet_NaN();
 	average.ratioFailedYaw = numeric_limits<float>::quiet_NaN();
 	average.ratioFailedVel = numeric_limits<float>::quiet_NaN();
+	average.numScansList.clear();
+	average.foodScannedList.clear();
+	average.foodOverlappingList.clear();
+	average.numScans = 0;
+	average.foodScanned = 0;
+	average.foodOverlapping = 0;
+	average.foodScannedPerScan = numeric_limits<float>::quiet_NaN();
+	average.foodOverlappingPerScan = numeric_limits<float>::quiet_NaN();
 }
 
 void EatStatistics::StepBegin()
@@ -41,6 +52,9 @@ void EatStatistics::StepBegin()
 	step.numFailed = 0;
 	step.numFailedYaw = 0;
 	step.numFailedVel = 0;
+	step.numScans = 0;
+	step.foodScanned = 0;
+	step.foodOverlapping = 0;
 }
 
 void EatStatistics::StepEnd()
@@ -91,6 +105,30 @@ void EatStatistics::StepEnd()
 		TRACE( cout << "ratio failed Yaw Avg=" << average.ratioFailedYaw << endl );
 		TRACE( cout << "ratio failed Vel Avg=" << average.ratioFailedVel << endl );
 	} 
+
+	if( step.numScans > 0 )
+	{
+		if( average.numScansList.size() >= EAT_STATS_AVERAGE_STEPS )
+		{
+			average.numScans -= average.numScansList.front();
+			average.foodScanned -= average.foodScannedList.front();
+			average.foodOverlapping -= average.foodOverlappingList.front();
+
+			average.numScansList.pop_front();
+			average.foodScannedList.pop_front();
+			average.foodOverlappingList.pop_front();
+		}
+
+		average.numScansList.push_back( step.numScans );
+		average.foodScannedList.push_back( step.foodScanned );
+		average.foodOverlappingList.push_back( step.foodOverlapping );
+
+		average.numScans += step.numScans;
+		average.foodScanned += step.foodScanned;
+		average.foodOverlapping += step.foodOverlapping;
+		average.foodScannedPerScan = float(average.foodScanned) / average.numScans;
+		average.foodOverlappingPerScan = float(average.foodOverlapping) / average.numScans;
+	}
 }
 
 void EatStatistics::AgentEatAttempt( bool success, bool failedYaw, bool failedVel, bool failedMinAge )
@@ -107,6 +145,15 @@ void EatStatistics::AgentEatAttempt( bool success, bool failedYaw, bool failedVe
 	}
 }
 
+// Called for every Eat(), with the food examined in looking for something to
+// eat, and how many of those overlapped the agent.
+void EatStatistics::AgentEatScan( long foodScanned, long foodOverlapping )
+{
+	step.numScans++;
+	step.foodScanned += foodScanned;
+	step.foodOverlapping += foodOverlapping;
+}
+
 const float *EatStatistics::GetProperty( const string &name )
 {
 	if( name == "EatFailed" )
@@ -121,6 +168,14 @@ const float *EatStatistics::GetProperty( const string &name )
 	{
 		return &average.ratioFailedVel;
 	}
+	else if( name == "EatFoodScanned" )
+	{
+		return &average.foodScannedPerScan;
+	}
+	else if( name == "EatFoodOverlapping" )
+	{
+		return &average.foodOverlappingPerScan;
+	}
 	else
 	{
 		assert( false );
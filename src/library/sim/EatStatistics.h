@@ -10,6 +10,7 @@ class EatStatistics
 	void StepBegin();
 	void StepEnd();
 	void AgentEatAttempt( bool success, bool failedYaw, bool failedVel, bool failedMinAge );
+	void AgentEatScan( long foodScanned, long foodOverlapping );
 
 	const float *GetProperty( const std::string &name );
 
@@ -20,6 +21,9 @@ class EatStatistics
 		long numFailed;
 		long numFailedYaw;
 		long numFailedVel;
+		long numScans;
+		long foodScanned;
+		long foodOverlapping;
 	} step;
 
 	struct Average
@@ -35,5 +39,14 @@ class EatStatistics
 		float ratioFailed;
 		float ratioFailedYaw;
 		float ratioFailedVel;
+
+		std::list<long> numScansList;
+		std::list<long> foodScannedList;
+		std::list<long> foodOverlappingList;
+		long numScans;
+		long foodScanned;
+		long foodOverlapping;
+		float foodScannedPerScan;
+		float foodOverlappingPerScan;
 	} average;
 };
@@ -1,12 +1,26 @@
 #include "FittestList.h"
 
+#include <algorithm>
+
 #include "agent/agent.h"
-#include "genome/GenomeUtil.h"
 
 using namespace genome;
 using namespace std;
 
 
+//---------------------------------------------------------------------------
+// isBetter
+//
+// Strict order, so the ranking never depends on the heap layout.
+//---------------------------------------------------------------------------
+static bool isBetter( const FitStruct *a, const FitStruct *b )
+{
+	if( a->fitness != b->fitness )
+		return a->fitness > b->fitness;
+	return a->sequence < b->sequence;
+}
+
+
 //===========================================================================
 // FittestList
 //===========================================================================
@@ -18,14 +32,12 @@ FittestList::FittestList( int capacity, bool storeGenome )
 : _capacity( capacity )
 , _storeGenome( storeGenome )
 , _size( 0 )
+, _sequence( 0 )
+, _rankedValid( false )
 {
-	_elements = new FitStruct*[ _capacity ];
-	for( int i = 0; i < _capacity; i++ )
-	{
-		FitStruct *element = new FitStruct;
-		element->genes = NULL;
-		_elements[i] = element;
-	}
+	_storage = new FitStruct[ _capacity ];
+	_heap = new FitStruct*[ _capacity ];
+	_ranked = new FitStruct*[ _capacity ];
 
 	clear();
 }
@@ -35,57 +47,42 @@ FittestList::FittestList( int capacity, bool storeGenome )
 //---------------------------------------------------------------------------
 FittestList::~FittestList()
 {
-	for( int i = 0; i < _capacity; i++ )
-	{
-		if( _elements[i]->genes )
-			delete _elements[i]->genes;
-		delete _elements[i];
-	}
-	delete [] _elements;
+	delete [] _ranked;
+	delete [] _heap;
+	delete [] _storage;
 }
 
 //---------------------------------------------------------------------------
 // FittestList::update
 //---------------------------------------------------------------------------
-void FittestList::update( agent *candidate, float fitness )
+void FittestList::update( agent *candidate, float fitness, const GenomeRef &genes )
 {
-	if( !isFull() || (fitness > _elements[_size - 1]->fitness) )
+	if( isFull() && !(fitness > _heap[0]->fitness) )
+		return;
+
+	FitStruct *newElement;
+	if( isFull() )
 	{
-		int rank = -1;
-		for( int i = 0; i < _size; i++ )
-		{
-			if( fitness > _elements[i]->fitness )
-			{
-				rank = i;
-				break;
-			}
-		}
-		if( rank == -1 )
-		{
-			assert( !isFull() );
-			rank = _size;
-		}
-
-		if( !isFull() )
-		{
-			// We're growing the list. We may or may not need to allocate a genome, depending
-			// on whether this list was previously a larger size but then cleared.
-			if( _storeGenome && (_elements[_size]->genes == NULL) )
-				_elements[_size]->genes = GenomeUtil::createGenome();
-			_size++;
-		}
-
-		FitStruct *newElement = _elements[_size-1];
-		for( int i = _size - 1; i > rank; i-- )
-			_elements[i] = _elements[i-1];
-		_elements[rank] = newElement;
-
-		newElement->fitness = fitness;
-		if( _storeGenome )
-			newElement->genes->copyFrom( candidate->Genes() );
-		newElement->agentID = candidate->Number();
-		newElement->complexity = candidate->Complexity();
+		// evict the worst
+		pop_heap( _heap, _heap + _size, isBetter );
+		newElement = _heap[_size - 1];
+	}
+	else
+	{
+		newElement = _storage + _size;
+		_heap[_size] = newElement;
+		_size++;
 	}
+
+	newElement->fitness = fitness;
+	newElement->sequence = _sequence++;
+	if( _storeGenome )
+		newElement->genes = genes;
+	newElement->agentID = candidate->Number();
+	newElement->complexity = candidate->Complexity();
+
+	push_heap( _heap, _heap + _size, isBetter );
+	_rankedValid = false;
 }
 
 //---------------------------------------------------------------------------
@@ -94,31 +91,45 @@ void FittestList::update( agent *candidate, float fitness )
 void FittestList::clear()
 {
 	_size = 0;
+	_rankedValid = false;
 
 	// todo: this shouldn't be necessary. retained to ensure backwards-compatible
 	for( int i = 0; i < _capacity; i++ )
 	{
-		_elements[i]->fitness = 0.0;
-		_elements[i]->agentID = 0;
-		_elements[i]->complexity = 0.0;
+		_storage[i].fitness = 0.0;
+		_storage[i].agentID = 0;
+		_storage[i].complexity = 0.0;
+		_storage[i].genes.reset();
 	}
 }
 
+//---------------------------------------------------------------------------
+// FittestList::rank
+//---------------------------------------------------------------------------
+void FittestList::rank()
+{
+	copy( _heap, _heap + _size, _ranked );
+	sort( _ranked, _ranked + _size, isBetter );
+	_rankedValid = true;
+}
+
 //---------------------------------------------------------------------------
 // FittestList::dump
 //---------------------------------------------------------------------------
 void FittestList::dump( ostream &out )
 {
-	for( int i = 0; i < _capacity; i++ )
+	for( int i = 0; i < _size; i++ )
 	{
-		out << _elements[i]->agentID << endl;
-		out << _elements[i]->fitness << endl;
-		out << _elements[i]->complexity << endl;
+		FitStruct *element = get( i );
+
+		out << element->agentID << endl;
+		out << element->fitness << endl;
+		out << element->complexity << endl;
 		
 		assert( false );
 		/* PORT TO AbstractFile
 		if( _storeGenome )
-			_elements[i]->dump(out);
+			element->dump(out);
 		*/
 	}
 }
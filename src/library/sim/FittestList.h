@@ -3,9 +3,14 @@
 #include <assert.h>
 
 #include <iostream>
+#include <memory>
 
 #include "genome/Genome.h"
 
+// Genomes in the fittest lists are snapshots taken at death, so they never
+// change and the lists can share them.
+typedef std::shared_ptr<genome::Genome> GenomeRef;
+
 //===========================================================================
 // FitStruct
 //===========================================================================
@@ -14,12 +19,17 @@ struct FitStruct
 	unsigned long	agentID;
 	float	fitness;
 	float   complexity;
-	genome::Genome *genes;
+	GenomeRef genes;
+	unsigned long sequence;	// insertion order; older ranks first among equal fitness
 };
 typedef struct FitStruct FitStruct;
 
 //===========================================================================
 // FittestList
+//
+// Keeps the best capacity candidates in a heap with the worst on top, so a
+// candidate that doesn't make the list costs one comparison and one that
+// does costs O(log capacity). get() ranks the elements on demand.
 //===========================================================================
 class FittestList
 {
@@ -27,7 +37,9 @@ class FittestList
 	FittestList( int capacity, bool storeGenome );
 	virtual ~FittestList();
 
-	void update( class agent *candidate, float fitness );
+	// genes must no longer change; it's only referenced, and only if the
+	// list stores genomes.
+	void update( class agent *candidate, float fitness, const GenomeRef &genes );
 
 	bool isFull();
 	void clear();
@@ -39,14 +51,18 @@ class FittestList
 	void dump( std::ostream &out );
 
  private:
+	void rank();
+
 	int _capacity;
 	bool _storeGenome;
 	int _size;
-
- public: // tmp access
-	FitStruct **_elements;
+	unsigned long _sequence;
+	FitStruct *_storage;
+	FitStruct **_heap;		// worst on top
+	FitStruct **_ranked;	// best first, once rank() has run
+	bool _rankedValid;
 };
 
 inline bool FittestList::isFull() { return _size == _capacity; }
 inline int FittestList::size() { return _size; }
-inline FitStruct *FittestList::get( int rank ) { assert(rank < _size); return _elements[rank]; }
+inline FitStruct *FittestList::get( int rank ) { assert(rank < _size); if( !_rankedValid ) this->rank(); return _ranked[rank]; }
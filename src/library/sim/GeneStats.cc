@@ -1,7 +1,9 @@
 #include "GeneStats.h"
 
+#include <algorithm>
+
+#include "agent/AgentRegistry.h"
 #include "genome/GenomeUtil.h"
-#include "utils/objectxsortedlist.h"
 
 using namespace genome;
 
@@ -63,12 +65,9 @@ void GeneStats::compute( Scheduler &scheduler)
 		// Because we'll be performing the stats calculations/recording in parallel
 		// with the master task, which will kill and birth agents, we must create a
 		// snapshot of the agents alive right now.
-		_nagents = objectxsortedlist::gXSortedObjects.getCount(AGENTTYPE);
-		objectxsortedlist::gXSortedObjects.reset();
-		for( int i = 0; i < _nagents; i++ )
-		{
-			objectxsortedlist::gXSortedObjects.nextObj( AGENTTYPE, (gobject**)_agents + i );
-		}
+		const std::vector<agent *> &agents = AgentRegistry::getAgents();
+		_nagents = agents.size();
+		std::copy( agents.begin(), agents.end(), _agents );
 
 		// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 		// !!! POST PARALLEL
@@ -1,26 +1,45 @@
 #include "Scheduler.h"
 
 #include <assert.h>
+
+#include <algorithm>
+#include <future>
 #include <iostream>
+#include <memory>
 #include <thread>
 
 using namespace std;
 
+static unsigned coreCount = 0;
+
 static unsigned get_thread_count()
 {
-    unsigned ncores = thread::hardware_concurrency();
+    return Scheduler::getCoreCount() - 1; // (ncores - 1) helper threads in thread pool + 1 master thread
+                                          // occupies CPU.
+}
+
+Scheduler::Scheduler()
+    : threadCount(get_thread_count())
+    , threadPool(threadCount)
+{
+}
+
+void Scheduler::setCoreCount( unsigned ncores )
+{
+	coreCount = ncores;
+}
+
+unsigned Scheduler::getCoreCount()
+{
+    unsigned ncores = coreCount;
+    if(ncores == 0)
+        ncores = thread::hardware_concurrency();
     if(ncores == 0)
     {
         ncores = 1;
         cerr << "Unable to determine CPU core count via thread::hardware_concurrency(), assuming 1 core." << endl;
     }
-    return ncores - 1; // (ncores - 1) helper threads in thread pool + 1 master thread
-                       // occupies CPU.
-}
-
-Scheduler::Scheduler()
-    : threadPool(get_thread_count())
-{
+    return ncores;
 }
 
 void Scheduler::execMasterTask( Task masterTask,
@@ -38,6 +57,7 @@ void Scheduler::execMasterTask( Task masterTask,
         state = Master;
 
         masterTask();
+        flushBatch();
 
         state = Parallel;
         threadPool.join();
@@ -81,3 +101,79 @@ void Scheduler::postSerial( Task task )
 	}
 		
 }
+
+void Scheduler::postParallelBatched( Task task )
+{
+	if( forceAllSerial )
+	{
+		task();
+	}
+	else
+	{
+        assert(state == Master);
+
+        batch.push_back( task );
+        if( ((int)batch.size() >= batchSize) || threadPool.has_idle_thread() )
+            flushBatch();
+	}
+}
+
+void Scheduler::setBatchSize( int batchSize )
+{
+	assert( batchSize > 0 );
+	this->batchSize = batchSize;
+}
+
+void Scheduler::execParallelFor( int n,
+								 RangeTask body )
+{
+	int nranges = min( n, (int)threadCount + 1 );
+
+	if( forceAllSerial || (nranges <= 1) )
+	{
+		if( n > 0 )
+			body( 0, n );
+		return;
+	}
+
+	vector< future<void> > pending;
+	int begin = 0;
+	for( int i = 0; i < nranges; i++ )
+	{
+		int end = begin + (n - begin) / (nranges - i);
+
+		if( i == nranges - 1 )
+		{
+			// The calling thread takes the last range itself.
+			body( begin, end );
+		}
+		else
+		{
+			shared_ptr< promise<void> > done = make_shared< promise<void> >();
+			pending.push_back( done->get_future() );
+			threadPool.schedule( [=]() {
+					body( begin, end );
+					done->set_value();
+				} );
+		}
+
+		begin = end;
+	}
+
+	for( future<void> &f: pending )
+		f.get();
+}
+
+void Scheduler::flushBatch()
+{
+    if( batch.empty() )
+        return;
+
+    shared_ptr< vector<Task> > tasks = make_shared< vector<Task> >();
+    tasks->swap( batch );
+
+    threadPool.schedule( [tasks]() {
+            for( Task &task: *tasks )
+                task();
+        } );
+}
@@ -13,17 +13,44 @@ class Scheduler
 
     Scheduler();
 
+	// Cores a Scheduler constructed afterwards may use, for processes sharing
+	// the machine. 0, the default, means all of them.
+	static void setCoreCount( unsigned ncores );
+	// Cores a Scheduler constructed now would use, at least 1.
+	static unsigned getCoreCount();
+
 	void execMasterTask(Task masterTask,
                         bool forceAllSerial );
 	void postParallel( Task task );
 	void postSerial( Task task );
 
+	// Batched tasks are handed to the thread pool in groups of batchSize, or
+	// at once while a pool thread is idle, so a lone task doesn't wait on
+	// others to fill its group. Any partial group left is posted when the
+	// master task returns. Use for many small tasks of similar cost, e.g.
+	// growing the brains of a step's births.
+	void postParallelBatched( Task task );
+	void setBatchSize( int batchSize );
+
+	// Runs body over [0,n) split into contiguous ranges on the thread pool and
+	// the calling thread, returning once every range is done. Unlike the post
+	// methods this may be used from within a master task, whose other posted
+	// tasks are unaffected.
+	typedef std::function<void (int begin, int end)> RangeTask;
+	void execParallelFor( int n, RangeTask body );
+
  private:
     enum State {Idle, Master, Parallel, Serial} state = Idle;
 
+    unsigned threadCount;
     ThreadPool threadPool;
 
     std::vector<Task> serialTasks;
     std::mutex serialMutex;
 	bool forceAllSerial;
+
+	void flushBatch();
+
+	std::vector<Task> batch;
+	int batchSize = 1;
 };
@@ -41,6 +41,7 @@
 // Local
 #include "debug.h"
 #include "globals.h"
+#include "StepProfiler.h"
 
 #include "agent/AgentPovRenderer.h"
 #include "agent/Metabolism.h"
@@ -59,6 +60,7 @@
 #include "logs/Logs.h"
 #include "proplib/proplib.h"
 #include "utils/AbstractFile.h"
+#include "utils/BirthsDeathsIndex.h"
 #include "utils/objectxsortedlist.h"
 #include "utils/PwMovieUtils.h"
 #include "utils/RandomNumberGenerator.h"
@@ -189,7 +191,8 @@ inline float AverageAngles( float a, float b )
 TSimulation::TSimulation( string worldfilePath, proplib::ParameterMap parameters )
 	:
 		fLockStepWithBirthsDeathsLog(false),
-		fLockstepFile(NULL),
+		fLockstepEvents(NULL),
+		fLockstepNextStep(0),
 
 		fMaxPopulationPenaltyFraction(0.0),
 		fLowPopulationAdvantageFactor(1.0),
@@ -234,6 +237,7 @@ TSimulation::TSimulation( string worldfilePath, proplib::ParameterMap parameters
 {
 	fStep = 0;
 	memset( fNumberAliveWithMetabolism, 0, sizeof(fNumberAliveWithMetabolism) );
+	fInteractCandidates.active = false;
 
 	fCurrentBrainStats.sheets.synapseCount = new Stat *[ sheets::Sheet::__NTYPES ];
 	for( int i = 0; i < sheets::Sheet::__NTYPES; i++ )
@@ -263,6 +267,15 @@ TSimulation::TSimulation( string worldfilePath, proplib::ParameterMap parameters
 	// ---
 	// --- Process the Worldfile
 	// ---
+	// Resolved expression values from earlier runs of the same worldfile and
+	// parameters. Kept to the end of the constructor, so it also keeps what
+	// InitCppProperties() evaluates.
+	proplib::DocumentCache documentCache;
+	documentCache.addFile( "./etc/worldfile.wfs" );
+	documentCache.addFile( worldfilePath );
+	documentCache.addParameters( parameters );
+	documentCache.load();
+
 	proplib::SchemaDocument *schema;
 	proplib::Document *worldfile;
 	{
@@ -334,23 +347,15 @@ TSimulation::TSimulation( string worldfilePath, proplib::ParameterMap parameters
 
 		cout << "*** Running in LOCKSTEP MODE with file 'LOCKSTEP-BirthsDeaths.log' ***" << endl;
 
-		if( (fLockstepFile = fopen("LOCKSTEP-BirthsDeaths.log", "r")) == NULL )
+		// Parsed once into a binary index that the steps just walk.
+		fLockstepEvents = BirthsDeathsIndex::open( "LOCKSTEP-BirthsDeaths.log", "run/LOCKSTEP-BirthsDeaths.idx" );
+		if( fLockstepEvents == NULL )
 		{
-			cerr << "ERROR/Init(): Could not open 'LOCKSTEP-BirthsDeaths.log' for reading. Exiting." << endl;
+			cerr << "ERROR/Init(): Could not read 'LOCKSTEP-BirthsDeaths.log'. Exiting." << endl;
 			exit(1);
 		}
 
-		char LockstepLine[512];
-		int currentpos=0;			// current position in fLockstepFile.
-
-		// bypass any header information
-		while( (fgets(LockstepLine, sizeof(LockstepLine), fLockstepFile)) != NULL )
-		{
-			if( LockstepLine[0] == '#' || LockstepLine[0] == '%' ) { currentpos = ftell( fLockstepFile ); continue; 	}				// if the line begins with a '#' or '%' (implying it is a header line), skip it.
-			else { fseek( fLockstepFile, currentpos, 0 ); break; }
-		}
-
-		if( feof(fLockstepFile) )	// this should never happen, but lets make sure.
+		if( fLockstepEvents->size() == 0 )	// this should never happen, but lets make sure.
 		{
 			cout << "ERROR/Init(): Did not find any data lines in 'LOCKSTEP-BirthsDeaths.log'.  Exiting." << endl;
 			exit(1);
@@ -373,6 +378,7 @@ TSimulation::TSimulation( string worldfilePath, proplib::ParameterMap parameters
 	agentPovRenderer = AgentPovRenderer::create( fMaxNumAgents,
                                                  Brain::config.retinaWidth,
                                                  Brain::config.retinaHeight );
+	agentPovRenderer->setBatchedReadback( fBatchRetinaReadback );
 
 	// ---
 	// --- Init Logs
@@ -402,6 +408,9 @@ TSimulation::TSimulation( string worldfilePath, proplib::ParameterMap parameters
 	// ---
 	// --- Init Agents, Food, Bricks, and Barriers
 	// ---
+	// cells as wide as the largest agent or piece of food
+	fFoodIndex.init( globals::worldsize, 2.0 * agent::config.maxRadius );
+
 	if (!fLoadState)
 	{
 		// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
@@ -495,8 +504,10 @@ TSimulation::~TSimulation()
 	// ---
 	delete logs;
 
-	if( fLockstepFile )
-		fclose( fLockstepFile );
+	StepProfiler::close();
+
+	if( fLockstepEvents )
+		delete fLockstepEvents;
 
 	{
 		barrier* b;
@@ -587,6 +598,8 @@ void TSimulation::Step()
 
 	fStep++;
 
+	StepProfiler::Timer stepTimer( StepProfiler::STEP );
+
 	debugcheck( "beginning of step %ld", fStep );
 
 	// compute some frame rates
@@ -653,6 +666,7 @@ void TSimulation::Step()
 	while( barrier::gXSortedBarriers.next( b ) )
 		b->update();
 	barrier::gXSortedBarriers.xsort();
+	barrier::gBarrierBVH.update( barrier::gXSortedBarriers );
 
 	MaintainEnergyCosts();
 
@@ -676,10 +690,14 @@ void TSimulation::Step()
 	// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 	// !!! EXEC MASTER
 	// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-	fScheduler.execMasterTask( [=]() { Interact(); },
-							   !fParallelInteract );
+	{
+		StepProfiler::Timer timer( StepProfiler::INTERACT );
+		fScheduler.execMasterTask( [=]() { Interact(); },
+								   !fParallelInteract );
+	}
 
 	assert( fNumberAlive == objectxsortedlist::gXSortedObjects.getCount(AGENTTYPE) );
+	assert( fNumberAlive == AgentRegistry::getCount() );
 
 	debugcheck( "after Interact() in step %ld", fStep );
 
@@ -696,20 +714,29 @@ void TSimulation::Step()
 	// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 	// !!! EXEC MASTER
 	// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-	fScheduler.execMasterTask( [=]() { CreateAgents(); },
-							   !fParallelCreateAgents );
+	{
+		StepProfiler::Timer timer( StepProfiler::CREATE_AGENTS );
+		fScheduler.execMasterTask( [=]() { CreateAgents(); },
+								   !fParallelCreateAgents );
+	}
 
 	// -------------------------
 	// ---- Maintain Bricks ----
 	// -------------------------
 	// maintain bricks, which may be in dynamic patches...
-	MaintainBricks();
+	{
+		StepProfiler::Timer timer( StepProfiler::MAINTAIN_BRICKS );
+		MaintainBricks();
+	}
 
 	// -----------------------
 	// ---- Maintain Food ----
 	// -----------------------
 	// finally, maintain the world's food supply...
-	MaintainFood();
+	{
+		StepProfiler::Timer timer( StepProfiler::MAINTAIN_FOOD );
+		MaintainFood();
+	}
 
 	fTotalFoodEnergyIn += fFoodEnergyIn;
 	fTotalFoodEnergyOut += fFoodEnergyOut;
@@ -721,7 +748,10 @@ void TSimulation::Step()
 	// ---------------------------------------------------
 	// ---- Step Ending Signal (e.g. update monitors) ----
 	// ---------------------------------------------------
-    stepEnding();
+	{
+		StepProfiler::Timer timer( StepProfiler::STEP_ENDING );
+		stepEnding();
+	}
 
 	// ---------------
 	// ---- Epoch ----
@@ -736,6 +766,9 @@ void TSimulation::Step()
 	}
 
 	logs->postEvent( StepEndEvent() );
+
+	stepTimer.stop();
+	StepProfiler::endStep( fStep );
 }
 
 //---------------------------------------------------------------------------
@@ -865,9 +898,9 @@ void TSimulation::InitAgents()
 			c->setGenomeReady();
 
 			// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-			// !!! POST PARALLEL
+			// !!! POST PARALLEL (BRAIN CONSTRUCTION)
 			// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-            fScheduler.postParallel([=]() {
+            fScheduler.postParallelBatched([=]() {
                         c->grow( fMateWait, true );
                 });
 
@@ -898,7 +931,7 @@ void TSimulation::InitAgents()
 #endif
 			c->setyaw(yaw);
 
-			objectxsortedlist::gXSortedObjects.add(c);	// stores c->listLink
+			objectxsortedlist::gXSortedObjects.add(c);	// stores c->listIndex
 
 			c->Domain(id);
 			fDomains[id].numAgents++;
@@ -944,9 +977,9 @@ void TSimulation::InitAgents()
 		c->setGenomeReady();
 
 		// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-		// !!! POST PARALLEL
+		// !!! POST PARALLEL (BRAIN CONSTRUCTION)
 		// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-        fScheduler.postParallel( [=]() {
+        fScheduler.postParallelBatched( [=]() {
                 c->grow( fMateWait, true );
             });
 
@@ -967,7 +1000,7 @@ void TSimulation::InitAgents()
 		float yaw =  360.0 * randpw();
 		c->setyaw(yaw);
 
-		objectxsortedlist::gXSortedObjects.add(c);	// stores c->listLink
+		objectxsortedlist::gXSortedObjects.add(c);	// stores c->listIndex
 
 		id = WhichDomain(x, z, 0);
 		c->Domain(id);
@@ -1010,6 +1043,8 @@ void TSimulation::InitFood()
 			}
 		}
 	}
+
+	AddNewFood();
 }
 
 //---------------------------------------------------------------------------
@@ -1379,13 +1414,22 @@ void TSimulation::UpdateAgents()
 		pass++;
 	#endif
 
-		a->UpdateVision();
-		a->UpdateBrain();
+		{
+			StepProfiler::Timer timer( StepProfiler::UPDATE_VISION );
+			a->UpdateVision();
+		}
+		{
+			StepProfiler::Timer timer( StepProfiler::UPDATE_BRAIN );
+			a->UpdateBrain();
+		}
 		if( !a->BeingCarried() )
+		{
+			StepProfiler::Timer timer( StepProfiler::UPDATE_BODY );
 			fFoodEnergyOut += a->UpdateBody(fMoveFitnessParameter,
 											agent::config.speed2DPosition,
 											fSolidObjects,
 											NULL);
+		}
 	}
 }
 
@@ -1399,7 +1443,8 @@ void TSimulation::UpdateAgents_StaticTimestepGeometry()
     // !!! EXEC MASTER
     // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
     fScheduler.execMasterTask([=]() {
-            fStage.Compile();
+            if( agentPovRenderer->usesGL() )
+                fStage.Compile();
             objectxsortedlist::gXSortedObjects.reset();
 
             agent *a = NULL;
@@ -1408,17 +1453,43 @@ void TSimulation::UpdateAgents_StaticTimestepGeometry()
                 // ---
                 // --- Update POV (3D rendering... expensive)
                 // ---
-                a->UpdateVision();
+                {
+                    StepProfiler::Timer timer( StepProfiler::UPDATE_VISION );
+                    a->UpdateVision();
+                }
 
-                fScheduler.postParallel([=]() {
-                        // ---
-                        // --- Execute Neural Net
-                        // ---
-                        a->UpdateBrain();
-                    });
+                // With batched readback, brains wait until every POV is drawn.
+                if( !fBatchRetinaReadback )
+                {
+                    fScheduler.postParallel([=]() {
+                            // ---
+                            // --- Execute Neural Net
+                            // ---
+                            StepProfiler::Timer timer( StepProfiler::UPDATE_BRAIN );
+                            a->UpdateBrain();
+                        });
+                }
             }
 
-            fStage.Decompile();
+            if( fBatchRetinaReadback )
+            {
+                {
+                    StepProfiler::Timer timer( StepProfiler::UPDATE_VISION );
+                    agentPovRenderer->readRetinas();
+                }
+
+                objectxsortedlist::gXSortedObjects.reset();
+                while (objectxsortedlist::gXSortedObjects.nextObj(AGENTTYPE, (gobject**)&a))
+                {
+                    fScheduler.postParallel([=]() {
+                            StepProfiler::Timer timer( StepProfiler::UPDATE_BRAIN );
+                            a->UpdateBrain();
+                        });
+                }
+            }
+
+            if( agentPovRenderer->usesGL() )
+                fStage.Decompile();
         },
         !fParallelBrains);
 
@@ -1432,10 +1503,13 @@ void TSimulation::UpdateAgents_StaticTimestepGeometry()
 		while( objectxsortedlist::gXSortedObjects.nextObj( AGENTTYPE, (gobject**)&a) )
 		{
 			if( !a->BeingCarried() )
+			{
+				StepProfiler::Timer timer( StepProfiler::UPDATE_BODY );
 				fFoodEnergyOut += a->UpdateBody( fMoveFitnessParameter,
 												 agent::config.speed2DPosition,
 												 fSolidObjects,
 												 NULL );
+			}
 		}
 	}
 }
@@ -1551,9 +1625,45 @@ void TSimulation::Interact()
 	// Now go through the list, and use the influence radius to determine
 	// all possible interactions
 
+	if( fParallelInteract )
+	{
+		// Find the contacts and food of every agent up front, spread over the
+		// worker threads, then resolve them below in the usual order.
+		FindInteractCandidates();
+	}
+
+	// Number the food in list order and pick up pieces carried since the
+	// last step, so Eat() can use the food index.
+	fFoodIndex.sync();
+
+	InteractCandidates &candidates = fInteractCandidates;
+	size_t candidateIndex = 0;
+
 	objectxsortedlist::gXSortedObjects.reset();
-    while( objectxsortedlist::gXSortedObjects.nextObj( AGENTTYPE, (gobject**) &c ) )
-    {
+	while( true )
+	{
+		size_t index = 0;
+
+		if( candidates.active )
+		{
+			// Agents only leave the list during resolution (births are added
+			// by serial tasks afterward), so the snapshot visits the same
+			// agents a walk of the live list would.
+			while( (candidateIndex < candidates.agents.size())
+				   && !candidates.agents[candidateIndex]->Alive() )
+				candidateIndex++;
+			if( candidateIndex == candidates.agents.size() )
+				break;
+
+			index = candidateIndex++;
+			c = candidates.agents[index];
+			objectxsortedlist::gXSortedObjects.setcurr( c );
+		}
+		else if( !objectxsortedlist::gXSortedObjects.nextObj( AGENTTYPE, (gobject**) &c ) )
+		{
+			break;
+		}
+
 		// Check for new agent.  If totally new (never updated), skip this agent.
 		// This is because newly born agents get added directly to the main list,
 		// and we might try to process them immediately after being born, but we
@@ -1565,71 +1675,48 @@ void TSimulation::Interact()
         cDied = false;
 
 		// See if there's an overlap with any other agents
-        while( objectxsortedlist::gXSortedObjects.nextObj( AGENTTYPE, (gobject**) &d ) ) // to end of list or...
-        {
-			if( d == c )	// sanity check; shouldn't happen
+		if( candidates.active )
+		{
+			for( agent *d : candidates.contacts[index] )
 			{
-				printf( "***************** d == c **************\n" );
-				continue;
-			}
-
-            if( (d->x() - d->radius()) >= (c->x() + c->radius()) )
-                break;  // this guy (& everybody else in list) is too far away
-
-            // so if we get here, then c & d are close enough in x to interact
-
-			// We used to test only on delta z at this point, thereby using manhattan distance to permit interaction
-			// now modified to use actual distances to tighten things up a little (particularly visible in "toy world"
-			// simulations).  Since we are basing interactions on circumscribing circles, agents may still interact
-			// without having an actual overlap of polygons, but using actual distances reduces the range over which
-			// this may happen and should reduce the number of such incidents.
-			if( sqrt( (d->x()-c->x())*(d->x()-c->x()) + (d->z()-c->z())*(d->z()-c->z()) ) <= (d->radius() + c->radius()) )
-            {
-                // and if we get here then they are also close enough in z,
-                // so must actually worry about their interaction
+				if( !d->Alive() )
+					continue;	// killed earlier in this step
 
-				ttPrint( "age %ld: agents # %ld & %ld are close\n", fStep, c->Number(), d->Number() );
-
-				AgentContactBeginEvent contactEvent( c, d );
-
-				logs->postEvent( contactEvent );
-
-				// -----------------------
-				// ---- Mate (Normal) ----
-				// -----------------------
-                Mate( c, d, &contactEvent );
-
-				// -----------------------
-				// -------- Fight --------
-				// -----------------------
-				bool dDied = false;
-                if (fPower2Energy > 0.0)
-                {
-					Fight( c, d, &contactEvent, &cDied, &dDied );
-                }
+				InteractPair( c, d, &cDied );
 
-				// -----------------------
-				// -------- Give ---------
-				// -----------------------
-				if( agent::config.enableGive )
+				if( cDied )
+					break;
+			}
+		}
+		else
+		{
+			while( objectxsortedlist::gXSortedObjects.nextObj( AGENTTYPE, (gobject**) &d ) ) // to end of list or...
+			{
+				if( d == c )	// sanity check; shouldn't happen
 				{
-					if( !cDied && !dDied )
-					{
-						Give( c, d, &contactEvent, &cDied, true );
-						if(!cDied)
-						{
-							Give( d, c, &contactEvent, &dDied, false );
-						}
-					}
+					printf( "***************** d == c **************\n" );
+					continue;
 				}
 
-				logs->postEvent( AgentContactEndEvent(contactEvent) );
+				if( (d->x() - d->radius()) >= (c->x() + c->radius()) )
+					break;  // this guy (& everybody else in list) is too far away
 
-				if( cDied )
-					break;
+				// so if we get here, then c & d are close enough in x to interact
+
+				// We used to test only on delta z at this point, thereby using manhattan distance to permit interaction
+				// now modified to use actual distances to tighten things up a little (particularly visible in "toy world"
+				// simulations).  Since we are basing interactions on circumscribing circles, agents may still interact
+				// without having an actual overlap of polygons, but using actual distances reduces the range over which
+				// this may happen and should reduce the number of such incidents.
+				if( sqrt( (d->x()-c->x())*(d->x()-c->x()) + (d->z()-c->z())*(d->z()-c->z()) ) <= (d->radius() + c->radius()) )
+				{
+					InteractPair( c, d, &cDied );
 
-            }  // if close enough
-        }  // while (agent::config.xSortedAgents.next(d))
+					if( cDied )
+						break;
+				}  // if close enough
+			}  // while (agent::config.xSortedAgents.next(d))
+		}
 
         debugcheck( "after all agent interactions" );
 
@@ -1663,6 +1750,9 @@ void TSimulation::Interact()
 
     } // while loop on agents (c)
 
+	candidates.active = false;
+	fFoodIndex.endSync();
+
 	fEatStatistics.StepEnd();
 
 // 	if( fFittest->size() > 0 )
@@ -1678,6 +1768,109 @@ void TSimulation::Interact()
 }
 
 
+//---------------------------------------------------------------------------
+// TSimulation::FindInteractCandidates
+//
+// The parallel half of Interact. For every agent, records the agents later
+// in x-order whose circles overlap it. Nothing is modified except
+// fInteractCandidates, so the work splits freely across threads; agent
+// positions and radii are fixed for the rest of Interact.
+//---------------------------------------------------------------------------
+void TSimulation::FindInteractCandidates()
+{
+	InteractCandidates &candidates = fInteractCandidates;
+	objectxsortedlist &list = objectxsortedlist::gXSortedObjects;
+
+	candidates.agents.clear();
+	{
+		agent *a;
+		list.reset();
+		while( list.nextObj( AGENTTYPE, (gobject**) &a ) )
+			candidates.agents.push_back( a );
+	}
+
+	int nagents = candidates.agents.size();
+	if( (int)candidates.contacts.size() < nagents )
+		candidates.contacts.resize( nagents );
+
+	fScheduler.execParallelFor( nagents, [&candidates, nagents]( int begin, int end )
+	{
+		for( int i = begin; i < end; i++ )
+		{
+			agent *c = candidates.agents[i];
+			std::vector<agent *> &contacts = candidates.contacts[i];
+
+			contacts.clear();
+
+			if( c->Age() <= 0 )
+				continue;	// won't be resolved this step
+
+			for( int j = i + 1; j < nagents; j++ )
+			{
+				agent *d = candidates.agents[j];
+
+				if( (d->x() - d->radius()) >= (c->x() + c->radius()) )
+					break;
+
+				if( sqrt( (d->x()-c->x())*(d->x()-c->x()) + (d->z()-c->z())*(d->z()-c->z()) ) <= (d->radius() + c->radius()) )
+					contacts.push_back( d );
+			}
+		}
+	} );
+
+	candidates.active = true;
+}
+
+//---------------------------------------------------------------------------
+// TSimulation::InteractPair
+//
+// Mate, fight and give between two agents already known to be in contact.
+//---------------------------------------------------------------------------
+void TSimulation::InteractPair( agent *c,
+								agent *d,
+								bool *cDied )
+{
+	// and if we get here then they are also close enough in z,
+	// so must actually worry about their interaction
+
+	ttPrint( "age %ld: agents # %ld & %ld are close\n", fStep, c->Number(), d->Number() );
+
+	AgentContactBeginEvent contactEvent( c, d );
+
+	logs->postEvent( contactEvent );
+
+	// -----------------------
+	// ---- Mate (Normal) ----
+	// -----------------------
+	Mate( c, d, &contactEvent );
+
+	// -----------------------
+	// -------- Fight --------
+	// -----------------------
+	bool dDied = false;
+	if (fPower2Energy > 0.0)
+	{
+		Fight( c, d, &contactEvent, cDied, &dDied );
+	}
+
+	// -----------------------
+	// -------- Give ---------
+	// -----------------------
+	if( agent::config.enableGive )
+	{
+		if( !*cDied && !dDied )
+		{
+			Give( c, d, &contactEvent, cDied, true );
+			if( !*cDied )
+			{
+				Give( d, c, &contactEvent, &dDied, false );
+			}
+		}
+	}
+
+	logs->postEvent( AgentContactEndEvent(contactEvent) );
+}
+
 //---------------------------------------------------------------------------
 // TSimulation::DeathAndStats
 //---------------------------------------------------------------------------
@@ -1713,7 +1906,7 @@ void TSimulation::DeathAndStats( void )
 				agent* randAgent = NULL;
 	//				int randomIndex = int( floor( randpw() * fDomains[kd].numagents ) );	// pick from this domain
 				int randomIndex = int( floor( randpw() * numagents ) );
-				gdlink<gobject*> *saveCurr = objectxsortedlist::gXSortedObjects.getcurr();	// save the state of the x-sorted list
+				gobject *saveCurr = objectxsortedlist::gXSortedObjects.getcurr();	// save the state of the x-sorted list
 
 				// As written, randAgent may not actually be the randomIndex-th agent in the domain, but it will be close,
 				// and as long as there's a single legitimate agent for killing, we will find and kill it
@@ -2012,7 +2205,7 @@ void TSimulation::MateLockstep( void )
 		short kd = WhichDomain(x, z, 0);
 		e->Domain(kd);
 		fStage.AddObject(e);
-		objectxsortedlist::gXSortedObjects.add(e); // Add the new agent directly to the list of objects (no new agent list); the e->listLink that gets auto stored here should be valid immediately
+		objectxsortedlist::gXSortedObjects.add(e); // Add the new agent directly to the list of objects (no new agent list); the e->listIndex that gets auto stored here should be valid immediately
 
 		fNewLifes++;
 		fDomains[kd].numAgents++;
@@ -2252,9 +2445,9 @@ void TSimulation::Mate( agent *c,
 				Birth( e, LifeSpan::BR_NATURAL, c, d );
 
 				// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-				// !!! POST PARALLEL
+				// !!! POST PARALLEL (BRAIN CONSTRUCTION)
 				// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-                fScheduler.postParallel( [=]() mutable {
+                fScheduler.postParallelBatched( [=]() mutable {
                         e->grow( fMateWait );
 
                         eenergy.constrain(0, e->GetMaxEnergy());
@@ -2267,8 +2460,8 @@ void TSimulation::Mate( agent *c,
 				// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
                 fScheduler.postSerial( [=]() {
                         fStage.AddObject(e);
-                        gdlink<gobject*> *saveCurr = objectxsortedlist::gXSortedObjects.getcurr();
-                        objectxsortedlist::gXSortedObjects.add(e); // Add the new agent directly to the list of objects (no new agent list); the e->listLink that gets auto stored here should be valid immediately
+                        gobject *saveCurr = objectxsortedlist::gXSortedObjects.getcurr();
+                        objectxsortedlist::gXSortedObjects.add(e); // Add the new agent directly to the list of objects (no new agent list); the e->listIndex that gets auto stored here should be valid immediately
                         objectxsortedlist::gXSortedObjects.setcurr( saveCurr );
                     });
 			}
@@ -2322,7 +2515,7 @@ void TSimulation::Smite( short kd,
 			agent* randAgent = NULL;
 			int randomIndex = int( floor( randpw() * fDomains[kd].numAgents ) );	// pick from this domain
 
-			gdlink<gobject*> *saveCurr = objectxsortedlist::gXSortedObjects.getcurr();	// save the state of the x-sorted list
+			gobject *saveCurr = objectxsortedlist::gXSortedObjects.getcurr();	// save the state of the x-sorted list
 
 			// As written, randAgent may not actually be the randomIndex-th agent in the domain, but it will be close,
 			// and as long as there's a single legitimate agent for smiting (right domain, old enough, and not one of the
@@ -2552,6 +2745,10 @@ void TSimulation::Give( agent *x,
 
 //---------------------------------------------------------------------------
 // TSimulation::Eat
+//
+// In CompatibilityMode, c eats the first food in list order that overlaps
+// it. While fFoodIndex can vouch for the list order, that piece is found
+// with a query of the index instead of a scan of the list.
 //---------------------------------------------------------------------------
 void TSimulation::Eat( agent *c, bool *cDied )
 {
@@ -2562,6 +2759,9 @@ void TSimulation::Eat( agent *c, bool *cDied )
 	bool eatFailedVel = false;
 	bool eatFailedMinAge = false;
 	bool eatAttempted = false;
+	bool indexed = false;
+	long foodScanned = 0;
+	long foodOverlapping = 0;
 
 	// Just to be slightly more like the old multi-x-sorted list version of the code, look backwards first
 
@@ -2600,16 +2800,53 @@ void TSimulation::Eat( agent *c, bool *cDied )
 	// look for food in the -x direction
 	ateBackwardFood = false;
 #if CompatibilityMode
-	// go backwards in the list until we reach a place where even the largest possible piece of food
-	// would entirely precede our agent, and no smaller piece of food sorting after it, but failing
-	// to reach the agent can prematurely terminate the scan back (hence the factor of 2.0),
-	// so we can then search forward from there
-	while( objectxsortedlist::gXSortedObjects.prevObj( FOODTYPE, (gobject**) &f ) )
-		if( (f->x() + 2.0*food::gMaxFoodRadius) < (c->x() - c->radius()) )
-			break;
+	indexed = fFoodIndex.isOrdered();
+	if( indexed )
+	{
+		fEatCandidates.clear();
+		fFoodIndex.query( c->x() - c->radius(), c->x() + c->radius(),
+						  c->z() - c->radius(), c->z() + c->radius(),
+						  fEatCandidates );
+		foodScanned = fEatCandidates.size();
+
+		food *first = NULL;
+		for( food *candidate : fEatCandidates )
+		{
+			// the forward scan's test below, including where it would stop
+			if( ((candidate->x() - candidate->radius()) <= (c->x() + c->radius())) &&
+				((candidate->x() + candidate->radius()) > (c->x() - c->radius())) &&
+				(fabs( candidate->z() - c->z() ) < (candidate->radius() + c->radius())) )
+			{
+				foodOverlapping++;
+				if( !first || (fFoodIndex.order(candidate) < fFoodIndex.order(first)) )
+					first = candidate;
+			}
+		}
+
+		if( first )
+		{
+			eatAttempted = true;
+			if( eatAllowed )
+				EatFood( c, first );
+		}
+	}
+	else
+	{
+		// go backwards in the list until we reach a place where even the largest possible piece of food
+		// would entirely precede our agent, and no smaller piece of food sorting after it, but failing
+		// to reach the agent can prematurely terminate the scan back (hence the factor of 2.0),
+		// so we can then search forward from there
+		while( objectxsortedlist::gXSortedObjects.prevObj( FOODTYPE, (gobject**) &f ) )
+		{
+			foodScanned++;
+			if( (f->x() + 2.0*food::gMaxFoodRadius) < (c->x() - c->radius()) )
+				break;
+		}
+	}
 #else // CompatibilityMode
 	while( objectxsortedlist::gXSortedObjects.prevObj( FOODTYPE, (gobject**) &f ) )
 	{
+		foodScanned++;
 		if( (f->x() + f->radius()) < (c->x() - c->radius()) )
 		{
 			// end of food comes before beginning of agent, so there is no overlap
@@ -2624,28 +2861,12 @@ void TSimulation::Eat( agent *c, bool *cDied )
 			// time to check for overlap in z
 			if( fabs( f->z() - c->z() ) < ( f->radius() + c->radius() ) )
 			{
+				foodOverlapping++;
 				eatAttempted = true;
 				if( !eatAllowed )
 					break;
 				// also overlap in z, so they really interact
-				ttPrint( "step %ld: agent # %ld is eating\n", fStep, c->Number() );
-				Energy foodEnergyLost;
-				Energy energyEatenRaw;
-				Energy energyEaten;
-				c->eat( f, fEatFitnessParameter, fEat2Consume, fEatThreshold, fStep, foodEnergyLost, energyEatenRaw, energyEaten );
-				logs->postEvent( EnergyEvent(c, f, c->Eat(), energyEaten, energyEatenRaw, EnergyEvent::Eat) );
-				if( fEvents )
-					fEvents->AddEvent( fStep, c->Number(), 'e' );
-
-				FoodEnergyOut( foodEnergyLost );
-				fEnergyEaten += energyEaten;
-
-				eatPrint( "at step %ld, agent %ld at (%g,%g) with rad=%g wasted %g units of food at (%g,%g) with rad=%g\n", fStep, c->Number(), c->x(), c->z(), c->radius(), foodEaten, f->x(), f->z(), f->radius() );
-
-				if( f->isDepleted() || fFoodRemoveFirstEat )  // all gone
-				{
-					RemoveFood( f );
-				}
+				EatFood( c, f );
 
 				// but this guy only gets to eat from one food source
 				ateBackwardFood = true;
@@ -2655,7 +2876,7 @@ void TSimulation::Eat( agent *c, bool *cDied )
 	}	// backward while loop on food
 #endif // CompatibilityMode
 
-	if( !ateBackwardFood && !eatAttempted )
+	if( !indexed && !ateBackwardFood && !eatAttempted )
 	{
 	#if ! CompatibilityMode
 		// set the list back to the agent mark, so we can look forward from that point
@@ -2665,6 +2886,7 @@ void TSimulation::Eat( agent *c, bool *cDied )
 		// look for food in the +x direction
 		while( objectxsortedlist::gXSortedObjects.nextObj( FOODTYPE, (gobject**) &f ) )
 		{
+			foodScanned++;
 			if( (f->x() - f->radius()) > (c->x() + c->radius()) )
 			{
 				// beginning of food comes after end of agent, so there is no overlap,
@@ -2682,28 +2904,12 @@ void TSimulation::Eat( agent *c, bool *cDied )
 				if( fabs( f->z() - c->z() ) < (f->radius() + c->radius()) )
 	#endif
 				{
+					foodOverlapping++;
 					eatAttempted = true;
 					if( !eatAllowed )
 						break;
 					// also overlap in z, so they really interact
-					ttPrint( "step %ld: agent # %ld is eating\n", fStep, c->Number() );
-					Energy foodEnergyLost;
-					Energy energyEatenRaw;
-					Energy energyEaten;
-					c->eat( f, fEatFitnessParameter, fEat2Consume, fEatThreshold, fStep, foodEnergyLost, energyEatenRaw, energyEaten );
-					logs->postEvent( EnergyEvent(c, f, c->Eat(), energyEaten, energyEatenRaw, EnergyEvent::Eat) );
-					if( fEvents )
-						fEvents->AddEvent( fStep, c->Number(), 'e' );
-
-					FoodEnergyOut( foodEnergyLost );
-					fEnergyEaten += energyEaten;
-
-					eatPrint( "at step %ld, agent %ld at (%g,%g) with rad=%g wasted %g units of food at (%g,%g) with rad=%g\n", fStep, c->Number(), c->x(), c->z(), c->radius(), foodEaten, f->x(), f->z(), f->radius() );
-
-					if( f->isDepleted() || fFoodRemoveFirstEat )  // all gone
-					{
-						RemoveFood( f );
-					}
+					EatFood( c, f );
 
 					// but this guy only gets to eat from one food source
 					break;  // so get out of the forward food while loop
@@ -2712,6 +2918,8 @@ void TSimulation::Eat( agent *c, bool *cDied )
 		} // forward while loop on food
 	} // if( !ateBackwardFood )
 
+	fEatStatistics.AgentEatScan( foodScanned, foodOverlapping );
+
 	if( eatAttempted )
 	{
 		fEatStatistics.AgentEatAttempt( eatAllowed, eatFailedYaw, eatFailedVel, eatFailedMinAge );
@@ -2733,6 +2941,37 @@ void TSimulation::Eat( agent *c, bool *cDied )
 	debugcheck( "after all agents had a chance to eat" );
 }
 
+//---------------------------------------------------------------------------
+// TSimulation::EatFood
+//---------------------------------------------------------------------------
+void TSimulation::EatFood( agent *c, food *f )
+{
+	ttPrint( "step %ld: agent # %ld is eating\n", fStep, c->Number() );
+	Energy foodEnergyLost;
+	Energy energyEatenRaw;
+	Energy energyEaten;
+	c->eat( f, fEatFitnessParameter, fEat2Consume, fEatThreshold, fStep, foodEnergyLost, energyEatenRaw, energyEaten );
+	logs->postEvent( EnergyEvent(c, f, c->Eat(), energyEaten, energyEatenRaw, EnergyEvent::Eat) );
+	if( fEvents )
+		fEvents->AddEvent( fStep, c->Number(), 'e' );
+
+	FoodEnergyOut( foodEnergyLost );
+	fEnergyEaten += energyEaten;
+
+	eatPrint( "at step %ld, agent %ld at (%g,%g) with rad=%g wasted %g units of food at (%g,%g) with rad=%g\n", fStep, c->Number(), c->x(), c->z(), c->radius(), foodEaten, f->x(), f->z(), f->radius() );
+
+	if( f->isDepleted() || fFoodRemoveFirstEat )  // all gone
+	{
+		// f may have come from the food index rather than a list walk
+		objectxsortedlist::gXSortedObjects.setcurr( f );
+		RemoveFood( f );
+	}
+	else
+	{
+		fFoodIndex.update( f );	// it shrank
+	}
+}
+
 //---------------------------------------------------------------------------
 // TSimulation::Carry
 //---------------------------------------------------------------------------
@@ -2795,6 +3034,8 @@ void TSimulation::Pickup( agent* c )
 				ttPrint( "step %ld: agent # %ld is picking up object of type %lu\n", fStep, c->Number(), o->getType() );
 
 				c->PickupObject( o );
+				if( o->getType() == FOODTYPE )
+					fFoodIndex.update( (food *)o );
 
 				if( c->NumCarries() >= agent::config.maxCarries )	// carrying as much as we can,
 					break;								// so get out of the backward while loop
@@ -2830,6 +3071,8 @@ void TSimulation::Pickup( agent* c )
 					ttPrint( "step %ld: agent # %ld is picking up object of type %d\n", fStep, c->Number(), o->getType() );
 
 					c->PickupObject( o );
+					if( o->getType() == FOODTYPE )
+						fFoodIndex.update( (food *)o );
 
 					if( c->NumCarries() >= agent::config.maxCarries )	// carrying as much as we can,
 						break;								// so get out of the forward while loop
@@ -2848,7 +3091,11 @@ void TSimulation::Pickup( agent* c )
 //---------------------------------------------------------------------------
 void TSimulation::Drop( agent* c )
 {
+	gobject *o = c->fCarries.back();
+
 	c->DropMostRecent();
+	if( o->getType() == FOODTYPE )
+		fFoodIndex.update( (food *)o );
 
 	debugcheck( "after dropping most recent" );
 }
@@ -2968,7 +3215,7 @@ void TSimulation::CreateAgents( void )
                     	&& ((fDomains[id].numcreated / fFitness1Frequency) * fFitness1Frequency == fDomains[id].numcreated) )
                     {
                         // revive 1 fittest
-                        newAgent->Genes()->copyFrom(fDomains[id].fittest->get(0)->genes);
+                        newAgent->Genes()->copyFrom(fDomains[id].fittest->get(0)->genes.get());
                         fNumberCreated1Fit++;
 						gaPrint( "%5ld: domain %d creation from one fittest (%4lu) %4ld\n", fStep, id, fDomains[id].fittest->get(0)->agentID, fNumberCreated1Fit );
                     }
@@ -2981,8 +3228,8 @@ void TSimulation::CreateAgents( void )
 							// using tournament selection
 							int parent1, parent2;
 							PickParentsUsingTournament(fDomains[id].fittest->size(), &parent1, &parent2);
-							newAgent->Genes()->crossover(fDomains[id].fittest->get(parent1)->genes,
-														 fDomains[id].fittest->get(parent2)->genes,
+							newAgent->Genes()->crossover(fDomains[id].fittest->get(parent1)->genes.get(),
+														 fDomains[id].fittest->get(parent2)->genes.get(),
 														 true);
 							fNumberCreated2Fit++;
 							gaPrint( "%5ld: domain %d creation from two (%d, %d) fittest (%4lu, %4lu) %4ld\n", fStep, id, parent1, parent2, fDomains[id].fittest->get(parent1)->agentID, fDomains[id].fittest->get(parent2)->agentID, fNumberCreated2Fit );
@@ -2990,8 +3237,8 @@ void TSimulation::CreateAgents( void )
 						else
 						{
 							// by iterating through the array of fittest
-							newAgent->Genes()->crossover(fDomains[id].fittest->get(fDomains[id].ifit)->genes,
-														 fDomains[id].fittest->get(fDomains[id].jfit)->genes,
+							newAgent->Genes()->crossover(fDomains[id].fittest->get(fDomains[id].ifit)->genes.get(),
+														 fDomains[id].fittest->get(fDomains[id].jfit)->genes.get(),
 														 true);
 							fNumberCreated2Fit++;
 							gaPrint( "%5ld: domain %d creation from two (%d, %d) fittest (%4lu, %4lu) %4ld\n", fStep, id, fDomains[id].ifit, fDomains[id].jfit, fDomains[id].fittest->get(fDomains[id].ifit)->agentID, fDomains[id].fittest->get(fDomains[id].jfit)->agentID, fNumberCreated2Fit );
@@ -3017,9 +3264,9 @@ void TSimulation::CreateAgents( void )
 				newAgent->setGenomeReady();
 
 				// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-				// !!! POST PARALLEL
+				// !!! POST PARALLEL (BRAIN CONSTRUCTION)
 				// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-                fScheduler.postParallel( [=]() {
+                fScheduler.postParallelBatched( [=]() {
                         newAgent->grow( fMateWait );
                     });
 
@@ -3075,7 +3322,7 @@ void TSimulation::CreateAgents( void )
                 	&& ((numglobalcreated / fFitness1Frequency) * fFitness1Frequency == numglobalcreated) )
                 {
                     // revive 1 fittest
-                    newAgent->Genes()->copyFrom( fFittest->get(0)->genes );
+                    newAgent->Genes()->copyFrom( fFittest->get(0)->genes.get() );
                     fNumberCreated1Fit++;
 					gaPrint( "%5ld: global creation from one fittest (%4lu) %4ld\n", fStep, fFittest->get(0)->agentID, fNumberCreated1Fit );
                 }
@@ -3087,14 +3334,14 @@ void TSimulation::CreateAgents( void )
 						// using tournament selection
 						int parent1, parent2;
 						TSimulation::PickParentsUsingTournament(fFittest->size(), &parent1, &parent2);
-						newAgent->Genes()->crossover( fFittest->get(parent1)->genes, fFittest->get(parent2)->genes, true );
+						newAgent->Genes()->crossover( fFittest->get(parent1)->genes.get(), fFittest->get(parent2)->genes.get(), true );
 						fNumberCreated2Fit++;
 						gaPrint( "%5ld: global creation from two (%d, %d) fittest (%4lu, %4lu) %4ld\n", fStep, parent1, parent2, fFittest->get(parent1)->agentID, fFittest->get(parent2)->agentID, fNumberCreated2Fit );
 					}
 					else
 					{
 						// by iterating through the array of fittest
-						newAgent->Genes()->crossover( fFittest->get(fFitI)->genes, fFittest->get(fFitJ)->genes, true );
+						newAgent->Genes()->crossover( fFittest->get(fFitI)->genes.get(), fFittest->get(fFitJ)->genes.get(), true );
 						fNumberCreated2Fit++;
 						gaPrint( "%5ld: global creation from two (%d, %d) fittest (%4lu, %4lu) %4ld\n", fStep, fFitI, fFitJ, fFittest->get(fFitI)->agentID, fFittest->get(fFitJ)->agentID, fNumberCreated2Fit );
 						ijfitinc( fFittest->size(), &fFitI, &fFitJ );
@@ -3129,9 +3376,9 @@ void TSimulation::CreateAgents( void )
             fDomains[id].lastcreate = fStep;
             fDomains[id].numAgents++;
             fStage.AddObject(newAgent);
-	    	objectxsortedlist::gXSortedObjects.add(newAgent); // add new agent to list of all objejcts; the newAgent->listLink that gets auto stored here should be valid immediately
+	    	objectxsortedlist::gXSortedObjects.add(newAgent); // add new agent to list of all objejcts; the newAgent->listIndex that gets auto stored here should be valid immediately
 	    	fNewLifes++;
-            //newAgents.add(newAgent); // add it to the full list later; the e->listLink that gets auto stored here must be replaced with one from full list below
+            //newAgents.add(newAgent); // add it to the full list later; the e->listIndex that gets auto stored here must be replaced with one from full list below
 
 			Birth( newAgent, LifeSpan::BR_CREATE );
         }
@@ -3165,23 +3412,21 @@ void TSimulation::MaintainFood()
 	// Remove any food that has exceeded its lifespan
 	if( food::gMaxLifeSpan > 0 )
 	{
-		while( !food::gAllFood.empty() )
+		std::vector<food *> expired;
+
+		for( food *f : food::gAllFood )
 		{
 			// gAllFood is ordered by creation, so when we've encountered
 			// a piece that is too young to be removed, we can stop looking.
-			// Removing food takes it out of the "all food" list, so we can
-			// look at the head of the list on each iteration.
-			food *f = food::gAllFood.front();
 			if( (f == NULL) || (f->getAge(fStep) < food::gMaxLifeSpan) )
 			{
 				break;
 			}
 
-			objectxsortedlist::gXSortedObjects.setcurr( f->GetListLink() );
-			RemoveFood( f );
+			expired.push_back( f );
 		}
 
-		objectxsortedlist::gXSortedObjects.reset();
+		RemoveFoods( expired );
 	}
 
 	// Go through each of the food patches and bring them up to minFoodCount size
@@ -3299,6 +3544,8 @@ void TSimulation::MaintainFood()
 		}
 	}
 
+	AddNewFood();
+
 	// If any dynamic food patches destroy their food when turned off, take care of it here
 	if( fFoodRemovalNeeded )
 	{
@@ -3320,6 +3567,7 @@ void TSimulation::MaintainFood()
 		if( numPatchesNeedingRemoval > 0 )
 		{
 			food* f;
+			std::vector<food *> removed;
 
 			// There are patches currently needing removal, so do it
 			objectxsortedlist::gXSortedObjects.reset();
@@ -3329,12 +3577,14 @@ void TSimulation::MaintainFood()
 				{
 					if( f->getPatch() == fFoodPatchesNeedingRemoval[i] )
 					{
-						RemoveFood( f );
+						removed.push_back( f );
 
-						break;	// found patch and deleted food, so get out of patch loop
+						break;	// found patch, so get out of patch loop
 					}
 				}
 			}
+
+			RemoveFoods( removed );
 		}
 	}
 
@@ -3390,6 +3640,8 @@ void TSimulation::Birth( agent* a,
 
 	if( a )	// a will NULL for virtual births only
 	{
+		AgentRegistry::add( a );
+
 		fNumberAlive++;
 		fNumberAliveWithMetabolism[ a->GetMetabolism()->index ]++;
 
@@ -3440,6 +3692,8 @@ void TSimulation::Kill( agent* c,
 {
 	AgentDeathEvent deathEvent(c, reason);
 
+	AgentRegistry::remove( c );
+
 	fNumberAlive--;
 	fNumberAliveWithMetabolism[c->GetMetabolism()->index]--;
 
@@ -3530,9 +3784,10 @@ void TSimulation::Kill( agent* c,
 			else
 			{
 				food* f = new food( carcassFoodType, fStep, foodEnergy, c->x(), c->z() );
-				gdlink<gobject*> *saveCurr = objectxsortedlist::gXSortedObjects.getcurr();
+				gobject *saveCurr = objectxsortedlist::gXSortedObjects.getcurr();
 				objectxsortedlist::gXSortedObjects.add( f );	// dead agent becomes food
 				objectxsortedlist::gXSortedObjects.setcurr( saveCurr );
+				fFoodIndex.add( f );
 				fStage.AddObject( f );			// put replacement food into the world
 				if( fp )
 				{
@@ -3572,7 +3827,7 @@ void TSimulation::Kill( agent* c,
 	// agent::config.xSortedAgents.remove(); // get agent out of the list
 	// objectxsortedlist::gXSortedObjects.removeCurrentObject(); // get agent out of the list
 
-	// Following assumes (requires!) the agent to have stored c->listLink correctly
+	// Following assumes (requires!) the agent to have stored c->listIndex correctly
 	objectxsortedlist::gXSortedObjects.removeObjectWithLink( (gobject*) c );
 
 	// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
@@ -3608,12 +3863,15 @@ void TSimulation::analyzeBrain( agent *c )
 
 	if ( fCalcComplexity )
 	{
-		// This should have been configured in response to the begin event.
+		// This should have been configured in response to the begin event,
+		// unless the brain has none of the neuron groups being recorded.
 		const char *brainFunctionPath = c->brainAnalysisParms.functionPath.c_str();
-		// Fail if it's zero length.
-		assert( *brainFunctionPath );
 
-		if( fComplexityType == "D" )	// special case the difference of complexities case
+		if( *brainFunctionPath == 0 )
+		{
+			c->SetComplexity( 0.0 );
+		}
+		else if( fComplexityType == "D" )	// special case the difference of complexities case
 		{
 			float pComplexity = CalcComplexity_brainfunction( brainFunctionPath, "P" );
 			float iComplexity = CalcComplexity_brainfunction( brainFunctionPath, "I" );
@@ -3663,19 +3921,23 @@ void TSimulation::updateFittest( agent *c )
 
 	fMaxFitness = max( cFitness, fMaxFitness );
 
+	// c is deleted as soon as we return, so its genome can no longer change
+	// and the lists may share it rather than copy it.
+	GenomeRef cGenes( c->ReleaseGenes() );
+
 	// First on a domain-by-domain basis...
 	if( fDomains[id].fittest )
-		fDomains[id].fittest->update( c, cFitness );
+		fDomains[id].fittest->update( c, cFitness, cGenes );
 
 	// Then on a whole-world basis...
-	fFittest->update( c, cFitness );
+	fFittest->update( c, cFitness, cGenes );
 
 	// Keep a separate list of the recent fittest, purely for data-gathering purposes,
 	// also based on complete fitness, however it is being currently being calculated
 	// "Recent" means since the last archival recording of recent best, as determined by fBestRecentBrainAnatomyRecordFrequency
 	// (Don't bother, if we're not gathering that kind of data)
 	if( fRecentFittest )
-		fRecentFittest->update( c, cFitness );
+		fRecentFittest->update( c, cFitness, cGenes );
 
 	// Must also update the leastFit data structures, now that they
 	// are used on-demand in the main mate/fight/eat loop in Interact()
@@ -3708,13 +3970,87 @@ void TSimulation::AddFood( long domainNumber, long patchNumber )
 	{
 		fDomains[domainNumber].foodCount++;
 		FoodEnergyIn( f->getEnergy() );
+
+		fNewFood.push_back( f );	// AddNewFood() puts it in the world
 	}
 }
 
+//-------------------------------------------------------------------------------------------
+// TSimulation::AddNewFood
+//
+// Puts the food grown since the last call into the object list and stage,
+// each in a single pass rather than a walk from the head per piece.
+//-------------------------------------------------------------------------------------------
+void TSimulation::AddNewFood()
+{
+	if( fNewFood.empty() )
+		return;
+
+	// a stable sort leaves ties in the order adding them one at a time would
+	std::stable_sort( fNewFood.begin(), fNewFood.end(),
+					  []( gobject *a, gobject *b )
+					  {
+						  return (a->x() - a->radius()) < (b->x() - b->radius());
+					  } );
+
+	objectxsortedlist::gXSortedObjects.addSorted( fNewFood );
+	fStage.AddObjects( fNewFood );
+
+	for( gobject *o : fNewFood )
+		fFoodIndex.add( (food *)o );
+
+	fNewFood.clear();
+}
+
 //-------------------------------------------------------------------------------------------
 // TSimulation::RemoveFood
 //-------------------------------------------------------------------------------------------
 void TSimulation::RemoveFood( food *f )
+{
+	assert( f == objectxsortedlist::gXSortedObjects.getcurr() );
+	UnlinkFood( f );
+
+	fStage.RemoveObject( f );  // get it out of the world
+
+	delete f;	// get it out of memory
+}
+
+//-------------------------------------------------------------------------------------------
+// TSimulation::RemoveFoods
+//
+// Removes many pieces with one pass over the stage. Leaves the list reset.
+//-------------------------------------------------------------------------------------------
+void TSimulation::RemoveFoods( std::vector<food *> &foods )
+{
+	if( foods.empty() )
+		return;
+
+	std::vector<gobject *> objects;
+	objects.reserve( foods.size() );
+
+	for( food *f : foods )
+	{
+		objectxsortedlist::gXSortedObjects.setcurr( f );
+		UnlinkFood( f );
+		objects.push_back( f );
+	}
+	objectxsortedlist::gXSortedObjects.reset();
+
+	fStage.RemoveObjects( objects );  // get them out of the world
+
+	for( food *f : foods )
+		delete f;	// get them out of memory
+
+	foods.clear();
+}
+
+//-------------------------------------------------------------------------------------------
+// TSimulation::UnlinkFood
+//
+// RemoveFood() short of taking f off the stage and deleting it. f must be
+// the list's current item.
+//-------------------------------------------------------------------------------------------
+void TSimulation::UnlinkFood( food *f )
 {
 	FoodPatch *fp = f->getPatch();
 	if( fp ) fp->foodCount--;
@@ -3723,10 +4059,8 @@ void TSimulation::RemoveFood( food *f )
 	assert( domain >= 0 && domain < fNumDomains );
 	fDomains[f->domain()].foodCount--;
 
-	assert( f == objectxsortedlist::gXSortedObjects.getcurr()->e );
 	objectxsortedlist::gXSortedObjects.removeCurrentObject();   // get it out of the list
-
-	fStage.RemoveObject( f );  // get it out of the world
+	fFoodIndex.remove( f );
 
 	if( f->BeingCarried() )
 	{
@@ -3735,8 +4069,6 @@ void TSimulation::RemoveFood( food *f )
 	}
 
 	FoodEnergyOut( f->getEnergy() );
-
-	delete f;	// get it out of memory
 }
 
 //-------------------------------------------------------------------------------------------
@@ -3864,6 +4196,15 @@ void TSimulation::processWorldFile( proplib::Document *docWorldFile )
 	fParallelInteract = doc.get( "ParallelInteract" );
 	fParallelCreateAgents = doc.get( "ParallelCreateAgents" );
 	fParallelBrains = doc.get( "ParallelBrains" );
+	fBatchRetinaReadback = fStaticTimestepGeometry && (bool)doc.get( "BatchRetinaReadback" );
+	fScheduler.setBatchSize( doc.get("BrainConstructionBatchSize") );
+	{
+		string timeline = doc.get( "ProfileTimeline" );
+		StepProfiler::init( doc.get("ProfileSteps"),
+							timeline == "ChromeTrace" ? StepProfiler::TIMELINE_CHROME_TRACE
+							: timeline == "Datalib" ? StepProfiler::TIMELINE_DATALIB
+							: StepProfiler::TIMELINE_NONE );
+	}
 	fMinNumAgents = doc.get( "MinAgents" );
 	fMaxNumAgents = doc.get( "MaxAgents" );
 	fInitNumAgents = doc.get( "InitAgents" );
@@ -4027,6 +4368,8 @@ void TSimulation::processWorldFile( proplib::Document *docWorldFile )
 
 			barrier::gXSortedBarriers.add( b );
 		}
+
+		barrier::gBarrierBVH.build( barrier::gXSortedBarriers );
 	}
 
 	globals::numEnergyTypes = doc.get( "NumEnergyTypes" );
@@ -4547,7 +4890,7 @@ void TSimulation::processWorldFile( proplib::Document *docWorldFile )
 	fTournamentSize = doc.get( "TournamentSize" );
 
 	globals::recordFileType = (bool)doc.get( "CompressFiles" )
-		? AbstractFile::TYPE_GZIP_FILE
+		? AbstractFile::getCompressedType( ((string)doc.get( "CompressionBackend" )).c_str() )
 		: AbstractFile::TYPE_FILE;
 
 	fFogFunction = ((string)doc.get( "FogFunction" ))[0];
@@ -4861,256 +5204,121 @@ void TSimulation::SwitchDomain(short newDomain, short oldDomain, int objectType)
 
 
 //---------------------------------------------------------------------------
-// TSimulation::getStatusText
+// summarize
 //---------------------------------------------------------------------------
-void TSimulation::getStatusText( StatusText& statusText,
-								 int statusFrequency )
+template<typename TStat>
+static StatusSnapshot::StatSummary summarize( TStat &stat )
 {
-	char t[256];
-	char t2[256];
-	short id;
-
-	// TODO: If we're neither updating the window, nor writing to the stat file,
-	// then we shouldn't sprintf all these strings, or put them in the statusText
-	// (but for now, the window always draws anyway, so it's not a big deal)
-
-	sprintf( t, "step = %ld", fStep );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, "agents = %4d", objectxsortedlist::gXSortedObjects.getCount(AGENTTYPE) );
-	if (fNumDomains > 1)
-	{
-		sprintf(t2, " (%ld",fDomains[0].numAgents );
-		strcat(t, t2 );
-		for (id = 1; id < fNumDomains; id++)
-		{
-			sprintf(t2, ", %ld", fDomains[id].numAgents );
-			strcat( t, t2 );
-		}
-
-		strcat(t,")" );
-	}
-	statusText.push_back( strdup( t ) );
-	if( Metabolism::getNumberOfDefinitions() > 1 )
-	{
-		for( int i = 0; i < Metabolism::getNumberOfDefinitions(); i++ )
-		{
-			sprintf( t, " -%s = %4ld", Metabolism::get(i)->name.c_str(), fNumberAliveWithMetabolism[i] );
-			statusText.push_back( strdup( t ) );
-		}
-	}
-
-	sprintf( t, "food = %4d", objectxsortedlist::gXSortedObjects.getCount(FOODTYPE) );
-	if (fNumDomains > 1)
-	{
-		sprintf(t2, " (%d",fDomains[0].foodCount );
-		strcat(t, t2 );
-		for (id = 1; id < fNumDomains; id++)
-		{
-			sprintf(t2, ", %d", fDomains[id].foodCount );
-			strcat( t, t2 );
-		}
+	StatusSnapshot::StatSummary summary;
+	summary.mean = stat.mean();
+	summary.stddev = stat.stddev();
+	summary.min = stat.min();
+	summary.max = stat.max();
+	return summary;
+}
 
-		strcat(t,")" );
-	}
-	statusText.push_back( strdup( t ) );
+//---------------------------------------------------------------------------
+// TSimulation::getStatus
+//
+// Only copies values; see formatStatusText(). The rates are averaged over
+// statusFrequency steps, so this must be called on each multiple of it.
+//---------------------------------------------------------------------------
+void TSimulation::getStatus( StatusSnapshot &status,
+							 int statusFrequency )
+{
+	status.step = fStep;
 
-	sprintf( t, "foodEnergy = %.1f", getFoodEnergy() );
-	statusText.push_back( strdup( t ) );
+	status.numAgents = objectxsortedlist::gXSortedObjects.getCount( AGENTTYPE );
+	status.numFood = objectxsortedlist::gXSortedObjects.getCount( FOODTYPE );
+	status.foodEnergy = getFoodEnergy();
 
-	sprintf( t, "created  = %4ld", fNumberCreated );
-	if (fNumDomains > 1)
+	status.domains.resize( fNumDomains );
+	for( int id = 0; id < fNumDomains; id++ )
 	{
-		sprintf( t2, " (%ld",fDomains[0].numcreated );
-		strcat( t, t2 );
+		StatusSnapshot::Domain &domain = status.domains[id];
 
-		for (id = 1; id < fNumDomains; id++)
-		{
-			sprintf( t2, ",%ld",fDomains[id].numcreated );
-			strcat( t, t2 );
-		}
-		strcat(t,")" );
-	}
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, " -random = %4ld", fNumberCreatedRandom );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, " -two    = %4ld", fNumberCreated2Fit );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, " -one    = %4ld", fNumberCreated1Fit );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, "born     = %4ld", fNumberBorn );
-	if (fNumDomains > 1)
-	{
-		sprintf( t2, " (%ld",fDomains[0].numborn );
-		strcat( t, t2 );
-		for (id = 1; id < fNumDomains; id++)
-		{
-			sprintf( t2, ",%ld",fDomains[id].numborn );
-			strcat( t, t2 );
-		}
-		strcat(t,")" );
-	}
-	statusText.push_back( strdup( t ) );
+		domain.numAgents = fDomains[id].numAgents;
+		domain.foodCount = fDomains[id].foodCount;
+		domain.numCreated = fDomains[id].numcreated;
+		domain.numBorn = fDomains[id].numborn;
+		domain.numDied = fDomains[id].numdied;
+		domain.lastCreate = fDomains[id].lastcreate;
+		domain.maxGapCreate = fDomains[id].maxgapcreate;
 
-	if( (fHeuristicFitnessWeight != 0.0) || (fComplexityFitnessWeight != 0.0) || fLockStepWithBirthsDeathsLog )
-	{
-		sprintf( t, "born_v   = %4ld", fNumberBornVirtual );
-		statusText.push_back( strdup( t ) );
-	}
-
-	sprintf( t, "died     = %4ld", fNumberDied );
-	if (fNumDomains > 1)
-	{
-		sprintf( t2, " (%ld",fDomains[0].numdied );
-		strcat( t, t2 );
-		for (id = 1; id < fNumDomains; id++)
+		domain.foodPatches.clear();
+		if( fCalcFoodPatchAgentCounts )
 		{
-			sprintf( t2, ",%ld",fDomains[id].numdied );
-			strcat( t, t2 );
+			for( int i = 0; i < fDomains[id].numFoodPatches; i++ )
+			{
+				StatusSnapshot::FoodPatchCounts counts;
+				counts.foodCount = fDomains[id].fFoodPatches[i].foodCount;
+				counts.agentInsideCount = fDomains[id].fFoodPatches[i].agentInsideCount;
+				counts.agentNeighborhoodCount = fDomains[id].fFoodPatches[i].agentNeighborhoodCount;
+				domain.foodPatches.push_back( counts );
+			}
 		}
-		strcat(t,")" );
 	}
-	statusText.push_back( strdup( t ) );
-
-
-	sprintf( t, " -age    = %4ld", fNumberDiedAge );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, " -energy = %4ld", fNumberDiedEnergy );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, " -fight  = %4ld", fNumberDiedFight );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, " -eat    = %4ld", fNumberDiedEat );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, " -edge   = %4ld", fNumberDiedEdge );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, " -smite  = %4ld", fNumberDiedSmite );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, " -patch  = %4ld", fNumberDiedPatch );
-	statusText.push_back( strdup( t ) );
-
-    sprintf( t, "birthDenials = %ld", fBirthDenials );
-	statusText.push_back( strdup( t ) );
-
-    sprintf( t, "miscDenials = %ld", fMiscDenials );
-	statusText.push_back( strdup( t ) );
-
-    sprintf( t, "ageCreate = %ld", fLastCreated );
-    if (fNumDomains > 1)
-    {
-        sprintf( t2, " (%ld",fDomains[0].lastcreate );
-        strcat( t, t2 );
-        for (id = 1; id < fNumDomains; id++)
-        {
-            sprintf( t2, ",%ld",fDomains[id].lastcreate );
-            strcat( t, t2 );
-        }
-        strcat(t,")" );
-    }
-	statusText.push_back( strdup( t ) );
 
-	sprintf( t, "maxGapCreate = %ld", fMaxGapCreate );
-	if (fNumDomains > 1)
+	status.metabolisms.clear();
+	if( Metabolism::getNumberOfDefinitions() > 1 )
 	{
-		sprintf( t2, " (%ld",fDomains[0].maxgapcreate );
-	   	strcat( t, t2 );
-	   	for (id = 1; id < fNumDomains; id++)
-	   	{
-			sprintf( t2, ",%ld", fDomains[id].maxgapcreate );
-	       	strcat(t, t2 );
-	   	}
-	   	strcat(t,")" );
-	}
-	statusText.push_back( strdup( t ) );
-
-	if( (fHeuristicFitnessWeight != 0.0) || (fComplexityFitnessWeight != 0.0) )
-		sprintf( t, "born_v/(c+bv) = %.2f", float(fNumberBornVirtual) / float(fNumberCreated + fNumberBornVirtual) );
-	else
-		sprintf( t, "born/total = %.2f", float(fNumberBorn) / float(fNumberCreated + fNumberBorn) );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, "Fitness m=%.2f, c=%.2f, a=%.2f", fMaxFitness, fCurrentMaxFitness[0] / fTotalHeuristicFitness, fAverageFitness );
-	statusText.push_back( strdup( t ) );
-
-//	sprintf( t, "NormFit m=%.2f, c=%.2f, a=%.2f", fMaxFitness / fTotalHeuristicFitness, fCurrentMaxFitness[0] / fTotalHeuristicFitness, fAverageFitness / fTotalHeuristicFitness );
-//	statusText.push_back( strdup( t ) );
-
-	sprintf( t, "Fittest =" );
+		for( int i = 0; i < Metabolism::getNumberOfDefinitions(); i++ )
+			status.metabolisms.push_back( make_pair(Metabolism::get(i)->name, fNumberAliveWithMetabolism[i]) );
+	}
+
+	status.numCreated = fNumberCreated;
+	status.numCreatedRandom = fNumberCreatedRandom;
+	status.numCreated2Fit = fNumberCreated2Fit;
+	status.numCreated1Fit = fNumberCreated1Fit;
+	status.numBorn = fNumberBorn;
+	status.numBornVirtual = fNumberBornVirtual;
+	status.showBornVirtual = (fHeuristicFitnessWeight != 0.0) || (fComplexityFitnessWeight != 0.0) || fLockStepWithBirthsDeathsLog;
+	status.virtualBirthRatio = (fHeuristicFitnessWeight != 0.0) || (fComplexityFitnessWeight != 0.0);
+	status.numDied = fNumberDied;
+	status.numDiedAge = fNumberDiedAge;
+	status.numDiedEnergy = fNumberDiedEnergy;
+	status.numDiedFight = fNumberDiedFight;
+	status.numDiedEat = fNumberDiedEat;
+	status.numDiedEdge = fNumberDiedEdge;
+	status.numDiedSmite = fNumberDiedSmite;
+	status.numDiedPatch = fNumberDiedPatch;
+	status.birthDenials = fBirthDenials;
+	status.miscDenials = fMiscDenials;
+	status.lastCreated = fLastCreated;
+	status.maxGapCreate = fMaxGapCreate;
+
+	status.maxFitness = fMaxFitness;
+	status.currentMaxFitness = fCurrentMaxFitness[0] / fTotalHeuristicFitness;
+	status.averageFitness = fAverageFitness;
+
+	status.fittest.clear();
 	int fittestCount = min( 5, fFittest->size() );
 	for( int i = 0; i < fittestCount; i++ )
 	{
-		sprintf( t2, " %lu", fFittest->get(i)->agentID );
-		strcat( t, t2 );
+		StatusSnapshot::Fittest fittest = { fFittest->get(i)->agentID, fFittest->get(i)->fitness };
+		status.fittest.push_back( fittest );
 	}
-	statusText.push_back( strdup( t ) );
 
-	if( fittestCount > 0 )
-	{
-		sprintf( t, " " );
-		for( int i = 0; i < fittestCount; i++ )
-		{
-			sprintf( t2, "  %.2f", fFittest->get(i)->fitness );
-			strcat( t, t2 );
-		}
-		statusText.push_back( strdup( t ) );
-	}
-
-	sprintf( t, "CurFit =" );
+	status.currentFittest.clear();
 	for( int i = 0; i < fCurrentFittestCount; i++ )
 	{
-		sprintf( t2, " %lu", fCurrentFittestAgent[i]->Number() );
-		strcat( t, t2 );
+		StatusSnapshot::Fittest fittest = { (unsigned long)fCurrentFittestAgent[i]->Number(),
+											fCurrentFittestAgent[i]->HeuristicFitness() / fTotalHeuristicFitness };
+		status.currentFittest.push_back( fittest );
 	}
-	statusText.push_back( strdup( t ) );
 
-	if( fCurrentFittestCount > 0 )
-	{
-		sprintf( t, " " );
-		for( int i = 0; i < fCurrentFittestCount; i++ )
-		{
-			sprintf( t2, "  %.2f", fCurrentFittestAgent[i]->HeuristicFitness() / fTotalHeuristicFitness );
-			strcat( t, t2 );
-		}
-		statusText.push_back( strdup( t ) );
-	}
-
-	sprintf( t, "avgFoodEnergy = %.2f", (fAverageFoodEnergyIn - fAverageFoodEnergyOut) / (fAverageFoodEnergyIn + fAverageFoodEnergyOut) );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, "totFoodEnergy = %.2f", (fTotalFoodEnergyIn - fTotalFoodEnergyOut) / (fTotalFoodEnergyIn + fTotalFoodEnergyOut) );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, "totEnergyEaten = %.1f", fTotalEnergyEaten[0] );
-	for( int i = 1; i < globals::numEnergyTypes; i++ )
-	{
-		sprintf( t2, ", %.1f", fTotalEnergyEaten[i] );
-		strcat( t, t2 );
-	}
-	statusText.push_back( strdup( t ) );
+	status.avgFoodEnergy = (fAverageFoodEnergyIn - fAverageFoodEnergyOut) / (fAverageFoodEnergyIn + fAverageFoodEnergyOut);
+	status.totFoodEnergy = (fTotalFoodEnergyIn - fTotalFoodEnergyOut) / (fTotalFoodEnergyIn + fTotalFoodEnergyOut);
+	status.totalEnergyEaten = fTotalEnergyEaten;
 
 	static Energy lastTotalEnergyEaten;
 	static Energy deltaEnergy;
-    if( !(fStep % statusFrequency) )
-    {
+	if( !(fStep % statusFrequency) )
+	{
 		deltaEnergy = fTotalEnergyEaten - lastTotalEnergyEaten;
 		lastTotalEnergyEaten = fTotalEnergyEaten;
 	}
-	sprintf( t, "EatRate = %.1f", deltaEnergy[0] / statusFrequency );
-	for( int i = 1; i < globals::numEnergyTypes; i++ )
-	{
-		sprintf( t2, ", %.1f", deltaEnergy[i] / statusFrequency );
-		strcat( t, t2 );
-	}
-	statusText.push_back( strdup( t ) );
+	status.eatRate = deltaEnergy * (1.0f / statusFrequency);
 
 	static long lastNumberBorn = 0;
 	static long deltaBorn;
@@ -5119,122 +5327,57 @@ void TSimulation::getStatusText( StatusText& statusText,
 		numberBorn = fNumberBornVirtual;
 	else
 		numberBorn = fNumberBorn;
-    if( !(fStep % statusFrequency) )
-    {
+	if( !(fStep % statusFrequency) )
+	{
 		deltaBorn = numberBorn - lastNumberBorn;
 		lastNumberBorn = numberBorn;
 	}
-	sprintf( t, "MateRate = %.2f", (double) deltaBorn / statusFrequency );
-	statusText.push_back( strdup( t ) );
-
-	sprintf( t, "LifeSpan = %lu \xb1 %lu [%lu, %lu]", nint( fLifeSpanStats.mean() ), nint( fLifeSpanStats.stddev() ), (unsigned long) fLifeSpanStats.min(), (unsigned long) fLifeSpanStats.max() );
-	statusText.push_back( strdup( t ) );
+	status.mateRate = (double) deltaBorn / statusFrequency;
 
-	sprintf( t, "RecLifeSpan = %lu \xb1 %lu [%lu, %lu]", nint( fLifeSpanRecentStats.mean() ), nint( fLifeSpanRecentStats.stddev() ), (unsigned long) fLifeSpanRecentStats.min(), (unsigned long) fLifeSpanRecentStats.max() );
-	statusText.push_back( strdup( t ) );
+	status.eatFoodScanned = *fEatStatistics.GetProperty( "EatFoodScanned" );
+	status.eatFoodOverlapping = *fEatStatistics.GetProperty( "EatFoodOverlapping" );
 
-	// ---
-	// --- addStat()
-	// ---
-	function<void (const char *, Stat &)> addStat =
-		[&t, &statusText] ( const char *name, Stat &stat )
-		{
-			sprintf( t, "%s = %.1f \xb1 %.1f [%lu, %lu]",
-					 name, stat.mean(), stat.stddev(), (unsigned long) stat.min(), (unsigned long) stat.max() );
-			statusText.push_back( strdup( t ) );
-		};
+	status.lifeSpan = summarize( fLifeSpanStats );
+	status.recentLifeSpan = summarize( fLifeSpanRecentStats );
 
-	addStat( "CurNeurons", fCurrentBrainStats.neuronCount );
+	status.brainStats.clear();
+	status.brainStats.push_back( make_pair(string("CurNeurons"), summarize(fCurrentBrainStats.neuronCount)) );
 
 	switch( Brain::config.architecture )
 	{
 	case Brain::Configuration::Groups:
-		addStat( "CurNeurGroups", fCurrentBrainStats.groups.groupCount );
+		status.brainStats.push_back( make_pair(string("CurNeurGroups"), summarize(fCurrentBrainStats.groups.groupCount)) );
 		break;
 	case Brain::Configuration::Sheets:
-		addStat( "CurInternalSheets", fCurrentBrainStats.sheets.internalSheetCount );
-		addStat( "CurInternalNeurons", fCurrentBrainStats.sheets.internalNeuronCount );
+		status.brainStats.push_back( make_pair(string("CurInternalSheets"), summarize(fCurrentBrainStats.sheets.internalSheetCount)) );
+		status.brainStats.push_back( make_pair(string("CurInternalNeurons"), summarize(fCurrentBrainStats.sheets.internalNeuronCount)) );
 		for( SheetSynapseType &type : SheetSynapseTypes )
 		{
 			char name[ 64 ];
 			sprintf( name, "CurSynapse%sTo%s", sheets::Sheet::getName(type.from), sheets::Sheet::getName(type.to) );
 
-			addStat( name, fCurrentBrainStats.sheets.synapseCount[type.from][type.to] );
+			status.brainStats.push_back( make_pair(string(name), summarize(fCurrentBrainStats.sheets.synapseCount[type.from][type.to])) );
 		}
 		break;
 	default:
 		assert( false );
 	}
 
-	addStat( "CurSynapses", fCurrentBrainStats.synapseCount );
-
-	sprintf( t, "Rate %2.1f (%2.1f) %2.1f (%2.1f) %2.1f (%2.1f)",
-			 fFramesPerSecondInstantaneous, fSecondsPerFrameInstantaneous,
-			 fFramesPerSecondRecent,        fSecondsPerFrameRecent,
-			 fFramesPerSecondOverall,       fSecondsPerFrameOverall  );
-	statusText.push_back( strdup( t ) );
-
-	if( fCalcFoodPatchAgentCounts )
-	{
-		int numAgentsInAnyFoodPatchInAnyDomain = 0;
-		int numAgentsInOuterRangesInAnyDomain = 0;
-
-		for( int domainNumber = 0; domainNumber < fNumDomains; domainNumber++ )
-		{
-			sprintf( t, "Domain %d", domainNumber);
-			statusText.push_back( strdup( t ) );
-
-			int numAgentsInAnyFoodPatch = 0;
-			int numAgentsInOuterRanges = 0;
-
-			for( int i = 0; i < fDomains[domainNumber].numFoodPatches; i++ )
-			{
-				numAgentsInAnyFoodPatch += fDomains[domainNumber].fFoodPatches[i].agentInsideCount;
-				numAgentsInOuterRanges += fDomains[domainNumber].fFoodPatches[i].agentNeighborhoodCount;
-			}
-
-			float makePercent = 100.0 / fDomains[domainNumber].numAgents;
-			float makePercentNorm = 100.0 / numAgentsInAnyFoodPatch;
-
-			for( int i = 0; i < fDomains[domainNumber].numFoodPatches; i++ )
-			{
-				sprintf( t, "  FP%d %d %3d %3d  %4.1f %4.1f  %4.1f",
-						 i,
-						 fDomains[domainNumber].fFoodPatches[i].foodCount,
-						 fDomains[domainNumber].fFoodPatches[i].agentInsideCount,
-						 fDomains[domainNumber].fFoodPatches[i].agentInsideCount + fDomains[domainNumber].fFoodPatches[i].agentNeighborhoodCount,
-						 fDomains[domainNumber].fFoodPatches[i].agentInsideCount * makePercent,
-						(fDomains[domainNumber].fFoodPatches[i].agentInsideCount + fDomains[domainNumber].fFoodPatches[i].agentNeighborhoodCount) * makePercent,
-						 fDomains[domainNumber].fFoodPatches[i].agentInsideCount * makePercentNorm );
-				statusText.push_back( strdup( t ) );
-			}
-
+	status.brainStats.push_back( make_pair(string("CurSynapses"), summarize(fCurrentBrainStats.synapseCount)) );
 
-			sprintf( t, "  FP* %3d %3d  %4.1f %4.1f 100.0",
-					 numAgentsInAnyFoodPatch,
-					 numAgentsInAnyFoodPatch + numAgentsInOuterRanges,
-					 numAgentsInAnyFoodPatch * makePercent,
-					(numAgentsInAnyFoodPatch + numAgentsInOuterRanges) * makePercent );
-			statusText.push_back( strdup( t ) );
+	status.framesPerSecondInstantaneous = fFramesPerSecondInstantaneous;
+	status.secondsPerFrameInstantaneous = fSecondsPerFrameInstantaneous;
+	status.framesPerSecondRecent = fFramesPerSecondRecent;
+	status.secondsPerFrameRecent = fSecondsPerFrameRecent;
+	status.framesPerSecondOverall = fFramesPerSecondOverall;
+	status.secondsPerFrameOverall = fSecondsPerFrameOverall;
 
-			numAgentsInAnyFoodPatchInAnyDomain += numAgentsInAnyFoodPatch;
-			numAgentsInOuterRangesInAnyDomain += numAgentsInOuterRanges;
-		}
+	StepProfiler::getSummary( status );
 
-		if( fNumDomains > 1 )
-		{
-			float makePercent = 100.0 / objectxsortedlist::gXSortedObjects.getCount( AGENTTYPE );
-
-			sprintf( t, "**FP* %3d %3d  %4.1f %4.1f 100.0",
-					 numAgentsInAnyFoodPatchInAnyDomain,
-					 numAgentsInAnyFoodPatchInAnyDomain + numAgentsInOuterRangesInAnyDomain,
-					 numAgentsInAnyFoodPatchInAnyDomain * makePercent,
-					(numAgentsInAnyFoodPatchInAnyDomain + numAgentsInOuterRangesInAnyDomain) * makePercent );
-			statusText.push_back( strdup( t ) );
-		}
-	}
+	status.calcFoodPatchAgentCounts = fCalcFoodPatchAgentCounts;
 
 	// Dynamic Properties
+	status.dynamicProperties.clear();
 	{
 		int nprops;
 		proplib::CppProperties::PropertyMetadata *metadata;
@@ -5243,10 +5386,7 @@ void TSimulation::getStatusText( StatusText& statusText,
 		for( int i = 0; i < nprops; i++ )
 		{
 			if( metadata[i].type == proplib::CppProperties::PropertyMetadata::Dynamic )
-			{
-				sprintf( t, "%s = %s", metadata[i].name.c_str(), metadata[i].toString() );
-				statusText.push_back( strdup(t) );
-			}
+				status.dynamicProperties.push_back( make_pair(metadata[i].name, string(metadata[i].toString())) );
 		}
 	}
 }
@@ -5303,32 +5443,31 @@ void TSimulation::SetNextLockstepEvent()
 		exit(1);
 	}
 
-	const char *delimiters = " ";		// a single space is the field delimiter
-	char LockstepLine[512];				// making this big in case we add longer lines in the future.
-
 	fLockstepNumDeathsAtTimestep = 0;
 	fLockstepNumBirthsAtTimestep = 0;
 
-	if( fgets( LockstepLine, sizeof(LockstepLine), fLockstepFile ) )			// get the next event, if the LOCKSTEP-BirthsDeaths.log still has entries in it.
+	// skip to the next step with events, if LOCKSTEP-BirthsDeaths.log still has entries in it.
+	long maxStep = fLockstepEvents->getMaxStep();
+	while( (fLockstepNextStep <= maxStep)
+		   && (fLockstepEvents->begin(fLockstepNextStep) == fLockstepEvents->end(fLockstepNextStep)) )
 	{
-		fLockstepTimestep = atoi( strtok( LockstepLine, delimiters ) );		// token => timestep
-		assert( fLockstepTimestep > 0 );										// if we get a >= zero timestep something is definitely wrong.
+		fLockstepNextStep++;
+	}
 
-		int currentpos;
-		int nexttimestep;
-		char LockstepEvent;
+	if( fLockstepNextStep <= maxStep )
+	{
+		fLockstepTimestep = fLockstepNextStep;
+		assert( fLockstepTimestep > 0 );										// if we get a >= zero timestep something is definitely wrong.
 
-		do
+		const BirthsDeathsIndex::Record *end = fLockstepEvents->end( fLockstepNextStep );
+		for( const BirthsDeathsIndex::Record *event = fLockstepEvents->begin( fLockstepNextStep ); event != end; event++ )
 		{
-			nexttimestep = 0;
-			LockstepEvent = (strtok( NULL, delimiters ))[0];    // token => event
-
 			//TODO: Add support for the 'GENERATION' event.  Note a GENERATION event cannot be identical to a BIRTH event.  They must be made from the Fittest list.
-			if( LockstepEvent == 'B' )
+			if( event->type == BirthsDeathsIndex::BIRTH )
 				fLockstepNumBirthsAtTimestep++;
-			else if( LockstepEvent == 'D' )
+			else if( event->type == BirthsDeathsIndex::DEATH )
 				fLockstepNumDeathsAtTimestep++;
-			else if( LockstepEvent == 'C' )
+			else if( event->type == BirthsDeathsIndex::CREATION )
 			{
 				fLockstepNumBirthsAtTimestep++;
 				cerr << "t" << fLockstepTimestep << ": Warning: a CREATION event occured, but we're simply going to treat it as a random BIRTH." << endl;
@@ -5336,21 +5475,12 @@ void TSimulation::SetNextLockstepEvent()
 			else
 			{
 				cerr << "ERROR/SetNextLockstepEvent(): Currently only support events 'DEATH', 'BIRTH', and 'CREATION' events in the Lockstep file.  Exiting.";
-				cerr << "Latest Event: '" << LockstepEvent << "'" << endl;
+				cerr << "Latest Event: '" << BirthsDeathsIndex::getTypeName( event->type ) << "'" << endl;
 				exit(1);
 			}
+		}
 
-			currentpos = ftell( fLockstepFile );
-
-			//=======================
-
-			if( (fgets(LockstepLine, sizeof(LockstepLine), fLockstepFile)) != NULL )		// if LOCKSTEP-BirthsDeaths.log still has entries in it, nexttimestep is the timestep of the next line.
-				nexttimestep = atoi( strtok( LockstepLine, delimiters ) );    // token => timestep
-
-		} while( fLockstepTimestep == nexttimestep );
-
-		// reset to the beginning of the next timestep
-		fseek( fLockstepFile, currentpos, 0 );
+		fLockstepNextStep++;
 		lsPrint( "SetNextLockstepEvent()/ Timestep: %d\tDeaths: %d\tBirths: %d\n", fLockstepTimestep, fLockstepNumDeathsAtTimestep, fLockstepNumBirthsAtTimestep );
 	}
 }
@@ -5,6 +5,7 @@
 #endif
 
 #include <string>
+#include <vector>
 
 // Local
 #include "Domain.h"
@@ -12,10 +13,13 @@
 #include "FittestList.h"
 #include "GeneStats.h"
 #include "Scheduler.h"
+#include "StatusSnapshot.h"
 #include "simconst.h"
 #include "simtypes.h"
+#include "agent/AgentRegistry.h"
 #include "agent/LifeSpan.h"
 #include "environment/Energy.h"
+#include "environment/FoodIndex.h"
 #include "genome/SeparationCache.h"
 #include "graphics/gmisc.h"
 #include "graphics/gpolygon.h"
@@ -54,6 +58,7 @@ public:
 	void SwitchDomain( short newDomain, short oldDomain, int objectType );
 
 	class AgentPovRenderer *GetAgentPovRenderer();
+	Scheduler &getScheduler();
 	gstage &getStage();
 
 	bool isLockstep() const;
@@ -74,8 +79,8 @@ public:
 	float getFoodEnergy();
 	GeneStats &getGeneStats();
 
-	void getStatusText( StatusText& statusText,
-						int statusFrequency );
+	void getStatus( StatusSnapshot &status,
+					int statusFrequency );
 
 	long getStep() const;
 	long GetMaxSteps() const;
@@ -84,7 +89,8 @@ public:
 	double EnergyScaleFactor( long minAgents, long maxAgents, long numAgents );
 
 	bool fLockStepWithBirthsDeathsLog;	// Are we running in lockstep mode?
-	FILE * fLockstepFile;				// Define a file pointer to our LOCKSTEP-BirthsDeaths.log
+	class BirthsDeathsIndex *fLockstepEvents;	// index of LOCKSTEP-BirthsDeaths.log
+	long fLockstepNextStep;				// first step SetNextLockstepEvent() hasn't consumed
 	int fLockstepTimestep;				// Timestep at which the next event in LOCKSTEP-BirthDeaths.log occurs
 	int fLockstepNumDeathsAtTimestep;	// How many agents died at this LockstepTimestep?
 	int fLockstepNumBirthsAtTimestep;	// how many agents were born at LockstepTimestep?
@@ -170,6 +176,10 @@ private:
 	void UpdateAgents_StaticTimestepGeometry();
 
 	void Interact();
+	void FindInteractCandidates();
+	void InteractPair( agent *c,
+					   agent *d,
+					   bool *cDied );
 	void DeathAndStats();
 	void MateLockstep();
 	int GetMatePotential( agent *x );
@@ -200,6 +210,8 @@ private:
 			   bool toMarkOnDeath );
 	void Eat( agent *c,
 			  bool *cDied );
+	void EatFood( agent *c,
+				  food *f );
 	void Carry( agent *c );
 	void Pickup( agent *c );
 	void Drop( agent *c );
@@ -226,7 +238,10 @@ private:
 	void updateFittest( agent *c );
 
 	void AddFood( long domainNumber, long patchNumber );
+	void AddNewFood();
 	void RemoveFood( food *f );
+	void RemoveFoods( std::vector<food *> &foods );
+	void UnlinkFood( food *f );
 
 	void FoodEnergyIn( const Energy &e );
 	void FoodEnergyOut( const Energy &e );
@@ -368,6 +383,10 @@ private:
 	class FoodPatch* fFoodPatches;
 	class FoodPatch** fFoodPatchesNeedingRemoval;
 
+	FoodIndex fFoodIndex;
+	std::vector<gobject *> fNewFood;		// grown this step, not yet in the world
+	std::vector<food *> fEatCandidates;
+
 	int fNumBrickPatches;
 	class BrickPatch* fBrickPatches;
 
@@ -441,8 +460,19 @@ private:
 	bool fStaticTimestepGeometry;
 	bool fParallelInitAgents;
 	bool fParallelInteract;
+
+	// Interact runs in two phases when fParallelInteract is set: contacts are
+	// found for all agents in parallel, then resolved on the master thread in
+	// x-sorted order exactly as a single pass would.
+	struct InteractCandidates
+	{
+		bool active;
+		std::vector<agent *> agents;					// x-sorted, as of the start of resolution
+		std::vector< std::vector<agent *> > contacts;	// per agent, overlapping agents later in x
+	} fInteractCandidates;
 	bool fParallelCreateAgents;
 	bool fParallelBrains;
+	bool fBatchRetinaReadback;
 
     gpolyobj fGround;
     TSetList fWorldSet;
@@ -453,6 +483,7 @@ private:
 inline void TSimulation::enableComplexityCalculations() { fCalcComplexity = true; }
 
 inline class AgentPovRenderer *TSimulation::GetAgentPovRenderer() { return agentPovRenderer; }
+inline Scheduler &TSimulation::getScheduler() { return fScheduler; }
 inline gstage &TSimulation::getStage() { return fStage; }
 
 
@@ -490,13 +521,7 @@ inline FittestList *TSimulation::getFittest( FitnessScope scope )
 }
 inline class agent *TSimulation::getAgentByNumber( long number )
 {
-	class agent* a;
-	objectxsortedlist::gXSortedObjects.reset();
-	while( objectxsortedlist::gXSortedObjects.nextObj( AGENTTYPE, (gobject**) &a ) )
-	{
-		if( a->Number() == number) return a;
-	}
-	return NULL;
+	return AgentRegistry::find( number );
 }
 inline class agent *TSimulation::getCurrentFittest( int rank )
 {
@@ -0,0 +1,310 @@
+#include "StatusSnapshot.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "globals.h"
+#include "utils/misc.h"
+
+using namespace std;
+
+namespace sim
+{
+
+//---------------------------------------------------------------------------
+// appendDomains
+//
+// Appends " (v0, v1, ...)" when there is more than one domain.
+//---------------------------------------------------------------------------
+template<typename T>
+static void appendDomains( char *t,
+						   const StatusSnapshot &status,
+						   T StatusSnapshot::Domain::*field,
+						   const char *format,
+						   const char *separator )
+{
+	if( status.domains.size() < 2 )
+		return;
+
+	char t2[256];
+
+	strcat( t, " (" );
+	for( size_t id = 0; id < status.domains.size(); id++ )
+	{
+		if( id > 0 )
+			strcat( t, separator );
+		sprintf( t2, format, status.domains[id].*field );
+		strcat( t, t2 );
+	}
+	strcat( t, ")" );
+}
+
+//---------------------------------------------------------------------------
+// formatStatusText
+//---------------------------------------------------------------------------
+void formatStatusText( const StatusSnapshot &status, StatusText &statusText )
+{
+	typedef StatusSnapshot::Domain Domain;
+
+	char t[256];
+	char t2[256];
+
+	sprintf( t, "step = %ld", status.step );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "agents = %4d", status.numAgents );
+	appendDomains( t, status, &Domain::numAgents, "%ld", ", " );
+	statusText.push_back( strdup( t ) );
+
+	for( size_t i = 0; i < status.metabolisms.size(); i++ )
+	{
+		sprintf( t, " -%s = %4ld", status.metabolisms[i].first.c_str(), status.metabolisms[i].second );
+		statusText.push_back( strdup( t ) );
+	}
+
+	sprintf( t, "food = %4d", status.numFood );
+	appendDomains( t, status, &Domain::foodCount, "%d", ", " );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "foodEnergy = %.1f", status.foodEnergy );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "created  = %4ld", status.numCreated );
+	appendDomains( t, status, &Domain::numCreated, "%ld", "," );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, " -random = %4ld", status.numCreatedRandom );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, " -two    = %4ld", status.numCreated2Fit );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, " -one    = %4ld", status.numCreated1Fit );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "born     = %4ld", status.numBorn );
+	appendDomains( t, status, &Domain::numBorn, "%ld", "," );
+	statusText.push_back( strdup( t ) );
+
+	if( status.showBornVirtual )
+	{
+		sprintf( t, "born_v   = %4ld", status.numBornVirtual );
+		statusText.push_back( strdup( t ) );
+	}
+
+	sprintf( t, "died     = %4ld", status.numDied );
+	appendDomains( t, status, &Domain::numDied, "%ld", "," );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, " -age    = %4ld", status.numDiedAge );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, " -energy = %4ld", status.numDiedEnergy );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, " -fight  = %4ld", status.numDiedFight );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, " -eat    = %4ld", status.numDiedEat );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, " -edge   = %4ld", status.numDiedEdge );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, " -smite  = %4ld", status.numDiedSmite );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, " -patch  = %4ld", status.numDiedPatch );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "birthDenials = %ld", status.birthDenials );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "miscDenials = %ld", status.miscDenials );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "ageCreate = %ld", status.lastCreated );
+	appendDomains( t, status, &Domain::lastCreate, "%ld", "," );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "maxGapCreate = %ld", status.maxGapCreate );
+	appendDomains( t, status, &Domain::maxGapCreate, "%ld", "," );
+	statusText.push_back( strdup( t ) );
+
+	if( status.virtualBirthRatio )
+		sprintf( t, "born_v/(c+bv) = %.2f", float(status.numBornVirtual) / float(status.numCreated + status.numBornVirtual) );
+	else
+		sprintf( t, "born/total = %.2f", float(status.numBorn) / float(status.numCreated + status.numBorn) );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "Fitness m=%.2f, c=%.2f, a=%.2f", status.maxFitness, status.currentMaxFitness, status.averageFitness );
+	statusText.push_back( strdup( t ) );
+
+	// ---
+	// --- addFittest()
+	// ---
+	auto addFittest =
+		[&t, &t2, &statusText] ( const char *name, const vector<StatusSnapshot::Fittest> &fittest )
+		{
+			sprintf( t, "%s =", name );
+			for( size_t i = 0; i < fittest.size(); i++ )
+			{
+				sprintf( t2, " %lu", fittest[i].agentID );
+				strcat( t, t2 );
+			}
+			statusText.push_back( strdup( t ) );
+
+			if( !fittest.empty() )
+			{
+				sprintf( t, " " );
+				for( size_t i = 0; i < fittest.size(); i++ )
+				{
+					sprintf( t2, "  %.2f", fittest[i].fitness );
+					strcat( t, t2 );
+				}
+				statusText.push_back( strdup( t ) );
+			}
+		};
+
+	addFittest( "Fittest", status.fittest );
+	addFittest( "CurFit", status.currentFittest );
+
+	sprintf( t, "avgFoodEnergy = %.2f", status.avgFoodEnergy );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "totFoodEnergy = %.2f", status.totFoodEnergy );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "totEnergyEaten = %.1f", status.totalEnergyEaten[0] );
+	for( int i = 1; i < globals::numEnergyTypes; i++ )
+	{
+		sprintf( t2, ", %.1f", status.totalEnergyEaten[i] );
+		strcat( t, t2 );
+	}
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "EatRate = %.1f", status.eatRate[0] );
+	for( int i = 1; i < globals::numEnergyTypes; i++ )
+	{
+		sprintf( t2, ", %.1f", status.eatRate[i] );
+		strcat( t, t2 );
+	}
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "MateRate = %.2f", status.mateRate );
+	statusText.push_back( strdup( t ) );
+
+	sprintf( t, "EatScan = %.1f (%.2f overlapping)", status.eatFoodScanned, status.eatFoodOverlapping );
+	statusText.push_back( strdup( t ) );
+
+	// ---
+	// --- addLifeSpan()
+	// ---
+	auto addLifeSpan =
+		[&t, &statusText] ( const char *name, const StatusSnapshot::StatSummary &stat )
+		{
+			sprintf( t, "%s = %lu \xb1 %lu [%lu, %lu]",
+					 name, nint( stat.mean ), nint( stat.stddev ), (unsigned long) stat.min, (unsigned long) stat.max );
+			statusText.push_back( strdup( t ) );
+		};
+
+	addLifeSpan( "LifeSpan", status.lifeSpan );
+	addLifeSpan( "RecLifeSpan", status.recentLifeSpan );
+
+	for( size_t i = 0; i < status.brainStats.size(); i++ )
+	{
+		const StatusSnapshot::StatSummary &stat = status.brainStats[i].second;
+		sprintf( t, "%s = %.1f \xb1 %.1f [%lu, %lu]",
+				 status.brainStats[i].first.c_str(), stat.mean, stat.stddev, (unsigned long) stat.min, (unsigned long) stat.max );
+		statusText.push_back( strdup( t ) );
+	}
+
+	sprintf( t, "Rate %2.1f (%2.1f) %2.1f (%2.1f) %2.1f (%2.1f)",
+			 status.framesPerSecondInstantaneous, status.secondsPerFrameInstantaneous,
+			 status.framesPerSecondRecent,        status.secondsPerFrameRecent,
+			 status.framesPerSecondOverall,       status.secondsPerFrameOverall  );
+	statusText.push_back( strdup( t ) );
+
+	if( status.profileSteps > 0 )
+	{
+		sprintf( t, "Profile %.2f ms/step (%ld steps)", status.profileMsPerStep, status.profileSteps );
+		statusText.push_back( strdup( t ) );
+
+		for( size_t i = 0; i < status.profilePhases.size(); i++ )
+		{
+			sprintf( t, " -%s = %.2f ms", status.profilePhases[i].first.c_str(), status.profilePhases[i].second );
+			statusText.push_back( strdup( t ) );
+		}
+	}
+
+	if( status.calcFoodPatchAgentCounts )
+	{
+		int numAgentsInAnyFoodPatchInAnyDomain = 0;
+		int numAgentsInOuterRangesInAnyDomain = 0;
+
+		for( size_t domainNumber = 0; domainNumber < status.domains.size(); domainNumber++ )
+		{
+			const Domain &domain = status.domains[domainNumber];
+
+			sprintf( t, "Domain %d", (int)domainNumber );
+			statusText.push_back( strdup( t ) );
+
+			int numAgentsInAnyFoodPatch = 0;
+			int numAgentsInOuterRanges = 0;
+
+			for( size_t i = 0; i < domain.foodPatches.size(); i++ )
+			{
+				numAgentsInAnyFoodPatch += domain.foodPatches[i].agentInsideCount;
+				numAgentsInOuterRanges += domain.foodPatches[i].agentNeighborhoodCount;
+			}
+
+			float makePercent = 100.0 / domain.numAgents;
+			float makePercentNorm = 100.0 / numAgentsInAnyFoodPatch;
+
+			for( size_t i = 0; i < domain.foodPatches.size(); i++ )
+			{
+				const StatusSnapshot::FoodPatchCounts &patch = domain.foodPatches[i];
+
+				sprintf( t, "  FP%d %d %3d %3d  %4.1f %4.1f  %4.1f",
+						 (int)i,
+						 patch.foodCount,
+						 patch.agentInsideCount,
+						 patch.agentInsideCount + patch.agentNeighborhoodCount,
+						 patch.agentInsideCount * makePercent,
+						(patch.agentInsideCount + patch.agentNeighborhoodCount) * makePercent,
+						 patch.agentInsideCount * makePercentNorm );
+				statusText.push_back( strdup( t ) );
+			}
+
+			sprintf( t, "  FP* %3d %3d  %4.1f %4.1f 100.0",
+					 numAgentsInAnyFoodPatch,
+					 numAgentsInAnyFoodPatch + numAgentsInOuterRanges,
+					 numAgentsInAnyFoodPatch * makePercent,
+					(numAgentsInAnyFoodPatch + numAgentsInOuterRanges) * makePercent );
+			statusText.push_back( strdup( t ) );
+
+			numAgentsInAnyFoodPatchInAnyDomain += numAgentsInAnyFoodPatch;
+			numAgentsInOuterRangesInAnyDomain += numAgentsInOuterRanges;
+		}
+
+		if( status.domains.size() > 1 )
+		{
+			float makePercent = 100.0 / status.numAgents;
+
+			sprintf( t, "**FP* %3d %3d  %4.1f %4.1f 100.0",
+					 numAgentsInAnyFoodPatchInAnyDomain,
+					 numAgentsInAnyFoodPatchInAnyDomain + numAgentsInOuterRangesInAnyDomain,
+					 numAgentsInAnyFoodPatchInAnyDomain * makePercent,
+					(numAgentsInAnyFoodPatchInAnyDomain + numAgentsInOuterRangesInAnyDomain) * makePercent );
+			statusText.push_back( strdup( t ) );
+		}
+	}
+
+	for( size_t i = 0; i < status.dynamicProperties.size(); i++ )
+	{
+		sprintf( t, "%s = %s", status.dynamicProperties[i].first.c_str(), status.dynamicProperties[i].second.c_str() );
+		statusText.push_back( strdup( t ) );
+	}
+}
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "simtypes.h"
+#include "environment/Energy.h"
+
+namespace sim
+{
+	//===========================================================================
+	// StatusSnapshot
+	//
+	// The values behind the status text, as of one step. Filling one is a
+	// handful of copies; the text is only formatted by formatStatusText() when
+	// somebody reads it.
+	//===========================================================================
+	struct StatusSnapshot
+	{
+		struct StatSummary
+		{
+			StatSummary() : mean(0), stddev(0), min(0), max(0) {}
+
+			float mean;
+			float stddev;
+			float min;
+			float max;
+		};
+
+		struct FoodPatchCounts
+		{
+			int foodCount;
+			int agentInsideCount;
+			int agentNeighborhoodCount;
+		};
+
+		struct Domain
+		{
+			long numAgents;
+			int foodCount;
+			long numCreated;
+			long numBorn;
+			long numDied;
+			long lastCreate;
+			long maxGapCreate;
+			std::vector<FoodPatchCounts> foodPatches;
+		};
+
+		struct Fittest
+		{
+			unsigned long agentID;
+			float fitness;
+		};
+
+		StatusSnapshot() : step(-1) {}
+
+		long step;
+
+		int numAgents;
+		int numFood;
+		float foodEnergy;
+		std::vector<Domain> domains;
+		std::vector< std::pair<std::string, long> > metabolisms;	// only if more than one
+
+		long numCreated;
+		long numCreatedRandom;
+		long numCreated2Fit;
+		long numCreated1Fit;
+		long numBorn;
+		long numBornVirtual;
+		bool showBornVirtual;
+		bool virtualBirthRatio;
+		long numDied;
+		long numDiedAge;
+		long numDiedEnergy;
+		long numDiedFight;
+		long numDiedEat;
+		long numDiedEdge;
+		long numDiedSmite;
+		long numDiedPatch;
+		long birthDenials;
+		long miscDenials;
+		long lastCreated;
+		long maxGapCreate;
+
+		float maxFitness;
+		float currentMaxFitness;
+		float averageFitness;
+		std::vector<Fittest> fittest;
+		std::vector<Fittest> currentFittest;
+
+		float avgFoodEnergy;
+		float totFoodEnergy;
+		Energy totalEnergyEaten;
+		Energy eatRate;
+		double mateRate;
+		float eatFoodScanned;
+		float eatFoodOverlapping;
+
+		StatSummary lifeSpan;
+		StatSummary recentLifeSpan;
+		std::vector< std::pair<std::string, StatSummary> > brainStats;
+
+		double framesPerSecondInstantaneous;
+		double secondsPerFrameInstantaneous;
+		double framesPerSecondRecent;
+		double secondsPerFrameRecent;
+		double framesPerSecondOverall;
+		double secondsPerFrameOverall;
+
+		// From StepProfiler; profileSteps is 0 while profiling is off.
+		long profileSteps;
+		double profileMsPerStep;
+		std::vector< std::pair<std::string, double> > profilePhases;	// ms/step, costliest first
+
+		bool calcFoodPatchAgentCounts;
+
+		std::vector< std::pair<std::string, std::string> > dynamicProperties;
+	};
+
+	void formatStatusText( const StatusSnapshot &status, StatusText &statusText );
+}
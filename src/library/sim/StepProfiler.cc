@@ -0,0 +1,327 @@
+#include "StepProfiler.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+#include <mutex>
+
+#include "StatusSnapshot.h"
+#include "utils/datalib.h"
+#include "utils/misc.h"
+
+using namespace std;
+using namespace std::chrono;
+
+#define DatalibPath "run/profile/steps.txt"
+#define TracePath "run/profile/trace.json"
+
+#define SummaryMaxPhases 8
+
+atomic<bool> StepProfiler::enabled( false );
+bool StepProfiler::closed = false;
+StepProfiler::Timeline StepProfiler::timeline = StepProfiler::TIMELINE_NONE;
+vector<string> StepProfiler::phaseNames;
+vector<StepProfiler::ThreadRecord *> StepProfiler::threadRecords;
+StepProfiler::TimePoint StepProfiler::epoch;
+DataLibWriter *StepProfiler::datalibWriter = NULL;
+FILE *StepProfiler::traceFile = NULL;
+bool StepProfiler::traceFirstEvent = true;
+double StepProfiler::summarySeconds[];
+long StepProfiler::summarySteps = 0;
+
+static mutex threadRecordsMutex;
+
+//---------------------------------------------------------------------------
+// StepProfiler::definePhase
+//---------------------------------------------------------------------------
+int StepProfiler::definePhase( const string &name )
+{
+	definePhases();
+
+	assert( datalibWriter == NULL );
+	assert( (int)phaseNames.size() < MAX_PHASES );
+
+	phaseNames.push_back( name );
+
+	return phaseNames.size() - 1;
+}
+
+//---------------------------------------------------------------------------
+// StepProfiler::init
+//---------------------------------------------------------------------------
+void StepProfiler::init( bool enabled, Timeline timeline )
+{
+	definePhases();
+
+	StepProfiler::enabled = enabled;
+	StepProfiler::timeline = timeline;
+	closed = false;
+
+	epoch = steady_clock::now();
+}
+
+//---------------------------------------------------------------------------
+// StepProfiler::close
+//---------------------------------------------------------------------------
+void StepProfiler::close()
+{
+	enabled = false;
+	closed = true;
+
+	if( datalibWriter )
+	{
+		delete datalibWriter;
+		datalibWriter = NULL;
+	}
+
+	if( traceFile )
+	{
+		fprintf( traceFile, "\n]\n" );
+		fclose( traceFile );
+		traceFile = NULL;
+	}
+}
+
+//---------------------------------------------------------------------------
+// StepProfiler::setEnabled
+//
+// Only call between steps. Ignored once closed.
+//---------------------------------------------------------------------------
+void StepProfiler::setEnabled( bool enabled )
+{
+	if( closed )
+		return;
+
+	StepProfiler::enabled = enabled;
+}
+
+//---------------------------------------------------------------------------
+// StepProfiler::endStep
+//
+// Must be invoked by the master thread with no parallel tasks outstanding.
+//---------------------------------------------------------------------------
+void StepProfiler::endStep( long step )
+{
+	if( closed || !enabled )
+		return;
+
+	int nphases = phaseNames.size();
+	double seconds[MAX_PHASES];
+	memset( seconds, 0, sizeof(seconds) );
+
+	{
+		lock_guard<mutex> lock( threadRecordsMutex );
+
+		for( ThreadRecord *record : threadRecords )
+		{
+			for( int i = 0; i < nphases; i++ )
+				seconds[i] += record->seconds[i];
+		}
+	}
+
+	for( int i = 0; i < nphases; i++ )
+		summarySeconds[i] += seconds[i];
+	summarySteps++;
+
+	switch( timeline )
+	{
+	case TIMELINE_NONE:
+		break;
+	case TIMELINE_DATALIB:
+		writeDatalib( step, seconds );
+		break;
+	case TIMELINE_CHROME_TRACE:
+		writeDatalib( step, seconds );
+		writeTrace( step );
+		break;
+	default:
+		assert( false );
+	}
+
+	lock_guard<mutex> lock( threadRecordsMutex );
+	for( ThreadRecord *record : threadRecords )
+	{
+		memset( record->seconds, 0, sizeof(record->seconds) );
+		record->events.clear();
+	}
+}
+
+//---------------------------------------------------------------------------
+// StepProfiler::getSummary
+//
+// Fills in the costliest phases, averaged over the steps since the previous
+// call. Times of phases that run in parallel tasks are summed over threads.
+//---------------------------------------------------------------------------
+void StepProfiler::getSummary( sim::StatusSnapshot &status )
+{
+	status.profileSteps = summarySteps;
+	status.profilePhases.clear();
+
+	if( summarySteps == 0 )
+		return;
+
+	vector< pair<double, int> > phases;
+	for( int i = 0; i < (int)phaseNames.size(); i++ )
+	{
+		if( (i != STEP) && (summarySeconds[i] > 0.0) )
+			phases.push_back( make_pair(summarySeconds[i], i) );
+	}
+	sort( phases.begin(), phases.end(),
+		  []( const pair<double, int> &a, const pair<double, int> &b )
+		  {
+			  return a.first > b.first;
+		  } );
+
+	status.profileMsPerStep = 1000.0 * summarySeconds[STEP] / summarySteps;
+
+	for( int i = 0; i < min((int)phases.size(), SummaryMaxPhases); i++ )
+	{
+		status.profilePhases.push_back( make_pair(phaseNames[phases[i].second],
+												  1000.0 * phases[i].first / summarySteps) );
+	}
+
+	memset( summarySeconds, 0, sizeof(summarySeconds) );
+	summarySteps = 0;
+}
+
+//---------------------------------------------------------------------------
+// StepProfiler::definePhases
+//---------------------------------------------------------------------------
+void StepProfiler::definePhases()
+{
+	if( !phaseNames.empty() )
+		return;
+
+	phaseNames.resize( __NPHASES );
+
+#define PHASE(ID, NAME) phaseNames[ID] = NAME
+	PHASE( STEP, "Step" );
+	PHASE( UPDATE_VISION, "UpdateVision" );
+	PHASE( UPDATE_BRAIN, "UpdateBrain" );
+	PHASE( UPDATE_BODY, "UpdateBody" );
+	PHASE( INTERACT, "Interact" );
+	PHASE( CREATE_AGENTS, "CreateAgents" );
+	PHASE( BRAIN_CONSTRUCTION, "BrainConstruction" );
+	PHASE( MAINTAIN_BRICKS, "MaintainBricks" );
+	PHASE( MAINTAIN_FOOD, "MaintainFood" );
+	PHASE( STEP_ENDING, "StepEnding" );
+#undef PHASE
+}
+
+//---------------------------------------------------------------------------
+// StepProfiler::record
+//---------------------------------------------------------------------------
+void StepProfiler::record( int phase, TimePoint start, TimePoint end )
+{
+	// A timer started before close() may stop after it.
+	if( !enabled.load(memory_order_relaxed) )
+		return;
+
+	ThreadRecord *record = getThreadRecord();
+
+	record->seconds[phase] += duration<double>( end - start ).count();
+
+	if( timeline == TIMELINE_CHROME_TRACE )
+	{
+		TraceEvent event = { phase, start, end };
+		record->events.push_back( event );
+	}
+}
+
+//---------------------------------------------------------------------------
+// StepProfiler::getThreadRecord
+//---------------------------------------------------------------------------
+StepProfiler::ThreadRecord *StepProfiler::getThreadRecord()
+{
+	static thread_local ThreadRecord *record = NULL;
+
+	if( record == NULL )
+	{
+		lock_guard<mutex> lock( threadRecordsMutex );
+
+		record = new ThreadRecord();
+		record->tid = threadRecords.size();
+		memset( record->seconds, 0, sizeof(record->seconds) );
+
+		threadRecords.push_back( record );
+	}
+
+	return record;
+}
+
+//---------------------------------------------------------------------------
+// StepProfiler::writeDatalib
+//---------------------------------------------------------------------------
+void StepProfiler::writeDatalib( long step, double *seconds )
+{
+	int nphases = phaseNames.size();
+
+	if( datalibWriter == NULL )
+	{
+		makeParentDir( DatalibPath );
+		datalibWriter = new DataLibWriter( DatalibPath );
+
+		vector<string> colnames;
+		vector<datalib::Type> coltypes;
+
+		colnames.push_back( "Timestep" );
+		coltypes.push_back( datalib::INT );
+		for( const string &name : phaseNames )
+		{
+			colnames.push_back( name );
+			coltypes.push_back( datalib::FLOAT );
+		}
+
+		datalibWriter->beginTable( "Milliseconds", colnames, coltypes );
+	}
+
+	Variant cols[MAX_PHASES + 1];
+	cols[0] = step;
+	for( int i = 0; i < nphases; i++ )
+		cols[i + 1] = float( 1000.0 * seconds[i] );
+
+	datalibWriter->addRow( cols );
+}
+
+//---------------------------------------------------------------------------
+// StepProfiler::writeTrace
+//---------------------------------------------------------------------------
+void StepProfiler::writeTrace( long step )
+{
+	if( traceFile == NULL )
+	{
+		makeParentDir( TracePath );
+		traceFile = fopen( TracePath, "w" );
+		if( traceFile == NULL )
+		{
+			fprintf( stderr, "Failed opening %s\n", TracePath );
+			timeline = TIMELINE_DATALIB;
+			return;
+		}
+
+		// JSON array form of the Chrome trace format; viewers accept it even
+		// if the closing bracket is missing after a crash.
+		fprintf( traceFile, "[" );
+		traceFirstEvent = true;
+	}
+
+	for( ThreadRecord *record : threadRecords )
+	{
+		for( const TraceEvent &event : record->events )
+		{
+			fprintf( traceFile,
+					 "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+					 traceFirstEvent ? "" : ",",
+					 phaseNames[event.phase].c_str(),
+					 record->tid,
+					 duration<double, micro>( event.start - epoch ).count(),
+					 duration<double, micro>( event.end - event.start ).count() );
+			if( event.phase == STEP )
+				fprintf( traceFile, ",\"args\":{\"step\":%ld}", step );
+			fprintf( traceFile, "}" );
+
+			traceFirstEvent = false;
+		}
+	}
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "simtypes.h"
+
+class DataLibWriter;
+namespace sim { struct StatusSnapshot; }
+
+// ================================================================================
+// ===
+// === CLASS StepProfiler
+// ===
+// === Scoped wall-clock timers for the phases of a simulation step. Each thread
+// === accumulates into its own record, so timers in parallel tasks never
+// === contend; the master folds the records together in endStep(), once all
+// === tasks of the step are done.
+// ===
+// === Per-step totals go to run/profile/steps.txt (datalib) and, with the
+// === ChromeTrace timeline, every scope goes to run/profile/trace.json for
+// === chrome://tracing or Perfetto.
+// ===
+// === A disabled profiler costs one branch per scope.
+// ===
+// ================================================================================
+class StepProfiler
+{
+ public:
+	enum Timeline
+	{
+		TIMELINE_NONE,
+		TIMELINE_DATALIB,
+		TIMELINE_CHROME_TRACE
+	};
+
+	// Fixed phases; loggers define theirs with definePhase().
+	enum Phase
+	{
+		STEP = 0,
+		UPDATE_VISION,
+		UPDATE_BRAIN,
+		UPDATE_BODY,
+		INTERACT,
+		CREATE_AGENTS,
+		BRAIN_CONSTRUCTION,
+		MAINTAIN_BRICKS,
+		MAINTAIN_FOOD,
+		STEP_ENDING,
+		__NPHASES
+	};
+
+	static const int MAX_PHASES = 128;
+
+	// Phases may only be defined before the first step.
+	static int definePhase( const std::string &name );
+
+	static void init( bool enabled, Timeline timeline );
+	static void close();
+
+	static bool isEnabled() { return enabled.load( std::memory_order_relaxed ); }
+	static void setEnabled( bool enabled );
+
+	static void endStep( long step );
+	static void getSummary( sim::StatusSnapshot &status );
+
+	class Timer
+	{
+	public:
+		Timer( int phase )
+		{
+			if( StepProfiler::enabled.load(std::memory_order_relaxed) )
+			{
+				this->phase = phase;
+				start = std::chrono::steady_clock::now();
+			}
+			else
+			{
+				this->phase = -1;
+			}
+		}
+
+		~Timer()
+		{
+			stop();
+		}
+
+		void stop()
+		{
+			if( phase >= 0 )
+			{
+				StepProfiler::record( phase, start, std::chrono::steady_clock::now() );
+				phase = -1;
+			}
+		}
+
+	private:
+		int phase;
+		std::chrono::steady_clock::time_point start;
+	};
+
+ private:
+	typedef std::chrono::steady_clock::time_point TimePoint;
+
+	struct TraceEvent
+	{
+		int phase;
+		TimePoint start;
+		TimePoint end;
+	};
+
+	struct ThreadRecord
+	{
+		int tid;
+		double seconds[MAX_PHASES];
+		std::vector<TraceEvent> events;
+	};
+
+	static void definePhases();
+	static void record( int phase, TimePoint start, TimePoint end );
+	static ThreadRecord *getThreadRecord();
+	static void writeDatalib( long step, double *seconds );
+	static void writeTrace( long step );
+
+	// Read by timers on worker threads while the UI thread may toggle it.
+	static std::atomic<bool> enabled;
+	// Set by close(); the profiler never records or writes again.
+	static bool closed;
+	static Timeline timeline;
+	static std::vector<std::string> phaseNames;
+	static std::vector<ThreadRecord *> threadRecords;
+	static TimePoint epoch;
+
+	static DataLibWriter *datalibWriter;
+	static FILE *traceFile;
+	static bool traceFirstEvent;
+
+	// Totals since the last getSummary().
+	static double summarySeconds[MAX_PHASES];
+	static long summarySteps;
+};
@@ -33,7 +33,7 @@ void DebugCheck( const char* func, const char* frmt, ... )
 	gobject* b = NULL;
 	gobject* bbad = NULL;
 	
-	gdlink<gobject*> *saveCurr = objectxsortedlist::gXSortedObjects.getcurr();	// save the state of the x-sorted list
+	gobject *saveCurr = objectxsortedlist::gXSortedObjects.getcurr();	// save the state of the x-sorted list
 	
 	objectxsortedlist::gXSortedObjects.reset();
 	objectxsortedlist::gXSortedObjects.nextObj( AGENTTYPE, (gobject**) &a );
@@ -8,7 +8,23 @@
 #include <unistd.h>
 #include <sys/stat.h>
 
+#include "BlockCompression.h"
+
 #define GZIP_EXT ".gz"
+#define ZSTD_EXT ".zst"
+
+static bool hasExtension( const char *path, const char *ext )
+{
+	size_t len = strlen( path );
+	size_t extlen = strlen( ext );
+
+	return len >= extlen && 0 == strcmp( path + len - extlen, ext );
+}
+
+static bool isWriteMode( const char *mode )
+{
+	return mode[0] == 'w' || mode[0] == 'a';
+}
 
 AbstractFile *AbstractFile::open( ConcreteFileType type,
 								  const char *abstractPath,
@@ -42,6 +58,12 @@ bool AbstractFile::exists(  const char *abstractPath,
 		type = TYPE_GZIP_FILE;
 	}
 
+	if( exists(TYPE_ZSTD_FILE, abstractPath) )
+	{
+		numFound++;
+		type = TYPE_ZSTD_FILE;
+	}
+
 	if( isAmbiguous != NULL )
 	{
 		*isAmbiguous = numFound > 1;
@@ -152,6 +174,19 @@ int AbstractFile::rename( const char *oldAbstractPath,
 	return rc;
 }
 
+AbstractFile::ConcreteFileType AbstractFile::getCompressedType( const char *backendName )
+{
+	if( 0 == strcmp(backendName, "Gzip") )
+		return TYPE_GZIP_FILE;
+	else if( 0 == strcmp(backendName, "ParallelGzip") )
+		return TYPE_PARALLEL_GZIP_FILE;
+	else if( 0 == strcmp(backendName, "Zstd") )
+		return TYPE_ZSTD_FILE;
+
+	fprintf( stderr, "Invalid compression backend: %s\n", backendName );
+	exit( 1 );
+}
+
 AbstractFile::AbstractFile( ConcreteFileType type,
 							const char *abstractPath,
 							const char *mode )
@@ -177,9 +212,17 @@ AbstractFile::AbstractFile( const char *abstractPath,
 		numFound++;
 	}
 
+	if( exists(TYPE_ZSTD_FILE, abstractPath) )
+	{
+		type = TYPE_ZSTD_FILE;
+		numFound++;
+	}
+
 	if( numFound > 1 )
 	{
-		if( &abstractPath[strlen(abstractPath)-strlen(GZIP_EXT)] )	// specified path ends in .gz
+		if( hasExtension(abstractPath, ZSTD_EXT) )
+			type = TYPE_ZSTD_FILE;
+		else if( exists(TYPE_GZIP_FILE, abstractPath) )
 			type = TYPE_GZIP_FILE;
 		else
 			type = TYPE_FILE;
@@ -224,6 +267,26 @@ int AbstractFile::close()
 			gzip.fp = NULL;
 		}
 		break;
+	case TYPE_PARALLEL_GZIP_FILE:
+	case TYPE_ZSTD_FILE:
+		if( block.path )
+		{
+			free( (void *)block.path );
+			block.path = NULL;
+		}
+		if( block.writer )
+		{
+			rc = block.writer->close();
+			delete block.writer;
+			block.writer = NULL;
+		}
+		if( block.reader )
+		{
+			rc = block.reader->close();
+			delete block.reader;
+			block.reader = NULL;
+		}
+		break;
 	default:
 		assert( false );
 	}
@@ -267,6 +330,20 @@ bool AbstractFile::isCapable( ConcreteFileCapability cap )
 			}
 		}
 		break;
+	case TYPE_PARALLEL_GZIP_FILE:
+	case TYPE_ZSTD_FILE:
+		{
+			switch( cap )
+			{
+			case CAP_SEEK_END:
+			case CAP_REWRITE:
+				retval = false;
+				break;
+			default:
+				retval = true;
+			}
+		}
+		break;
 	default:
 		assert( false );
 	}
@@ -295,6 +372,13 @@ size_t AbstractFile::write( const void *ptr, size_t size, size_t nmemb )
 			}
 		}
 		break;
+	case TYPE_PARALLEL_GZIP_FILE:
+	case TYPE_ZSTD_FILE:
+		{
+			assert( block.writer );
+			rc = block.writer->write( ptr, size * nmemb ) / size;
+		}
+		break;
 	default:
 		assert( false );
 	}
@@ -346,6 +430,16 @@ int AbstractFile::flush( bool full )
 			}
 		}
 		break;
+	case TYPE_PARALLEL_GZIP_FILE:
+	case TYPE_ZSTD_FILE:
+		{
+			// Same tradeoff as gzip: a flush ends the current block.
+			if( full && block.writer )
+			{
+				block.writer->flush();
+			}
+		}
+		break;
 	default:
 		assert( false );
 	}
@@ -373,6 +467,12 @@ size_t AbstractFile::read( void *ptr, size_t size, size_t nmemb )
 			}
 		}
 		break;
+	case TYPE_ZSTD_FILE:
+		{
+			assert( block.reader );
+			rc = block.reader->read( ptr, size * nmemb ) / size;
+		}
+		break;
 	default:
 		assert( false );
 	}
@@ -424,6 +524,12 @@ char *AbstractFile::gets( char *s, int size )
 			retval = gzgets( gzip.fp, s, size );
 		}
 		break;
+	case TYPE_ZSTD_FILE:
+		{
+			assert( block.reader );
+			retval = block.reader->gets( s, size );
+		}
+		break;
 	default:
 		assert( false );
 	}
@@ -463,6 +569,17 @@ int AbstractFile::seek( offset_t offset,
 			}
 		}
 		break;
+	case TYPE_PARALLEL_GZIP_FILE:
+		{
+			// write-only
+			rc = -1;
+		}
+		break;
+	case TYPE_ZSTD_FILE:
+		{
+			rc = block.reader ? block.reader->seek( offset, whence ) : -1;
+		}
+		break;
 	default:
 		assert( false );
 	}
@@ -486,6 +603,15 @@ AbstractFile::offset_t AbstractFile::tell()
 			rc = gztell( gzip.fp );
 		}
 		break;
+	case TYPE_PARALLEL_GZIP_FILE:
+	case TYPE_ZSTD_FILE:
+		{
+			if( block.writer )
+				rc = block.writer->tell();
+			else
+				rc = block.reader->tell();
+		}
+		break;
 	default:
 		assert( false );
 	}
@@ -497,6 +623,12 @@ void AbstractFile::init( ConcreteFileType type,
 						 const char *abstractPath,
 						 const char *mode )
 {
+	// Reading a parallel gzip file is just reading a gzip file.
+	if( type == TYPE_PARALLEL_GZIP_FILE && !isWriteMode(mode) )
+	{
+		type = TYPE_GZIP_FILE;
+	}
+
 	this->type = type;
 	this->abstractPath = strdup( abstractPath );
 
@@ -529,6 +661,45 @@ void AbstractFile::init( ConcreteFileType type,
                 sleep(1);
         }
     }
+    break;
+	case TYPE_PARALLEL_GZIP_FILE:
+	case TYPE_ZSTD_FILE:
+    {
+        block.path = createPath( type, abstractPath );
+        block.writer = NULL;
+        block.reader = NULL;
+
+        bool write = isWriteMode( mode );
+        // Appending would leave a stale seek table in the middle of a zstd file.
+        assert( !(type == TYPE_ZSTD_FILE && mode[0] == 'a') );
+
+        FILE *fp = fopen( block.path, write ? (mode[0] == 'a' ? "ab" : "wb") : "rb" );
+        if( !fp )
+        {
+            fprintf( stderr, "Unable to open file at '%s'\n", block.path );
+            perror( block.path );
+            fprintf( stderr, "Sleeping forever...\n"); fflush(stderr);
+            while( true )
+                sleep(1);
+        }
+
+        if( write )
+        {
+            block.writer = new BlockCompressor( type == TYPE_ZSTD_FILE
+                                                ? BlockCompressor::CODEC_ZSTD
+                                                : BlockCompressor::CODEC_GZIP,
+                                                fp );
+        }
+        else
+        {
+            block.reader = new ZstdFrameReader( fp );
+            if( !block.reader->isValid() )
+            {
+                fprintf( stderr, "Invalid zstd file at '%s'\n", block.path );
+                exit( 1 );
+            }
+        }
+    }
     break;
 	default:
 		assert( false );
@@ -547,9 +718,12 @@ char *AbstractFile::createPath( ConcreteFileType type, const char *abstractPath
 			path = strdup( abstractPath );
 			if( strstr( &path[strlen(path)-strlen(GZIP_EXT)], GZIP_EXT ) )
 				path[strlen(path)-strlen(GZIP_EXT)] = '\0';
+			else if( hasExtension(path, ZSTD_EXT) )
+				path[strlen(path)-strlen(ZSTD_EXT)] = '\0';
 		}
 		break;
 	case TYPE_GZIP_FILE:
+	case TYPE_PARALLEL_GZIP_FILE:
 		{
 			if( strstr( &abstractPath[strlen(abstractPath)-strlen(GZIP_EXT)], GZIP_EXT ) )
 				path = strdup( abstractPath );
@@ -561,6 +735,18 @@ char *AbstractFile::createPath( ConcreteFileType type, const char *abstractPath
 			}
 		}
 		break;
+	case TYPE_ZSTD_FILE:
+		{
+			if( hasExtension(abstractPath, ZSTD_EXT) )
+				path = strdup( abstractPath );
+			else
+			{
+				path = (char *)malloc( strlen(abstractPath) + strlen(ZSTD_EXT) + 1 );
+				assert( path );
+				sprintf( path, "%s%s", abstractPath, ZSTD_EXT );
+			}
+		}
+		break;
 	default:
 		assert( false );
 	}
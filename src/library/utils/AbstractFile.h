@@ -3,6 +3,9 @@
 #include <stdio.h>
 #include <zlib.h>
 
+class BlockCompressor;
+class ZstdFrameReader;
+
 class AbstractFile
 {
  public:
@@ -10,7 +13,14 @@ class AbstractFile
 	{
 		TYPE_UNDEFINED,
 		TYPE_FILE,
-		TYPE_GZIP_FILE
+		TYPE_GZIP_FILE,
+		// Write-side variant of TYPE_GZIP_FILE: blocks are deflated on
+		// worker threads. The result is an ordinary .gz file, which is
+		// read back as TYPE_GZIP_FILE.
+		TYPE_PARALLEL_GZIP_FILE,
+		// .zst with a seekable frame index; blocks are compressed on
+		// worker threads when writing.
+		TYPE_ZSTD_FILE
 	};
 	enum ConcreteFileCapability
 	{
@@ -40,6 +50,8 @@ class AbstractFile
 	static int rename( const char *oldAbstractPath,
 					   const char *newAbstractPath );
 
+	static ConcreteFileType getCompressedType( const char *backendName );
+
 	AbstractFile( ConcreteFileType type,
 				  const char *abstractPath,
 				  const char *mode );
@@ -88,6 +100,13 @@ class AbstractFile
 			const char *path;
 			gzFile fp;
 		} gzip;
+
+		struct
+		{
+			const char *path;
+			BlockCompressor *writer;
+			ZstdFrameReader *reader;
+		} block;
 	};
 
  public:
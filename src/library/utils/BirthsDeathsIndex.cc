@@ -0,0 +1,279 @@
+#include "BirthsDeathsIndex.h"
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "misc.h"
+
+using namespace std;
+
+#define Magic "PWBDIDX"
+
+static const char *TypeNames[] = { "BIRTH", "CREATION", "DEATH", "VIRTUAL" };
+
+//---------------------------------------------------------------------------
+// getMtime
+//
+// Nanoseconds, since a log can be rewritten within the second it was indexed.
+//---------------------------------------------------------------------------
+static int64_t getMtime( const struct stat &st )
+{
+#ifdef __APPLE__
+	return (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+	return (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+}
+
+//---------------------------------------------------------------------------
+// BirthsDeathsIndex::open
+//---------------------------------------------------------------------------
+BirthsDeathsIndex *BirthsDeathsIndex::open( const string &logPath,
+											const string &indexPath_ )
+{
+	string indexPath = indexPath_;
+	if( indexPath.empty() )
+	{
+		indexPath = logPath;
+		size_t suffix = indexPath.rfind( ".log" );
+		if( suffix == indexPath.size() - 4 )
+			indexPath.erase( suffix );
+		indexPath += ".idx";
+	}
+
+	struct stat logStat;
+	if( stat(logPath.c_str(), &logStat) != 0 )
+	{
+		cerr << "Failed reading " << logPath << endl;
+		return NULL;
+	}
+
+	// Try an existing index first, then rebuild it once.
+	for( int attempt = 0; attempt < 2; attempt++ )
+	{
+		if( (attempt > 0) && !build(logPath, indexPath) )
+			return NULL;
+
+		BirthsDeathsIndex *index = map( indexPath, logStat );
+		if( index )
+			return index;
+	}
+
+	cerr << "Failed opening " << indexPath << endl;
+	return NULL;
+}
+
+//---------------------------------------------------------------------------
+// BirthsDeathsIndex::map
+//
+// Returns NULL if the index is missing, malformed, or was built from a
+// different version of the log.
+//---------------------------------------------------------------------------
+BirthsDeathsIndex *BirthsDeathsIndex::map( const string &indexPath,
+										   const struct stat &logStat )
+{
+	int fd = ::open( indexPath.c_str(), O_RDONLY );
+	if( fd < 0 )
+		return NULL;
+
+	struct stat st;
+	void *addr = MAP_FAILED;
+	if( (fstat(fd, &st) == 0) && (st.st_size >= (off_t)sizeof(Header)) )
+		addr = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+	close( fd );
+	if( addr == MAP_FAILED )
+		return NULL;
+
+	const Header *header = (const Header *)addr;
+	size_t length = st.st_size;
+
+	if( (memcmp(header->magic, Magic, sizeof(header->magic)) != 0)
+		|| (header->version != VERSION)
+		|| (header->recordSize != sizeof(Record))
+		|| (header->nrecords < 0)
+		|| (header->maxStep < 0)
+		|| (length != sizeof(Header)
+			+ header->nrecords * sizeof(Record)
+			+ (header->maxStep + 2) * sizeof(int64_t))
+		|| (header->logSize != (int64_t)logStat.st_size)
+		|| (header->logMtime != getMtime(logStat)) )
+	{
+		// stale format, a partial write, or a changed log
+		munmap( addr, length );
+		return NULL;
+	}
+
+	return new BirthsDeathsIndex( addr, length );
+}
+
+//---------------------------------------------------------------------------
+// BirthsDeathsIndex::build
+//
+// Writes to a temporary file first, so readers never see a partial index.
+//---------------------------------------------------------------------------
+bool BirthsDeathsIndex::build( const string &logPath,
+							   const string &indexPath )
+{
+	FILE *in = fopen( logPath.c_str(), "r" );
+	if( in == NULL )
+	{
+		cerr << "Failed reading " << logPath << endl;
+		return false;
+	}
+
+	// Taken before reading, so a log that grows meanwhile looks stale later.
+	struct stat logStat;
+	if( fstat(fileno(in), &logStat) != 0 )
+	{
+		cerr << "Failed reading " << logPath << endl;
+		fclose( in );
+		return false;
+	}
+
+	vector<Record> records;
+	char line[512];
+	long lineno = 0;
+
+	while( fgets(line, sizeof(line), in) )
+	{
+		lineno++;
+
+		// header and blank lines
+		if( (line[0] == '#') || (line[0] == '%') || (line[0] == '\n') )
+			continue;
+
+		Record record;
+		memset( &record, 0, sizeof(record) );
+
+		char type[32];
+		int nfields = sscanf( line, "%" SCNd64 " %31s %" SCNd64 " %" SCNd64 " %" SCNd64,
+							  &record.step, type, &record.agent,
+							  &record.parent1, &record.parent2 );
+		if( nfields < 3 )
+		{
+			cerr << logPath << ":" << lineno << ": parse failed: " << line;
+			fclose( in );
+			return false;
+		}
+
+		record.type = -1;
+		for( int i = 0; i < (int)(sizeof(TypeNames) / sizeof(*TypeNames)); i++ )
+		{
+			if( strcmp(type, TypeNames[i]) == 0 )
+				record.type = i;
+		}
+		if( (record.type < 0) || (record.step < 0)
+			|| (!records.empty() && (record.step < records.back().step)) )
+		{
+			cerr << logPath << ":" << lineno << ": unexpected event: " << line;
+			fclose( in );
+			return false;
+		}
+		if( nfields < 5 )
+			record.parent1 = record.parent2 = 0;
+
+		records.push_back( record );
+	}
+	fclose( in );
+
+	Header header;
+	memset( &header, 0, sizeof(header) );
+	memcpy( header.magic, Magic, sizeof(header.magic) );
+	header.version = VERSION;
+	header.recordSize = sizeof(Record);
+	header.nrecords = records.size();
+	header.maxStep = records.empty() ? 0 : records.back().step;
+	header.logSize = logStat.st_size;
+	header.logMtime = getMtime( logStat );
+
+	// stepOffsets[step] is the first record at or after step
+	vector<int64_t> stepOffsets( header.maxStep + 2 );
+	size_t irecord = 0;
+	for( int64_t step = 0; step <= header.maxStep + 1; step++ )
+	{
+		while( (irecord < records.size()) && (records[irecord].step < step) )
+			irecord++;
+		stepOffsets[step] = irecord;
+	}
+
+	string tmpPath = indexPath + ".tmp";
+	makeParentDir( tmpPath );
+	FILE *out = fopen( tmpPath.c_str(), "wb" );
+	if( out == NULL )
+	{
+		cerr << "Failed creating " << tmpPath << endl;
+		return false;
+	}
+
+	bool ok = (fwrite(&header, sizeof(header), 1, out) == 1)
+		&& (records.empty() || (fwrite(&records[0], sizeof(Record), records.size(), out) == records.size()))
+		&& (fwrite(&stepOffsets[0], sizeof(int64_t), stepOffsets.size(), out) == stepOffsets.size());
+	ok = (fclose(out) == 0) && ok;
+
+	if( !ok || (rename(tmpPath.c_str(), indexPath.c_str()) != 0) )
+	{
+		cerr << "Failed writing " << indexPath << endl;
+		unlink( tmpPath.c_str() );
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// BirthsDeathsIndex::getTypeName
+//---------------------------------------------------------------------------
+const char *BirthsDeathsIndex::getTypeName( int type )
+{
+	return TypeNames[type];
+}
+
+//---------------------------------------------------------------------------
+// BirthsDeathsIndex::BirthsDeathsIndex
+//---------------------------------------------------------------------------
+BirthsDeathsIndex::BirthsDeathsIndex( void *addr_, size_t length_ )
+: addr( addr_ )
+, length( length_ )
+{
+	header = (const Header *)addr;
+	records = (const Record *)(header + 1);
+	stepOffsets = (const int64_t *)(records + header->nrecords);
+}
+
+//---------------------------------------------------------------------------
+// BirthsDeathsIndex::~BirthsDeathsIndex
+//---------------------------------------------------------------------------
+BirthsDeathsIndex::~BirthsDeathsIndex()
+{
+	munmap( addr, length );
+}
+
+//---------------------------------------------------------------------------
+// BirthsDeathsIndex::begin
+//---------------------------------------------------------------------------
+const BirthsDeathsIndex::Record *BirthsDeathsIndex::begin( long step )
+{
+	if( step > header->maxStep )
+		return end();
+	return records + stepOffsets[ max(0L, step) ];
+}
+
+//---------------------------------------------------------------------------
+// BirthsDeathsIndex::end
+//---------------------------------------------------------------------------
+const BirthsDeathsIndex::Record *BirthsDeathsIndex::end( long step )
+{
+	if( step > header->maxStep )
+		return end();
+	return records + stepOffsets[ max(0L, step) + 1 ];
+}
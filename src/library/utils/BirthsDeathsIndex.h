@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include <string>
+
+//===========================================================================
+// BirthsDeathsIndex
+//
+// Binary form of a BirthsDeaths.log, so lockstep replay and the analysis
+// tools can map it and walk the events instead of parsing text. The file
+// holds a header, the events as fixed-size records in log order, and a
+// table with the first record of each step 0..maxStep+1.
+//
+// The index is built from the log once and kept next to it (see open());
+// it is rebuilt whenever the log's size or modification time differs from
+// the ones recorded when it was built.
+//
+// All fields are native byte order.
+//===========================================================================
+class BirthsDeathsIndex
+{
+ public:
+	enum EventType
+	{
+		BIRTH,
+		CREATION,
+		DEATH,
+		VIRTUAL
+	};
+
+	struct Record
+	{
+		int64_t step;
+		int32_t type;
+		int32_t reserved;
+		int64_t agent;
+		int64_t parent1;	// 0 unless BIRTH or VIRTUAL
+		int64_t parent2;
+	};
+
+	// Opens the index of logPath, building it if needed. The index goes to
+	// indexPath, or next to the log with an .idx suffix if that's empty.
+	// Returns NULL if the log can't be read.
+	static BirthsDeathsIndex *open( const std::string &logPath,
+									const std::string &indexPath = "" );
+
+	static bool build( const std::string &logPath,
+					   const std::string &indexPath );
+
+	static const char *getTypeName( int type );
+
+	~BirthsDeathsIndex();
+
+	long getMaxStep();
+	size_t size();
+
+	// Events of step, as [begin, end).
+	const Record *begin( long step );
+	const Record *end( long step );
+
+	// All events, in log order.
+	const Record *begin();
+	const Record *end();
+
+ private:
+	static const uint32_t VERSION = 2;
+
+	struct Header
+	{
+		char magic[8];		// "PWBDIDX"
+		uint32_t version;
+		uint32_t recordSize;
+		int64_t nrecords;
+		int64_t maxStep;
+		int64_t logSize;	// of the log the index was built from
+		int64_t logMtime;	// nanoseconds
+	};
+
+	static BirthsDeathsIndex *map( const std::string &indexPath,
+								   const struct stat &logStat );
+
+	BirthsDeathsIndex( void *addr, size_t length );
+
+	void *addr;
+	size_t length;
+	const Header *header;
+	const Record *records;
+	const int64_t *stepOffsets;	// maxStep + 2 entries
+};
+
+inline long BirthsDeathsIndex::getMaxStep() { return header->maxStep; }
+inline size_t BirthsDeathsIndex::size() { return header->nrecords; }
+inline const BirthsDeathsIndex::Record *BirthsDeathsIndex::begin() { return records; }
+inline const BirthsDeathsIndex::Record *BirthsDeathsIndex::end() { return records + header->nrecords; }
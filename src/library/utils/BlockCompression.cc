@@ -0,0 +1,694 @@
+#include "BlockCompression.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <thread>
+
+#include <zlib.h>
+#ifdef PW_ZSTD
+	#include <zstd.h>
+#endif
+
+#include "ThreadPool.h"
+#include "sim/Scheduler.h"
+
+using namespace std;
+
+// Zstd seekable format constants (see contrib/seekable_format in zstd).
+#define ZSTD_SKIPPABLE_MAGIC 0x184D2A5E
+#define ZSTD_SEEKABLE_MAGIC 0x8F92EAB1
+#define ZSTD_SEEKTABLE_FOOTER_SIZE 9
+#define ZSTD_SKIPPABLE_HEADER_SIZE 8
+#define ZSTD_LEVEL 3
+
+static void putLE32( unsigned char *p, uint32_t val )
+{
+	p[0] = val & 0xff;
+	p[1] = (val >> 8) & 0xff;
+	p[2] = (val >> 16) & 0xff;
+	p[3] = (val >> 24) & 0xff;
+}
+
+static uint32_t getLE32( const unsigned char *p )
+{
+	return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+// ================================================================================
+// ===
+// === CLASS BlockCompressor
+// ===
+// ================================================================================
+
+// ------------------------------------------------------------
+// --- ctor()
+// ------------------------------------------------------------
+BlockCompressor::BlockCompressor( Codec codec, FILE *fp )
+: codec( codec )
+, fp( fp )
+, nwritten( 0 )
+{
+#ifndef PW_ZSTD
+	if( codec == CODEC_ZSTD )
+	{
+		fprintf( stderr, "zstd support not compiled in (rerun configure with libzstd installed).\n" );
+		exit( 1 );
+	}
+#endif
+}
+
+// ------------------------------------------------------------
+// --- dtor()
+// ------------------------------------------------------------
+BlockCompressor::~BlockCompressor()
+{
+	close();
+}
+
+// ------------------------------------------------------------
+// --- write()
+// ------------------------------------------------------------
+size_t BlockCompressor::write( const void *ptr, size_t len )
+{
+	assert( fp );
+
+	const char *p = (const char *)ptr;
+	size_t remaining = len;
+
+	while( remaining > 0 )
+	{
+		if( !current )
+		{
+			current.reset( new Block() );
+			current->in.reserve( BLOCK_SIZE );
+		}
+
+		size_t n = min( remaining, BLOCK_SIZE - current->in.size() );
+		current->in.insert( current->in.end(), p, p + n );
+		p += n;
+		remaining -= n;
+
+		if( current->in.size() == BLOCK_SIZE )
+		{
+			submit();
+		}
+	}
+
+	nwritten += len;
+
+	return len;
+}
+
+// ------------------------------------------------------------
+// --- flush()
+// ---
+// --- Compresses the partial block and waits until everything
+// --- written so far is on disk. Frequent calls cost compression
+// --- ratio, just like gzflush().
+// ------------------------------------------------------------
+void BlockCompressor::flush()
+{
+	assert( fp );
+
+	submit();
+	retire( 0 );
+	fflush( fp );
+}
+
+// ------------------------------------------------------------
+// --- close()
+// ------------------------------------------------------------
+int BlockCompressor::close()
+{
+	if( !fp )
+	{
+		return 0;
+	}
+
+	submit();
+	retire( 0 );
+
+	if( codec == CODEC_ZSTD )
+	{
+		writeSeekTable();
+	}
+
+	int rc = fclose( fp );
+	fp = NULL;
+
+	return rc;
+}
+
+// ------------------------------------------------------------
+// --- tell()
+// ------------------------------------------------------------
+uint64_t BlockCompressor::tell()
+{
+	return nwritten;
+}
+
+// ------------------------------------------------------------
+// --- submit()
+// ------------------------------------------------------------
+void BlockCompressor::submit()
+{
+	if( !current || current->in.empty() )
+	{
+		return;
+	}
+
+	// Bound memory and let the writer fall behind by at most a few blocks.
+	retire( getMaxPending() - 1 );
+
+	shared_ptr<Block> block = current;
+	current.reset();
+
+	shared_ptr< promise<void> > done( new promise<void>() );
+	future<void> result = done->get_future();
+	Codec codec = this->codec;
+
+	getThreadPool().schedule( [block, done, codec]()
+							  {
+								  compress( codec, block.get() );
+								  done->set_value();
+							  } );
+
+	pending.push_back( PendingBlock(block, move(result)) );
+}
+
+// ------------------------------------------------------------
+// --- retire()
+// ---
+// --- Writes completed blocks, in submission order, until no more
+// --- than maxPending remain in flight.
+// ------------------------------------------------------------
+void BlockCompressor::retire( size_t maxPending )
+{
+	while( pending.size() > maxPending )
+	{
+		PendingBlock &front = pending.front();
+		front.second.wait();
+
+		Block *block = front.first.get();
+		if( !block->ok )
+		{
+			fprintf( stderr, "Failed compressing block.\n" );
+			exit( 1 );
+		}
+
+		size_t n = fwrite( &block->out[0], 1, block->out.size(), fp );
+		assert( n == block->out.size() );
+
+		if( codec == CODEC_ZSTD )
+		{
+			frameSizes.push_back( make_pair((uint32_t)block->out.size(),
+											(uint32_t)block->in.size()) );
+		}
+
+		pending.pop_front();
+	}
+}
+
+// ------------------------------------------------------------
+// --- writeSeekTable()
+// ---
+// --- Skippable frame holding (compressed, decompressed) sizes for
+// --- every frame, followed by the seekable format footer.
+// ------------------------------------------------------------
+void BlockCompressor::writeSeekTable()
+{
+	size_t nframes = frameSizes.size();
+	size_t payload = (nframes * 8) + ZSTD_SEEKTABLE_FOOTER_SIZE;
+	vector<unsigned char> table( ZSTD_SKIPPABLE_HEADER_SIZE + payload );
+	unsigned char *p = &table[0];
+
+	putLE32( p, ZSTD_SKIPPABLE_MAGIC ); p += 4;
+	putLE32( p, payload ); p += 4;
+
+	for( size_t i = 0; i < nframes; i++ )
+	{
+		putLE32( p, frameSizes[i].first ); p += 4;
+		putLE32( p, frameSizes[i].second ); p += 4;
+	}
+
+	putLE32( p, nframes ); p += 4;
+	*(p++) = 0; // descriptor: no checksums
+	putLE32( p, ZSTD_SEEKABLE_MAGIC ); p += 4;
+
+	size_t n = fwrite( &table[0], 1, table.size(), fp );
+	assert( n == table.size() );
+}
+
+// ------------------------------------------------------------
+// --- compress()
+// ------------------------------------------------------------
+void BlockCompressor::compress( Codec codec, Block *block )
+{
+	block->ok = false;
+
+	switch( codec )
+	{
+	case CODEC_GZIP:
+		{
+			z_stream strm;
+			memset( &strm, 0, sizeof(strm) );
+
+			// windowBits + 16 requests a gzip header and trailer.
+			if( Z_OK != deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) )
+			{
+				return;
+			}
+
+			block->out.resize( deflateBound(&strm, block->in.size()) );
+
+			strm.next_in = (Bytef *)&block->in[0];
+			strm.avail_in = block->in.size();
+			strm.next_out = (Bytef *)&block->out[0];
+			strm.avail_out = block->out.size();
+
+			int rc = deflate( &strm, Z_FINISH );
+			block->out.resize( strm.total_out );
+			deflateEnd( &strm );
+
+			block->ok = rc == Z_STREAM_END;
+		}
+		break;
+	case CODEC_ZSTD:
+		{
+#ifdef PW_ZSTD
+			block->out.resize( ZSTD_compressBound(block->in.size()) );
+
+			size_t n = ZSTD_compress( &block->out[0], block->out.size(),
+									  &block->in[0], block->in.size(),
+									  ZSTD_LEVEL );
+			if( !ZSTD_isError(n) )
+			{
+				block->out.resize( n );
+				block->ok = true;
+			}
+#endif
+		}
+		break;
+	default:
+		assert( false );
+	}
+}
+
+// ------------------------------------------------------------
+// --- getThreadPool()
+// ---
+// --- Shared by all open files.
+// ------------------------------------------------------------
+ThreadPool &BlockCompressor::getThreadPool()
+{
+	static ThreadPool pool( getThreadCount() );
+
+	return pool;
+}
+
+// ------------------------------------------------------------
+// --- getThreadCount()
+// ---
+// --- Half the cores the Scheduler was given. Its pool runs beside
+// --- this one, so compressing during a parallel phase adds at most
+// --- half again to the threads competing for those cores, and an
+// --- ensemble replicate stays within its share of the machine.
+// ------------------------------------------------------------
+unsigned BlockCompressor::getThreadCount()
+{
+	return max( 1u, Scheduler::getCoreCount() / 2 );
+}
+
+// ------------------------------------------------------------
+// --- getMaxPending()
+// ------------------------------------------------------------
+size_t BlockCompressor::getMaxPending()
+{
+	return 2 * getThreadCount();
+}
+
+// ================================================================================
+// ===
+// === CLASS ZstdFrameReader
+// ===
+// ================================================================================
+
+// ------------------------------------------------------------
+// --- ctor()
+// ------------------------------------------------------------
+ZstdFrameReader::ZstdFrameReader( FILE *fp )
+: fp( fp )
+, valid( false )
+, total( 0 )
+, pos( 0 )
+, currentFrame( -1 )
+{
+#ifdef PW_ZSTD
+	valid = loadSeekTable() || scanFrames();
+#endif
+}
+
+// ------------------------------------------------------------
+// --- dtor()
+// ------------------------------------------------------------
+ZstdFrameReader::~ZstdFrameReader()
+{
+	close();
+}
+
+// ------------------------------------------------------------
+// --- isValid()
+// ------------------------------------------------------------
+bool ZstdFrameReader::isValid()
+{
+	return valid;
+}
+
+// ------------------------------------------------------------
+// --- read()
+// ------------------------------------------------------------
+size_t ZstdFrameReader::read( void *ptr, size_t len )
+{
+	char *p = (char *)ptr;
+	size_t nread = 0;
+
+	while( nread < len && pos < total )
+	{
+		if( !loadFrame(pos) )
+		{
+			break;
+		}
+
+		const Frame &frame = frames[currentFrame];
+		size_t offset = pos - frame.doffset;
+		size_t n = min( len - nread, (size_t)frame.dsize - offset );
+
+		memcpy( p + nread, &dbuf[offset], n );
+		nread += n;
+		pos += n;
+	}
+
+	return nread;
+}
+
+// ------------------------------------------------------------
+// --- gets()
+// ------------------------------------------------------------
+char *ZstdFrameReader::gets( char *s, int size )
+{
+	int n = 0;
+
+	while( n < size - 1 && pos < total )
+	{
+		if( !loadFrame(pos) )
+		{
+			break;
+		}
+
+		const Frame &frame = frames[currentFrame];
+		size_t offset = pos - frame.doffset;
+		size_t avail = min( (size_t)(size - 1 - n), (size_t)frame.dsize - offset );
+
+		const char *start = &dbuf[offset];
+		const char *nl = (const char *)memchr( start, '\n', avail );
+		size_t ncopy = nl ? (nl - start) + 1 : avail;
+
+		memcpy( s + n, start, ncopy );
+		n += ncopy;
+		pos += ncopy;
+
+		if( nl )
+		{
+			break;
+		}
+	}
+
+	if( n == 0 )
+	{
+		return NULL;
+	}
+
+	s[n] = '\0';
+	return s;
+}
+
+// ------------------------------------------------------------
+// --- seek()
+// ------------------------------------------------------------
+int ZstdFrameReader::seek( long offset, int whence )
+{
+	long base;
+
+	switch( whence )
+	{
+	case SEEK_SET:
+		base = 0;
+		break;
+	case SEEK_CUR:
+		base = pos;
+		break;
+	case SEEK_END:
+		base = total;
+		break;
+	default:
+		return -1;
+	}
+
+	long newpos = base + offset;
+	if( newpos < 0 || (uint64_t)newpos > total )
+	{
+		return -1;
+	}
+
+	pos = newpos;
+
+	return 0;
+}
+
+// ------------------------------------------------------------
+// --- tell()
+// ------------------------------------------------------------
+long ZstdFrameReader::tell()
+{
+	return pos;
+}
+
+// ------------------------------------------------------------
+// --- size()
+// ------------------------------------------------------------
+uint64_t ZstdFrameReader::size()
+{
+	return total;
+}
+
+// ------------------------------------------------------------
+// --- close()
+// ------------------------------------------------------------
+int ZstdFrameReader::close()
+{
+	int rc = 0;
+
+	if( fp )
+	{
+		rc = fclose( fp );
+		fp = NULL;
+	}
+
+	return rc;
+}
+
+// ------------------------------------------------------------
+// --- loadSeekTable()
+// ---
+// --- Only trusted if the frames it describes account for the
+// --- whole file (e.g. not after an append).
+// ------------------------------------------------------------
+bool ZstdFrameReader::loadSeekTable()
+{
+	if( 0 != fseek(fp, 0, SEEK_END) )
+	{
+		return false;
+	}
+	long filesize = ftell( fp );
+	if( filesize < ZSTD_SKIPPABLE_HEADER_SIZE + ZSTD_SEEKTABLE_FOOTER_SIZE )
+	{
+		return false;
+	}
+
+	unsigned char footer[ZSTD_SEEKTABLE_FOOTER_SIZE];
+	if( 0 != fseek(fp, -ZSTD_SEEKTABLE_FOOTER_SIZE, SEEK_END)
+		|| 1 != fread(footer, sizeof(footer), 1, fp) )
+	{
+		return false;
+	}
+	if( getLE32(footer + 5) != ZSTD_SEEKABLE_MAGIC || footer[4] != 0 )
+	{
+		return false;
+	}
+
+	uint32_t nframes = getLE32( footer );
+	long tablesize = ZSTD_SKIPPABLE_HEADER_SIZE + (nframes * 8) + ZSTD_SEEKTABLE_FOOTER_SIZE;
+	if( tablesize > filesize )
+	{
+		return false;
+	}
+
+	vector<unsigned char> table( tablesize );
+	if( 0 != fseek(fp, -tablesize, SEEK_END)
+		|| 1 != fread(&table[0], tablesize, 1, fp) )
+	{
+		return false;
+	}
+	if( getLE32(&table[0]) != ZSTD_SKIPPABLE_MAGIC )
+	{
+		return false;
+	}
+
+	frames.resize( nframes );
+	uint64_t coffset = 0;
+	uint64_t doffset = 0;
+	const unsigned char *p = &table[ZSTD_SKIPPABLE_HEADER_SIZE];
+	for( uint32_t i = 0; i < nframes; i++ )
+	{
+		Frame &frame = frames[i];
+		frame.coffset = coffset;
+		frame.csize = getLE32( p ); p += 4;
+		frame.doffset = doffset;
+		frame.dsize = getLE32( p ); p += 4;
+
+		coffset += frame.csize;
+		doffset += frame.dsize;
+	}
+
+	if( coffset + tablesize != (uint64_t)filesize )
+	{
+		frames.clear();
+		return false;
+	}
+
+	total = doffset;
+
+	return true;
+}
+
+// ------------------------------------------------------------
+// --- scanFrames()
+// ---
+// --- Fallback for zstd files without a usable seek table.
+// ------------------------------------------------------------
+bool ZstdFrameReader::scanFrames()
+{
+#ifdef PW_ZSTD
+	if( 0 != fseek(fp, 0, SEEK_END) )
+	{
+		return false;
+	}
+	long filesize = ftell( fp );
+	rewind( fp );
+
+	vector<char> data( filesize );
+	if( filesize > 0 && 1 != fread(&data[0], filesize, 1, fp) )
+	{
+		return false;
+	}
+
+	frames.clear();
+	uint64_t doffset = 0;
+	size_t offset = 0;
+	while( offset < data.size() )
+	{
+		const unsigned char *p = (const unsigned char *)&data[offset];
+		size_t remaining = data.size() - offset;
+
+		// Skippable frames (including seek tables) carry no content.
+		if( remaining >= ZSTD_SKIPPABLE_HEADER_SIZE && (getLE32(p) & 0xFFFFFFF0) == 0x184D2A50 )
+		{
+			offset += ZSTD_SKIPPABLE_HEADER_SIZE + getLE32( p + 4 );
+			continue;
+		}
+
+		size_t csize = ZSTD_findFrameCompressedSize( p, remaining );
+		unsigned long long dsize = ZSTD_getFrameContentSize( p, remaining );
+		if( ZSTD_isError(csize)
+			|| dsize == ZSTD_CONTENTSIZE_UNKNOWN
+			|| dsize == ZSTD_CONTENTSIZE_ERROR )
+		{
+			fprintf( stderr, "Unsupported zstd frame (content size must be recorded).\n" );
+			frames.clear();
+			return false;
+		}
+
+		Frame frame;
+		frame.coffset = offset;
+		frame.csize = csize;
+		frame.doffset = doffset;
+		frame.dsize = dsize;
+		frames.push_back( frame );
+
+		offset += csize;
+		doffset += dsize;
+	}
+
+	total = doffset;
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+// ------------------------------------------------------------
+// --- loadFrame()
+// ------------------------------------------------------------
+bool ZstdFrameReader::loadFrame( uint64_t offset )
+{
+#ifdef PW_ZSTD
+	if( currentFrame >= 0 )
+	{
+		const Frame &frame = frames[currentFrame];
+		if( offset >= frame.doffset && offset < frame.doffset + frame.dsize )
+		{
+			return true;
+		}
+	}
+
+	// Find the last frame starting at or before offset.
+	struct local
+	{
+		static bool cmp( uint64_t offset, const Frame &frame )
+		{
+			return offset < frame.doffset;
+		}
+	};
+	vector<Frame>::iterator it = upper_bound( frames.begin(), frames.end(), offset, local::cmp );
+	assert( it != frames.begin() );
+	--it;
+	const Frame &frame = *it;
+
+	cbuf.resize( frame.csize );
+	dbuf.resize( frame.dsize );
+
+	if( 0 != fseek(fp, frame.coffset, SEEK_SET)
+		|| 1 != fread(&cbuf[0], frame.csize, 1, fp) )
+	{
+		return false;
+	}
+
+	size_t n = ZSTD_decompress( &dbuf[0], dbuf.size(), &cbuf[0], cbuf.size() );
+	if( ZSTD_isError(n) || n != frame.dsize )
+	{
+		fprintf( stderr, "Failed decompressing zstd frame: %s\n",
+				 ZSTD_isError(n) ? ZSTD_getErrorName(n) : "size mismatch" );
+		return false;
+	}
+
+	currentFrame = it - frames.begin();
+
+	return true;
+#else
+	return false;
+#endif
+}
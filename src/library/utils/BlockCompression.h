@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+// ================================================================================
+// ===
+// === CLASS BlockCompressor
+// ===
+// === Splits a byte stream into fixed-size blocks that are compressed
+// === independently on worker threads and written to the file in order.
+// ===
+// === CODEC_GZIP emits each block as a complete gzip member; a sequence of
+// === members is a valid gzip file, so the output is readable by zlib,
+// === gunzip and Python's gzip module.
+// ===
+// === CODEC_ZSTD emits each block as a zstd frame and, on close, appends a
+// === seek table in the zstd seekable format so readers can jump directly to
+// === the frame holding any offset.
+// ===
+// ================================================================================
+class BlockCompressor
+{
+ public:
+	enum Codec
+	{
+		CODEC_GZIP,
+		CODEC_ZSTD
+	};
+
+	static const size_t BLOCK_SIZE = 256 * 1024;
+
+	BlockCompressor( Codec codec, FILE *fp );
+	~BlockCompressor();
+
+	size_t write( const void *ptr, size_t len );
+	void flush();
+	int close();
+
+	uint64_t tell();
+
+ private:
+	struct Block
+	{
+		std::vector<char> in;
+		std::vector<char> out;
+		bool ok;
+	};
+	typedef std::pair< std::shared_ptr<Block>, std::future<void> > PendingBlock;
+
+	void submit();
+	void retire( size_t maxPending );
+	void writeSeekTable();
+
+	static void compress( Codec codec, Block *block );
+	static ThreadPool &getThreadPool();
+	static unsigned getThreadCount();
+	static size_t getMaxPending();
+
+	Codec codec;
+	FILE *fp;
+	std::shared_ptr<Block> current;
+	std::deque<PendingBlock> pending;
+	std::vector< std::pair<uint32_t, uint32_t> > frameSizes;
+	uint64_t nwritten;
+};
+
+// ================================================================================
+// ===
+// === CLASS ZstdFrameReader
+// ===
+// === Random-access reader for zstd files. Frames are located through the
+// === seek table written by BlockCompressor or, failing that, by walking the
+// === frame headers once. Only the frame containing the current offset is
+// === held decompressed.
+// ===
+// ================================================================================
+class ZstdFrameReader
+{
+ public:
+	ZstdFrameReader( FILE *fp );
+	~ZstdFrameReader();
+
+	bool isValid();
+
+	size_t read( void *ptr, size_t len );
+	char *gets( char *s, int size );
+	int seek( long offset, int whence );
+	long tell();
+	uint64_t size();
+
+	int close();
+
+ private:
+	struct Frame
+	{
+		uint64_t coffset;
+		uint32_t csize;
+		uint64_t doffset;
+		uint32_t dsize;
+	};
+
+	bool loadSeekTable();
+	bool scanFrames();
+	bool loadFrame( uint64_t offset );
+
+	FILE *fp;
+	bool valid;
+	std::vector<Frame> frames;
+	uint64_t total;
+	uint64_t pos;
+	long currentFrame;
+	std::vector<char> cbuf;
+	std::vector<char> dbuf;
+};
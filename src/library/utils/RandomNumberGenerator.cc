@@ -132,3 +132,26 @@ double RandomNumberGenerator::range( double lo,
 				   lo,
 				   hi );
 }
+
+void RandomNumberGenerator::range( double lo,
+								   double hi,
+								   unsigned char *out,
+								   int n )
+{
+	switch( type )
+	{
+	case LOCAL:
+		{
+			gsl_rng *rng = (gsl_rng *)state;
+			for( int i = 0; i < n; i++ )
+				out[i] = (unsigned char)interp( gsl_rng_uniform(rng), lo, hi );
+		}
+		break;
+	case GLOBAL:
+		for( int i = 0; i < n; i++ )
+			out[i] = (unsigned char)interp( drand48(), lo, hi );
+		break;
+	default:
+		assert( false );
+	}
+}
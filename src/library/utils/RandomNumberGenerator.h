@@ -57,6 +57,11 @@ class RandomNumberGenerator
 	double nrand();
 	double range( double lo,
 				  double hi );
+	// Fills n bytes with range(lo,hi); same sequence as n calls to range().
+	void range( double lo,
+				double hi,
+				unsigned char *out,
+				int n );
 
  private:
 	Type type;
@@ -94,6 +94,13 @@ void ThreadPool::schedule(Task task)
     }
 }
 
+bool ThreadPool::has_idle_thread()
+{
+    unique_lock<mutex> lock(_mutex);
+
+    return (_waiting_threads > _tasks.size()) || (_threads.size() < _max_threads);
+}
+
 ThreadPool::Thread::Thread(ThreadPool &pool)
     : _pool(pool)
     , _systhread([this](){ run(); })
@@ -19,6 +19,9 @@ public:
     void schedule(Task task);
     void join();
 
+    // Whether a task scheduled now would start at once.
+    bool has_idle_thread();
+
 private:
     unsigned _max_threads;
     unsigned _waiting_threads;
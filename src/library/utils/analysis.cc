@@ -83,7 +83,9 @@ void analysis::initialize(const std::string& run) {
     schema->lenient = true;
     worldfile = builder.buildWorldfileDocument(schema, run + "/original.wf");
     schema->apply(worldfile);
-    globals::recordFileType = (bool)worldfile->get("CompressFiles") ? AbstractFile::TYPE_GZIP_FILE : AbstractFile::TYPE_FILE;
+    globals::recordFileType = (bool)worldfile->get("CompressFiles")
+        ? AbstractFile::getCompressedType(((std::string)worldfile->get("CompressionBackend")).c_str())
+        : AbstractFile::TYPE_FILE;
     agent::processWorldfile(*worldfile);
     genome::GenomeSchema::processWorldfile(*worldfile);
     Brain::processWorldfile(*worldfile);
@@ -121,21 +123,10 @@ int analysis::getMaxAgent(const std::string& run) {
     return reader.nrows();
 }
 
-std::map<int, std::list<analysis::Event> > analysis::getEvents(const std::string& run) {
-    std::map<int, std::list<Event> > events;
-    std::ifstream in(run + "/BirthsDeaths.log");
-    std::string line;
-    std::getline(in, line);
-    while (std::getline(in, line)) {
-        std::istringstream stream(line);
-        Event event;
-        int timestep;
-        stream >> timestep >> event.type >> event.agent;
-        if (stream) {
-            events[timestep].push_back(event);
-        } else {
-            std::cerr << "Parse failed: " << line << std::endl;
-        }
+BirthsDeathsIndex* analysis::getEvents(const std::string& run) {
+    BirthsDeathsIndex* events = BirthsDeathsIndex::open(run + "/BirthsDeaths.log");
+    if (events == NULL) {
+        exit(1);
     }
     return events;
 }
@@ -6,13 +6,9 @@
 #include "brain/RqNervousSystem.h"
 #include "genome/Genome.h"
 #include "utils/AbstractFile.h"
+#include "utils/BirthsDeathsIndex.h"
 
 namespace analysis {
-    struct Event {
-        std::string type;
-        int agent;
-    };
-    
     class Vector {
     public:
         static void add(Vector&, Vector&, Vector&);
@@ -34,7 +30,7 @@ namespace analysis {
     int getMaxTimestep(const std::string&);
     int getInitAgentCount(const std::string&);
     int getMaxAgent(const std::string&);
-    std::map<int, std::list<Event> > getEvents(const std::string&);
+    BirthsDeathsIndex* getEvents(const std::string&);
     genome::Genome* getGenome(const std::string&, int);
     AbstractFile* getSynapses(const std::string&, int, const std::string&);
     RqNervousSystem* getNervousSystem(genome::Genome*, AbstractFile*);
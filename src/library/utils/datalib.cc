@@ -1,6 +1,12 @@
 #include "datalib.h"
 
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace datalib;
 using namespace std;
@@ -18,6 +24,8 @@ using namespace std;
 #define VERSION_READ_MIN 2
 #define VERSION_READ 3
 #define VERSION_WRITE 3
+#define MAX_ROWLEN 4096
+#define BLOCK_SIZE (64 * 1024)
 
 char *rfind( char *begin, char *end, char c );
 char *rfind( char *begin, char *end, char c )
@@ -33,6 +41,113 @@ char *rfind( char *begin, char *end, char c )
 	return NULL;
 }
 
+// ------------------------------------------------------------
+// --- Fast formatters
+// ---
+// --- These produce exactly the same text as the corresponding
+// --- printf conversions, without parsing a format string.
+// ------------------------------------------------------------
+static char *pad( char *start, char *b, int width )
+{
+	while( b - start < width )
+	{
+		*(b++) = ' ';
+	}
+	return b;
+}
+
+static char *formatUInt( char *b, uint64_t val )
+{
+	char digits[20];
+	int n = 0;
+	do
+	{
+		digits[n++] = '0' + (val % 10);
+		val /= 10;
+	} while( val );
+
+	while( n )
+	{
+		*(b++) = digits[--n];
+	}
+	return b;
+}
+
+static char *formatInt( char *b, int val, int width )
+{
+	char *start = b;
+	uint64_t uval = val;
+	if( val < 0 )
+	{
+		*(b++) = '-';
+		uval = -(int64_t)val;
+	}
+	b = formatUInt( b, uval );
+	return pad( start, b, width );
+}
+
+static char *formatFloat( char *b, float fval, int precision, int width )
+{
+	static const double scale[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6 };
+	static const uint64_t iscale[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+	char *start = b;
+	double val = fval;
+
+	if( !(fabs(val) < 1e9) )
+	{
+		// nan, inf, or too large for the exact path below
+		b += sprintf( b, "%.*f", precision, val );
+		return pad( start, b, width );
+	}
+
+	// A float mantissa (24 bits) times 10^6 (< 2^20) fits in a double
+	// mantissa, so the scaled value is exact and we can round it
+	// half-to-even just as printf does.
+	bool neg = signbit( val );
+	if( neg )
+	{
+		val = -val;
+	}
+	double scaled = val * scale[precision];
+	double ipart = floor( scaled );
+	double frac = scaled - ipart;
+	uint64_t n = (uint64_t)ipart;
+	if( frac > 0.5 || (frac == 0.5 && (n & 1)) )
+	{
+		n++;
+	}
+
+	if( neg )
+	{
+		*(b++) = '-';
+	}
+	b = formatUInt( b, n / iscale[precision] );
+	if( precision > 0 )
+	{
+		*(b++) = '.';
+		uint64_t f = n % iscale[precision];
+		for( int i = precision - 1; i >= 0; i-- )
+		{
+			b[i] = '0' + (f % 10);
+			f /= 10;
+		}
+		b += precision;
+	}
+
+	return pad( start, b, width );
+}
+
+static char *formatString( char *b, const char *val, int width, size_t avail )
+{
+	char *start = b;
+	size_t len = strlen( val );
+	assert( len < avail );
+	memcpy( b, val, len );
+	b += len;
+	return pad( start, b, width );
+}
+
 // ================================================================================
 // ===
 // === CLASS __Column
@@ -43,6 +158,9 @@ __Column::__Column()
 	name = "";
 	type = INVALID;
 	tname = format = NULL;
+	fmtkind = FMT_PRINTF;
+	width = 0;
+	precision = -1;
 }
 
 __Column::__Column( const char *name,
@@ -93,6 +211,79 @@ __Column::__Column( const char *name,
 			assert( false );
 		}
 	}
+
+	parseFormat();
+}
+
+// ------------------------------------------------------------
+// --- parseFormat()
+// ---
+// --- Recognizes the simple formats that have a fast path, i.e.
+// --- "%[-width][.precision]{d,f,s}". Anything else is rendered
+// --- with sprintf.
+// ------------------------------------------------------------
+void __Column::parseFormat()
+{
+	fmtkind = FMT_PRINTF;
+	width = 0;
+	precision = -1;
+
+	const char *p = format;
+	if( *(p++) != '%' )
+		return;
+
+	bool left = false;
+	if( *p == '-' )
+	{
+		left = true;
+		p++;
+	}
+
+	int w = 0;
+	while( *p >= '0' && *p <= '9' )
+		w = (w * 10) + (*(p++) - '0');
+
+	int prec = -1;
+	if( *p == '.' )
+	{
+		p++;
+		prec = 0;
+		while( *p >= '0' && *p <= '9' )
+			prec = (prec * 10) + (*(p++) - '0');
+	}
+
+	char conv = *(p++);
+	if( *p != '\0' )
+		return;
+	if( w > 0 && !left )
+		return;
+
+	switch( conv )
+	{
+	case 'd':
+		if( prec != -1 || (type != datalib::INT && type != datalib::BOOL) )
+			return;
+		fmtkind = FMT_INT;
+		break;
+	case 'f':
+		if( prec == -1 )
+			prec = 6;
+		// float * 10^prec is exact in a double for prec <= 6
+		if( prec > 6 || type != datalib::FLOAT )
+			return;
+		fmtkind = FMT_FLOAT;
+		break;
+	case 's':
+		if( prec != -1 || type != datalib::STRING )
+			return;
+		fmtkind = FMT_STRING;
+		break;
+	default:
+		return;
+	}
+
+	width = w;
+	precision = prec;
 }
 
 
@@ -120,6 +311,10 @@ DataLibWriter::DataLibWriter( const char *path,
 
 	table = NULL;
 
+	block.resize( BLOCK_SIZE );
+	blocklen = 0;
+	rowstart = NULL;
+
 	fileHeader();
 }
 
@@ -178,6 +373,8 @@ void DataLibWriter::beginTable( const char *name,
 	assert( table == NULL );
 	assert( tables.empty() || !singleSchema );
 
+	flushBlock();
+
 	tables.push_back( __Table(name) );
 	table = &tables.back();
 
@@ -268,65 +465,74 @@ void DataLibWriter::addRow( Variant *colsdata )
 {
 	assert( table );
 
-	table->nrows++;
-
-	char buf[4096];
-	char *b = buf;
+	char *b = beginRow();
 
-	if( randomAccess )
-	{
-		sprintf( buf, "    " );
-		b += strlen( buf );
-	}
-
-	itfor( __ColVector, cols, it )
+	for( size_t i = 0; i < cols.size(); i++ )
 	{
-#define TOBUF(TYPE)								\
-		{										\
-			TYPE val = (TYPE)*(colsdata++);		\
-												\
-			sprintf( b,							\
-					 it->format,				\
-					 val );						\
-		}
-
+		Variant &val = colsdata[i];
 
-		switch( it->type )
+		switch( cols[i].type )
 		{
 		case datalib::INT:
-			TOBUF(int);
+			b = putCol( b, i, (int)val );
 			break;
 		case datalib::FLOAT:
-			TOBUF(float);
+			b = putCol( b, i, (float)val );
 			break;
 		case datalib::STRING:
-			TOBUF(const char *);
+			b = putCol( b, i, (const char *)val );
 			break;
 		case datalib::BOOL:
-			TOBUF(bool);
+			b = putCol( b, i, (bool)val );
 			break;
 		default:
 			assert( false );
 		}
+	}
 
-#undef TOBUF
+	endRow( b );
+}
 
-		b += strlen( b );
-		if( !randomAccess )
-		{
-			*(b++) = '\t';
-		}
-		assert( size_t(b - buf) < sizeof(buf) );
+// ------------------------------------------------------------
+// --- beginRow()
+// ---
+// --- Returns where the next row's text should be written. A row
+// --- is never split across blocks.
+// ------------------------------------------------------------
+char *DataLibWriter::beginRow()
+{
+	table->nrows++;
+
+	if( block.size() - blocklen < MAX_ROWLEN )
+	{
+		flushBlock();
 	}
 
+	rowstart = &block[blocklen];
+	char *b = rowstart;
+
+	if( randomAccess )
+	{
+		memcpy( b, "    ", 4 );
+		b += 4;
+	}
+
+	return b;
+}
+
+// ------------------------------------------------------------
+// --- endRow()
+// ------------------------------------------------------------
+void DataLibWriter::endRow( char *b )
+{
 	if( !randomAccess )
 	{
 		b--; // erase last tab
 	}
 	*(b++) = '\n';
-	assert( size_t(b - buf) <= sizeof(buf) );
+	assert( size_t(b - rowstart) <= MAX_ROWLEN );
 
-	size_t nwrite = b - buf;
+	size_t nwrite = b - rowstart;
 
 	if( randomAccess )
 	{
@@ -340,8 +546,101 @@ void DataLibWriter::addRow( Variant *colsdata )
 			assert( nwrite == table->rowlen );
 		}
 	}
-	size_t n = fwrite( buf, 1, nwrite, f );
-	assert( n == nwrite );
+
+	blocklen += nwrite;
+	rowstart = NULL;
+}
+
+// ------------------------------------------------------------
+// --- putCol()
+// ------------------------------------------------------------
+char *DataLibWriter::putCol( char *b, size_t i, int val )
+{
+	const __Column &col = cols[i];
+
+	if( col.fmtkind == __Column::FMT_INT )
+	{
+		b = formatInt( b, val, col.width );
+	}
+	else
+	{
+		b += sprintf( b, col.format, val );
+	}
+
+	return endCol( b );
+}
+
+// ------------------------------------------------------------
+// --- putCol()
+// ------------------------------------------------------------
+char *DataLibWriter::putCol( char *b, size_t i, float val )
+{
+	const __Column &col = cols[i];
+
+	if( col.fmtkind == __Column::FMT_FLOAT )
+	{
+		b = formatFloat( b, val, col.precision, col.width );
+	}
+	else
+	{
+		b += sprintf( b, col.format, val );
+	}
+
+	return endCol( b );
+}
+
+// ------------------------------------------------------------
+// --- putCol()
+// ------------------------------------------------------------
+char *DataLibWriter::putCol( char *b, size_t i, bool val )
+{
+	return putCol( b, i, (int)val );
+}
+
+// ------------------------------------------------------------
+// --- putCol()
+// ------------------------------------------------------------
+char *DataLibWriter::putCol( char *b, size_t i, const char *val )
+{
+	const __Column &col = cols[i];
+
+	if( col.fmtkind == __Column::FMT_STRING )
+	{
+		b = formatString( b, val, col.width, MAX_ROWLEN - (b - rowstart) );
+	}
+	else
+	{
+		b += sprintf( b, col.format, val );
+	}
+
+	return endCol( b );
+}
+
+// ------------------------------------------------------------
+// --- endCol()
+// ------------------------------------------------------------
+char *DataLibWriter::endCol( char *b )
+{
+	if( !randomAccess )
+	{
+		*(b++) = '\t';
+	}
+	assert( size_t(b - rowstart) < MAX_ROWLEN );
+
+	return b;
+}
+
+// ------------------------------------------------------------
+// --- flushBlock()
+// ------------------------------------------------------------
+void DataLibWriter::flushBlock()
+{
+	if( blocklen > 0 )
+	{
+		size_t n = fwrite( &block[0], 1, blocklen, f );
+		assert( n == blocklen );
+		blocklen = 0;
+	}
 }
 
 // ------------------------------------------------------------
@@ -351,6 +650,7 @@ void DataLibWriter::endTable()
 {
 	assert( table );
 
+	flushBlock();
 	tableFooter();
 
 	table = NULL;
@@ -361,6 +661,7 @@ void DataLibWriter::endTable()
 // ------------------------------------------------------------
 void DataLibWriter::flush()
 {
+	flushBlock();
 	fflush( f );
 }
 
@@ -380,6 +681,8 @@ void DataLibWriter::fileHeader()
 // ------------------------------------------------------------
 void DataLibWriter::fileFooter()
 {
+	flushBlock();
+
 	size_t digest_start = ftell( f );
 
 	fprintf( f, "\n" );
@@ -481,7 +784,8 @@ void DataLibWriter::colMetaData()
 // ------------------------------------------------------------
 // --- ctor()
 // ------------------------------------------------------------
-DataLibReader::DataLibReader( const char *path )
+DataLibReader::DataLibReader( const char *path, Mode _mode )
+: mode( _mode )
 {
 	f = fopen( path, "rb" );
 	assert( f );
@@ -489,8 +793,17 @@ DataLibReader::DataLibReader( const char *path )
 	table = NULL;
 	this->path = path;
 
+	mapped = NULL;
+	mappedSize = 0;
+	rowptr = NULL;
+
 	parseHeader();
 	parseDigest();
+
+	if( mode == MAPPED )
+	{
+		mapFile();
+	}
 }
 
 // ------------------------------------------------------------
@@ -498,6 +811,11 @@ DataLibReader::DataLibReader( const char *path )
 // ------------------------------------------------------------
 DataLibReader::~DataLibReader()
 {
+	if( mapped )
+	{
+		munmap( mapped, mappedSize );
+	}
+
 	fclose( f );
 }
 
@@ -515,9 +833,15 @@ bool DataLibReader::seekTable( const char *name )
 
 	table = &(it->second);
 	row = -1;
+	rowptr = NULL;
 
 	parseTableHeader();
 
+	if( mode == MAPPED && !randomAccess )
+	{
+		buildRowIndex();
+	}
+
 	return true;
 }
 
@@ -558,6 +882,13 @@ void DataLibReader::seekRow( int index )
 	bool next = index == row + 1;
 	row = index;
 
+	if( mode == MAPPED )
+	{
+		// Columns are converted lazily by col() and the typed accessors.
+		rowptr = rowText( index );
+		return;
+	}
+
 	// ---
 	// --- Read the row text
 	// ---
@@ -667,9 +998,144 @@ const Variant &DataLibReader::col( const char *name )
 
 	__Column *col = it->second;
 
+	if( mode == MAPPED )
+	{
+		parseField( *col, findField(rowptr, col - &cols.front()) );
+	}
+
 	return col->rowdata;
 }
 
+// ------------------------------------------------------------
+// --- colHandle()
+// ------------------------------------------------------------
+DataLibReader::ColumnHandle DataLibReader::colHandle( const char *name )
+{
+	assert( table );
+
+	__ColMap::iterator it = colmap.find(name);
+	assert( it != colmap.end() );
+
+	ColumnHandle handle;
+	handle.index = it->second - &cols.front();
+	handle.type = it->second->type;
+
+	return handle;
+}
+
+// ------------------------------------------------------------
+// --- getInt()
+// ------------------------------------------------------------
+int DataLibReader::getInt( ColumnHandle col )
+{
+	assert( col.index >= 0 && (size_t)col.index < cols.size() );
+
+	if( row == -1 )
+	{
+		seekRow( 0 );
+	}
+
+	if( mode == MAPPED )
+	{
+		return atoi( findField(rowptr, col.index) );
+	}
+
+	return (int)cols[col.index].rowdata;
+}
+
+// ------------------------------------------------------------
+// --- getFloat()
+// ------------------------------------------------------------
+float DataLibReader::getFloat( ColumnHandle col )
+{
+	assert( col.index >= 0 && (size_t)col.index < cols.size() );
+
+	if( row == -1 )
+	{
+		seekRow( 0 );
+	}
+
+	if( mode == MAPPED )
+	{
+		return (float)atof( findField(rowptr, col.index) );
+	}
+
+	return (float)cols[col.index].rowdata;
+}
+
+// ------------------------------------------------------------
+// --- getString()
+// ------------------------------------------------------------
+string DataLibReader::getString( ColumnHandle col )
+{
+	assert( col.index >= 0 && (size_t)col.index < cols.size() );
+	assert( col.type == STRING );
+
+	if( row == -1 )
+	{
+		seekRow( 0 );
+	}
+
+	if( mode == MAPPED )
+	{
+		const char *start = findField( rowptr, col.index );
+		const char *end = start;
+		while( *end != ' ' && *end != '\t' && *end != '\n' && *end != '\0' )
+		{
+			end++;
+		}
+		return string( start, end - start );
+	}
+
+	return string( (const char *)cols[col.index].rowdata );
+}
+
+// ------------------------------------------------------------
+// --- readColumn()
+// ------------------------------------------------------------
+void DataLibReader::readColumn( ColumnHandle col, vector<int> &values )
+{
+	assert( table );
+
+	values.resize( table->nrows );
+
+	for( size_t i = 0; i < table->nrows; i++ )
+	{
+		if( mode == MAPPED )
+		{
+			values[i] = atoi( findField(rowText(i), col.index) );
+		}
+		else
+		{
+			seekRow( i );
+			values[i] = (int)cols[col.index].rowdata;
+		}
+	}
+}
+
+// ------------------------------------------------------------
+// --- readColumn()
+// ------------------------------------------------------------
+void DataLibReader::readColumn( ColumnHandle col, vector<float> &values )
+{
+	assert( table );
+
+	values.resize( table->nrows );
+
+	for( size_t i = 0; i < table->nrows; i++ )
+	{
+		if( mode == MAPPED )
+		{
+			values[i] = (float)atof( findField(rowText(i), col.index) );
+		}
+		else
+		{
+			seekRow( i );
+			values[i] = (float)cols[col.index].rowdata;
+		}
+	}
+}
+
 // ------------------------------------------------------------
 // --- parseHeader()
 // ------------------------------------------------------------
@@ -912,6 +1378,130 @@ void DataLibReader::parseTableHeader()
 	}
 }
 
+// ------------------------------------------------------------
+// --- mapFile()
+// ------------------------------------------------------------
+void DataLibReader::mapFile()
+{
+	struct stat st;
+	SYS( fstat(fileno(f), &st) );
+	mappedSize = st.st_size;
+
+	void *addr = mmap( NULL, mappedSize, PROT_READ, MAP_PRIVATE, fileno(f), 0 );
+	if( addr == MAP_FAILED )
+	{
+		perror( path.c_str() );
+		assert( false );
+	}
+	mapped = (char *)addr;
+
+	madvise( mapped, mappedSize, MADV_SEQUENTIAL );
+}
+
+// ------------------------------------------------------------
+// --- buildRowIndex()
+// ---
+// --- Records the offset of every row in the current table. Only
+// --- needed when rows are not of fixed length, and only done once
+// --- per table.
+// ------------------------------------------------------------
+void DataLibReader::buildRowIndex()
+{
+	if( table->rowindex.size() == table->nrows )
+	{
+		return;
+	}
+
+	table->rowindex.resize( table->nrows );
+
+	const char *end = mapped + mappedSize;
+	const char *p = mapped + table->data;
+
+	for( size_t i = 0; i < table->nrows; i++ )
+	{
+		table->rowindex[i] = p - mapped;
+
+		p = (const char *)memchr( p, '\n', end - p );
+		assert( p );
+		p++;
+	}
+}
+
+// ------------------------------------------------------------
+// --- rowText()
+// ------------------------------------------------------------
+const char *DataLibReader::rowText( int index )
+{
+	if( randomAccess )
+	{
+		return mapped + table->data + ( index * table->rowlen );
+	}
+	else
+	{
+		return mapped + table->rowindex[index];
+	}
+}
+
+// ------------------------------------------------------------
+// --- findField()
+// ---
+// --- Returns the start of the index'th whitespace-delimited field
+// --- of a row, using the same delimiters as parseLine().
+// ------------------------------------------------------------
+const char *DataLibReader::findField( const char *rowtext, int index )
+{
+	const char *p = rowtext;
+
+	for( int i = 0; true; i++ )
+	{
+		while( *p == ' ' || *p == '\t' )
+		{
+			p++;
+		}
+		assert( *p != '\n' && *p != '\0' );
+
+		if( i == index )
+		{
+			return p;
+		}
+
+		while( *p != ' ' && *p != '\t' && *p != '\n' && *p != '\0' )
+		{
+			p++;
+		}
+	}
+}
+
+// ------------------------------------------------------------
+// --- parseField()
+// ------------------------------------------------------------
+void DataLibReader::parseField( __Column &col, const char *start )
+{
+	switch( col.type )
+	{
+	case INT:
+		col.rowdata = atoi(start);
+		break;
+	case FLOAT:
+		col.rowdata = atof(start);
+		break;
+	case BOOL:
+		col.rowdata = atoi(start) != 0;
+		break;
+	case STRING: {
+		const char *end = start;
+		while( *end != ' ' && *end != '\t' && *end != '\n' && *end != '\0' )
+		{
+			end++;
+		}
+		col.rowdata = string( start, end - start ).c_str(); // makes a strdup
+		break;
+	}
+	default:
+		assert(false);
+	}
+}
+
 // ------------------------------------------------------------
 // --- parseLine()
 // ------------------------------------------------------------
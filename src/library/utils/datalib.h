@@ -61,8 +61,25 @@ namespace datalib
 		size_t data;
 		size_t rowlen;
 		size_t nrows;
+		// Row start offsets, built on demand by a mapped reader for tables
+		// without fixed-length rows.
+		std::vector<size_t> rowindex;
 	};
 
+	// ------------------------------------------------------------
+	// --- STRUCT TypeOf
+	// ---
+	// --- Maps a C++ type to its column datatype. Only supported
+	// --- types are specialized, so typed rows with other types
+	// --- fail to compile.
+	// ------------------------------------------------------------
+	template<typename T> struct TypeOf;
+	template<> struct TypeOf<int> { static const Type value = INT; };
+	template<> struct TypeOf<float> { static const Type value = FLOAT; };
+	template<> struct TypeOf<bool> { static const Type value = BOOL; };
+	template<> struct TypeOf<const char *> { static const Type value = STRING; };
+	template<> struct TypeOf<char *> { static const Type value = STRING; };
+
 	typedef std::vector<__Table> __TableVector;
 	typedef std::map<std::string, __Table> __TableMap;
 
@@ -74,6 +91,17 @@ namespace datalib
 	class __Column
 	{
 	public:
+		// How values are rendered. FMT_PRINTF is the general fallback;
+		// the others are fast paths that produce identical text for the
+		// formats that loggers actually use ("%d", "%-20f", "%.2f", ...).
+		enum FormatKind
+		{
+			FMT_PRINTF,
+			FMT_INT,
+			FMT_FLOAT,
+			FMT_STRING
+		};
+
 		__Column();
 		__Column( const char *name,
 				  datalib::Type type,
@@ -86,10 +114,19 @@ namespace datalib
 
 		const char *tname;
 		const char *format;
+
+		FormatKind fmtkind;
+		int width;
+		int precision;
+
+	private:
+		void parseFormat();
 	};
 
 	typedef std::vector<__Column> __ColVector;
 	typedef std::map<std::string, __Column *> __ColMap;
+
+	template<typename... Ts> class TypedTable;
 };
 
 // ================================================================================
@@ -117,7 +154,29 @@ class DataLibWriter
 	void endTable();
 	void flush();
 
+	// Typed tables: column types come from the template arguments, which
+	// must be types supported by datalib::TypeOf. Rows are written through
+	// the returned table, so they can only hold values of those types.
+	template<typename... Ts>
+	datalib::TypedTable<Ts...> beginTypedTable( const char *name,
+												const char *colnames[],
+												const char *colformats[] = NULL );
+
  private:
+	template<typename... Ts> friend class datalib::TypedTable;
+
+	template<typename... Ts>
+	void addTypedRow( Ts... vals );
+
+	char *beginRow();
+	void endRow( char *b );
+	char *putCol( char *b, size_t i, int val );
+	char *putCol( char *b, size_t i, float val );
+	char *putCol( char *b, size_t i, bool val );
+	char *putCol( char *b, size_t i, const char *val );
+	char *endCol( char *b );
+	void flushBlock();
+
 	void fileHeader();
 	void fileFooter();
 	void tableHeader();
@@ -131,8 +190,82 @@ class DataLibWriter
 	datalib::__TableVector tables;
 	datalib::__Table *table;
 	datalib::__ColVector cols;
+
+	// Formatted rows are accumulated here and written in bulk.
+	std::vector<char> block;
+	size_t blocklen;
+	char *rowstart;
 };
 
+namespace datalib
+{
+	// ------------------------------------------------------------
+	// --- CLASS TypedTable
+	// ---
+	// --- Handle to a table begun by DataLibWriter::beginTypedTable(),
+	// --- valid until the writer ends the table. addRow() takes exactly
+	// --- the column types, so a row that doesn't match the table
+	// --- fails to compile. That includes implicit conversions, such as
+	// --- long to int or double to float: any other argument types pick
+	// --- the deleted template.
+	// ------------------------------------------------------------
+	template<typename... Ts>
+	class TypedTable
+	{
+	public:
+		TypedTable() : writer( NULL ) {}
+
+		void addRow( Ts... vals ) { writer->addTypedRow<Ts...>( vals... ); }
+		template<typename... Us>
+		void addRow( Us... vals ) = delete;
+
+		DataLibWriter *getWriter() const { return writer; }
+
+	private:
+		friend class ::DataLibWriter;
+
+		TypedTable( DataLibWriter *writer ) : writer( writer ) {}
+
+		DataLibWriter *writer;
+	};
+}
+
+// ------------------------------------------------------------
+// --- beginTypedTable()
+// ------------------------------------------------------------
+template<typename... Ts>
+datalib::TypedTable<Ts...> DataLibWriter::beginTypedTable( const char *name,
+														   const char *colnames[],
+														   const char *colformats[] )
+{
+	const datalib::Type coltypes[] = { datalib::TypeOf<Ts>::value... };
+
+	beginTable( name, colnames, coltypes, colformats );
+
+	assert( cols.size() == sizeof...(Ts) );
+
+	return datalib::TypedTable<Ts...>( this );
+}
+
+// ------------------------------------------------------------
+// --- addTypedRow()
+// ------------------------------------------------------------
+template<typename... Ts>
+void DataLibWriter::addTypedRow( Ts... vals )
+{
+	assert( table );
+
+	char *b = beginRow();
+	size_t i = 0;
+
+	// Braced initializers are evaluated in order, so columns are
+	// emitted left to right.
+	int expand[] = { 0, (b = putCol(b, i++, vals), 0)... };
+	(void)expand;
+
+	endRow( b );
+}
+
 
 // ================================================================================
 // ===
@@ -142,7 +275,37 @@ class DataLibWriter
 class DataLibReader
 {
  public:
-	DataLibReader( const char *path );
+	// ------------------------------------------------------------
+	// --- ENUM Mode
+	// ---
+	// --- STREAM reads rows through stdio and parses every column
+	// --- into a Variant. MAPPED maps the file into memory, locates
+	// --- rows via the digest (fixed) or a one-time row index (none),
+	// --- and only converts the columns that are actually requested.
+	// ------------------------------------------------------------
+	enum Mode
+	{
+		STREAM,
+		MAPPED
+	};
+
+	// ------------------------------------------------------------
+	// --- CLASS ColumnHandle
+	// ---
+	// --- A column resolved once by name, for typed access that
+	// --- bypasses the name lookup and Variant conversion of col().
+	// --- Only valid for the table that was current when obtained.
+	// ------------------------------------------------------------
+	class ColumnHandle
+	{
+	public:
+		ColumnHandle() : index(-1), type(datalib::INVALID) {}
+
+		int index;
+		datalib::Type type;
+	};
+
+	DataLibReader( const char *path, Mode mode = STREAM );
 	~DataLibReader();
 
 	bool seekTable( const char *name );
@@ -153,6 +316,12 @@ class DataLibReader
 	int position();
 	const Variant &col( const char *name );
 
+	ColumnHandle colHandle( const char *name );
+	int getInt( ColumnHandle col );
+	float getFloat( ColumnHandle col );
+	std::string getString( ColumnHandle col );
+	void readColumn( ColumnHandle col, std::vector<int> &values );
+	void readColumn( ColumnHandle col, std::vector<float> &values );
 
  private:
 	void parseHeader();
@@ -166,8 +335,15 @@ class DataLibReader
 #endif
 											 const char *end)> callback);
 
+	void mapFile();
+	void buildRowIndex();
+	const char *rowText( int index );
+	const char *findField( const char *rowtext, int index );
+	void parseField( datalib::__Column &col, const char *start );
+
  private:
 	FILE *f;
+	Mode mode;
 	bool randomAccess;
 	bool singleSchema;
 	int row;
@@ -176,4 +352,9 @@ class DataLibReader
 	datalib::__ColVector cols;
 	datalib::__ColMap colmap;
 	std::string path;
+
+	// MAPPED mode state
+	char *mapped;
+	size_t mappedSize;
+	const char *rowptr;
 };
@@ -15,6 +15,8 @@
 	#include <mach/mach_time.h>
 #endif
 
+#include <algorithm>
+#include <dirent.h>
 #include <math.h>
 #include <mutex>
 #include <stdio.h>
@@ -24,6 +26,7 @@
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <utime.h>
 #include <set>
 #include <string>
 #include <vector>
@@ -271,6 +274,60 @@ vector<string> split( const string& str, const string& delimiters )
     return( parts );
 }
 
+
+unsigned long long hash64( const void *data, size_t len, unsigned long long hash )
+{
+	const unsigned char *bytes = (const unsigned char *)data;
+
+	for( size_t i = 0; i < len; i++ )
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+void touchCacheEntry( const string &path )
+{
+	utime( path.c_str(), NULL );
+}
+
+void pruneCacheDir( const string &dir, size_t maxEntries )
+{
+	DIR *d = opendir( dir.c_str() );
+	if( d == NULL )
+		return;
+
+	vector< pair<time_t, string> > entries;
+	struct dirent *ent;
+	while( (ent = readdir(d)) != NULL )
+	{
+		if( strchr(ent->d_name, '.') )
+			continue;
+
+		string path = dir + "/" + ent->d_name;
+		struct stat st;
+		if( stat(path.c_str(), &st) == 0 )
+			entries.push_back( make_pair(st.st_mtime, path) );
+	}
+	closedir( d );
+
+	if( entries.size() <= maxEntries )
+		return;
+
+	// Newest first.
+	sort( entries.rbegin(), entries.rend() );
+
+	for( size_t i = maxEntries; i < entries.size(); i++ )
+	{
+		// Only a cache, so a failure to remove is left for the next prune.
+		string cmd = "rm -rf " + entries[i].second;
+		if( 0 != system(cmd.c_str()) )
+			break;
+	}
+}
+
 // int main( int argc, char** argv )
 // {
 // 	string sentence( "Now is the time for all good men" );
@@ -104,6 +104,16 @@ int GetMaximumFiles( long *filecount );
 
 std::vector<std::string> split( const std::string& str, const std::string& delimiters = " " );
 
+// FNV-1a. Pass a previous result as hash to continue over more data.
+unsigned long long hash64( const void *data, size_t len, unsigned long long hash = 14695981039346656037ULL );
+
+// Cache directories hold one entry (file or directory) per key. An entry is
+// touched whenever it's used, and pruning removes all but the maxEntries most
+// recently used. Names with a '.' are temporaries still being written, and
+// are left alone.
+void touchCacheEntry( const std::string &path );
+void pruneCacheDir( const std::string &dir, size_t maxEntries );
+
 #ifndef PI
 #define PI M_PI
 #endif /*PI*/
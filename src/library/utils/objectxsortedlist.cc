@@ -7,6 +7,7 @@
  -------------------------------------------------------------------------*/
 
 #include <assert.h>
+#include <string.h>
 
 #include "objectxsortedlist.h"
 #include "agent/agent.h"
@@ -31,6 +32,17 @@ class objectxsortedlist;
 objectxsortedlist objectxsortedlist::gXSortedObjects;
 
 
+//---------------------------------------------------------------------------
+// objectxsortedlist::objectxsortedlist
+//---------------------------------------------------------------------------
+objectxsortedlist::objectxsortedlist()
+{
+    curr = -1;
+    nremoved = 0;
+    agentCount = foodCount = brickCount = 0;
+    markedAgent = markedFood = markedBrick = -1;
+}
+
 //---------------------------------------------------------------------------
 // objectxsortedlist::getCount
 //---------------------------------------------------------------------------
@@ -51,22 +63,72 @@ int objectxsortedlist::getCount( int objType )
 	return( count );
 }
 
+//---------------------------------------------------------------------------
+// objectxsortedlist::findObj
+//---------------------------------------------------------------------------
+// Index of the first object of a given type past from in direction, or -1.
+// From -1, starts at the head (NEXT) or the tail (PREV).
+long objectxsortedlist::findObj( long from, int direction, int objType )
+{
+	long n = entries.size();
+
+	if( direction == NEXT )
+	{
+		for( long i = from + 1; i < n; i++ )
+		{
+			gobject *o = entries[i].o;
+			if( o && (o->getType() & objType) )
+				return i;
+		}
+	}
+	else
+	{
+		for( long i = (from < 0 ? n : from) - 1; i >= 0; i-- )
+		{
+			gobject *o = entries[i].o;
+			if( o && (o->getType() & objType) )
+				return i;
+		}
+	}
+
+	return -1;
+}
+
+//---------------------------------------------------------------------------
+// objectxsortedlist::next
+//---------------------------------------------------------------------------
+int objectxsortedlist::next( gobject* &o )
+{
+	return nextObj( ANYTYPE, &o );
+}
+
+//---------------------------------------------------------------------------
+// objectxsortedlist::getcurr
+//---------------------------------------------------------------------------
+gobject* objectxsortedlist::getcurr()
+{
+	return curr < 0 ? NULL : entries[curr].o;
+}
+
+//---------------------------------------------------------------------------
+// objectxsortedlist::setcurr
+//---------------------------------------------------------------------------
+void objectxsortedlist::setcurr( gobject* o )
+{
+	curr = o ? o->listIndex : -1;
+}
+
 //---------------------------------------------------------------------------
 // objectxsortedlist::lastObj
 //---------------------------------------------------------------------------
 int objectxsortedlist::lastObj( int objType, gobject** g )
 {
-    int returnVal;
-
-    // Start with the last object
-    returnVal = this->last( *g );
-    
-    // Traverse the list backwards to find the last object of the given type
-    while( ((*g)->getType() & objType) == 0 )
-		returnVal = this->prev(*g);
-    
-    // Return whatever prev or last returned
-    return returnVal;
+	curr = findObj( -1, PREV, objType );
+	if( curr < 0 )
+		return 0;
+
+	*g = entries[curr].o;
+	return 1;
 }
 
 
@@ -78,22 +140,12 @@ int objectxsortedlist::lastObj( int objType, gobject** g )
 //
 int objectxsortedlist::nextObj( int objType, gobject** g )
 {
-    int returnVal;
+	curr = findObj( curr, NEXT, objType );
+	if( curr < 0 )
+		return 0;
 
-    // Start with the next object in the list
-    returnVal = this->next( *g );
-	if( !returnVal )
-		return returnVal;
-		
-    // Traverse the list forwards looking for an appropriate object
-    while( ((*g)->getType() & objType) == 0 )
-	{
-		returnVal = this->next( *g );
-		if( returnVal == 0 )
-			return returnVal;
-    }
-
-    return returnVal;
+	*g = entries[curr].o;
+	return 1;
 }
 
 
@@ -103,22 +155,12 @@ int objectxsortedlist::nextObj( int objType, gobject** g )
 // Get the previous object of a given type
 int objectxsortedlist::prevObj( int objType, gobject** g )
 {
-    int returnVal;
-	
-    // Start with the previous object
-    returnVal = this->prev( *g );
-	if( !returnVal )
-		return( returnVal );
+	curr = findObj( curr, PREV, objType );
+	if( curr < 0 )
+		return 0;
 
-    // Traverse backwards looking for an object of the given type
-    while( ((*g)->getType() & objType) == 0 )
-	{
-		returnVal = this->prev( *g );
-		if( !returnVal )
-			return returnVal;
-    }
-	
-    return returnVal;
+	*g = entries[curr].o;
+	return 1;
 }
 
 
@@ -139,31 +181,163 @@ int objectxsortedlist::anotherObj( int direction, int objType, gobject** g )
 }
 
 
+//---------------------------------------------------------------------------
+// objectxsortedlist::nextObj
+//---------------------------------------------------------------------------
+gobject* objectxsortedlist::nextObj( gobject* o, int objType )
+{
+	long i = findObj( o->listIndex, NEXT, objType );
+	return i < 0 ? NULL : entries[i].o;
+}
+
+
+//---------------------------------------------------------------------------
+// objectxsortedlist::prevObj
+//---------------------------------------------------------------------------
+gobject* objectxsortedlist::prevObj( gobject* o, int objType )
+{
+	long i = findObj( o->listIndex, PREV, objType );
+	return i < 0 ? NULL : entries[i].o;
+}
+
+
 //---------------------------------------------------------------------------
 // objectxsortedlist::add
 //---------------------------------------------------------------------------
-// Add an object to the all objects list
+// Add an object to the all objects list, before the first object starting
+// after it. Positions are read from the objects, which may have moved since
+// the last sort. The cursor and marks stay on the objects they were on.
 void objectxsortedlist::add( gobject* a )
 {
 #ifdef DEBUGCALLS
     pushproc( "objectxsortedlist::add" );
 #endif // DEBUGCALLS
-    bool inserted = false;
-    gobject* o;
-    this->reset();
-    while( this->next( o ) )
+    float xmin = a->x() - a->radius();
+    long n = entries.size();
+    long i;
+    for( i = 0; i < n; i++ )
 	{
-        if( (a->x() - a->radius()) < (o->x() - o->radius()) )
-		{
-			a->listLink = this->inserthere(a);
-            inserted = true;
+		gobject *o = entries[i].o;
+        if( o && (xmin < (o->x() - o->radius())) )
             break;
-        }
     }
 
-    if( !inserted )
-		a->listLink = this->append( a );
-    
+	// Fill a hole left by a removal if there's one right there.
+	if( (i > 0) && (entries[i - 1].o == NULL) && (curr != i - 1) )
+	{
+		entries[i - 1].xmin = xmin;
+		entries[i - 1].o = a;
+		a->listIndex = i - 1;
+		nremoved--;
+	}
+	else
+		insertAt( i, a );
+
+    countAdded( a );
+
+#ifdef DEBUGCALLS
+    popproc();
+#endif // DEBUGCALLS
+
+}
+
+
+//---------------------------------------------------------------------------
+// objectxsortedlist::insertAt
+//---------------------------------------------------------------------------
+void objectxsortedlist::insertAt( long i, gobject* a )
+{
+	Entry entry = { a->x() - a->radius(), a };
+	entries.insert( entries.begin() + i, entry );
+	indexFrom( i );
+
+	if( curr >= i )
+		curr++;
+	if( markedAgent >= i )
+		markedAgent++;
+	if( markedFood >= i )
+		markedFood++;
+	if( markedBrick >= i )
+		markedBrick++;
+}
+
+
+//---------------------------------------------------------------------------
+// objectxsortedlist::indexFrom
+//---------------------------------------------------------------------------
+// Tell the objects from i on where they are.
+void objectxsortedlist::indexFrom( long i )
+{
+	long n = entries.size();
+	for( ; i < n; i++ )
+	{
+		if( entries[i].o )
+			entries[i].o->listIndex = i;
+	}
+}
+
+
+//---------------------------------------------------------------------------
+// objectxsortedlist::addSorted
+//---------------------------------------------------------------------------
+// Add several objects, already stably sorted by x - radius, in one merge.
+// Leaves the list exactly as calling add() on each in turn would.
+void objectxsortedlist::addSorted( const vector<gobject*> &objects )
+{
+#ifdef DEBUGCALLS
+    pushproc( "objectxsortedlist::addSorted" );
+#endif // DEBUGCALLS
+	vector<Entry> merged;
+	merged.reserve( entries.size() + objects.size() );
+
+	long n = entries.size();
+	long k = 0;
+	long remap[] = { curr, markedAgent, markedFood, markedBrick };
+	long *indexes[] = { &curr, &markedAgent, &markedFood, &markedBrick };
+
+	auto copyThrough = [&]( long end )
+	{
+		for( ; k < end; k++ )
+		{
+			for( int j = 0; j < 4; j++ )
+				if( remap[j] == k )
+					*indexes[j] = merged.size();
+			merged.push_back( entries[k] );
+		}
+	};
+
+    for( gobject* a : objects )
+	{
+		float xmin = a->x() - a->radius();
+
+		// add() would stop at the same object, since everything before it
+		// starts no later than the previous object added
+		long end = k;
+		while( (end < n) && (!entries[end].o || !(xmin < (entries[end].o->x() - entries[end].o->radius()))) )
+			end++;
+		copyThrough( end );
+
+		Entry entry = { xmin, a };
+		merged.push_back( entry );
+
+		countAdded( a );
+	}
+	copyThrough( n );
+
+	entries.swap( merged );
+	indexFrom( 0 );
+
+#ifdef DEBUGCALLS
+    popproc();
+#endif // DEBUGCALLS
+}
+
+
+//---------------------------------------------------------------------------
+// objectxsortedlist::countAdded
+//---------------------------------------------------------------------------
+void objectxsortedlist::countAdded( gobject* a )
+{
     // Increase object type count based on added object's type
     switch( a->getType() )
 	{
@@ -183,83 +357,59 @@ void objectxsortedlist::add( gobject* a )
 			fprintf( stderr, "%s() called for x-sorted object list with invalid object type (%d)\n", __func__, a->getType() );
 			break;
     }
+}
 
-#ifdef DEBUGCALLS
-    popproc();
-#endif // DEBUGCALLS
 
+//---------------------------------------------------------------------------
+// objectxsortedlist::markFor
+//---------------------------------------------------------------------------
+long &objectxsortedlist::markFor( int objType )
+{
+	static long noMark;
+
+	switch( objType )
+	{
+		case AGENTTYPE:
+			return markedAgent;
+		case FOODTYPE:
+			return markedFood;
+		case BRICKTYPE:
+			return markedBrick;
+		default:
+			noMark = -1;
+			return noMark;
+	}
 }
 
 
 //---------------------------------------------------------------------------
 // objectxsortedlist::removeCurrentObject
 //---------------------------------------------------------------------------
-// Remove the current object and decrement the appropriate count
+// Remove the current object and decrement the appropriate count. The cursor
+// moves back to the previous object, and so does the mark for the object's
+// type if it was on it.
 void objectxsortedlist::removeCurrentObject()
 {
-    int validReturn;
-    gobject* o;
+	gobject* o = getcurr();
 
-    // Start with the previous object
-    validReturn = this->current( o );
-
-	if( validReturn )
+	if( o )
 	{
 		// decrease object type count based on added object's type
-		// and deal with the case when the marked item is what is being removed
 		switch( o->getType() )
 		{
-			gdlink<gobject*> *tempItem;
-
 			case AGENTTYPE:
 				cntPrint( "%s: decrementing agentCount from %d to %d\n", __func__, agentCount, agentCount - 1 );
 				agentCount--;
-				tempItem = currItem;
-				while( (markedAgent == currItem) && (markedAgent != 0) )
-				{
-					if( tempItem == lastItem->nextItem )	// backed up to the head of the list
-						markedAgent = 0;					// so there won't be a mark for this type anymore
-					else
-					{
-						tempItem = tempItem->prevItem;				// back up one item in the list
-						if( tempItem->e->getType() == AGENTTYPE )	// if it's of the right type,
-							markedAgent = tempItem;				// mark it (and that will kick us out of the loop)
-					}
-				}
 				break;
 
 			case FOODTYPE:
 				cntPrint( "%s: decrementing foodCount from %d to %d\n", __func__, foodCount, foodCount - 1 );
 				foodCount--;
-				tempItem = currItem;
-				while( (markedFood == currItem) && (markedFood != 0) )
-				{
-					if( tempItem == lastItem->nextItem )	// backed up to the head of the list
-						markedFood = 0;						// so there won't be a mark for this type anymore
-					else
-					{
-						tempItem = tempItem->prevItem;				// back up one item in the list
-						if( tempItem->e->getType() == FOODTYPE )	// if it's of the right type,
-							markedFood = tempItem;					// mark it (and that will kick us out of the loop)
-					}
-				}
 				break;
 
 			case BRICKTYPE:
 				cntPrint( "%s: decrementing brickCount from %d to %d\n", __func__, brickCount, brickCount - 1 );
 				brickCount--;
-				tempItem = currItem;
-				while( (markedBrick == currItem) && (markedBrick != 0) )
-				{
-					if( tempItem == lastItem->nextItem )	// backed up to the head of the list
-						markedBrick = 0;					// so there won't be a mark for this type anymore
-					else
-					{
-						tempItem = tempItem->prevItem;				// back up one item in the list
-						if( tempItem->e->getType() == BRICKTYPE )	// if it's of the right type,
-							markedBrick = tempItem;					// mark it (and that will kick us out of the loop)
-					}
-				}
 				break;
 
 			default:
@@ -267,9 +417,17 @@ void objectxsortedlist::removeCurrentObject()
 				break;
 		}
 
-		// Actually remove the object from the list
-		this->remove();
+		// deal with the case when the marked item is what is being removed
+		long &mark = markFor( o->getType() );
+		if( mark == curr )
+			mark = findObj( curr, PREV, o->getType() );
+
+		// Actually remove the object from the list, leaving a hole for sort()
+		entries[curr].o = NULL;
+		nremoved++;
+		curr = findObj( curr, PREV, ANYTYPE );
 		
+		long kount = entries.size() - nremoved;
 		if( kount != (agentCount + foodCount + brickCount) )
 		{
 			printf( "kount (%ld) != agentCount (%d) + foodCount (%d) + brickCount (%d)\n", kount, agentCount, foodCount, brickCount );
@@ -282,18 +440,18 @@ void objectxsortedlist::removeCurrentObject()
 // objectxsortedlist::removeObjectWithLink
 //---------------------------------------------------------------------------
 // Remove the provided object and decrement the appropriate count
-// The provided object MUST have a valid ListLink
+// The provided object MUST have a valid listIndex
 void objectxsortedlist::removeObjectWithLink( gobject* o )
 {
-	gdlink<gobject*> *item = o->GetListLink();
-	gdlink<gobject*> *saveCurr;
+	long item = o->listIndex;
+	long saveCurr;
 	int countType;
 	
-	saveCurr = 0;
-	if( currItem != item )
-		saveCurr = currItem;
-	currItem = item;
-	removeCurrentObject();	// will take care of currItem, markItem, and marked<type> if they point to the item being removed
+	saveCurr = -1;
+	if( curr != item )
+		saveCurr = curr;
+	curr = item;
+	removeCurrentObject();	// will take care of curr and marked<type> if they point to the item being removed
     switch( o->getType() )
 	{
 		case AGENTTYPE:
@@ -307,12 +465,12 @@ void objectxsortedlist::removeObjectWithLink( gobject* o )
 			break;
 		default:
 			printf( "ERROR: tried to remove object with link using invalid object type (%d)\n", o->getType() );
-			countType = kount;	// not very meaningful, but nothing is at this point
+			countType = entries.size() - nremoved;	// not very meaningful, but nothing is at this point
 			break;
     }
 
-	if( countType && saveCurr )
-		currItem = saveCurr;
+	if( countType && (saveCurr >= 0) )
+		curr = saveCurr;
 	return;
 }
 
@@ -326,40 +484,70 @@ void objectxsortedlist::sort()
 #ifdef DEBUGCALLS
     pushproc("objectxsortedlist::sort");
 #endif // DEBUGCALLS
+	// Marks follow their objects.
+	long *marks[] = { &markedAgent, &markedFood, &markedBrick };
+	gobject *marked[3];
+	for( int j = 0; j < 3; j++ )
+		marked[j] = *marks[j] < 0 ? NULL : entries[*marks[j]].o;
+
+	// Squeeze out the holes and take the new positions.
+	long n = 0;
+	for( Entry &entry : entries )
+	{
+		gobject *o = entry.o;
+		if( o )
+		{
+			entries[n].xmin = o->x() - o->radius();
+			entries[n].o = o;
+			n++;
+		}
+	}
+	entries.resize( n );
+	nremoved = 0;
+
     // This technique assumes that the list is almost entirely sorted at the start
     // Hopefully, with some reasonable frame-to-frame coherency, this will be true!
-    gdlink<gobject*> *savecurr;
-    gobject* o = NULL;
-    gobject* p = NULL;
-    gobject* b = NULL;
-    this->reset();
-    this->next( p );
-    savecurr = currItem;
-    while( this->next( o ) )
+    // An object that starts before its predecessor goes back to just after the
+    // last object that starts strictly before it, as the linked list's sort did.
+	Entry *e = entries.data();
+	for( long i = 1; i < n; i++ )
 	{
-		if( (o->x() - o->radius()) < (p->x() - p->radius()) )
+		if( e[i].xmin < e[i - 1].xmin )
 		{
-			gdlink<gobject*>* link = this->unlink();  // at o, just unlink
-			currItem = savecurr;  // back up to previous one directly
-			while( this->prev( b ) ) // then use iterator to move back again
-				if( (b->x() - b->radius()) < (o->x() - o->radius()) )
-					break; // until we have one that starts before o
-			if( currItem )  // we did find one, and didn't run off beginning of list
-				this->appendhere( link );
-			else  // we have a new head of the list
-				this->insert( link );
-			currItem = savecurr;
-			o =	p;
+			Entry moved = e[i];
+			long j = i - 1;
+			while( (j > 0) && !(e[j - 1].xmin < moved.xmin) )
+				j--;
+			memmove( e + j + 1, e + j, (i - j) * sizeof(Entry) );
+			e[j] = moved;
 		}
-		p = o;
-		savecurr = currItem;
-    }
+	}
+
+	indexFrom( 0 );
+
+	// The walk ends off the list, as the linked list's did.
+	curr = -1;
+	for( int j = 0; j < 3; j++ )
+		*marks[j] = marked[j] ? marked[j]->listIndex : -1;
 #ifdef DEBUGCALLS
     popproc();
 #endif // DEBUGCALLS
 }
 
 
+//---------------------------------------------------------------------------
+// objectxsortedlist::clear
+//---------------------------------------------------------------------------
+void objectxsortedlist::clear()
+{
+	entries.clear();
+	curr = -1;
+	nremoved = 0;
+	agentCount = foodCount = brickCount = 0;
+	markedAgent = markedFood = markedBrick = -1;
+}
+
+
 //---------------------------------------------------------------------------
 // objectxsortedlist::list
 //---------------------------------------------------------------------------
@@ -368,24 +556,18 @@ void objectxsortedlist::list()
 #ifdef DEBUGCALLS
     pushproc("objectxsortedlist::list");
 #endif // DEBUGCALLS
-    gdlink<gobject*> *savecurr;
-    gobject* pobj;
-    savecurr = currItem;
-    cout << "c" eql currItem sp "m" eql markItem sp "l" eql lastItem sp "f" eql lastItem->nextItem << " ";
-    this->reset();
-    cout << this->kount << ":";
-    while( this->next( pobj ) )
+    cout << "c" eql curr sp "a" eql markedAgent sp "f" eql markedFood sp "b" eql markedBrick << " ";
+    cout << (entries.size() - nremoved) << ":";
+    for( Entry &entry : entries )
 	{
-		if( pobj->getType() == AGENTTYPE )
+		if( entry.o && (entry.o->getType() == AGENTTYPE) )
 		{
 			agent* c;
-			c = (agent*) pobj;
-			//cout sp c->Number() << "/" << pobj << "/" << pobj->GetListLink();
+			c = (agent*) entry.o;
 			cout sp c->Number() << "(x=" << c->x() << ")";
 		}
     }
     cout nlf;
-    currItem = savecurr;
 #ifdef DEBUGCALLS
     popproc();
 #endif // DEBUGCALLS
@@ -403,57 +585,28 @@ void objectxsortedlist::list()
 */
 void objectxsortedlist::setMark( int objType )
 {
-    gdlink<gobject*>* lookAt = currItem;
-    if( lookAt->e->getType() != objType )
+    gobject* lookAt = getcurr();
+    if( !lookAt || (lookAt->getType() != objType) )
 	{
-		printf( "ERROR: mark objtype (%d) != current objtype (%d)\n", objType, lookAt->e->getType() );
+		printf( "ERROR: mark objtype (%d) != current objtype (%d)\n", objType, lookAt ? lookAt->getType() : 0 );
 		exit( 1 );
     }
 
-    /*  Other option is to search forward to find object of correct type
-	while( lookAt->e->getType() != objType )
-	{
-		lookAt = lookAt->nextItem;
-		if( lookAt == lastItem )
-		{
-			// Went to the end of the list
-			printf("Setting mark past the end of the list.\n");
-			//exit(1);
-		}
-    }
-    */
-
-    if( objType == AGENTTYPE )
-		markedAgent = lookAt;
-    else if( objType == FOODTYPE )
-		markedFood = lookAt;
-    else if( objType == BRICKTYPE )
-		markedBrick = lookAt;
+    if( (objType == AGENTTYPE) || (objType == FOODTYPE) || (objType == BRICKTYPE) )
+		markFor( objType ) = curr;
     else
 		printf( "ERROR: Trying to set mark with illegal type (%d)\n", objType );
 }
 
 
+/*
+  Set the mark on the nearest object of the type before the current one, or
+  off the list if there isn't one.
+*/
 void objectxsortedlist::setMarkPrevious( int objType )
 {
-    gdlink<gobject*>* lookAt = currItem->prevItem;
-    while( lookAt->e->getType() != objType )
-	{
-		lookAt = lookAt->prevItem;
-		if( lookAt == lastItem )
-		{
-			// Went to the beginning of the list
-			//printf( "Setting mark past the beginning of the list.\n" );
-			//exit( 1 );
-		}
-    }
-
-    if( objType == AGENTTYPE )
-		markedAgent = lookAt;
-    else if( objType == FOODTYPE )
-		markedFood = lookAt;
-    else if( objType == BRICKTYPE )
-		markedBrick = lookAt;
+    if( (objType == AGENTTYPE) || (objType == FOODTYPE) || (objType == BRICKTYPE) )
+		markFor( objType ) = findObj( curr, PREV, objType );
     else
 		printf( "ERROR: Trying to set mark to prev item with illegal type (%d)\n", objType );
 }
@@ -465,66 +618,30 @@ void objectxsortedlist::setMarkPrevious( int objType )
 */
 void objectxsortedlist::setMarkLast( int objType )
 {
-    gdlink<gobject*>* lookAt = lastItem;
-    while( lookAt->e->getType() != objType )
-	{
-		lookAt = lookAt->prevItem;
-		if( lookAt == lastItem )
-		{
-			// Went to the end of the list
-			//printf( "Setting mark past the end of the list.\n" );
-			//exit( 1 );
-		}
-    }
-	
-    if( objType == AGENTTYPE )
-		markedAgent = lookAt;
-    else if( objType == FOODTYPE )
-	    markedFood = lookAt;
-    else if( objType == BRICKTYPE )
-		markedBrick = lookAt;
+    if( (objType == AGENTTYPE) || (objType == FOODTYPE) || (objType == BRICKTYPE) )
+		markFor( objType ) = findObj( -1, PREV, objType );
     else
 		printf( "ERROR: Trying to set mark to last item with illegal type (%d)\n", objType );
 }
 
 void objectxsortedlist::toMark( int objType )
 {
-    if (objType == AGENTTYPE)
-		currItem = markedAgent;
-    else if (objType == FOODTYPE)
-		currItem = markedFood;
-    else if (objType == BRICKTYPE)
-		currItem = markedBrick;
+    if( (objType == AGENTTYPE) || (objType == FOODTYPE) || (objType == BRICKTYPE) )
+		curr = markFor( objType );
 	else
 		printf( "ERROR: Trying to go to mark for illegal type (%d)\n", objType );
 }
 
 void objectxsortedlist::getMark( int objType, gobject* gob )
 {
-    if( objType == AGENTTYPE )
+    if( (objType == AGENTTYPE) || (objType == FOODTYPE) || (objType == BRICKTYPE) )
 	{
-		if( markedAgent )
-			gob = markedAgent->e;
+		long mark = markFor( objType );
+		if( mark >= 0 )
+			gob = entries[mark].o;
 		else
 			gob = 0;
 	}
-	else if( objType == FOODTYPE )
-	{
-		if( markedFood )
-			gob = markedFood->e;
-		else
-			gob = 0;
-	}
-	else if (objType == BRICKTYPE)
-	{
-		if (markedBrick)
-			gob = markedBrick->e;
-		else
-			gob = 0;
-    }
 	else
 		printf( "ERROR: Trying to get mark for illegal type (%d)\n", objType );
 }
-
-
-
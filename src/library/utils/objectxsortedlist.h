@@ -4,7 +4,8 @@
 #define NEXT 1
 #define PREV 2
 
-#include "gdlink.h"
+#include <vector>
+
 #include "agent/agent.h"
 #include "environment/brick.h"
 #include "environment/food.h"
@@ -16,33 +17,67 @@ using namespace std;
 
 //===========================================================================
 // Sorted list of all objects: agents, food, bricks, other.
+//
+// Kept as an array of (x - radius, object) entries rather than a linked list,
+// so the per-step re-sort walks contiguous memory. Objects removed since the
+// last sort() are left as holes, so the indexes held by the cursor, the marks
+// and the objects themselves (gobject::listIndex) stay put while the list is
+// being walked; sort() squeezes them out.
 //===========================================================================
 
-class objectxsortedlist : public gdlist<gobject*>
+class objectxsortedlist
 {
 	PROPLIB_CPP_PROPERTIES
 
  private:
+	struct Entry
+	{
+		float xmin;		// as of the last sort
+		gobject *o;		// NULL once removed
+	};
+
+    vector<Entry> entries;
+    long curr;			// -1 when off the list, as after reset()
+    long nremoved;
     int agentCount;
     int foodCount;
     int brickCount;
-    gdlink<gobject*> *markedAgent;	
-    gdlink<gobject*> *markedFood;	
-    gdlink<gobject*> *markedBrick;	
+    long markedAgent;
+    long markedFood;
+    long markedBrick;
+
+    void countAdded( gobject* a );
+    long &markFor( int objType );
+    long findObj( long from, int direction, int objType );
+    void insertAt( long i, gobject* a );
+    void indexFrom( long i );
 
  public:
-    objectxsortedlist() { markedAgent = 0; markedFood = 0; markedBrick = 0; }
+    objectxsortedlist();
     ~objectxsortedlist() { }
     void add( gobject* a );
+    void addSorted( const vector<gobject*> &objects );
     void removeCurrentObject();
 	void removeObjectWithLink( gobject* o );
     void sort();
     void list();
+    void clear();
+
+    void reset() { curr = -1; }
+    int next( gobject* &o );
+    // The cursor as the current object, NULL when off the list. Unlike the
+    // linked list's, it stays valid across add() and remove.
+    gobject* getcurr();
+    void setcurr( gobject* o );
+
     int getCount( int objType );
     int nextObj( int objType, gobject** gob );
     int prevObj( int objType, gobject** gob );
     int lastObj( int objType, gobject** gob );
 	int anotherObj( int direction, int objType, gobject** gob );
+	// Neighbors of o, leaving the cursor alone.
+	gobject* nextObj( gobject* o, int objType );
+	gobject* prevObj( gobject* o, int objType );
 
     void setMark( int objType );
     void setMarkPrevious( int objType );
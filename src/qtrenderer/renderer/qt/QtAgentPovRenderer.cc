@@ -2,6 +2,9 @@
 
 #include <assert.h>
 
+#include <algorithm>
+
+#include <QGLBuffer>
 #include <QGLPixelBuffer>
 #include <QGLWidget>
 
@@ -27,6 +30,10 @@ QtAgentPovRenderer::QtAgentPovRenderer( int maxAgents,
                                         int retinaWidth,
                                         int retinaHeight )
 : fPixelBuffer( NULL )
+, fRetinaHeight( retinaHeight )
+, fBatchedReadback( false )
+, fReadbackBuffer( NULL )
+, fReadbackMapped( false )
 {
 	// If we decide we want the width W (in cells) to be a multiple of N (call it I)
 	// and we want the aspect ratio of W to height H (in cells) to be at least A,
@@ -41,6 +48,7 @@ QtAgentPovRenderer::QtAgentPovRenderer( int maxAgents,
 	int nrows = (maxAgents + ncols - 1) / ncols;
 	fBufferWidth = ncols * (retinaWidth + CELL_PAD);
 	fBufferHeight = nrows * (retinaHeight + CELL_PAD);
+	fNumRows = nrows;
 
 	slotHandle = AgentAttachedData::createSlot();
 
@@ -54,6 +62,8 @@ QtAgentPovRenderer::QtAgentPovRenderer( int maxAgents,
 		short irow = short(i / ncols);            
 		short icol = short(i) - (ncols * irow);
 
+		viewport->row = irow;
+
 		viewport->width = retinaWidth;
 		viewport->height = retinaHeight;
 
@@ -70,6 +80,13 @@ QtAgentPovRenderer::QtAgentPovRenderer( int maxAgents,
 //---------------------------------------------------------------------------
 QtAgentPovRenderer::~QtAgentPovRenderer()
 {
+	if( fReadbackBuffer )
+	{
+		fPixelBuffer->makeCurrent();
+		unmapReadback();
+		delete fReadbackBuffer;
+	}
+
 	delete fPixelBuffer;
 	delete [] fViewports;
 }
@@ -118,10 +135,30 @@ void QtAgentPovRenderer::beginStep()
 		glLoadIdentity();
 		glMatrixMode(GL_PROJECTION);
 		glLoadIdentity();
+
+		if( fBatchedReadback )
+		{
+			fReadbackBuffer = new QGLBuffer( QGLBuffer::PixelPackBuffer );
+			fReadbackBuffer->setUsagePattern( QGLBuffer::StreamRead );
+			if( fReadbackBuffer->create() )
+			{
+				fReadbackBuffer->bind();
+				fReadbackBuffer->allocate( fNumRows * fBufferWidth * 4 );
+				fReadbackBuffer->release();
+			}
+			else
+			{
+				delete fReadbackBuffer;
+				fReadbackBuffer = NULL;
+			}
+		}
 	}
 	else
 	{
 		fPixelBuffer->makeCurrent();
+
+		// Every brain has consumed its row by now.
+		unmapReadback();
 	}
 
 	glClearColor( 0, 0, 0, 1 );
@@ -147,8 +184,81 @@ void QtAgentPovRenderer::render( agent *a )
 		a->GetScene().Draw();
 	glPopMatrix();
 
-	// Copy pixel data into retina
-	a->GetRetina()->updateBuffer( viewport->x, viewport->y, viewport->width, viewport->height );
+	if( fBatchedReadback )
+	{
+		fRendered.push_back( a );
+	}
+	else
+	{
+		// Copy pixel data into retina
+		a->GetRetina()->updateBuffer( viewport->x, viewport->y, viewport->width, viewport->height );
+	}
+}
+
+//---------------------------------------------------------------------------
+// QtAgentPovRenderer::setBatchedReadback
+//---------------------------------------------------------------------------
+void QtAgentPovRenderer::setBatchedReadback( bool batched )
+{
+	assert( fPixelBuffer == NULL );
+
+	fBatchedReadback = batched;
+}
+
+//---------------------------------------------------------------------------
+// QtAgentPovRenderer::readRetinas
+//
+// One glReadPixels per row of viewports rather than one per agent. Into a
+// pixel pack buffer the reads don't stall, and the single map afterwards
+// waits on all of them at once.
+//---------------------------------------------------------------------------
+void QtAgentPovRenderer::readRetinas()
+{
+	if( fRendered.empty() )
+		return;
+
+	int rowBytes = fBufferWidth * 4;
+	short nrows = 0;
+	for( agent *a : fRendered )
+	{
+		Viewport *viewport = (Viewport *)AgentAttachedData::get( a, slotHandle );
+		nrows = std::max( nrows, short(viewport->row + 1) );
+	}
+
+	const unsigned char *pixels = NULL;
+
+	if( fReadbackBuffer )
+	{
+		fReadbackBuffer->bind();
+		for( short row = 0; row < nrows; row++ )
+		{
+			glReadPixels( 0, getRetinaY(row), fBufferWidth, 1,
+						  GL_RGBA, GL_UNSIGNED_BYTE,
+						  (GLvoid *)(size_t)(row * rowBytes) );
+		}
+		pixels = (const unsigned char *)fReadbackBuffer->map( QGLBuffer::ReadOnly );
+		fReadbackMapped = pixels != NULL;
+		fReadbackBuffer->release();
+	}
+
+	if( pixels == NULL )
+	{
+		fReadbackRows.resize( fNumRows * rowBytes );
+		for( short row = 0; row < nrows; row++ )
+		{
+			glReadPixels( 0, getRetinaY(row), fBufferWidth, 1,
+						  GL_RGBA, GL_UNSIGNED_BYTE,
+						  &fReadbackRows[row * rowBytes] );
+		}
+		pixels = &fReadbackRows[0];
+	}
+
+	for( agent *a : fRendered )
+	{
+		Viewport *viewport = (Viewport *)AgentAttachedData::get( a, slotHandle );
+		a->GetRetina()->setPixels( pixels + (viewport->row * rowBytes) + (viewport->x * 4) );
+	}
+	fRendered.clear();
 }
 
 //---------------------------------------------------------------------------
@@ -189,3 +299,30 @@ int QtAgentPovRenderer::getBufferHeight()
 {
 	return fBufferHeight;
 }
+
+//---------------------------------------------------------------------------
+// QtAgentPovRenderer::getRetinaY
+//
+// The row render() reads for the viewports in the given row: their middle.
+//---------------------------------------------------------------------------
+short QtAgentPovRenderer::getRetinaY( short row )
+{
+	short ytop = fBufferHeight  -  row * (fRetinaHeight + CELL_PAD) - CELL_PAD - 1;
+	short y = ytop  -  fRetinaHeight  +  1;
+
+	return y + fRetinaHeight / 2;
+}
+
+//---------------------------------------------------------------------------
+// QtAgentPovRenderer::unmapReadback
+//---------------------------------------------------------------------------
+void QtAgentPovRenderer::unmapReadback()
+{
+	if( fReadbackMapped )
+	{
+		fReadbackBuffer->bind();
+		fReadbackBuffer->unmap();
+		fReadbackBuffer->release();
+		fReadbackMapped = false;
+	}
+}
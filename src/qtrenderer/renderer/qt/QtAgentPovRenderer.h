@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <vector>
 
 #include "agent/AgentAttachedData.h"
 #include "agent/AgentPovRenderer.h"
@@ -21,6 +22,9 @@ class QtAgentPovRenderer : public AgentPovRenderer
 	virtual void render( class agent *a ) override;
 	virtual void endStep() override;
 
+	virtual void setBatchedReadback( bool batched ) override;
+	virtual void readRetinas() override;
+
 	void copyTo( class QGLWidget *dst );
 	int getBufferWidth();
 	int getBufferHeight();
@@ -29,14 +33,27 @@ class QtAgentPovRenderer : public AgentPovRenderer
 	struct Viewport
 	{
 		int index;
+		short row;
 		short x;
 		short y;
 		short width;
 		short height;
 	};
+	short getRetinaY( short row );
+	void unmapReadback();
+
 	class QGLPixelBuffer *fPixelBuffer;
 	int fBufferWidth;
 	int fBufferHeight;
+	int fNumRows;
+	int fRetinaHeight;
+	// Batched readback: the retina row of every viewport row goes to a pixel
+	// pack buffer, or to fReadbackRows if the GL can't do that.
+	bool fBatchedReadback;
+	class QGLBuffer *fReadbackBuffer;
+	bool fReadbackMapped;
+	std::vector<unsigned char> fReadbackRows;
+	std::vector<class agent *> fRendered;
 	// This gives us a reference to a per-agent opaque pointer.
 	AgentAttachedData::SlotHandle slotHandle;
 	Viewport *fViewports;
@@ -0,0 +1,157 @@
+// Measures write and read throughput of each AbstractFile backend on
+// synthetic brain function records ("%d %g" per neuron).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "utils/AbstractFile.h"
+#include "utils/PwMovieUtils.h"
+
+using namespace std;
+
+struct Backend
+{
+	const char *name;
+	AbstractFile::ConcreteFileType type;
+	AbstractFile::ConcreteFileType readType;
+	const char *ext;
+};
+
+static const Backend backends[] =
+{
+	{ "file", AbstractFile::TYPE_FILE, AbstractFile::TYPE_FILE, "" },
+	{ "gzip", AbstractFile::TYPE_GZIP_FILE, AbstractFile::TYPE_GZIP_FILE, ".gz" },
+	{ "pgzip", AbstractFile::TYPE_PARALLEL_GZIP_FILE, AbstractFile::TYPE_GZIP_FILE, ".gz" },
+	{ "zstd", AbstractFile::TYPE_ZSTD_FILE, AbstractFile::TYPE_ZSTD_FILE, ".zst" }
+};
+
+static void usage( const char *prog )
+{
+	fprintf( stderr, "usage: %s [-m megabytes] [-d dir] [backend...]\n", prog );
+	fprintf( stderr, "  backends: file gzip pgzip zstd (default: all)\n" );
+	exit( 1 );
+}
+
+static size_t fileSize( const char *path )
+{
+	struct stat st;
+	if( stat(path, &st) != 0 )
+		return 0;
+	return st.st_size;
+}
+
+// One step of records per string, generated up front so that the
+// timings measure the backend rather than formatting.
+static void makeRecords( vector<string> &records, int nsteps, int nneurons )
+{
+	char buf[64];
+	for( int step = 0; step < nsteps; step++ )
+	{
+		string record;
+		sprintf( buf, "%d %d\n", step, nneurons );
+		record += buf;
+		for( int i = 0; i < nneurons; i++ )
+		{
+			sprintf( buf, "%d %g\n", i, drand48() );
+			record += buf;
+		}
+		records.push_back( record );
+	}
+}
+
+static void bench( const Backend &backend, const vector<string> &records, const string &dir, size_t nbytes )
+{
+	string path = dir + "/afbench_" + backend.name;
+
+	// --- write
+	double start = hirestime();
+	size_t nwritten = 0;
+	{
+		AbstractFile *file = AbstractFile::open( backend.type, path.c_str(), "w" );
+		for( size_t i = 0; nwritten < nbytes; i++ )
+		{
+			const string &record = records[i % records.size()];
+			nwritten += file->write( record.c_str(), 1, record.size() );
+		}
+		delete file;
+	}
+	double writeTime = hirestime() - start;
+
+	// --- read
+	start = hirestime();
+	size_t nread = 0;
+	{
+		AbstractFile *file = AbstractFile::open( backend.readType, path.c_str(), "r" );
+		char buf[64 * 1024];
+		size_t n;
+		while( (n = file->read(buf, 1, sizeof(buf))) > 0 )
+		{
+			nread += n;
+		}
+		delete file;
+	}
+	double readTime = hirestime() - start;
+
+	string diskPath = path + backend.ext;
+	size_t compressed = fileSize( diskPath.c_str() );
+
+	printf( "%-6s write %8.1f MB/s   read %8.1f MB/s   ratio %5.2f%s\n",
+			backend.name,
+			nwritten / writeTime / (1024 * 1024),
+			nread / readTime / (1024 * 1024),
+			compressed ? double(nwritten) / compressed : 0.0,
+			nread == nwritten ? "" : "   READ MISMATCH" );
+
+	unlink( diskPath.c_str() );
+}
+
+int main( int argc, char **argv )
+{
+	size_t megabytes = 64;
+	string dir = ".";
+
+	int opt;
+	while( (opt = getopt(argc, argv, "m:d:h")) != -1 )
+	{
+		switch( opt )
+		{
+		case 'm':
+			megabytes = atoi( optarg );
+			break;
+		case 'd':
+			dir = optarg;
+			break;
+		default:
+			usage( argv[0] );
+		}
+	}
+
+	srand48( 1 );
+
+	vector<string> records;
+	makeRecords( records, 1000, 36 );
+
+	size_t nbackends = sizeof(backends) / sizeof(backends[0]);
+	for( size_t i = 0; i < nbackends; i++ )
+	{
+		bool selected = optind == argc;
+		for( int j = optind; j < argc; j++ )
+		{
+			if( 0 == strcmp(argv[j], backends[i].name) )
+				selected = true;
+		}
+
+		if( selected )
+		{
+			bench( backends[i], records, dir, megabytes * 1024 * 1024 );
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,137 @@
+#include "Bench.h"
+
+#include <assert.h>
+
+#include "utils/PwMovieUtils.h"
+
+using namespace std;
+
+namespace bench
+{
+	extern string tmpDir;
+	extern string runDirPath;
+
+	//---------------------------------------------------------------------------
+	// State::State
+	//---------------------------------------------------------------------------
+	State::State( long iterations, long arg )
+	: _iterations( iterations )
+	, _remaining( iterations )
+	, _arg( arg )
+	, _started( false )
+	, _start( 0 )
+	, _elapsed( 0 )
+	, _items( 0 )
+	, _bytes( 0 )
+	{
+	}
+
+	//---------------------------------------------------------------------------
+	// State::keepRunning
+	//---------------------------------------------------------------------------
+	bool State::keepRunning()
+	{
+		if( !_started )
+		{
+			_started = true;
+			_start = hirestime();
+		}
+
+		if( _remaining-- > 0 )
+			return true;
+
+		_elapsed += hirestime() - _start;
+		return false;
+	}
+
+	//---------------------------------------------------------------------------
+	// State::pauseTiming
+	//---------------------------------------------------------------------------
+	void State::pauseTiming()
+	{
+		_elapsed += hirestime() - _start;
+	}
+
+	//---------------------------------------------------------------------------
+	// State::resumeTiming
+	//---------------------------------------------------------------------------
+	void State::resumeTiming()
+	{
+		_start = hirestime();
+	}
+
+	//---------------------------------------------------------------------------
+	// Benchmark::Benchmark
+	//---------------------------------------------------------------------------
+	Benchmark::Benchmark( const char *name_, Function function_ )
+	: name( name_ )
+	, function( function_ )
+	, _needsRun( false )
+	{
+	}
+
+	//---------------------------------------------------------------------------
+	// Benchmark::arg
+	//---------------------------------------------------------------------------
+	Benchmark *Benchmark::arg( long value )
+	{
+		args.push_back( value );
+		return this;
+	}
+
+	//---------------------------------------------------------------------------
+	// Benchmark::needsRun
+	//---------------------------------------------------------------------------
+	Benchmark *Benchmark::needsRun()
+	{
+		_needsRun = true;
+		return this;
+	}
+
+	//---------------------------------------------------------------------------
+	// registry
+	//
+	// Function-static so registration from other translation units doesn't
+	// depend on static initialization order.
+	//---------------------------------------------------------------------------
+	static vector<Benchmark *> &registry()
+	{
+		static vector<Benchmark *> benchmarks;
+		return benchmarks;
+	}
+
+	//---------------------------------------------------------------------------
+	// registerBenchmark
+	//---------------------------------------------------------------------------
+	Benchmark *registerBenchmark( const char *name, Function function )
+	{
+		Benchmark *benchmark = new Benchmark( name, function );
+		registry().push_back( benchmark );
+		return benchmark;
+	}
+
+	//---------------------------------------------------------------------------
+	// getBenchmarks
+	//---------------------------------------------------------------------------
+	const vector<Benchmark *> &getBenchmarks()
+	{
+		return registry();
+	}
+
+	//---------------------------------------------------------------------------
+	// tmpPath
+	//---------------------------------------------------------------------------
+	string tmpPath( const string &name )
+	{
+		assert( !tmpDir.empty() );
+		return tmpDir + "/" + name;
+	}
+
+	//---------------------------------------------------------------------------
+	// runDir
+	//---------------------------------------------------------------------------
+	const string &runDir()
+	{
+		return runDirPath;
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+//===========================================================================
+// Microbenchmark harness
+//
+// Modeled on Google Benchmark, so kernels read the same way:
+//
+//   static void FiringRateModel_update( bench::State &state )
+//   {
+//       ...setup...
+//       while( state.keepRunning() )
+//           model->update( false );
+//   }
+//   BENCHMARK( FiringRateModel_update )->arg( 50 )->arg( 200 );
+//
+// Only the keepRunning() loop is timed. The runner calls the function with
+// growing iteration counts until one run lasts long enough to trust, then
+// repeats that count and keeps the per-iteration statistics.
+//===========================================================================
+namespace bench
+{
+	// ===
+	// === State
+	// ===
+	class State
+	{
+	 public:
+		State( long iterations, long arg );
+
+		bool keepRunning();
+
+		// Excludes work inside the loop from the timing.
+		void pauseTiming();
+		void resumeTiming();
+
+		long arg() const { return _arg; }
+		long iterations() const { return _iterations; }
+
+		// Rates reported alongside the time, per iteration.
+		void setItemsProcessed( double items ) { _items = items; }
+		void setBytesProcessed( double bytes ) { _bytes = bytes; }
+
+		double getElapsed() const { return _elapsed; }
+		double getItems() const { return _items; }
+		double getBytes() const { return _bytes; }
+
+	 private:
+		long _iterations;
+		long _remaining;
+		long _arg;
+		bool _started;
+		double _start;
+		double _elapsed;
+		double _items;
+		double _bytes;
+	};
+
+	typedef void (*Function)( State &state );
+
+	// ===
+	// === Benchmark
+	// ===
+	class Benchmark
+	{
+	 public:
+		Benchmark( const char *name, Function function );
+
+		Benchmark *arg( long value );
+		// Replays a recorded run, so is skipped unless one is given with -p.
+		Benchmark *needsRun();
+
+		const std::string &getName() const { return name; }
+		Function getFunction() const { return function; }
+		const std::vector<long> &getArgs() const { return args; }
+		bool getNeedsRun() const { return _needsRun; }
+
+	 private:
+		std::string name;
+		Function function;
+		std::vector<long> args;
+		bool _needsRun;
+	};
+
+	Benchmark *registerBenchmark( const char *name, Function function );
+	const std::vector<Benchmark *> &getBenchmarks();
+
+	// A path in the scratch directory made by the runner.
+	std::string tmpPath( const std::string &name );
+	// The run directory given with -p, empty if none.
+	const std::string &runDir();
+
+	// Keeps the compiler from discarding a result.
+	template<typename T>
+	inline void doNotOptimize( const T &value )
+	{
+		asm volatile( "" : : "g"(&value) : "memory" );
+	}
+}
+
+#define BENCHMARK_CONCAT2( a, b ) a##b
+#define BENCHMARK_CONCAT( a, b ) BENCHMARK_CONCAT2( a, b )
+
+#define BENCHMARK( FUNC )												\
+	static bench::Benchmark *BENCHMARK_CONCAT( __bench_, __LINE__ ) __attribute__((unused)) = \
+		bench::registerBenchmark( #FUNC, FUNC )
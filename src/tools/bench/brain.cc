@@ -0,0 +1,189 @@
+// Neuron model updates on synthetic networks of a given size. The networks
+// are wired at random rather than grown from a genome, so the size is
+// exact and the same on every run. Also the retina's pooling of a row of
+// pixels into its vision neurons.
+
+#include <stdlib.h>
+
+#include <vector>
+
+#include "Bench.h"
+#include "agent/Retina.h"
+#include "brain/Brain.h"
+#include "brain/FiringRateModel.h"
+#include "brain/NervousSystem.h"
+#include "brain/SpikingModel.h"
+
+using namespace std;
+
+#define NumOutputNeurons 7
+
+// ================================================================================
+// ===
+// === CLASS BenchNervousSystem
+// ===
+// === A nervous system with no nerves and an empty brain, which is all the
+// === neuron models reach for.
+// ===
+// ================================================================================
+class BenchNervousSystem : public NervousSystem
+{
+ public:
+	BenchNervousSystem() { b = new Brain( this ); }
+};
+
+//---------------------------------------------------------------------------
+// setDimensions
+//
+// A quarter of the neurons are inputs, and every other neuron gets synapses
+// from a quarter of all neurons.
+//---------------------------------------------------------------------------
+static void setDimensions( NeuronModel::Dimensions &dims, int numNeurons )
+{
+	dims.numNeurons = numNeurons;
+	dims.numInputNeurons = numNeurons / 4;
+	dims.numOutputNeurons = NumOutputNeurons;
+	dims.numSynapses = (long)dims.getNumNonInputNeurons() * (numNeurons / 4);
+}
+
+//---------------------------------------------------------------------------
+// wire
+//
+// attrs() fills in the attributes of a neuron.
+//---------------------------------------------------------------------------
+template<typename NeuronAttrs>
+static void wire( NeuronModel *model,
+				  NeuronModel::Dimensions &dims,
+				  void (*attrs)(NeuronAttrs &) )
+{
+	NeuronAttrs neuronAttrs;
+	int fanIn = dims.numSynapses / dims.getNumNonInputNeurons();
+	long k = 0;
+
+	for( int i = 0; i < dims.numNeurons; i++ )
+	{
+		attrs( neuronAttrs );
+
+		if( i < dims.getFirstOutputNeuron() )
+		{
+			model->set_neuron( i, &neuronAttrs );
+			continue;
+		}
+
+		model->set_neuron( i, &neuronAttrs, k, k + fanIn );
+		for( int j = 0; j < fanIn; j++, k++ )
+		{
+			float efficacy = (drand48() * 2.0 - 1.0) * Brain::config.initMaxWeight;
+			float lrate = Brain::config.minlrate + drand48() * (Brain::config.maxlrate - Brain::config.minlrate);
+			model->set_synapse( k, lrand48() % dims.numNeurons, i, efficacy, lrate );
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+// runModel
+//---------------------------------------------------------------------------
+static void runModel( bench::State &state, NeuronModel *model, NeuronModel::Dimensions &dims )
+{
+	vector<double> inputs( dims.numInputNeurons );
+	for( size_t i = 0; i < inputs.size(); i++ )
+		inputs[i] = drand48();
+
+	while( state.keepRunning() )
+	{
+		model->setActivations( &inputs[0], 0, dims.numInputNeurons );
+		model->update( false );
+	}
+
+	state.setItemsProcessed( dims.numSynapses );
+}
+
+//---------------------------------------------------------------------------
+// FiringRateModel_update
+//---------------------------------------------------------------------------
+static void firingRateAttrs( FiringRateModel__NeuronAttrs &attrs )
+{
+	attrs.bias = (drand48() * 2.0 - 1.0) * Brain::config.maxbias;
+	attrs.tau = Brain::config.Tau.seedVal;
+	attrs.gain = Brain::config.Gain.seedVal;
+}
+
+static void FiringRateModel_update( bench::State &state )
+{
+	BenchNervousSystem cns;
+	NeuronModel::Dimensions dims;
+	setDimensions( dims, state.arg() );
+
+	FiringRateModel model( &cns );
+	model.init( &dims, 0.1 );
+	wire( &model, dims, firingRateAttrs );
+
+	runModel( state, &model, dims );
+}
+BENCHMARK( FiringRateModel_update )->arg( 32 )->arg( 128 )->arg( 512 );
+
+//---------------------------------------------------------------------------
+// SpikingModel_update
+//---------------------------------------------------------------------------
+static void spikingAttrs( SpikingModel__NeuronAttrs &attrs )
+{
+	// Izhikevich regular spiking
+	attrs.bias = (drand48() * 2.0 - 1.0) * Brain::config.maxbias;
+	attrs.SpikingParameter_a = 0.02;
+	attrs.SpikingParameter_b = 0.2;
+	attrs.SpikingParameter_c = -65.0;
+	attrs.SpikingParameter_d = 8.0;
+}
+
+static void SpikingModel_update( bench::State &state )
+{
+	BenchNervousSystem cns;
+	NeuronModel::Dimensions dims;
+	setDimensions( dims, state.arg() );
+
+	SpikingModel model( &cns, 0.5 );
+	model.init( &dims, 0.1 );
+	wire( &model, dims, spikingAttrs );
+
+	runModel( state, &model, dims );
+}
+BENCHMARK( SpikingModel_update )->arg( 32 )->arg( 128 )->arg( 512 );
+
+//---------------------------------------------------------------------------
+// Retina_update
+//
+// The arg is the number of neurons per color, on a retina of the
+// worldfile's width.
+//---------------------------------------------------------------------------
+static void Retina_update( bench::State &state )
+{
+	static const char *colors[] = { "Red", "Green", "Blue" };
+	int numneurons = state.arg();
+	int width = Brain::config.retinaWidth;
+
+	BenchNervousSystem cns;
+	vector<double> activations( 3 * numneurons );
+	double *activationsPtr = &activations[0];
+	for( int i = 0; i < 3; i++ )
+	{
+		Nerve *nerve = cns.createNerve( Nerve::INPUT, colors[i] );
+		nerve->config( numneurons, i * numneurons );
+		nerve->config( &activationsPtr, &activationsPtr );
+	}
+
+	Retina retina( width );
+	retina.sensor_grow( &cns );
+
+	vector<unsigned char> pixels( width * 4 );
+	for( size_t i = 0; i < pixels.size(); i++ )
+		pixels[i] = lrand48() % 256;
+
+	while( state.keepRunning() )
+	{
+		retina.setPixels( &pixels[0] );
+		retina.sensor_update( false );
+	}
+
+	state.setItemsProcessed( 3 * numneurons );
+}
+BENCHMARK( Retina_update )->arg( 4 )->arg( 7 )->arg( 16 );
@@ -0,0 +1,71 @@
+// Neural complexity kernels on synthetic activity, arg neurons by
+// NumTimesteps samples.
+
+#include <stdlib.h>
+
+#include "Bench.h"
+#include "complexity/complexity_algorithm.h"
+
+#define NumTimesteps 500
+
+//---------------------------------------------------------------------------
+// createActivity
+//
+// Random activity, with each neuron partly following its predecessor so the
+// covariance isn't diagonal.
+//---------------------------------------------------------------------------
+static gsl_matrix *createActivity( int numNeurons )
+{
+	gsl_matrix *data = gsl_matrix_alloc( NumTimesteps, numNeurons );
+
+	for( int t = 0; t < NumTimesteps; t++ )
+	{
+		double prev = drand48();
+		for( int i = 0; i < numNeurons; i++ )
+		{
+			prev = 0.5 * prev + 0.5 * drand48();
+			gsl_matrix_set( data, t, i, prev );
+		}
+	}
+
+	return data;
+}
+
+//---------------------------------------------------------------------------
+// Complexity_calcCOV
+//---------------------------------------------------------------------------
+static void Complexity_calcCOV( bench::State &state )
+{
+	gsl_matrix *data = createActivity( state.arg() );
+
+	while( state.keepRunning() )
+	{
+		gsl_matrix *COV = calcCOV( data );
+		gsl_matrix_free( COV );
+	}
+
+	gsl_matrix_free( data );
+}
+BENCHMARK( Complexity_calcCOV )->arg( 16 )->arg( 64 )->arg( 256 );
+
+//---------------------------------------------------------------------------
+// Complexity_calcC_k
+//
+// At k = n/2, where the most subsets are sampled.
+//---------------------------------------------------------------------------
+static void Complexity_calcC_k( bench::State &state )
+{
+	gsl_matrix *data = createActivity( state.arg() );
+	gsl_matrix *COV = calcCOV( data );
+	double I_n = CalcI( COV, determinant(COV) );
+
+	while( state.keepRunning() )
+	{
+		double C_k = calcC_k( COV, I_n, state.arg() / 2 );
+		bench::doNotOptimize( C_k );
+	}
+
+	gsl_matrix_free( COV );
+	gsl_matrix_free( data );
+}
+BENCHMARK( Complexity_calcC_k )->arg( 16 )->arg( 64 )->arg( 256 );
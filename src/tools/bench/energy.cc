@@ -0,0 +1,44 @@
+// Energy arithmetic, as an agent's body and eating use it each step.
+
+#include "Bench.h"
+#include "environment/Energy.h"
+#include "sim/globals.h"
+
+//---------------------------------------------------------------------------
+// Energy_update
+//
+// Arg is the number of energy types.
+//---------------------------------------------------------------------------
+static void Energy_update( bench::State &state )
+{
+	int numEnergyTypes = globals::numEnergyTypes;
+	globals::numEnergyTypes = state.arg();
+
+	Energy energy( 100.0f );
+	Energy foodEnergy( 100.0f );
+	Energy maxEnergy( 200.0f );
+	Energy eat( 0.5f );
+	float denergy = 0.25f;
+
+	while( state.keepRunning() )
+	{
+		// agent::eat()
+		Energy actuallyEat = eat;
+		actuallyEat.constrain( energy * -1, maxEnergy - energy );
+		energy += actuallyEat;
+		foodEnergy += actuallyEat;
+		foodEnergy.constrain( 0, maxEnergy );
+
+		// agent::UpdateBody()
+		energy -= denergy;
+		foodEnergy -= denergy;
+		bool depleted = energy.isDepleted();
+		bench::doNotOptimize( depleted );
+	}
+
+	bench::doNotOptimize( energy );
+	bench::doNotOptimize( foodEnergy );
+
+	globals::numEnergyTypes = numEnergyTypes;
+}
+BENCHMARK( Energy_update )->arg( 1 )->arg( 2 )->arg( 4 );
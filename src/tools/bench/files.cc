@@ -0,0 +1,191 @@
+// Writing run data: datalib rows, gzip'd AbstractFiles, and movie frames.
+// Files go to the runner's scratch directory and are removed afterwards.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "utils/AbstractFile.h"
+#include "utils/datalib.h"
+#include "utils/PwMovieUtils.h"
+
+using namespace std;
+
+#define NumRecords 1000
+#define NeuronsPerRecord 36
+
+static const char *colnames[] = { "Timestep", "Agent", "x", "z", NULL };
+
+//---------------------------------------------------------------------------
+// DataLibWriter_addRow
+//---------------------------------------------------------------------------
+static void DataLibWriter_addRow( bench::State &state )
+{
+	string path = bench::tmpPath( "datalib.txt" );
+	const datalib::Type coltypes[] = { datalib::INT, datalib::INT, datalib::FLOAT, datalib::FLOAT };
+
+	DataLibWriter *writer = new DataLibWriter( path.c_str(), true, false );
+	writer->beginTable( "Positions", colnames, coltypes );
+
+	int step = 0;
+	while( state.keepRunning() )
+	{
+		step++;
+		writer->addRow( step, step % 200, step * 0.25f, step * -0.5f );
+	}
+
+	writer->endTable();
+	delete writer;
+	unlink( path.c_str() );
+}
+BENCHMARK( DataLibWriter_addRow );
+
+//---------------------------------------------------------------------------
+// DataLibWriter_addTypedRow
+//---------------------------------------------------------------------------
+static void DataLibWriter_addTypedRow( bench::State &state )
+{
+	string path = bench::tmpPath( "datalib.txt" );
+
+	DataLibWriter *writer = new DataLibWriter( path.c_str(), true, false );
+	datalib::TypedTable<int, int, float, float> table =
+		writer->beginTypedTable<int, int, float, float>( "Positions", colnames );
+
+	int step = 0;
+	while( state.keepRunning() )
+	{
+		step++;
+		table.addRow( step, step % 200, step * 0.25f, step * -0.5f );
+	}
+
+	writer->endTable();
+	delete writer;
+	unlink( path.c_str() );
+}
+BENCHMARK( DataLibWriter_addTypedRow );
+
+//---------------------------------------------------------------------------
+// AbstractFile_gzip_printf
+//
+// One brain function record per iteration, formatted a neuron at a time.
+//---------------------------------------------------------------------------
+static void AbstractFile_gzip_printf( bench::State &state )
+{
+	string path = bench::tmpPath( "printf" );
+
+	vector<double> activations( NumRecords * NeuronsPerRecord );
+	for( size_t i = 0; i < activations.size(); i++ )
+		activations[i] = drand48();
+
+	AbstractFile *file = AbstractFile::open( AbstractFile::TYPE_GZIP_FILE, path.c_str(), "w" );
+
+	int step = 0;
+	while( state.keepRunning() )
+	{
+		const double *record = &activations[ (step % NumRecords) * NeuronsPerRecord ];
+		file->printf( "%d %d\n", step++, NeuronsPerRecord );
+		for( int i = 0; i < NeuronsPerRecord; i++ )
+			file->printf( "%d %g\n", i, record[i] );
+	}
+
+	delete file;
+	AbstractFile::unlink( path.c_str() );
+
+	state.setItemsProcessed( NeuronsPerRecord );
+}
+BENCHMARK( AbstractFile_gzip_printf );
+
+//---------------------------------------------------------------------------
+// AbstractFile_gzip_write
+//
+// Preformatted records, arg bytes per write.
+//---------------------------------------------------------------------------
+static void AbstractFile_gzip_write( bench::State &state )
+{
+	string path = bench::tmpPath( "write" );
+
+	string records;
+	char buf[64];
+	while( records.size() < (size_t)state.arg() * 4 )
+	{
+		sprintf( buf, "%d %g\n", (int)(records.size() % NeuronsPerRecord), drand48() );
+		records += buf;
+	}
+
+	AbstractFile *file = AbstractFile::open( AbstractFile::TYPE_GZIP_FILE, path.c_str(), "w" );
+
+	size_t offset = 0;
+	while( state.keepRunning() )
+	{
+		file->write( records.c_str() + offset, 1, state.arg() );
+		offset = (offset + state.arg()) % (records.size() - state.arg());
+	}
+
+	delete file;
+	AbstractFile::unlink( path.c_str() );
+
+	state.setBytesProcessed( state.arg() );
+}
+BENCHMARK( AbstractFile_gzip_write )->arg( 4096 )->arg( 65536 );
+
+//---------------------------------------------------------------------------
+// PwMovieWriter_writeFrame
+//
+// Square frames of side arg, alternating between two frames that differ
+// where objects moved, so most frames are run-length diffs.
+//---------------------------------------------------------------------------
+static void drawFrame( vector<uint32_t> &frame, int side, int shift )
+{
+	frame.assign( side * side, 0x00202020 );
+
+	// same objects in both frames, without disturbing drand48()
+	unsigned short seed[3] = { 2, 0, 0 };
+	for( int i = 0; i < side / 4; i++ )
+	{
+		int x0 = nrand48( seed ) % side;
+		int y0 = nrand48( seed ) % side;
+		uint32_t color = nrand48( seed ) & 0x00ffffff;
+
+		// every other object moves between the frames
+		if( i % 2 )
+			x0 = (x0 + shift) % side;
+
+		for( int y = y0; y < min(side, y0 + 6); y++ )
+			for( int x = x0; x < min(side, x0 + 6); x++ )
+				frame[ y * side + x ] = color;
+	}
+}
+
+static void PwMovieWriter_writeFrame( bench::State &state )
+{
+	string path = bench::tmpPath( "movie.pmv" );
+	int side = state.arg();
+
+	vector<uint32_t> frames[2];
+	drawFrame( frames[0], side, 0 );
+	drawFrame( frames[1], side, 2 );
+
+	FILE *file = fopen( path.c_str(), "w" );
+	PwMovieWriter *writer = new PwMovieWriter( file );
+
+	uint32_t timestep = 0;
+	while( state.keepRunning() )
+	{
+		timestep++;
+		writer->writeFrame( timestep, side, side,
+							&frames[(timestep + 1) % 2][0],
+							&frames[timestep % 2][0] );
+	}
+
+	delete writer;	// closes file
+	unlink( path.c_str() );
+
+	state.setBytesProcessed( side * side * sizeof(uint32_t) );
+}
+BENCHMARK( PwMovieWriter_writeFrame )->arg( 256 )->arg( 512 );
@@ -0,0 +1,67 @@
+// Genome operations on random genomes of the worldfile's schema.
+
+#include "Bench.h"
+#include "genome/Genome.h"
+#include "genome/GenomeSchema.h"
+#include "genome/GenomeUtil.h"
+
+using namespace genome;
+
+//---------------------------------------------------------------------------
+// Genome_crossover
+//
+// With mutation, as for a birth.
+//---------------------------------------------------------------------------
+static void Genome_crossover( bench::State &state )
+{
+	Genome *g1 = GenomeUtil::createGenome( true );
+	Genome *g2 = GenomeUtil::createGenome( true );
+	Genome *child = GenomeUtil::createGenome();
+
+	while( state.keepRunning() )
+		child->crossover( g1, g2, true );
+
+	state.setBytesProcessed( GenomeUtil::schema->getMutableSize() );
+
+	delete child;
+	delete g2;
+	delete g1;
+}
+BENCHMARK( Genome_crossover );
+
+//---------------------------------------------------------------------------
+// Genome_mutateBits
+//---------------------------------------------------------------------------
+static void Genome_mutateBits( bench::State &state )
+{
+	Genome *g = GenomeUtil::createGenome( true );
+
+	while( state.keepRunning() )
+		g->mutateBits();
+
+	state.setBytesProcessed( GenomeUtil::schema->getMutableSize() );
+
+	delete g;
+}
+BENCHMARK( Genome_mutateBits );
+
+//---------------------------------------------------------------------------
+// Genome_separation
+//---------------------------------------------------------------------------
+static void Genome_separation( bench::State &state )
+{
+	Genome *g1 = GenomeUtil::createGenome( true );
+	Genome *g2 = GenomeUtil::createGenome( true );
+
+	while( state.keepRunning() )
+	{
+		float separation = g1->separation( g2 );
+		bench::doNotOptimize( separation );
+	}
+
+	state.setBytesProcessed( GenomeUtil::schema->getMutableSize() );
+
+	delete g2;
+	delete g1;
+}
+BENCHMARK( Genome_separation );
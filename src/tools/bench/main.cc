@@ -0,0 +1,321 @@
+// Runs the microbenchmarks of the simulation's hot paths and optionally
+// writes the results as JSON, for comparison with scripts/benchcompare.
+//
+// Must be run from the Polyworld home directory, since the brain and genome
+// configuration comes from a worldfile.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "agent/agent.h"
+#include "brain/Brain.h"
+#include "genome/GenomeSchema.h"
+#include "genome/GenomeUtil.h"
+#include "proplib/builder.h"
+#include "proplib/dom.h"
+#include "proplib/interpreter.h"
+#include "proplib/schema.h"
+
+using namespace std;
+using namespace bench;
+
+#define MaxIterations 1000000000L
+
+namespace bench
+{
+	string tmpDir;
+	string runDirPath;
+}
+
+struct Result
+{
+	string name;
+	long iterations;
+	vector<double> times;	// seconds per iteration, one per repetition
+	double itemsPerSecond;
+	double bytesPerSecond;
+};
+
+static void usage( const char *prog )
+{
+	fprintf( stderr, "usage: %s [-w worldfile] [-t seconds] [-r repetitions] [-o results.json] [-p rundir] [-l] [filter...]\n", prog );
+	fprintf( stderr, "  -w  worldfile with the brain and genome configuration (default: worldfiles/hello.wf)\n" );
+	fprintf( stderr, "  -t  minimum duration of a timed run (default: 0.5)\n" );
+	fprintf( stderr, "  -r  timed runs per benchmark (default: 5)\n" );
+	fprintf( stderr, "  -o  write results as JSON\n" );
+	fprintf( stderr, "  -p  run recorded with RecordPosition, for the benchmarks that replay one\n" );
+	fprintf( stderr, "  -l  list benchmarks and exit\n" );
+	fprintf( stderr, "  filter: run benchmarks whose name contains any of these\n" );
+	exit( 1 );
+}
+
+// Same configuration steps as analysis::initialize(), from a worldfile
+// instead of a run directory.
+static void initWorldfile( const string &path )
+{
+	proplib::Interpreter::init();
+	proplib::DocumentBuilder builder;
+	proplib::SchemaDocument *schema = builder.buildSchemaDocument( "etc/worldfile.wfs" );
+	schema->lenient = true;
+	proplib::Document *worldfile = builder.buildWorldfileDocument( schema, path );
+	schema->apply( worldfile );
+
+	agent::processWorldfile( *worldfile );
+	genome::GenomeSchema::processWorldfile( *worldfile );
+	Brain::processWorldfile( *worldfile );
+
+	proplib::Interpreter::dispose();
+	delete worldfile;
+	delete schema;
+
+	Brain::init();
+	genome::GenomeUtil::createSchema();
+}
+
+static string getName( Benchmark *benchmark, long arg, bool hasArg )
+{
+	char buf[32];
+	string name = benchmark->getName();
+	if( hasArg )
+	{
+		sprintf( buf, "/%ld", arg );
+		name += buf;
+	}
+	return name;
+}
+
+static bool isSelected( const string &name, const vector<string> &filters )
+{
+	if( filters.empty() )
+		return true;
+	for( size_t i = 0; i < filters.size(); i++ )
+	{
+		if( name.find(filters[i]) != string::npos )
+			return true;
+	}
+	return false;
+}
+
+// Grows the iteration count until a run lasts minTime, then repeats runs of
+// that length.
+static Result run( Benchmark *benchmark, long arg, const string &name, double minTime, int repetitions )
+{
+	Result result;
+	result.name = name;
+
+	long iterations = 1;
+	for( ;; )
+	{
+		State state( iterations, arg );
+		benchmark->getFunction()( state );
+
+		double elapsed = state.getElapsed();
+		if( (elapsed >= minTime) || (iterations >= MaxIterations) )
+			break;
+
+		double multiplier = elapsed > 0 ? 1.4 * minTime / elapsed : 10.0;
+		multiplier = max( 2.0, min(10.0, multiplier) );
+		iterations = min( MaxIterations, (long)ceil(iterations * multiplier) );
+	}
+
+	result.iterations = iterations;
+	result.itemsPerSecond = 0;
+	result.bytesPerSecond = 0;
+
+	for( int i = 0; i < repetitions; i++ )
+	{
+		State state( iterations, arg );
+		benchmark->getFunction()( state );
+
+		double elapsed = state.getElapsed();
+		result.times.push_back( elapsed / iterations );
+		if( elapsed > 0 )
+		{
+			result.itemsPerSecond += state.getItems() * iterations / elapsed / repetitions;
+			result.bytesPerSecond += state.getBytes() * iterations / elapsed / repetitions;
+		}
+	}
+
+	return result;
+}
+
+static double median( vector<double> values )
+{
+	sort( values.begin(), values.end() );
+	size_t n = values.size();
+	return (n % 2) ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+static void printResult( const Result &result )
+{
+	printf( "%-40s %12.1f ns %12.1f ns %10ld",
+			result.name.c_str(),
+			median(result.times) * 1e9,
+			*min_element(result.times.begin(), result.times.end()) * 1e9,
+			result.iterations );
+	if( result.itemsPerSecond > 0 )
+		printf( "  %10.3g items/s", result.itemsPerSecond );
+	if( result.bytesPerSecond > 0 )
+		printf( "  %8.1f MB/s", result.bytesPerSecond / (1024 * 1024) );
+	printf( "\n" );
+	fflush( stdout );
+}
+
+static bool writeJson( const string &path, const vector<Result> &results, const string &worldfile, int repetitions )
+{
+	FILE *f = fopen( path.c_str(), "w" );
+	if( f == NULL )
+	{
+		perror( path.c_str() );
+		return false;
+	}
+
+	char host[256] = "";
+	gethostname( host, sizeof(host) - 1 );
+
+	char date[64];
+	time_t now = time( NULL );
+	strftime( date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now) );
+
+	fprintf( f, "{\n" );
+	fprintf( f, "  \"context\": {\n" );
+	fprintf( f, "    \"date\": \"%s\",\n", date );
+	fprintf( f, "    \"host_name\": \"%s\",\n", host );
+	fprintf( f, "    \"num_cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN) );
+	fprintf( f, "    \"worldfile\": \"%s\",\n", worldfile.c_str() );
+	fprintf( f, "    \"repetitions\": %d\n", repetitions );
+	fprintf( f, "  },\n" );
+	fprintf( f, "  \"benchmarks\": [" );
+
+	for( size_t i = 0; i < results.size(); i++ )
+	{
+		const Result &result = results[i];
+
+		fprintf( f, "%s\n    {\n", i ? "," : "" );
+		fprintf( f, "      \"name\": \"%s\",\n", result.name.c_str() );
+		fprintf( f, "      \"iterations\": %ld,\n", result.iterations );
+		fprintf( f, "      \"real_time\": %.6g,\n", median(result.times) * 1e9 );
+		fprintf( f, "      \"min_time\": %.6g,\n", *min_element(result.times.begin(), result.times.end()) * 1e9 );
+		fprintf( f, "      \"max_time\": %.6g,\n", *max_element(result.times.begin(), result.times.end()) * 1e9 );
+		fprintf( f, "      \"items_per_second\": %.6g,\n", result.itemsPerSecond );
+		fprintf( f, "      \"bytes_per_second\": %.6g,\n", result.bytesPerSecond );
+		fprintf( f, "      \"time_unit\": \"ns\"\n" );
+		fprintf( f, "    }" );
+	}
+
+	fprintf( f, "\n  ]\n}\n" );
+
+	return fclose( f ) == 0;
+}
+
+int main( int argc, char **argv )
+{
+	string worldfile = "worldfiles/hello.wf";
+	double minTime = 0.5;
+	int repetitions = 5;
+	string jsonPath;
+	bool list = false;
+
+	int opt;
+	while( (opt = getopt(argc, argv, "w:t:r:o:p:lh")) != -1 )
+	{
+		switch( opt )
+		{
+		case 'w':
+			worldfile = optarg;
+			break;
+		case 't':
+			minTime = atof( optarg );
+			break;
+		case 'r':
+			repetitions = max( 1, atoi(optarg) );
+			break;
+		case 'o':
+			jsonPath = optarg;
+			break;
+		case 'p':
+			runDirPath = optarg;
+			break;
+		case 'l':
+			list = true;
+			break;
+		default:
+			usage( argv[0] );
+		}
+	}
+
+	vector<string> filters( argv + optind, argv + argc );
+	const vector<Benchmark *> &benchmarks = getBenchmarks();
+
+	if( list )
+	{
+		for( size_t i = 0; i < benchmarks.size(); i++ )
+		{
+			const vector<long> &args = benchmarks[i]->getArgs();
+			if( args.empty() )
+				printf( "%s\n", getName(benchmarks[i], 0, false).c_str() );
+			for( size_t j = 0; j < args.size(); j++ )
+				printf( "%s\n", getName(benchmarks[i], args[j], true).c_str() );
+		}
+		return 0;
+	}
+
+	if( access(worldfile.c_str(), R_OK) != 0 )
+	{
+		fprintf( stderr, "Cannot read worldfile %s; run from the Polyworld home directory or use -w.\n", worldfile.c_str() );
+		return 1;
+	}
+	initWorldfile( worldfile );
+
+	char tmpTemplate[] = "/tmp/pwbench.XXXXXX";
+	if( mkdtemp(tmpTemplate) == NULL )
+	{
+		perror( "mkdtemp" );
+		return 1;
+	}
+	tmpDir = tmpTemplate;
+
+	// the same inputs on every run, so results are comparable
+	srand48( 1 );
+	srand( 1 );
+
+	printf( "%-40s %15s %15s %10s\n", "benchmark", "median", "min", "iterations" );
+
+	vector<Result> results;
+	for( size_t i = 0; i < benchmarks.size(); i++ )
+	{
+		if( benchmarks[i]->getNeedsRun() && runDirPath.empty() )
+			continue;
+
+		vector<long> args = benchmarks[i]->getArgs();
+		bool hasArg = !args.empty();
+		if( !hasArg )
+			args.push_back( 0 );
+
+		for( size_t j = 0; j < args.size(); j++ )
+		{
+			string name = getName( benchmarks[i], args[j], hasArg );
+			if( !isSelected(name, filters) )
+				continue;
+
+			results.push_back( run(benchmarks[i], args[j], name, minTime, repetitions) );
+			printResult( results.back() );
+		}
+	}
+
+	rmdir( tmpDir.c_str() );
+
+	if( !jsonPath.empty() && !writeJson(jsonPath, results, worldfile, repetitions) )
+		return 1;
+
+	return 0;
+}
@@ -0,0 +1,435 @@
+// The x-sorted object list on synthetic populations: the per-step re-sort
+// after everything has moved a little, and the neighbor sweep Interact does
+// over the sorted list. The arg is the number of objects, half agents and
+// half food, at a fixed density.
+//
+// objectxsortedlist_sortTrace instead replays the agent positions a run
+// recorded (RecordPosition Precise or Approximate), births and deaths
+// included, so the sort sees the ordering changes agents really make.
+
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "graphics/gobject.h"
+#include "utils/datalib.h"
+#include "utils/objectxsortedlist.h"
+
+using namespace std;
+
+#define ObjectsPerSide 8.0f
+#define AgentRadius 1.0f
+#define FoodRadius 0.5f
+#define MaxStepDistance 0.5f
+
+// ================================================================================
+// ===
+// === CLASS BenchObject
+// ===
+// ================================================================================
+class BenchObject : public gobject
+{
+ public:
+	BenchObject( int type, float x, float z, float radius )
+	{
+		setType( type );
+		setx( x );
+		setz( z );
+		setradius( radius );
+	}
+};
+
+// ================================================================================
+// ===
+// === CLASS Population
+// ===
+// ================================================================================
+class Population
+{
+ public:
+	Population( int n );
+	~Population();
+
+	// Moves every object by up to MaxStepDistance, as a step would.
+	void step();
+
+	objectxsortedlist list;
+	vector<BenchObject *> objects;
+	float worldsize;
+
+ private:
+	vector<float> deltas;
+	size_t ndelta;
+};
+
+static bool lessX( gobject *a, gobject *b )
+{
+	return (a->x() - a->radius()) < (b->x() - b->radius());
+}
+
+//---------------------------------------------------------------------------
+// Population::Population
+//---------------------------------------------------------------------------
+Population::Population( int n )
+: ndelta( 0 )
+{
+	worldsize = sqrt( (float)n ) * ObjectsPerSide;
+
+	for( int i = 0; i < n; i++ )
+	{
+		bool isAgent = (i % 2) == 0;
+		objects.push_back( new BenchObject(isAgent ? AGENTTYPE : FOODTYPE,
+										   drand48() * worldsize,
+										   -drand48() * worldsize,
+										   isAgent ? AgentRadius : FoodRadius) );
+	}
+
+	vector<gobject *> sorted( objects.begin(), objects.end() );
+	stable_sort( sorted.begin(), sorted.end(), lessX );
+	list.addSorted( sorted );
+
+	// Precomputed, so step() costs the same on every run.
+	deltas.resize( 2 * n + 1 );
+	for( size_t i = 0; i < deltas.size(); i++ )
+		deltas[i] = (drand48() * 2.0 - 1.0) * MaxStepDistance;
+}
+
+//---------------------------------------------------------------------------
+// Population::~Population
+//---------------------------------------------------------------------------
+Population::~Population()
+{
+	list.clear();
+	for( size_t i = 0; i < objects.size(); i++ )
+		delete objects[i];
+}
+
+//---------------------------------------------------------------------------
+// Population::step
+//---------------------------------------------------------------------------
+void Population::step()
+{
+	for( size_t i = 0; i < objects.size(); i++ )
+	{
+		BenchObject *o = objects[i];
+		if( o->getType() != AGENTTYPE )
+			continue;
+
+		float dx = deltas[ (i + ndelta) % deltas.size() ];
+		float dz = deltas[ (i + ndelta + 1) % deltas.size() ];
+		o->setx( max(0.0f, min(worldsize, o->x() + dx)) );
+		o->setz( max(-worldsize, min(0.0f, o->z() + dz)) );
+	}
+	ndelta++;
+}
+
+//---------------------------------------------------------------------------
+// objectxsortedlist_sort
+//---------------------------------------------------------------------------
+static void objectxsortedlist_sort( bench::State &state )
+{
+	Population population( state.arg() );
+
+	while( state.keepRunning() )
+	{
+		state.pauseTiming();
+		population.step();
+		state.resumeTiming();
+
+		population.list.sort();
+	}
+
+	state.setItemsProcessed( state.arg() );
+}
+BENCHMARK( objectxsortedlist_sort )->arg( 250 )->arg( 1000 )->arg( 4000 );
+
+//---------------------------------------------------------------------------
+// Interact_sweep
+//
+// Interact itself needs a whole simulation; this is its scan for agents and
+// food overlapping each agent, walking forward from the agent's mark until
+// nothing further along in x can reach it.
+//---------------------------------------------------------------------------
+static long sweep( objectxsortedlist &list )
+{
+	long contacts = 0;
+	gobject *c;
+	gobject *d;
+
+	list.reset();
+	while( list.nextObj(AGENTTYPE, &c) )
+	{
+		list.setMark( AGENTTYPE );
+
+		while( list.nextObj(AGENTTYPE | FOODTYPE, &d) )
+		{
+			if( (d->x() - d->radius()) >= (c->x() + c->radius()) )
+				break;
+
+			float dx = d->x() - c->x();
+			float dz = d->z() - c->z();
+			if( sqrt(dx * dx + dz * dz) <= (d->radius() + c->radius()) )
+				contacts++;
+		}
+
+		list.toMark( AGENTTYPE );
+	}
+
+	return contacts;
+}
+
+static void Interact_sweep( bench::State &state )
+{
+	Population population( state.arg() );
+	population.list.sort();
+
+	while( state.keepRunning() )
+	{
+		long contacts = sweep( population.list );
+		bench::doNotOptimize( contacts );
+	}
+
+	state.setItemsProcessed( state.arg() );
+}
+BENCHMARK( Interact_sweep )->arg( 250 )->arg( 1000 )->arg( 4000 );
+
+// ================================================================================
+// ===
+// === CLASS Trace
+// ===
+// ================================================================================
+class Trace
+{
+ public:
+	struct Track
+	{
+		long birth;
+		vector<float> x;
+		vector<float> z;
+	};
+
+	// Loaded once, on first use.
+	static const Trace &get();
+
+	vector<Track> tracks;
+	long begin;
+	long end;				// one past the last step
+	vector< vector<int> > births;	// by step - begin
+	vector< vector<int> > deaths;	// by step - begin, before the step's moves
+	double meanPopulation;
+
+ private:
+	Trace( const string &dir );
+};
+
+//---------------------------------------------------------------------------
+// Trace::get
+//---------------------------------------------------------------------------
+const Trace &Trace::get()
+{
+	static Trace *trace = NULL;
+	if( trace == NULL )
+		trace = new Trace( bench::runDir() + "/motion/position/agents" );
+	return *trace;
+}
+
+//---------------------------------------------------------------------------
+// Trace::Trace
+//---------------------------------------------------------------------------
+Trace::Trace( const string &dir )
+: begin( 0 )
+, end( 0 )
+, meanPopulation( 0 )
+{
+	DIR *d = opendir( dir.c_str() );
+	if( d == NULL )
+	{
+		fprintf( stderr, "Cannot open %s; was the run recorded with RecordPosition Precise or Approximate?\n", dir.c_str() );
+		exit( 1 );
+	}
+
+	vector<string> paths;
+	for( struct dirent *ent; (ent = readdir(d)) != NULL; )
+	{
+		long number;
+		char ext[8];
+		if( (sscanf(ent->d_name, "position_%ld.%7s", &number, ext) == 2) && (string(ext) == "txt") )
+			paths.push_back( dir + "/" + ent->d_name );
+	}
+	closedir( d );
+	// readdir order varies between file systems.
+	std::sort( paths.begin(), paths.end() );
+
+	for( const string &path : paths )
+	{
+		DataLibReader in( path.c_str(), DataLibReader::MAPPED );
+		if( !in.seekTable("Positions") || (in.nrows() == 0) )
+			continue;
+
+		DataLibReader::ColumnHandle col_timestep = in.colHandle( "Timestep" );
+		DataLibReader::ColumnHandle col_x = in.colHandle( "x" );
+		DataLibReader::ColumnHandle col_z = in.colHandle( "z" );
+
+		Track track;
+		// One row per step alive.
+		in.seekRow( 0 );
+		track.birth = in.getInt( col_timestep );
+		in.readColumn( col_x, track.x );
+		in.readColumn( col_z, track.z );
+
+		if( tracks.empty() || (track.birth < begin) )
+			begin = track.birth;
+		end = max( end, track.birth + (long)track.x.size() );
+		tracks.push_back( track );
+	}
+
+	if( tracks.empty() )
+	{
+		fprintf( stderr, "No agent positions in %s\n", dir.c_str() );
+		exit( 1 );
+	}
+
+	births.resize( end - begin );
+	deaths.resize( end - begin + 1 );
+	long agentSteps = 0;
+	for( size_t i = 0; i < tracks.size(); i++ )
+	{
+		const Track &track = tracks[i];
+		births[ track.birth - begin ].push_back( i );
+		deaths[ track.birth + track.x.size() - begin ].push_back( i );
+		agentSteps += track.x.size();
+	}
+	meanPopulation = double(agentSteps) / (end - begin);
+
+	printf( "# trace: %lu agents over steps %ld-%ld, %.0f alive on average\n",
+			tracks.size(), begin, end - 1, meanPopulation );
+}
+
+// ================================================================================
+// ===
+// === CLASS Replay
+// ===
+// ================================================================================
+class Replay
+{
+ public:
+	Replay( const Trace &trace );
+	~Replay();
+
+	// Applies the next recorded step's deaths, births and moves, starting
+	// over once the trace runs out.
+	void step();
+
+	objectxsortedlist list;
+
+ private:
+	void restart();
+
+	const Trace &trace;
+	long t;
+	vector<BenchObject *> objects;	// by track, NULL when not alive
+	vector<int> alive;
+};
+
+//---------------------------------------------------------------------------
+// Replay::Replay
+//---------------------------------------------------------------------------
+Replay::Replay( const Trace &trace_ )
+: trace( trace_ )
+, objects( trace_.tracks.size(), NULL )
+{
+	restart();
+}
+
+//---------------------------------------------------------------------------
+// Replay::~Replay
+//---------------------------------------------------------------------------
+Replay::~Replay()
+{
+	list.clear();
+	for( size_t i = 0; i < objects.size(); i++ )
+		delete objects[i];
+}
+
+//---------------------------------------------------------------------------
+// Replay::restart
+//---------------------------------------------------------------------------
+void Replay::restart()
+{
+	list.clear();
+	for( size_t i = 0; i < objects.size(); i++ )
+	{
+		delete objects[i];
+		objects[i] = NULL;
+	}
+	alive.clear();
+	t = trace.begin;
+}
+
+//---------------------------------------------------------------------------
+// Replay::step
+//---------------------------------------------------------------------------
+void Replay::step()
+{
+	if( t == trace.end )
+		restart();
+
+	long i = t - trace.begin;
+
+	for( int track : trace.deaths[i] )
+	{
+		list.removeObjectWithLink( objects[track] );
+		delete objects[track];
+		objects[track] = NULL;
+		alive.erase( find(alive.begin(), alive.end(), track) );
+	}
+
+	vector<gobject *> born;
+	for( int track : trace.births[i] )
+	{
+		objects[track] = new BenchObject( AGENTTYPE, 0.0f, 0.0f, AgentRadius );
+		alive.push_back( track );
+	}
+
+	for( int track : alive )
+	{
+		const Trace::Track &positions = trace.tracks[track];
+		long row = t - positions.birth;
+		objects[track]->setx( positions.x[row] );
+		objects[track]->setz( positions.z[row] );
+	}
+
+	for( int track : trace.births[i] )
+		born.push_back( objects[track] );
+	stable_sort( born.begin(), born.end(), lessX );
+	list.addSorted( born );
+
+	t++;
+}
+
+//---------------------------------------------------------------------------
+// objectxsortedlist_sortTrace
+//---------------------------------------------------------------------------
+static void objectxsortedlist_sortTrace( bench::State &state )
+{
+	const Trace &trace = Trace::get();
+	Replay replay( trace );
+
+	while( state.keepRunning() )
+	{
+		state.pauseTiming();
+		replay.step();
+		state.resumeTiming();
+
+		replay.list.sort();
+	}
+
+	state.setItemsProcessed( trace.meanPopulation );
+}
+BENCHMARK( objectxsortedlist_sortTrace )->needsRun();
@@ -0,0 +1,185 @@
+// Grows brains from random genomes of a worldfile, as births do, and checks
+// the table of derived genome attributes a brain grows from against the
+// genome's own answers. Exits 1 on the first mismatch.
+//
+// Must be run from the Polyworld home directory.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "agent/agent.h"
+#include "brain/Brain.h"
+#include "brain/NervousSystem.h"
+#include "genome/GenomeSchema.h"
+#include "genome/GenomeUtil.h"
+#include "genome/groups/GroupsGenome.h"
+#include "genome/groups/GroupsGenomeSchema.h"
+#include "proplib/builder.h"
+#include "proplib/dom.h"
+#include "proplib/interpreter.h"
+#include "proplib/schema.h"
+
+using namespace std;
+using namespace genome;
+
+#define NumGenomes 200
+
+//---------------------------------------------------------------------------
+// fail
+//---------------------------------------------------------------------------
+static void fail( int i, const char *what, int from, int to )
+{
+	fprintf( stderr, "genome %d: %s differs for %d -> %d\n", i, what, from, to );
+	exit( 1 );
+}
+
+//---------------------------------------------------------------------------
+// initWorldfile
+//
+// Same configuration steps as analysis::initialize(), from a worldfile
+// instead of a run directory.
+//---------------------------------------------------------------------------
+static void initWorldfile( const char *path )
+{
+	proplib::Interpreter::init();
+	proplib::DocumentBuilder builder;
+	proplib::SchemaDocument *schema = builder.buildSchemaDocument( "etc/worldfile.wfs" );
+	proplib::Document *worldfile = builder.buildWorldfileDocument( schema, path );
+	schema->apply( worldfile );
+
+	agent::processWorldfile( *worldfile );
+	GenomeSchema::processWorldfile( *worldfile );
+	Brain::processWorldfile( *worldfile );
+
+	proplib::Interpreter::dispose();
+	delete worldfile;
+	delete schema;
+
+	Brain::init();
+	GenomeUtil::createSchema();
+}
+
+//---------------------------------------------------------------------------
+// checkDerivedAttrs
+//
+// Every neuron count and synapse target a brain queries, from the table and
+// then directly. Neuron counts are queried by raw index too, so check all
+// groups.
+//---------------------------------------------------------------------------
+static void checkDerivedAttrs( int i, GroupsGenome *g )
+{
+	GroupsGenomeSchema *schema = g->getSchema();
+	vector<int> groups = g->getOrderedGroups();
+	int maxGroups = schema->getMaxGroupCount( NGT_ANY );
+
+	vector<int> neuronCounts;
+	for( int group = 0; group < maxGroups; group++ )
+	{
+		neuronCounts.push_back( g->getNeuronCount(INHIBITORY, group) );
+		neuronCounts.push_back( g->getNeuronCount(EXCITATORY, group) );
+	}
+
+	vector<int> counts;
+	vector<float> distortions;
+	for( GroupsSynapseType *synapseType : schema->getSynapseTypes() )
+		for( int from : groups )
+			for( int to : groups )
+				if( schema->getNeurGroupType(to) != NGT_INPUT )
+				{
+					counts.push_back( g->getSynapseCount(synapseType, from, to) );
+					distortions.push_back( g->getTopologicalDistortion(synapseType, from, to) );
+				}
+
+	GroupsGenome::DerivedAttrs attrs;
+	g->beginDerivedAttrs( &attrs );
+
+	size_t n = 0;
+	for( int group = 0; group < maxGroups; group++ )
+	{
+		if( (g->getNeuronCount(INHIBITORY, group) != neuronCounts[n])
+			|| (g->getNeuronCount(EXCITATORY, group) != neuronCounts[n + 1]) )
+		{
+			fail( i, "neuron count", group, group );
+		}
+		n += 2;
+	}
+
+	n = 0;
+	for( GroupsSynapseType *synapseType : schema->getSynapseTypes() )
+		for( int from : groups )
+			for( int to : groups )
+				if( schema->getNeurGroupType(to) != NGT_INPUT )
+				{
+					if( g->getSynapseCount(synapseType, from, to) != counts[n] )
+						fail( i, "synapse count", from, to );
+					if( g->getTopologicalDistortion(synapseType, from, to) != distortions[n] )
+						fail( i, "topological distortion", from, to );
+					n++;
+				}
+
+	g->endDerivedAttrs();
+}
+
+//---------------------------------------------------------------------------
+// growBrain
+//
+// With a nerve per input and output group, as agent::grow() makes them.
+//---------------------------------------------------------------------------
+static void growBrain( int i, Genome *g )
+{
+	GroupsGenomeSchema *schema = dynamic_cast<GroupsGenomeSchema *>( GenomeUtil::schema );
+
+	NervousSystem cns;
+	if( schema )
+	{
+		int numInOutGroups = schema->getMaxGroupCount( NGT_INPUT ) + schema->getMaxGroupCount( NGT_OUTPUT );
+		for( int group = 0; group < numInOutGroups; group++ )
+		{
+			NeurGroupGene *groupGene = schema->getGroupGene( group );
+			cns.createNerve( groupGene->getGroupType() == NGT_INPUT ? Nerve::INPUT : Nerve::OUTPUT,
+							 groupGene->name );
+		}
+	}
+
+	cns.grow( g );
+
+	NeuronModel::Dimensions dims = cns.getBrain()->getDimensions();
+	if( (dims.numNeurons <= 0)
+		|| (dims.numInputNeurons != cns.getNeuronCount(Nerve::INPUT))
+		|| (dims.numOutputNeurons != cns.getNeuronCount(Nerve::OUTPUT)) )
+	{
+		fprintf( stderr, "genome %d: bad brain dimensions (%d neurons, %d input, %d output)\n",
+				 i, dims.numNeurons, dims.numInputNeurons, dims.numOutputNeurons );
+		exit( 1 );
+	}
+}
+
+//---------------------------------------------------------------------------
+// main
+//---------------------------------------------------------------------------
+int main( int argc, char **argv )
+{
+	const char *worldfile = argc > 1 ? argv[1] : "worldfiles/hello.wf";
+
+	initWorldfile( worldfile );
+
+	for( int i = 0; i < NumGenomes; i++ )
+	{
+		Genome *g = GenomeUtil::createGenome( true );
+
+		GroupsGenome *groupsGenome = dynamic_cast<GroupsGenome *>( g );
+		if( groupsGenome )
+			checkDerivedAttrs( i, groupsGenome );
+
+		growBrain( i, g );
+
+		delete g;
+	}
+
+	printf( "grew %d brains from %s\n", NumGenomes, worldfile );
+
+	return 0;
+}
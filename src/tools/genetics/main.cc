@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+#include "genome/GenomeDelta.h"
 #include "genome/GenomeUtil.h"
 #include "sim/globals.h"
 #include "utils/AbstractFile.h"
@@ -14,6 +15,8 @@ struct Arguments {
     std::vector<std::string> args;
     bool help;
     std::string run;
+    std::string delta;
+    long agent;
 
     Arguments(int argc, char** argv);
     std::string usage();
@@ -29,11 +32,15 @@ Arguments::Arguments(int argc, char** argv) :
 std::string Arguments::usage() {
     std::ostringstream out;
     out << "Usage: " << args[0] << " RUN" << std::endl;
+    out << "       " << args[0] << " --delta FILE [AGENT]" << std::endl;
     out << std::endl;
-    out << "Generate the population genetics log for an existing run." << std::endl;
+    out << "Generate the population genetics log for an existing run, or convert a" << std::endl;
+    out << "log recorded with Encoding Delta to text." << std::endl;
     out << "See Logs::PopulationGeneticsLog for more information." << std::endl;
     out << std::endl;
-    out << "  RUN  Run directory" << std::endl;
+    out << "  RUN    Run directory" << std::endl;
+    out << "  FILE   Delta-encoded population genetics log" << std::endl;
+    out << "  AGENT  Only print the genome of this agent" << std::endl;
     return out.str();
 }
 
@@ -46,6 +53,7 @@ bool Arguments::parse() {
         }
     }
     help = false;
+    agent = 0;
     unsigned argi = 1;
     try {
 #define PARSE(ARGUMENT, CONVERTER, PREDICATE, MESSAGE) \
@@ -61,7 +69,15 @@ bool Arguments::parse() {
     } \
     argi++; \
 }
-        PARSE(run, , exists(run + "/endStep.txt"), "Not a Polyworld run")
+        if (argi < args.size() && args[argi] == "--delta") {
+            argi++;
+            PARSE(delta, , AbstractFile::exists(delta.c_str()), "File not found")
+            if (argi < args.size()) {
+                PARSE(agent, std::stol, agent >= 1, "Invalid agent ID")
+            }
+        } else {
+            PARSE(run, , exists(run + "/endStep.txt"), "Not a Polyworld run")
+        }
 #undef PARSE
     } catch (...) {
         fail(argi, "Invalid argument");
@@ -81,6 +97,7 @@ void Arguments::fail(int argi, const std::string& message) {
 void printBirth(const std::string& run, int agent);
 void printDeath(int agent);
 void printStep(int step);
+int convertDelta(const std::string& path, long agent);
 
 int main(int argc, char** argv) {
     Arguments arguments(argc, argv);
@@ -91,6 +108,9 @@ int main(int argc, char** argv) {
         std::cout << arguments.usage();
         return 0;
     }
+    if (!arguments.delta.empty()) {
+        return convertDelta(arguments.delta, arguments.agent);
+    }
     analysis::initialize(arguments.run);
     std::cout << "SIZE " << genome::GenomeUtil::schema->getMutableSize() << std::endl;
     int initAgentCount = analysis::getInitAgentCount(arguments.run);
@@ -98,25 +118,22 @@ int main(int argc, char** argv) {
         printBirth(arguments.run, agent);
     }
     printStep(0);
-    std::map<int, std::list<analysis::Event> > events = analysis::getEvents(arguments.run);
+    BirthsDeathsIndex* events = analysis::getEvents(arguments.run);
     int maxTimestep = analysis::getMaxTimestep(arguments.run);
     for (int timestep = 1; timestep <= maxTimestep; timestep++) {
-        std::map<int, std::list<analysis::Event> >::iterator eventsIter = events.find(timestep);
-        if (eventsIter != events.end()) {
-            itfor(std::list<analysis::Event>, eventsIter->second, timestepEventsIter) {
-                analysis::Event event = *timestepEventsIter;
-                if (event.type == "BIRTH" || event.type == "CREATION") {
-                    printBirth(arguments.run, event.agent);
-                } else if (event.type == "DEATH") {
-                    printDeath(event.agent);
-                } else if (event.type != "VIRTUAL") {
-                    std::cerr << "Unhandled event: " << event.type << std::endl;
-                    return 1;
-                }
+        for (const BirthsDeathsIndex::Record* event = events->begin(timestep); event != events->end(timestep); event++) {
+            if (event->type == BirthsDeathsIndex::BIRTH || event->type == BirthsDeathsIndex::CREATION) {
+                printBirth(arguments.run, event->agent);
+            } else if (event->type == BirthsDeathsIndex::DEATH) {
+                printDeath(event->agent);
+            } else if (event->type != BirthsDeathsIndex::VIRTUAL) {
+                std::cerr << "Unhandled event: " << BirthsDeathsIndex::getTypeName(event->type) << std::endl;
+                return 1;
             }
         }
         printStep(timestep);
     }
+    delete events;
     return 0;
 }
 
@@ -136,3 +153,60 @@ void printDeath(int agent) {
 void printStep(int step) {
     std::cout << "STEP " << step << std::endl;
 }
+
+void printGenome(const genome::GenomeBytes& genome) {
+    for (unsigned char byte : genome) {
+        std::cout << (int)byte << '\n';
+    }
+}
+
+int convertDelta(const std::string& path, long agent) {
+    AbstractFile* file = AbstractFile::open(path.c_str(), "r");
+    genome::GenomeDeltaReader reader(file);
+    if (!reader.isValid()) {
+        std::cerr << path << ": Not a delta-encoded population genetics log" << std::endl;
+        delete file;
+        return 1;
+    }
+    if (agent == 0) {
+        std::cout << "SIZE " << reader.getGenomeSize() << std::endl;
+    } else {
+        reader.seekAgent(agent);
+    }
+    genome::GenomeDeltaReader::Record record;
+    while (reader.next(record)) {
+        switch (record.type) {
+        case genome::GenomeDeltaReader::RECORD_STEP:
+            if (agent == 0) {
+                printStep(record.step);
+            }
+            break;
+        case genome::GenomeDeltaReader::RECORD_BIRTH:
+            if (agent == 0) {
+                std::cout << "BIRTH " << record.agent << std::endl;
+                printGenome(*record.genome);
+                std::cout << std::endl;
+            } else if (record.agent == agent) {
+                printGenome(*record.genome);
+                delete file;
+                return 0;
+            }
+            break;
+        case genome::GenomeDeltaReader::RECORD_DEATH:
+            if (agent == 0) {
+                printDeath(record.agent);
+            }
+            break;
+        case genome::GenomeDeltaReader::RECORD_END:
+            delete file;
+            if (agent != 0) {
+                std::cerr << "Agent " << agent << " not found" << std::endl;
+                return 1;
+            }
+            return 0;
+        }
+    }
+    std::cerr << path << ": Malformed record" << std::endl;
+    delete file;
+    return 1;
+}
@@ -0,0 +1,59 @@
+// Vision backend that renders nothing: every retina sees black. For worlds
+// whose agents don't depend on vision, or for timing everything else.
+
+#include <vector>
+
+#include "VisionBackend.h"
+#include "agent/agent.h"
+#include "agent/AgentPovRenderer.h"
+#include "agent/Retina.h"
+
+// ================================================================================
+// ===
+// === CLASS BlindAgentPovRenderer
+// ===
+// ================================================================================
+class BlindAgentPovRenderer : public AgentPovRenderer
+{
+ public:
+	BlindAgentPovRenderer( int retinaWidth )
+		: fBlack( retinaWidth * 4, 0 )
+	{
+	}
+
+	virtual void add( agent *a ) override {}
+	virtual void remove( agent *a ) override {}
+
+	virtual void beginStep() override {}
+
+	virtual void render( agent *a ) override
+	{
+		a->GetRetina()->setPixels( &fBlack[0] );
+	}
+
+	virtual void endStep() override
+	{
+		renderComplete();
+	}
+
+	// render() never touches GL, so there's nothing to batch.
+	virtual void setBatchedReadback( bool batched ) override {}
+	virtual void readRetinas() override {}
+
+	// There's no GL context to draw with.
+	virtual bool usesGL() override { return false; }
+
+ private:
+	std::vector<unsigned char> fBlack;
+};
+
+//---------------------------------------------------------------------------
+// createBlind
+//---------------------------------------------------------------------------
+static AgentPovRenderer *createBlind( int maxAgents,
+									  int retinaWidth,
+									  int retinaHeight )
+{
+	return new BlindAgentPovRenderer( retinaWidth );
+}
+VISION_BACKEND( "blind", "no rendering, retinas are black", createBlind );
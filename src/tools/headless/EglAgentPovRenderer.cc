@@ -0,0 +1,350 @@
+// Vision backend rendering into an EGL pbuffer, so it needs neither Qt nor a
+// display server. The viewport layout and draw calls are the Qt renderer's,
+// so retinas see the same pixels on the same GL implementation.
+
+#ifdef PW_EGL
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <EGL/egl.h>
+#include <gl.h>
+
+#include "VisionBackend.h"
+#include "agent/agent.h"
+#include "agent/AgentAttachedData.h"
+#include "agent/AgentPovRenderer.h"
+#include "agent/Retina.h"
+
+#define CELL_PAD 2
+
+using namespace std;
+
+// ================================================================================
+// ===
+// === CLASS EglAgentPovRenderer
+// ===
+// ================================================================================
+class EglAgentPovRenderer : public AgentPovRenderer
+{
+ public:
+	EglAgentPovRenderer( int maxAgents,
+						 int retinaWidth,
+						 int retinaHeight );
+	virtual ~EglAgentPovRenderer();
+
+	virtual void add( agent *a ) override;
+	virtual void remove( agent *a ) override;
+
+	virtual void beginStep() override;
+	virtual void render( agent *a ) override;
+	virtual void endStep() override;
+
+	virtual void setBatchedReadback( bool batched ) override;
+	virtual void readRetinas() override;
+
+ private:
+	struct Viewport
+	{
+		int index;
+		short row;
+		short x;
+		short y;
+		short width;
+		short height;
+	};
+	void initContext();
+	short getRetinaY( short row );
+
+	EGLDisplay fDisplay;
+	EGLSurface fSurface;
+	EGLContext fContext;
+	int fBufferWidth;
+	int fBufferHeight;
+	int fNumRows;
+	int fRetinaHeight;
+	// Batched readback: the retina row of every viewport row, read at once.
+	bool fBatchedReadback;
+	vector<unsigned char> fReadbackRows;
+	vector<agent *> fRendered;
+	AgentAttachedData::SlotHandle slotHandle;
+	Viewport *fViewports;
+	map<int, Viewport *> fFreeViewports;
+};
+
+//---------------------------------------------------------------------------
+// EglAgentPovRenderer::EglAgentPovRenderer
+//---------------------------------------------------------------------------
+EglAgentPovRenderer::EglAgentPovRenderer( int maxAgents,
+										  int retinaWidth,
+										  int retinaHeight )
+: fDisplay( EGL_NO_DISPLAY )
+, fSurface( EGL_NO_SURFACE )
+, fContext( EGL_NO_CONTEXT )
+, fRetinaHeight( retinaHeight )
+, fBatchedReadback( false )
+{
+	// Same grid as QtAgentPovRenderer: a width that's a multiple of 10 cells
+	// and at least 3 times the height.
+	int n = 10;
+	int a = 3;
+	int i = (int) (sqrt( (float) (maxAgents * a) ) + n - 1) / n;
+	int ncols = i * n;
+	int nrows = (maxAgents + ncols - 1) / ncols;
+	fBufferWidth = ncols * (retinaWidth + CELL_PAD);
+	fBufferHeight = nrows * (retinaHeight + CELL_PAD);
+	fNumRows = nrows;
+
+	slotHandle = AgentAttachedData::createSlot();
+
+	fViewports = new Viewport[ maxAgents ];
+	for( int i = 0; i < maxAgents; i++ )
+	{
+		Viewport *viewport = fViewports + i;
+
+		viewport->index = i;
+
+		short irow = short(i / ncols);
+		short icol = short(i) - (ncols * irow);
+
+		viewport->row = irow;
+
+		viewport->width = retinaWidth;
+		viewport->height = retinaHeight;
+
+		viewport->x = icol * (viewport->width + CELL_PAD)  +  CELL_PAD;
+		short ytop = fBufferHeight  -  (irow) * (viewport->height + CELL_PAD) - CELL_PAD - 1;
+		viewport->y = ytop  -  viewport->height  +  1;
+
+		fFreeViewports.insert( make_pair(viewport->index, viewport) );
+	}
+}
+
+//---------------------------------------------------------------------------
+// EglAgentPovRenderer::~EglAgentPovRenderer
+//---------------------------------------------------------------------------
+EglAgentPovRenderer::~EglAgentPovRenderer()
+{
+	if( fDisplay != EGL_NO_DISPLAY )
+	{
+		eglMakeCurrent( fDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+		if( fContext != EGL_NO_CONTEXT )
+			eglDestroyContext( fDisplay, fContext );
+		if( fSurface != EGL_NO_SURFACE )
+			eglDestroySurface( fDisplay, fSurface );
+		eglTerminate( fDisplay );
+	}
+
+	delete [] fViewports;
+}
+
+//---------------------------------------------------------------------------
+// EglAgentPovRenderer::initContext
+//---------------------------------------------------------------------------
+void EglAgentPovRenderer::initContext()
+{
+	fDisplay = eglGetDisplay( EGL_DEFAULT_DISPLAY );
+	if( (fDisplay == EGL_NO_DISPLAY) || !eglInitialize(fDisplay, NULL, NULL) )
+	{
+		fprintf( stderr, "Failed initializing EGL display (error 0x%x).\n", eglGetError() );
+		exit( 1 );
+	}
+
+	const EGLint configAttribs[] =
+		{
+			EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_RED_SIZE, 8,
+			EGL_GREEN_SIZE, 8,
+			EGL_BLUE_SIZE, 8,
+			EGL_DEPTH_SIZE, 24,
+			EGL_NONE
+		};
+	EGLConfig config;
+	EGLint nconfigs = 0;
+	if( !eglChooseConfig(fDisplay, configAttribs, &config, 1, &nconfigs) || (nconfigs == 0) )
+	{
+		fprintf( stderr, "No EGL config for an offscreen OpenGL pbuffer (error 0x%x).\n", eglGetError() );
+		exit( 1 );
+	}
+
+	const EGLint surfaceAttribs[] =
+		{
+			EGL_WIDTH, fBufferWidth,
+			EGL_HEIGHT, fBufferHeight,
+			EGL_NONE
+		};
+	fSurface = eglCreatePbufferSurface( fDisplay, config, surfaceAttribs );
+
+	eglBindAPI( EGL_OPENGL_API );
+	fContext = eglCreateContext( fDisplay, config, EGL_NO_CONTEXT, NULL );
+
+	if( (fSurface == EGL_NO_SURFACE) || (fContext == EGL_NO_CONTEXT) )
+	{
+		fprintf( stderr, "Failed creating %dx%d EGL pbuffer (error 0x%x).\n",
+				 fBufferWidth, fBufferHeight, eglGetError() );
+		exit( 1 );
+	}
+}
+
+//---------------------------------------------------------------------------
+// EglAgentPovRenderer::add
+//---------------------------------------------------------------------------
+void EglAgentPovRenderer::add( agent *a )
+{
+	assert( AgentAttachedData::get( a, slotHandle ) == NULL );
+
+	Viewport *viewport = fFreeViewports.begin()->second;
+	fFreeViewports.erase( fFreeViewports.begin() );
+
+	AgentAttachedData::set( a, slotHandle, viewport );
+}
+
+//---------------------------------------------------------------------------
+// EglAgentPovRenderer::remove
+//---------------------------------------------------------------------------
+void EglAgentPovRenderer::remove( agent *a )
+{
+	Viewport *viewport = (Viewport *)AgentAttachedData::get( a, slotHandle );
+
+	if( viewport )
+	{
+		AgentAttachedData::set( a, slotHandle, NULL );
+		fFreeViewports.insert( make_pair(viewport->index, viewport) );
+	}
+}
+
+//---------------------------------------------------------------------------
+// EglAgentPovRenderer::beginStep
+//---------------------------------------------------------------------------
+void EglAgentPovRenderer::beginStep()
+{
+	if( fContext == EGL_NO_CONTEXT )
+	{
+		initContext();
+		eglMakeCurrent( fDisplay, fSurface, fSurface, fContext );
+
+		glEnable( GL_DEPTH_TEST );
+		glEnable( GL_NORMALIZE );
+
+		glMatrixMode(GL_MODELVIEW);
+		glLoadIdentity();
+		glMatrixMode(GL_PROJECTION);
+		glLoadIdentity();
+	}
+	else
+	{
+		eglMakeCurrent( fDisplay, fSurface, fSurface, fContext );
+	}
+
+	glClearColor( 0, 0, 0, 1 );
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+//---------------------------------------------------------------------------
+// EglAgentPovRenderer::render
+//---------------------------------------------------------------------------
+void EglAgentPovRenderer::render( agent *a )
+{
+	Viewport *viewport = (Viewport *)AgentAttachedData::get( a, slotHandle );
+
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+
+	glViewport( viewport->x, viewport->y, viewport->width, viewport->height );
+
+	glPushMatrix();
+		a->GetScene().Draw();
+	glPopMatrix();
+
+	if( fBatchedReadback )
+		fRendered.push_back( a );
+	else
+		a->GetRetina()->updateBuffer( viewport->x, viewport->y, viewport->width, viewport->height );
+}
+
+//---------------------------------------------------------------------------
+// EglAgentPovRenderer::endStep
+//---------------------------------------------------------------------------
+void EglAgentPovRenderer::endStep()
+{
+	eglMakeCurrent( fDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+
+	renderComplete();
+}
+
+//---------------------------------------------------------------------------
+// EglAgentPovRenderer::setBatchedReadback
+//---------------------------------------------------------------------------
+void EglAgentPovRenderer::setBatchedReadback( bool batched )
+{
+	assert( fContext == EGL_NO_CONTEXT );
+
+	fBatchedReadback = batched;
+}
+
+//---------------------------------------------------------------------------
+// EglAgentPovRenderer::readRetinas
+//
+// One glReadPixels per row of viewports into client memory. Without Qt's
+// buffer wrappers there's no pixel pack buffer, but the per-agent reads are
+// still gone.
+//---------------------------------------------------------------------------
+void EglAgentPovRenderer::readRetinas()
+{
+	if( fRendered.empty() )
+		return;
+
+	int rowBytes = fBufferWidth * 4;
+	short nrows = 0;
+	for( agent *a : fRendered )
+	{
+		Viewport *viewport = (Viewport *)AgentAttachedData::get( a, slotHandle );
+		nrows = max( nrows, short(viewport->row + 1) );
+	}
+
+	fReadbackRows.resize( fNumRows * rowBytes );
+	for( short row = 0; row < nrows; row++ )
+	{
+		glReadPixels( 0, getRetinaY(row), fBufferWidth, 1,
+					  GL_RGBA, GL_UNSIGNED_BYTE,
+					  &fReadbackRows[row * rowBytes] );
+	}
+
+	for( agent *a : fRendered )
+	{
+		Viewport *viewport = (Viewport *)AgentAttachedData::get( a, slotHandle );
+		a->GetRetina()->setPixels( &fReadbackRows[(viewport->row * rowBytes) + (viewport->x * 4)] );
+	}
+	fRendered.clear();
+}
+
+//---------------------------------------------------------------------------
+// EglAgentPovRenderer::getRetinaY
+//---------------------------------------------------------------------------
+short EglAgentPovRenderer::getRetinaY( short row )
+{
+	short ytop = fBufferHeight  -  row * (fRetinaHeight + CELL_PAD) - CELL_PAD - 1;
+	short y = ytop  -  fRetinaHeight  +  1;
+
+	return y + fRetinaHeight / 2;
+}
+
+//---------------------------------------------------------------------------
+// createEgl
+//---------------------------------------------------------------------------
+static AgentPovRenderer *createEgl( int maxAgents,
+									int retinaWidth,
+									int retinaHeight )
+{
+	return new EglAgentPovRenderer( maxAgents, retinaWidth, retinaHeight );
+}
+VISION_BACKEND( "egl", "offscreen OpenGL through EGL, same pixels as Polyworld", createEgl );
+
+#endif // PW_EGL
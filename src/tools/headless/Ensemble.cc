@@ -0,0 +1,233 @@
+// Replicates of one worldfile, run at once. The simulation keeps its state in
+// globals and statics (agent::config, gXSortedObjects, the drand48 stream...),
+// so each replicate is a forked copy of this process rather than a thread.
+// They share what's already loaded, and the compiled dynamic properties,
+// which replicate 0 builds and leaves in the cache for the rest; replicates
+// 1..n-1 start once it has. The machine's cores are divided between them.
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "Run.h"
+#include "proplib/builder.h"
+#include "proplib/dom.h"
+#include "proplib/schema.h"
+#include "sim/Scheduler.h"
+#include "utils/misc.h"
+
+using namespace std;
+
+static volatile sig_atomic_t forwardSignal = 0;
+
+//===========================================================================
+// handleForwardSignal
+//===========================================================================
+static void handleForwardSignal( int signum )
+{
+	forwardSignal = signum;
+}
+
+//===========================================================================
+// absolutePath
+//===========================================================================
+static string absolutePath( const string &path )
+{
+	if( !path.empty() && path[0] == '/' )
+		return path;
+
+	char cwd[1024];
+	if( getcwd(cwd, sizeof(cwd)) == NULL )
+	{
+		perror( "getcwd" );
+		exit( 1 );
+	}
+
+	return path == "." ? string(cwd) : string(cwd) + "/" + path;
+}
+
+//===========================================================================
+// runReplicate
+//
+// In the child. Doesn't return.
+//===========================================================================
+static void runReplicate( RunOptions options, const string &dir, int readyFd )
+{
+	// Own process group, so a ^C reaches the replicates once, through the
+	// parent, rather than twice.
+	setpgid( 0, 0 );
+	signal( SIGINT, SIG_DFL );
+	signal( SIGTERM, SIG_DFL );
+
+	if( chdir(dir.c_str()) != 0 )
+	{
+		perror( dir.c_str() );
+		_exit( 1 );
+	}
+
+	options.readyFd = readyFd;
+
+	exit( runSimulation(options) );
+}
+
+//===========================================================================
+// runEnsemble
+//===========================================================================
+int runEnsemble( const RunOptions &options, int numReplicates, const string &ensembleDir )
+{
+	// Seeds as the worldfile resolves them, so replicate 0 is the run a lone
+	// pw-headless would do. This also fails a bad worldfile before anything
+	// is forked.
+	long initSeed;
+	long simulationSeed;
+	{
+		proplib::Interpreter::init();
+
+		proplib::DocumentBuilder builder;
+		proplib::SchemaDocument *schema = builder.buildSchemaDocument( "./etc/worldfile.wfs" );
+		proplib::Document *worldfile = builder.buildWorldfileDocument( schema, options.worldfilePath, options.parameters );
+		schema->apply( worldfile );
+
+		initSeed = (int)worldfile->get( "InitSeed" );
+		simulationSeed = (int)worldfile->get( "SimulationSeed" );
+
+		delete worldfile;
+		delete schema;
+
+		proplib::Interpreter::dispose();
+	}
+
+	unsigned ncores = max( 1u, thread::hardware_concurrency() );
+	Scheduler::setCoreCount( max(1u, ncores / numReplicates) );
+
+	{
+		struct sigaction sa;
+		sa.sa_handler = handleForwardSignal;
+		sigemptyset( &sa.sa_mask );
+		sa.sa_flags = 0;	// no SA_RESTART, so waits are interrupted
+		sigaction( SIGINT, &sa, NULL );
+		sigaction( SIGTERM, &sa, NULL );
+	}
+
+	string home = absolutePath( "." );
+	vector<pid_t> pids( numReplicates, 0 );
+
+	for( int i = 0; (i < numReplicates) && !forwardSignal; i++ )
+	{
+		string dir;
+		{
+			ostringstream out;
+			out << absolutePath( ensembleDir ) << "/" << i;
+			dir = out.str();
+		}
+		makeDirs( dir );
+		if( !exists(dir + "/etc") && (symlink((home + "/etc").c_str(), (dir + "/etc").c_str()) != 0) )
+		{
+			perror( (dir + "/etc").c_str() );
+			break;
+		}
+
+		RunOptions replicate = options;
+		replicate.worldfilePath = absolutePath( options.worldfilePath );
+		replicate.monitorPath = absolutePath( options.monitorPath );
+		replicate.parameters["InitSeed"] = to_string( initSeed + i );
+		if( simulationSeed != 0 )
+			replicate.parameters["SimulationSeed"] = to_string( simulationSeed + i );
+		replicate.label = "[" + to_string( i ) + "] ";
+
+		int ready[2] = { -1, -1 };
+		if( (i == 0) && (numReplicates > 1) && (pipe(ready) != 0) )
+		{
+			perror( "pipe" );
+			break;
+		}
+
+		fflush( stdout );
+		fflush( stderr );
+
+		pid_t pid = fork();
+		if( pid == 0 )
+		{
+			if( ready[0] != -1 )
+				close( ready[0] );
+			runReplicate( replicate, dir, ready[1] );
+		}
+		else if( pid == -1 )
+		{
+			perror( "fork" );
+			break;
+		}
+
+		pids[i] = pid;
+		printf( "%sstarted in %s (pid %d)\n", replicate.label.c_str(), dir.c_str(), (int)pid );
+		fflush( stdout );
+
+		// Wait for the first replicate to construct its simulation, or die.
+		if( ready[0] != -1 )
+		{
+			close( ready[1] );
+			char c;
+			while( (read(ready[0], &c, 1) == -1) && (errno == EINTR) && !forwardSignal )
+				;
+			close( ready[0] );
+		}
+	}
+
+	int status = 0;
+	int nrunning = count_if( pids.begin(), pids.end(), [](pid_t pid) { return pid != 0; } );
+	if( nrunning < numReplicates )
+		status = 1;
+
+	while( nrunning > 0 )
+	{
+		if( forwardSignal )
+		{
+			for( pid_t pid : pids )
+				if( pid )
+					kill( pid, forwardSignal );
+			forwardSignal = 0;
+		}
+
+		int childStatus;
+		pid_t pid = waitpid( -1, &childStatus, 0 );
+		if( pid == -1 )
+		{
+			if( errno == EINTR )
+				continue;
+			perror( "waitpid" );
+			return 1;
+		}
+
+		int i = find( pids.begin(), pids.end(), pid ) - pids.begin();
+		if( i == numReplicates )
+			continue;
+		pids[i] = 0;
+		nrunning--;
+
+		if( WIFEXITED(childStatus) && (WEXITSTATUS(childStatus) == 0) )
+		{
+			printf( "[%d] done\n", i );
+		}
+		else
+		{
+			if( WIFSIGNALED(childStatus) )
+				printf( "[%d] killed by %s\n", i, strsignal(WTERMSIG(childStatus)) );
+			else
+				printf( "[%d] failed with status %d\n", i, WEXITSTATUS(childStatus) );
+			status = 1;
+		}
+		fflush( stdout );
+	}
+
+	return status;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+#include "proplib/proplib.h"
+
+//===========================================================================
+// RunOptions
+//===========================================================================
+struct RunOptions
+{
+	RunOptions() : progressInterval( 0 ), readyFd( -1 ) {}
+
+	std::string worldfilePath;
+	proplib::ParameterMap parameters;
+	std::string monitorPath;
+	double progressInterval;	// seconds, 0 for no progress lines
+	std::string label;			// prefixed to progress lines
+	int readyFd;				// written to once the simulation is constructed
+};
+
+// Runs one simulation in the working directory, returning an exit status.
+int runSimulation( const RunOptions &options );
+
+// Runs replicates of a simulation in forked processes, each in a directory of
+// its own under ensembleDir, returning an exit status.
+int runEnsemble( const RunOptions &options, int numReplicates, const std::string &ensembleDir );
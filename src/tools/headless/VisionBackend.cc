@@ -0,0 +1,124 @@
+#include "VisionBackend.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "agent/AgentPovRenderer.h"
+#include "monitor/SceneRenderer.h"
+
+using namespace std;
+
+static VisionBackend *selected = NULL;
+
+//---------------------------------------------------------------------------
+// backends
+//
+// Function-local so backends can register from static initializers in any
+// translation unit.
+//---------------------------------------------------------------------------
+static vector<VisionBackend *> &backends()
+{
+	static vector<VisionBackend *> backends;
+	return backends;
+}
+
+//===========================================================================
+// VisionBackend
+//===========================================================================
+
+//---------------------------------------------------------------------------
+// VisionBackend::VisionBackend
+//---------------------------------------------------------------------------
+VisionBackend::VisionBackend( const char *name_,
+							  const char *description_,
+							  CreateFunc create_ )
+: name( name_ )
+, description( description_ )
+, create( create_ )
+{
+	backends().push_back( this );
+}
+
+//---------------------------------------------------------------------------
+// VisionBackend::getBackends
+//---------------------------------------------------------------------------
+const vector<VisionBackend *> &VisionBackend::getBackends()
+{
+	return backends();
+}
+
+//---------------------------------------------------------------------------
+// VisionBackend::find
+//---------------------------------------------------------------------------
+VisionBackend *VisionBackend::find( const string &name )
+{
+	for( VisionBackend *backend : backends() )
+	{
+		if( name == backend->name )
+			return backend;
+	}
+
+	return NULL;
+}
+
+//---------------------------------------------------------------------------
+// VisionBackend::getDefault
+//
+// Real rendering when it's been built in, so runs match the Qt app's.
+//---------------------------------------------------------------------------
+VisionBackend *VisionBackend::getDefault()
+{
+	VisionBackend *backend = find( "egl" );
+	if( backend == NULL )
+		backend = find( "blind" );
+
+	return backend;
+}
+
+//---------------------------------------------------------------------------
+// VisionBackend::select
+//---------------------------------------------------------------------------
+void VisionBackend::select( VisionBackend *backend )
+{
+	selected = backend;
+}
+
+//---------------------------------------------------------------------------
+// VisionBackend::getSelected
+//---------------------------------------------------------------------------
+VisionBackend *VisionBackend::getSelected()
+{
+	return selected;
+}
+
+//===========================================================================
+// Renderer factories the library expects a renderer library to define
+//===========================================================================
+
+//---------------------------------------------------------------------------
+// AgentPovRenderer::create
+//---------------------------------------------------------------------------
+AgentPovRenderer *AgentPovRenderer::create( int maxAgents,
+                                            int retinaWidth,
+                                            int retinaHeight )
+{
+	assert( selected );
+
+	return selected->create( maxAgents, retinaWidth, retinaHeight );
+}
+
+//---------------------------------------------------------------------------
+// SceneRenderer::create
+//
+// Scenes are only for watching and recording movies, which need the Qt
+// renderer; etc/headless.mf leaves them disabled.
+//---------------------------------------------------------------------------
+SceneRenderer *SceneRenderer::create( gstage &stage,
+									  const CameraProperties &cameraProps,
+									  int width,
+									  int height )
+{
+	fprintf( stderr, "Scenes aren't available headless. Disable them in the monitor file or run Polyworld.\n" );
+	exit( 1 );
+}
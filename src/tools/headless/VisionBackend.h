@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+class AgentPovRenderer;
+
+//===========================================================================
+// VisionBackend
+//
+// What renders the agents' points of view in place of the Qt renderer. The
+// simulation asks for its renderer through AgentPovRenderer::create(), which
+// here builds one from whichever backend main() selected.
+//===========================================================================
+class VisionBackend
+{
+ public:
+	typedef AgentPovRenderer *(*CreateFunc)( int maxAgents,
+											 int retinaWidth,
+											 int retinaHeight );
+
+	VisionBackend( const char *name, const char *description, CreateFunc create );
+
+	static const std::vector<VisionBackend *> &getBackends();
+	static VisionBackend *find( const std::string &name );
+	static VisionBackend *getDefault();
+
+	static void select( VisionBackend *backend );
+	static VisionBackend *getSelected();
+
+	const char *name;
+	const char *description;
+	CreateFunc create;
+};
+
+// Defines a backend from a function with the signature of CreateFunc.
+#define VISION_BACKEND( NAME, DESCRIPTION, CREATE )						\
+	static VisionBackend __visionBackend_##CREATE( NAME, DESCRIPTION, CREATE )
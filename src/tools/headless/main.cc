@@ -0,0 +1,288 @@
+// Runs a simulation with no Qt and no event loop: Step() in a loop until the
+// simulation ends itself or a signal asks it to. Monitors are those of
+// `Polyworld --ui term` without the scenes (etc/headless.mf), so a run writes
+// the same files. With --replicates, runs several at once (see Ensemble.cc).
+
+#include <locale.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "Run.h"
+#include "VisionBackend.h"
+#include "monitor/MonitorManager.h"
+#include "proplib/proplib.h"
+#include "sim/Simulation.h"
+#include "utils/misc.h"
+#include "utils/PwMovieUtils.h"
+
+using namespace std;
+
+#define DefaultProgressInterval 10.0
+
+static volatile sig_atomic_t endSignal = 0;
+
+//===========================================================================
+// usage
+//===========================================================================
+void usage( const char* format, ... )
+{
+	printf( "Usage:  pw-headless [--vision backend] [--progress seconds]\n" );
+	printf( "                    [--replicates n [--ensemble-dir path]] [--key value]... worldfile\n" );
+	printf( "\n" );
+	printf( "Run from the Polyworld directory. SIGINT or SIGTERM ends the simulation\n" );
+	printf( "cleanly; a second one kills it.\n" );
+	printf( "\n" );
+	printf( "  --vision        how agents see, default %s:\n", VisionBackend::getDefault()->name );
+	for( VisionBackend *backend : VisionBackend::getBackends() )
+		printf( "                    %-8s %s\n", backend->name, backend->description );
+	printf( "  --progress      seconds between progress lines, 0 for none (default %g)\n", DefaultProgressInterval );
+	printf( "  --replicates    run n replicates at once, replicate i with InitSeed, and\n" );
+	printf( "                  SimulationSeed if it's nonzero, increased by i\n" );
+	printf( "  --ensemble-dir  replicate i runs in <path>/i (default ensemble)\n" );
+	printf( "  --key value     overrides worldfile parameter key\n" );
+
+	if( format )
+	{
+		printf( "Error:\n\t" );
+		va_list argv;
+		va_start( argv, format );
+		vprintf( format, argv );
+		va_end( argv );
+		printf( "\n" );
+	}
+
+	exit( 1 );
+}
+
+void usage()
+{
+	usage( NULL );
+}
+
+//===========================================================================
+// handleEndSignal
+//===========================================================================
+static void handleEndSignal( int signum )
+{
+	endSignal = signum;
+}
+
+//===========================================================================
+// formatDuration
+//===========================================================================
+static string formatDuration( double seconds )
+{
+	long s = long(seconds + 0.5);
+	char buf[32];
+	sprintf( buf, "%ld:%02ld:%02ld", s / 3600, (s / 60) % 60, s % 60 );
+	return buf;
+}
+
+//===========================================================================
+// printProgress
+//===========================================================================
+static void printProgress( const char *label, TSimulation *simulation, double elapsed, double stepsPerSecond )
+{
+	long step = simulation->getStep();
+	long maxSteps = simulation->GetMaxSteps();
+
+	printf( "%sstep %ld", label, step );
+	if( maxSteps > 0 )
+	{
+		printf( "/%ld (%.1f%%)", maxSteps, 100.0 * step / maxSteps );
+	}
+	printf( "  agents %ld  %.1f steps/s  elapsed %s",
+			simulation->getNumAgents(),
+			stepsPerSecond,
+			formatDuration(elapsed).c_str() );
+	if( (maxSteps > 0) && (stepsPerSecond > 0) )
+	{
+		printf( "  eta %s", formatDuration((maxSteps - step) / stepsPerSecond).c_str() );
+	}
+	printf( "\n" );
+	fflush( stdout );
+}
+
+//===========================================================================
+// runSimulation
+//===========================================================================
+int runSimulation( const RunOptions &options )
+{
+	proplib::Interpreter::init();
+
+	TSimulation *simulation = new TSimulation( options.worldfilePath, options.parameters );
+	MonitorManager *monitorManager = new MonitorManager( simulation, options.monitorPath );
+
+	proplib::Interpreter::dispose();
+
+	if( options.readyFd >= 0 )
+	{
+		char ready = 1;
+		if( write(options.readyFd, &ready, 1) != 1 )
+			perror( "write ready" );
+		close( options.readyFd );
+	}
+
+	bool ended = false;
+	simulation->stepEnding += [=]{monitorManager->step();};
+	simulation->ended += [&]{ended = true;};
+
+	{
+		struct sigaction sa;
+		sa.sa_handler = handleEndSignal;
+		sigemptyset( &sa.sa_mask );
+		// Back to the default action, so a second signal kills a run that
+		// won't end.
+		sa.sa_flags = SA_RESETHAND;
+		sigaction( SIGINT, &sa, NULL );
+		sigaction( SIGTERM, &sa, NULL );
+	}
+
+	const char *label = options.label.c_str();
+	double timeStart = hirestime();
+	double timeProgress = timeStart;
+	long stepProgress = simulation->getStep();
+
+	while( !ended )
+	{
+		if( endSignal )
+		{
+			printf( "%sEnding on %s at step %ld\n", label, strsignal(endSignal), simulation->getStep() );
+			simulation->End( "Signal" );
+			break;
+		}
+
+		simulation->Step();
+
+		if( options.progressInterval > 0 )
+		{
+			double now = hirestime();
+			if( now - timeProgress >= options.progressInterval )
+			{
+				printProgress( label,
+							   simulation,
+							   now - timeStart,
+							   (simulation->getStep() - stepProgress) / (now - timeProgress) );
+				timeProgress = now;
+				stepProgress = simulation->getStep();
+			}
+		}
+	}
+
+	if( options.progressInterval > 0 )
+	{
+		double elapsed = hirestime() - timeStart;
+		printProgress( label,
+					   simulation,
+					   elapsed,
+					   elapsed > 0 ? simulation->getStep() / elapsed : 0 );
+	}
+
+	delete simulation;
+	delete monitorManager;
+
+	return 0;
+}
+
+//===========================================================================
+// main
+//===========================================================================
+int main( int argc, char** argv )
+{
+	const char *worldfilePath = NULL;
+	VisionBackend *vision = VisionBackend::getDefault();
+	double progressInterval = DefaultProgressInterval;
+	int numReplicates = 1;
+	string ensembleDir = "ensemble";
+	proplib::ParameterMap parameters;
+
+	for( int argi = 1; argi < argc; argi++ )
+	{
+		string arg = argv[argi];
+
+		if( arg[0] == '-' )	// it's a flagged argument
+		{
+			if( arg == "-h" || arg == "--help" )
+				usage();
+			if( arg[1] != '-' )
+				usage( "Unknown argument: %s", arg.c_str() );
+			string key = arg.substr(2);
+			if( ++argi >= argc )
+				usage( "Missing %s arg", arg.c_str() );
+			string value( argv[argi] );
+			if( key == "vision" )
+			{
+				vision = VisionBackend::find( value );
+				if( vision == NULL )
+					usage( "Invalid --vision arg (%s)", value.c_str() );
+			}
+			else if( key == "progress" )
+			{
+				char *end;
+				progressInterval = strtod( value.c_str(), &end );
+				if( *end || progressInterval < 0 )
+					usage( "Invalid --progress arg (%s)", value.c_str() );
+			}
+			else if( key == "replicates" )
+			{
+				char *end;
+				numReplicates = strtol( value.c_str(), &end, 10 );
+				if( *end || numReplicates < 1 )
+					usage( "Invalid --replicates arg (%s)", value.c_str() );
+			}
+			else if( key == "ensemble-dir" )
+				ensembleDir = value;
+			else
+				parameters[key] = value;
+		}
+		else
+		{
+			if( worldfilePath == NULL )
+				worldfilePath = argv[argi];
+			else
+				usage( "Only one worldfile path allowed, at least two specified (%s, %s)", worldfilePath, argv[argi] );
+		}
+	}
+
+	if( ! worldfilePath )
+	{
+		usage( "A valid path to a worldfile must be specified" );
+	}
+
+	// Schemas and the run directory are all relative to the Polyworld directory.
+	if( ! exists("./etc/worldfile.wfs") )
+	{
+		fprintf( stderr, "Must execute from the Polyworld directory (no ./etc/worldfile.wfs)\n" );
+		exit( 1 );
+	}
+
+	string monitorPath;
+	{
+		if( exists("./headless.mf") )
+			monitorPath = "./headless.mf";
+		else
+			monitorPath = "./etc/headless.mf";
+	}
+
+	// Floats in worldfiles use a period whatever the system locale.
+	setlocale( LC_NUMERIC, "C" );
+
+	VisionBackend::select( vision );
+
+	RunOptions options;
+	options.worldfilePath = worldfilePath;
+	options.parameters = parameters;
+	options.monitorPath = monitorPath;
+	options.progressInterval = progressInterval;
+
+	if( numReplicates > 1 )
+		return runEnsemble( options, numReplicates, ensembleDir );
+	else
+		return runSimulation( options );
+}
@@ -124,46 +124,42 @@ int main(int argc, char** argv) {
         }
         copyAbstractFile(arguments.driven, arguments.passive, "/brain/synapses/synapses_" + std::to_string(agent) + "_birth.txt");
     }
-    std::map<int, std::list<analysis::Event> > events = analysis::getEvents(arguments.driven);
+    BirthsDeathsIndex* events = analysis::getEvents(arguments.driven);
     int maxTimestep = analysis::getMaxTimestep(arguments.driven);
     for (int timestep = 1; timestep <= maxTimestep; timestep++) {
         if (timestep % 100 == 0) {
             std::cerr << timestep << std::endl;
         }
-        std::map<int, std::list<analysis::Event> >::iterator eventsIter = events.find(timestep);
-        if (eventsIter != events.end()) {
-            itfor(std::list<analysis::Event>, eventsIter->second, timestepEventsIter) {
-                analysis::Event event = *timestepEventsIter;
-                if (event.type == "BIRTH" || event.type == "CREATION") {
-                    births[event.agent] = timestep;
-                    std::map<int, genome::Genome*>::iterator parent1 = choose(genomes);
-                    std::map<int, genome::Genome*>::iterator parent2;
-                    do {
-                        parent2 = choose(genomes);
-                    } while (parent2->first == parent1->first);
-                    genome::Genome* child = genome::GenomeUtil::createGenome();
-                    child->crossover(parent1->second, parent2->second, true);
-                    genomes[event.agent] = child;
-                    logGenome(arguments.passive, event.agent, child);
-                    RqNervousSystem* cns = new RqNervousSystem();
-                    cns->grow(child);
-                    if (Brain::config.learningMode != Brain::Configuration::LEARN_NONE) {
-                        logSynapses(arguments.passive, event.agent, "incept", cns);
-                    }
-                    cns->prebirth();
-                    logSynapses(arguments.passive, event.agent, "birth", cns);
-                    delete cns;
-                    log << timestep << " BIRTH " << event.agent << " " << parent1->first << " " << parent2->first << std::endl;
-                } else if (event.type == "DEATH") {
-                    std::map<int, genome::Genome*>::iterator genome = choose(genomes);
-                    genomes.erase(genome->first);
-                    delete genome->second;
-                    log << timestep << " DEATH " << genome->first << std::endl;
-                    writer.addRow(genome->first, births[genome->first], "PASSIVE", timestep, "PASSIVE");
-                } else {
-                    std::cerr << "Unhandled event: " << event.type << std::endl;
-                    return 1;
+        for (const BirthsDeathsIndex::Record* event = events->begin(timestep); event != events->end(timestep); event++) {
+            if (event->type == BirthsDeathsIndex::BIRTH || event->type == BirthsDeathsIndex::CREATION) {
+                births[event->agent] = timestep;
+                std::map<int, genome::Genome*>::iterator parent1 = choose(genomes);
+                std::map<int, genome::Genome*>::iterator parent2;
+                do {
+                    parent2 = choose(genomes);
+                } while (parent2->first == parent1->first);
+                genome::Genome* child = genome::GenomeUtil::createGenome();
+                child->crossover(parent1->second, parent2->second, true);
+                genomes[event->agent] = child;
+                logGenome(arguments.passive, event->agent, child);
+                RqNervousSystem* cns = new RqNervousSystem();
+                cns->grow(child);
+                if (Brain::config.learningMode != Brain::Configuration::LEARN_NONE) {
+                    logSynapses(arguments.passive, event->agent, "incept", cns);
                 }
+                cns->prebirth();
+                logSynapses(arguments.passive, event->agent, "birth", cns);
+                delete cns;
+                log << timestep << " BIRTH " << event->agent << " " << parent1->first << " " << parent2->first << std::endl;
+            } else if (event->type == BirthsDeathsIndex::DEATH) {
+                std::map<int, genome::Genome*>::iterator genome = choose(genomes);
+                genomes.erase(genome->first);
+                delete genome->second;
+                log << timestep << " DEATH " << genome->first << std::endl;
+                writer.addRow(genome->first, births[genome->first], "PASSIVE", timestep, "PASSIVE");
+            } else {
+                std::cerr << "Unhandled event: " << BirthsDeathsIndex::getTypeName(event->type) << std::endl;
+                return 1;
             }
         }
     }
@@ -172,6 +168,7 @@ int main(int argc, char** argv) {
         delete genomesIter->second;
     }
     log.close();
+    delete events;
     return 0;
 }
 
@@ -184,7 +181,18 @@ void copyFile(const std::string& source, const std::string& target, const std::s
 }
 
 void copyAbstractFile(const std::string& source, const std::string& target, const std::string& path) {
-    std::string extension = globals::recordFileType == AbstractFile::TYPE_GZIP_FILE ? ".gz" : "";
+    std::string extension;
+    switch (globals::recordFileType) {
+    case AbstractFile::TYPE_GZIP_FILE:
+    case AbstractFile::TYPE_PARALLEL_GZIP_FILE:
+        extension = ".gz";
+        break;
+    case AbstractFile::TYPE_ZSTD_FILE:
+        extension = ".zst";
+        break;
+    default:
+        break;
+    }
     SYSTEM(("cp " + (source + path + extension) + " " + (target + path + extension)).c_str());
 }
 
@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "proplib/builder.h"
+#include "proplib/cache.h"
 #include "proplib/editor.h"
 #include "proplib/overlay.h"
 #include "proplib/schema.h"
@@ -227,6 +228,16 @@ int main( int argc, const char **argv )
 	return 0;
 }
 
+// Values resolved by earlier calls on the same schema and doc, of which the
+// farm scripts make many.
+void loadCache( DocumentCache &cache, const char *pathSchema, const char *pathDoc )
+{
+	cache.addString( isWorldfile ? "worldfile" : "" );
+	cache.addFile( pathSchema );
+	cache.addFile( pathDoc );
+	cache.load();
+}
+
 Document *parseDoc( SchemaDocument *schema, const char *pathDoc )
 {
 	DocumentBuilder builder;
@@ -239,6 +250,9 @@ Document *parseDoc( SchemaDocument *schema, const char *pathDoc )
 
 void apply( const char *pathSchema, const char *pathDoc )
 {
+	DocumentCache cache;
+	loadCache( cache, pathSchema, pathDoc );
+
 	DocumentBuilder builder;
 	SchemaDocument *schema = builder.buildSchemaDocument( pathSchema );
 	Document *doc = parseDoc( schema, pathDoc );
@@ -285,6 +299,9 @@ void get( const char *pathDoc, const char *name )
 
 void get( const char *pathSchema, const char *pathDoc, const char *name )
 {
+	DocumentCache cache;
+	loadCache( cache, pathSchema, pathDoc );
+
 	DocumentBuilder builder;
 	SchemaDocument *schema = builder.buildSchemaDocument( pathSchema );
 	Document *doc = parseDoc( schema, pathDoc );
@@ -359,6 +376,9 @@ void len( const char *pathDoc, const char *name )
 
 void len( const char *pathSchema, const char *pathDoc, const char *name )
 {
+	DocumentCache cache;
+	loadCache( cache, pathSchema, pathDoc );
+
 	DocumentBuilder builder;
 	SchemaDocument *schema = builder.buildSchemaDocument( pathSchema );
 	Document *doc = parseDoc( schema, pathDoc );